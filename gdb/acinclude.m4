@@ -68,6 +68,9 @@ m4_include(libiberty.m4)
 dnl For GDB_AC_PTRACE.
 m4_include(ptrace.m4)
 
+dnl For GDB_AC_PTHREAD.
+m4_include(pthread.m4)
+
 m4_include(ax_cxx_compile_stdcxx.m4)
 
 ## ----------------------------------------- ##
@@ -1138,11 +1138,28 @@ ada_remove_Xbn_suffix (const char *encoded, int *len)
     *len = i;
 }
 
+/* The buffer holding the result of ada_decode.  Each thread has its
+   own, since names can be decoded by worker threads.  */
+
+struct ada_decoding_buffer
+{
+  ~ada_decoding_buffer ()
+  {
+    xfree (data);
+  }
+
+  char *data;
+  size_t size;
+};
+
+static thread_local struct ada_decoding_buffer decoding_buffer;
+
 /* If ENCODED follows the GNAT entity encoding conventions, then return
    the decoded form of ENCODED.  Otherwise, return "<%s>" where "%s" is
    replaced by ENCODED.
 
-   The resulting string is valid until the next call of ada_decode.
+   The resulting string is valid until the next call of ada_decode in
+   the same thread.
    If the string is unchanged by decoding, the original string pointer
    is returned.  */
 
@@ -1154,8 +1171,6 @@ ada_decode (const char *encoded)
   const char *p;
   char *decoded;
   int at_start_name;
-  static char *decoding_buffer = NULL;
-  static size_t decoding_buffer_size = 0;
 
   /* The name of the Ada main procedure starts with "_ada_".
      This prefix is not part of the decoded name, so skip this part
@@ -1209,8 +1224,8 @@ ada_decode (const char *encoded)
 
   /* Make decoded big enough for possible expansion by operator name.  */
 
-  GROW_VECT (decoding_buffer, decoding_buffer_size, 2 * len0 + 1);
-  decoded = decoding_buffer;
+  GROW_VECT (decoding_buffer.data, decoding_buffer.size, 2 * len0 + 1);
+  decoded = decoding_buffer.data;
 
   /* Remove trailing __{digit}+ or trailing ${digit}+.  */
 
@@ -1383,12 +1398,13 @@ ada_decode (const char *encoded)
     return decoded;
 
 Suppress:
-  GROW_VECT (decoding_buffer, decoding_buffer_size, strlen (encoded) + 3);
-  decoded = decoding_buffer;
+  GROW_VECT (decoding_buffer.data, decoding_buffer.size,
+	     strlen (encoded) + 3);
+  decoded = decoding_buffer.data;
   if (encoded[0] == '<')
     strcpy (decoded, encoded);
   else
-    xsnprintf (decoded, decoding_buffer_size, "<%s>", encoded);
+    xsnprintf (decoded, decoding_buffer.size, "<%s>", encoded);
   return decoded;
 
 }
@@ -22,6 +22,7 @@
 #include "defs.h"
 #include "gdb_obstack.h"
 #include "bcache.h"
+#include <mutex>
 
 /* The type used to hold a single bcache string.  The user data is
    stored in d.data.  Since it can be any type, it needs to have the
@@ -31,15 +32,12 @@
 
 struct bstring
 {
-  /* Hash chain.  */
-  struct bstring *next;
+  /* The hash of the data, as returned by bcache_hash.  This is used
+     as a pre-check when comparing two strings, which avoids most
+     length and memcmp calls, and when the hash table grows.  */
+  unsigned int hash;
   /* Assume the data length is no more than 64k.  */
   unsigned short length;
-  /* The half hash hack.  This contains the upper 16 bits of the hash
-     value and is used as a pre-check when comparing two strings and
-     avoids the need to do length or memcmp calls.  It proves to be
-     roughly 100% effective.  */
-  unsigned short half_hash;
 
   union
   {
@@ -49,22 +47,41 @@ struct bstring
   d;
 };
 
+/* A bcache is split into shards, each of which holds the strings
+   whose hash starts with the shard's index.  Worker threads only need
+   to lock the shard they are inserting into.  */
 
-/* The structure for a bcache itself.  The bcache is initialized, in
-   bcache_xmalloc(), by filling it with zeros and then setting the
-   corresponding obstack's malloc() and free() methods.  */
+#define BCACHE_SHARD_BITS 3
+#define BCACHE_SHARD_COUNT (1 << BCACHE_SHARD_BITS)
 
-struct bcache
+/* The number of slots of a shard's hash table when it is first
+   used.  */
+
+#define BCACHE_INITIAL_SLOTS 32
+
+/* The size of the chunks of a shard's obstack when it is first used,
+   and the largest size they grow to, which is the obstack default.
+   Small chunks keep the shards of a small bcache from wasting much
+   memory.  */
+
+#define BCACHE_INITIAL_CHUNK_SIZE (4064 / 8)
+#define BCACHE_MAX_CHUNK_SIZE 4064
+
+struct bcache_shard
 {
-  /* All the bstrings are allocated here.  */
+  /* Held while inserting into this shard from a worker thread.  */
+  std::mutex lock;
+
+  /* All the bstrings of this shard are allocated here.  */
   struct obstack cache;
 
-  /* How many hash buckets we're using.  */
-  unsigned int num_buckets;
-  
-  /* Hash buckets.  This table is allocated using malloc, so when we
-     grow the table we can return the old table to the system.  */
-  struct bstring **bucket;
+  /* How many hash table slots we're using.  Always a power of 2.  */
+  unsigned int num_slots;
+
+  /* The hash table, with open addressing and linear probing.  This
+     table is allocated using malloc, so when we grow the table we can
+     return the old table to the system.  */
+  struct bstring **slots;
 
   /* Statistics.  */
   unsigned long unique_count;	/* number of unique strings */
@@ -73,16 +90,19 @@ struct bcache
   long total_size;      /* total number of bytes cached, including dups */
   long structure_size;	/* total size of bcache, including infrastructure */
   /* Number of times that the hash table is expanded and hence
-     re-built, and the corresponding number of times that a string is
-     [re]hashed as part of entering it into the expanded table.  The
-     total number of hashes can be computed by adding TOTAL_COUNT to
-     expand_hash_count.  */
+     re-built.  Since the strings remember their hash, they are not
+     rehashed when that happens.  */
   unsigned long expand_count;
-  unsigned long expand_hash_count;
-  /* Number of times that the half-hash compare hit (compare the upper
-     16 bits of hash values) hit, but the corresponding combined
-     length/data compare missed.  */
+  /* Number of times that the hash compare hit, but the corresponding
+     combined length/data compare missed.  */
   unsigned long half_hash_miss_count;
+};
+
+/* The structure for a bcache itself.  */
+
+struct bcache
+{
+  struct bcache_shard shards[BCACHE_SHARD_COUNT];
 
   /* Hash function to be used for this bcache object.  */
   unsigned long (*hash_function)(const void *addr, int length);
@@ -119,86 +139,85 @@ hash_continue (const void *addr, int length, unsigned long h)
 
 /* Growing the bcache's hash table.  */
 
-/* If the average chain length grows beyond this, then we want to
-   resize our hash table.  */
-#define CHAIN_LENGTH_THRESHOLD (5)
+/* Double the size of SHARD's hash table, or allocate it if this is
+   the first string of SHARD.  */
 
 static void
-expand_hash_table (struct bcache *bcache)
+expand_hash_table (struct bcache_shard *shard)
 {
-  /* A table of good hash table sizes.  Whenever we grow, we pick the
-     next larger size from this table.  sizes[i] is close to 1 << (i+10),
-     so we roughly double the table size each time.  After we fall off 
-     the end of this table, we just double.  Don't laugh --- there have
-     been executables sighted with a gigabyte of debug info.  */
-  static unsigned long sizes[] = { 
-    1021, 2053, 4099, 8191, 16381, 32771,
-    65537, 131071, 262144, 524287, 1048573, 2097143,
-    4194301, 8388617, 16777213, 33554467, 67108859, 134217757,
-    268435459, 536870923, 1073741827, 2147483659UL
-  };
-  unsigned int new_num_buckets;
-  struct bstring **new_buckets;
+  unsigned int new_num_slots;
+  struct bstring **new_slots;
   unsigned int i;
 
-  /* Count the stats.  Every unique item needs to be re-hashed and
-     re-entered.  */
-  bcache->expand_count++;
-  bcache->expand_hash_count += bcache->unique_count;
+  if (shard->num_slots == 0)
+    new_num_slots = BCACHE_INITIAL_SLOTS;
+  else
+    {
+      shard->expand_count++;
+      new_num_slots = shard->num_slots * 2;
 
-  /* Find the next size.  */
-  new_num_buckets = bcache->num_buckets * 2;
-  for (i = 0; i < (sizeof (sizes) / sizeof (sizes[0])); i++)
-    if (sizes[i] > bcache->num_buckets)
-      {
-	new_num_buckets = sizes[i];
-	break;
-      }
+      /* Let the obstack chunks grow along with the table.  */
+      if (obstack_chunk_size (&shard->cache) < BCACHE_MAX_CHUNK_SIZE)
+	obstack_chunk_size (&shard->cache) *= 2;
+    }
 
   /* Allocate the new table.  */
   {
-    size_t new_size = new_num_buckets * sizeof (new_buckets[0]);
+    size_t new_size = new_num_slots * sizeof (new_slots[0]);
 
-    new_buckets = (struct bstring **) xmalloc (new_size);
-    memset (new_buckets, 0, new_size);
+    new_slots = (struct bstring **) xmalloc (new_size);
+    memset (new_slots, 0, new_size);
 
-    bcache->structure_size -= (bcache->num_buckets
-			       * sizeof (bcache->bucket[0]));
-    bcache->structure_size += new_size;
+    shard->structure_size -= shard->num_slots * sizeof (shard->slots[0]);
+    shard->structure_size += new_size;
   }
 
-  /* Rehash all existing strings.  */
-  for (i = 0; i < bcache->num_buckets; i++)
+  /* Move all existing strings to the new table.  */
+  for (i = 0; i < shard->num_slots; i++)
     {
-      struct bstring *s, *next;
+      struct bstring *s = shard->slots[i];
+      unsigned int j;
 
-      for (s = bcache->bucket[i]; s; s = next)
-	{
-	  struct bstring **new_bucket;
-	  next = s->next;
-
-	  new_bucket = &new_buckets[(bcache->hash_function (&s->d.data,
-							    s->length)
-				     % new_num_buckets)];
-	  s->next = *new_bucket;
-	  *new_bucket = s;
-	}
+      if (s == NULL)
+	continue;
+
+      for (j = s->hash & (new_num_slots - 1);
+	   new_slots[j] != NULL;
+	   j = (j + 1) & (new_num_slots - 1))
+	;
+      new_slots[j] = s;
     }
 
   /* Plug in the new table.  */
-  if (bcache->bucket)
-    xfree (bcache->bucket);
-  bcache->bucket = new_buckets;
-  bcache->num_buckets = new_num_buckets;
+  xfree (shard->slots);
+  shard->slots = new_slots;
+  shard->num_slots = new_num_slots;
 }
 
-
+
 /* Looking up things in the bcache.  */
 
 /* The number of bytes needed to allocate a struct bstring whose data
    is N bytes long.  */
 #define BSTRING_SIZE(n) (offsetof (struct bstring, d.data) + (n))
 
+/* Return the hash of the LENGTH bytes at ADDR in BCACHE.  The result
+   of the hash function is mixed, since the shard is picked from the
+   top bits and the table slot from the bottom bits.  */
+
+static unsigned int
+bcache_hash (struct bcache *bcache, const void *addr, int length)
+{
+  unsigned long full_hash = bcache->hash_function (addr, length);
+  /* Shift twice, since unsigned long may have only 32 bits.  */
+  unsigned int h = full_hash ^ ((full_hash >> 16) >> 16);
+
+  h ^= h >> 16;
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  return h;
+}
+
 /* Find a copy of the LENGTH bytes at ADDR in BCACHE.  If BCACHE has
    never seen those bytes before, add a copy of them to BCACHE.  In
    either case, return a pointer to BCACHE's copy of that string.  */
@@ -217,66 +236,66 @@ bcache (const void *addr, int length, struct bcache *cache)
 const void *
 bcache_full (const void *addr, int length, struct bcache *bcache, int *added)
 {
-  unsigned long full_hash;
-  unsigned short half_hash;
-  int hash_index;
+  unsigned int h;
+  struct bcache_shard *shard;
+  unsigned int mask, i;
   struct bstring *s;
 
   if (added)
     *added = 0;
 
-  /* Lazily initialize the obstack.  This can save quite a bit of
-     memory in some cases.  */
-  if (bcache->total_count == 0)
-    {
-      /* We could use obstack_specify_allocation here instead, but
-	 gdb_obstack.h specifies the allocation/deallocation
-	 functions.  */
-      obstack_init (&bcache->cache);
-    }
+  h = bcache_hash (bcache, addr, length);
+  shard = &bcache->shards[h >> (32 - BCACHE_SHARD_BITS)];
 
-  /* If our average chain length is too high, expand the hash table.  */
-  if (bcache->unique_count >= bcache->num_buckets * CHAIN_LENGTH_THRESHOLD)
-    expand_hash_table (bcache);
+  /* Outside of parallel_for, only the main thread runs, so there is
+     nothing to lock against.  */
+  std::unique_lock<std::mutex> guard (shard->lock, std::defer_lock);
+  if (in_worker_thread)
+    guard.lock ();
 
-  bcache->total_count++;
-  bcache->total_size += length;
+  /* Lazily initialize the obstack.  This can save quite a bit of
+     memory in some cases.  */
+  if (shard->total_count == 0)
+    obstack_begin (&shard->cache, BCACHE_INITIAL_CHUNK_SIZE);
 
-  full_hash = bcache->hash_function (addr, length);
+  /* Keep the table at most three quarters full, so that probe
+     sequences stay short and always end at an empty slot.  */
+  if ((shard->unique_count + 1) * 4 > (unsigned long) shard->num_slots * 3)
+    expand_hash_table (shard);
 
-  half_hash = (full_hash >> 16);
-  hash_index = full_hash % bcache->num_buckets;
+  shard->total_count++;
+  shard->total_size += length;
 
-  /* Search the hash bucket for a string identical to the caller's.
-     As a short-circuit first compare the upper part of each hash
-     values.  */
-  for (s = bcache->bucket[hash_index]; s; s = s->next)
+  /* Search for a string identical to the caller's.  As a
+     short-circuit first compare the hash values.  */
+  mask = shard->num_slots - 1;
+  for (i = h & mask; (s = shard->slots[i]) != NULL; i = (i + 1) & mask)
     {
-      if (s->half_hash == half_hash)
+      if (s->hash == h)
 	{
 	  if (s->length == length
 	      && bcache->compare_function (&s->d.data, addr, length))
 	    return &s->d.data;
 	  else
-	    bcache->half_hash_miss_count++;
+	    shard->half_hash_miss_count++;
 	}
     }
 
-  /* The user's string isn't in the list.  Insert it after *ps.  */
+  /* The user's string isn't in the table.  Insert it in the empty
+     slot that ended the search.  */
   {
     struct bstring *newobj
-      = (struct bstring *) obstack_alloc (&bcache->cache,
+      = (struct bstring *) obstack_alloc (&shard->cache,
 					  BSTRING_SIZE (length));
 
     memcpy (&newobj->d.data, addr, length);
     newobj->length = length;
-    newobj->next = bcache->bucket[hash_index];
-    newobj->half_hash = half_hash;
-    bcache->bucket[hash_index] = newobj;
+    newobj->hash = h;
+    shard->slots[i] = newobj;
 
-    bcache->unique_count++;
-    bcache->unique_size += length;
-    bcache->structure_size += BSTRING_SIZE (length);
+    shard->unique_count++;
+    shard->unique_size += length;
+    shard->structure_size += BSTRING_SIZE (length);
 
     if (added)
       *added = 1;
@@ -284,7 +303,7 @@ bcache_full (const void *addr, int length, struct bcache *bcache, int *added)
     return &newobj->d.data;
   }
 }
-
+
 
 /* Compare the byte string at ADDR1 of lenght LENGHT to the
    string at ADDR2.  Return 1 if they are equal.  */
@@ -309,7 +328,7 @@ bcache_xmalloc (unsigned long (*hash_function)(const void *, int length),
 					int length))
 {
   /* Allocate the bcache pre-zeroed.  */
-  struct bcache *b = XCNEW (struct bcache);
+  struct bcache *b = new struct bcache ();
 
   if (hash_function)
     b->hash_function = hash_function;
@@ -327,13 +346,20 @@ bcache_xmalloc (unsigned long (*hash_function)(const void *, int length),
 void
 bcache_xfree (struct bcache *bcache)
 {
+  int i;
+
   if (bcache == NULL)
     return;
-  /* Only free the obstack if we actually initialized it.  */
-  if (bcache->total_count > 0)
-    obstack_free (&bcache->cache, 0);
-  xfree (bcache->bucket);
-  xfree (bcache);
+  for (i = 0; i < BCACHE_SHARD_COUNT; i++)
+    {
+      struct bcache_shard *shard = &bcache->shards[i];
+
+      /* Only free the obstack if we actually initialized it.  */
+      if (shard->total_count > 0)
+	obstack_free (&shard->cache, 0);
+      xfree (shard->slots);
+    }
+  delete bcache;
 }
 
 
@@ -354,71 +380,85 @@ print_percentage (int portion, int total)
 /* Print statistics on BCACHE's memory usage and efficacity at
    eliminating duplication.  NAME should describe the kind of data
    BCACHE holds.  Statistics are printed using `printf_filtered' and
-   its ilk.  */
+   its ilk.  The "chain" of a string is the probe sequence that leads
+   to it in its shard's hash table.  */
 void
 print_bcache_statistics (struct bcache *c, char *type)
 {
-  int occupied_buckets;
+  unsigned long unique_count = 0;
+  long total_count = 0;
+  long unique_size = 0;
+  long total_size = 0;
+  long structure_size = 0;
+  unsigned long expand_count = 0;
+  unsigned long half_hash_miss_count = 0;
+  unsigned long num_slots = 0;
+  unsigned long total_chain_length = 0;
   int max_chain_length;
   int median_chain_length;
   int max_entry_size;
   int median_entry_size;
+  int i;
 
-  /* Count the number of occupied buckets, tally the various string
-     lengths, and measure chain lengths.  */
-  {
-    unsigned int b;
-    int *chain_length = XCNEWVEC (int, c->num_buckets + 1);
-    int *entry_size = XCNEWVEC (int, c->unique_count + 1);
-    int stringi = 0;
+  for (i = 0; i < BCACHE_SHARD_COUNT; i++)
+    {
+      struct bcache_shard *shard = &c->shards[i];
+
+      unique_count += shard->unique_count;
+      total_count += shard->total_count;
+      unique_size += shard->unique_size;
+      total_size += shard->total_size;
+      structure_size += shard->structure_size;
+      expand_count += shard->expand_count;
+      half_hash_miss_count += shard->half_hash_miss_count;
+      num_slots += shard->num_slots;
+    }
 
-    occupied_buckets = 0;
+  /* Tally the various string lengths, and measure chain lengths.  */
+  {
+    int *chain_length = XCNEWVEC (int, unique_count + 1);
+    int *entry_size = XCNEWVEC (int, unique_count + 1);
+    unsigned long stringi = 0;
 
-    for (b = 0; b < c->num_buckets; b++)
+    for (i = 0; i < BCACHE_SHARD_COUNT; i++)
       {
-	struct bstring *s = c->bucket[b];
+	struct bcache_shard *shard = &c->shards[i];
+	unsigned int mask = shard->num_slots - 1;
+	unsigned int b;
 
-	chain_length[b] = 0;
-
-	if (s)
+	for (b = 0; b < shard->num_slots; b++)
 	  {
-	    occupied_buckets++;
-	    
-	    while (s)
-	      {
-		gdb_assert (b < c->num_buckets);
-		chain_length[b]++;
-		gdb_assert (stringi < c->unique_count);
-		entry_size[stringi++] = s->length;
-		s = s->next;
-	      }
+	    struct bstring *s = shard->slots[b];
+
+	    if (s == NULL)
+	      continue;
+
+	    gdb_assert (stringi < unique_count);
+	    chain_length[stringi] = ((b - (s->hash & mask)) & mask) + 1;
+	    total_chain_length += chain_length[stringi];
+	    entry_size[stringi] = s->length;
+	    stringi++;
 	  }
       }
 
     /* To compute the median, we need the set of chain lengths
        sorted.  */
-    qsort (chain_length, c->num_buckets, sizeof (chain_length[0]),
+    qsort (chain_length, unique_count, sizeof (chain_length[0]),
 	   compare_positive_ints);
-    qsort (entry_size, c->unique_count, sizeof (entry_size[0]),
+    qsort (entry_size, unique_count, sizeof (entry_size[0]),
 	   compare_positive_ints);
 
-    if (c->num_buckets > 0)
+    if (unique_count > 0)
       {
-	max_chain_length = chain_length[c->num_buckets - 1];
-	median_chain_length = chain_length[c->num_buckets / 2];
+	max_chain_length = chain_length[unique_count - 1];
+	median_chain_length = chain_length[unique_count / 2];
+	max_entry_size = entry_size[unique_count - 1];
+	median_entry_size = entry_size[unique_count / 2];
       }
     else
       {
 	max_chain_length = 0;
 	median_chain_length = 0;
-      }
-    if (c->unique_count > 0)
-      {
-	max_entry_size = entry_size[c->unique_count - 1];
-	median_entry_size = entry_size[c->unique_count / 2];
-      }
-    else
-      {
 	max_entry_size = 0;
 	median_entry_size = 0;
       }
@@ -428,22 +468,22 @@ print_bcache_statistics (struct bcache *c, char *type)
   }
 
   printf_filtered (_("  Cached '%s' statistics:\n"), type);
-  printf_filtered (_("    Total object count:  %ld\n"), c->total_count);
-  printf_filtered (_("    Unique object count: %lu\n"), c->unique_count);
+  printf_filtered (_("    Total object count:  %ld\n"), total_count);
+  printf_filtered (_("    Unique object count: %lu\n"), unique_count);
   printf_filtered (_("    Percentage of duplicates, by count: "));
-  print_percentage (c->total_count - c->unique_count, c->total_count);
+  print_percentage (total_count - unique_count, total_count);
   printf_filtered ("\n");
 
-  printf_filtered (_("    Total object size:   %ld\n"), c->total_size);
-  printf_filtered (_("    Unique object size:  %ld\n"), c->unique_size);
+  printf_filtered (_("    Total object size:   %ld\n"), total_size);
+  printf_filtered (_("    Unique object size:  %ld\n"), unique_size);
   printf_filtered (_("    Percentage of duplicates, by size:  "));
-  print_percentage (c->total_size - c->unique_size, c->total_size);
+  print_percentage (total_size - unique_size, total_size);
   printf_filtered ("\n");
 
   printf_filtered (_("    Max entry size:     %d\n"), max_entry_size);
   printf_filtered (_("    Average entry size: "));
-  if (c->unique_count > 0)
-    printf_filtered ("%ld\n", c->unique_size / c->unique_count);
+  if (unique_count > 0)
+    printf_filtered ("%ld\n", unique_size / unique_count);
   else
     /* i18n: "Average entry size: (not applicable)".  */
     printf_filtered (_("(not applicable)\n"));    
@@ -452,28 +492,28 @@ print_bcache_statistics (struct bcache *c, char *type)
 
   printf_filtered (_("    \
 Total memory used by bcache, including overhead: %ld\n"),
-		   c->structure_size);
+		   structure_size);
   printf_filtered (_("    Percentage memory overhead: "));
-  print_percentage (c->structure_size - c->unique_size, c->unique_size);
+  print_percentage (structure_size - unique_size, unique_size);
   printf_filtered (_("    Net memory savings:         "));
-  print_percentage (c->total_size - c->structure_size, c->total_size);
+  print_percentage (total_size - structure_size, total_size);
   printf_filtered ("\n");
 
-  printf_filtered (_("    Hash table size:           %3d\n"), 
-		   c->num_buckets);
+  printf_filtered (_("    Hash table size:           %3lu\n"),
+		   num_slots);
   printf_filtered (_("    Hash table expands:        %lu\n"),
-		   c->expand_count);
-  printf_filtered (_("    Hash table hashes:         %lu\n"),
-		   c->total_count + c->expand_hash_count);
+		   expand_count);
+  printf_filtered (_("    Hash table hashes:         %ld\n"),
+		   total_count);
   printf_filtered (_("    Half hash misses:          %lu\n"),
-		   c->half_hash_miss_count);
+		   half_hash_miss_count);
   printf_filtered (_("    Hash table population:     "));
-  print_percentage (occupied_buckets, c->num_buckets);
+  print_percentage (unique_count, num_slots);
   printf_filtered (_("    Median hash chain length:  %3d\n"),
 		   median_chain_length);
   printf_filtered (_("    Average hash chain length: "));
-  if (c->num_buckets > 0)
-    printf_filtered ("%3lu\n", c->unique_count / c->num_buckets);
+  if (unique_count > 0)
+    printf_filtered ("%3lu\n", total_chain_length / unique_count);
   else
     /* i18n: "Average hash chain length: (not applicable)".  */
     printf_filtered (_("(not applicable)\n"));
@@ -485,7 +525,11 @@ Total memory used by bcache, including overhead: %ld\n"),
 int
 bcache_memory_used (struct bcache *bcache)
 {
-  if (bcache->total_count == 0)
-    return 0;
-  return obstack_memory_used (&bcache->cache);
+  int used = 0;
+  int i;
+
+  for (i = 0; i < BCACHE_SHARD_COUNT; i++)
+    if (bcache->shards[i].total_count > 0)
+      used += obstack_memory_used (&bcache->shards[i].cache);
+  return used;
 }
@@ -133,8 +133,25 @@
    Mind you, looking at the wall clock, the same GDB debugging GDB
    showed only marginal speed up (0.780 vs 0.773s).  Seems GDB is too
    busy doing something else :-(
-  
-*/
+
+
+   Open addressing and shards:
+
+   With the large symbol tables of C++ programs, the chains grew much
+   longer than 4 in practice, and walking them, one cache miss per
+   link, came to dominate the cost of the bcache.  So the bcache now
+   uses open addressing after all, with linear probing in a table of
+   pointers kept at most three quarters full.  The empty slots cost
+   more memory than the chains did, but part of that is paid back by
+   the chain pointer each string no longer needs.  The
+   hash of each string is kept where the half hash used to be, so it
+   still short-circuits compares, and the table can grow without
+   calling the hash function again.
+
+   So that worker threads can add strings concurrently, a bcache is
+   split into shards, picked by the top bits of the hash, each with its
+   own table, obstack and lock.  The lock is only taken by the threads
+   of parallel_for; on its own, the main thread never waits.  */
 
 
 struct bcache;
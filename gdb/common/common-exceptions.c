@@ -22,6 +22,10 @@
 
 const struct gdb_exception exception_none = { (enum return_reason) 0, GDB_NO_ERROR, NULL };
 
+/* See common-exceptions.h.  */
+
+thread_local bool in_worker_thread;
+
 /* Possible catcher states.  */
 enum catcher_state {
   /* Initial state, a new catcher has just been created.  */
@@ -286,7 +290,8 @@ throw_exception_sjlj (struct gdb_exception exception)
 static ATTRIBUTE_NORETURN void
 throw_exception_cxx (struct gdb_exception exception)
 {
-  do_cleanups (all_cleanups ());
+  if (!in_worker_thread)
+    do_cleanups (all_cleanups ());
 
   if (exception.reason == RETURN_QUIT)
     {
@@ -345,6 +350,17 @@ throw_it (enum return_reason reason, enum errors error, const char *fmt,
   int depth = try_scope_depth;
 #endif
 
+#if GDB_XCPT != GDB_XCPT_SJMP
+  if (in_worker_thread)
+    {
+      /* The catcher owns the message.  */
+      e.reason = reason;
+      e.error = error;
+      e.message = xstrvprintf (fmt, ap);
+      throw_exception (e);
+    }
+#endif
+
   gdb_assert (depth > 0);
 
   /* Note: The new message may use an old message's text.  */
@@ -300,6 +300,14 @@ struct gdb_quit_bad_alloc
 
 /* *INDENT-ON* */
 
+/* True in a thread doing work for the main thread, see
+   parallel-for.h.  The cleanup chain and the TRY/CATCH state belong
+   to the main thread, so an exception thrown while this is set does
+   not run cleanups, and its message is allocated with xmalloc rather
+   than recorded for reuse.  The thread must catch it with a C++
+   catch and xfree the message.  */
+extern thread_local bool in_worker_thread;
+
 /* Throw an exception (as described by "struct gdb_exception"),
    landing in the inner most containing exception handler established
    using TRY/CATCH.  */
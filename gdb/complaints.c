@@ -97,6 +97,10 @@ static struct complaints symfile_complaint_book = {
 };
 struct complaints *symfile_complaints = &symfile_complaint_book;
 
+/* See complaints.h.  */
+
+thread_local unsigned int worker_complaint_count;
+
 /* Wrapper function to, on-demand, fill in a complaints object.  */
 
 static struct complaints *
@@ -160,11 +164,19 @@ vcomplaint (struct complaints **c, const char *file,
 	    int line, const char *fmt,
 	    va_list args)
 {
-  struct complaints *complaints = get_complaints (c);
-  struct complain *complaint = find_complaint (complaints, file, 
-					       line, fmt);
+  struct complaints *complaints;
+  struct complain *complaint;
   enum complaint_series series;
 
+  if (in_worker_thread)
+    {
+      ++worker_complaint_count;
+      return;
+    }
+
+  complaints = get_complaints (c);
+  complaint = find_complaint (complaints, file, line, fmt);
+
   gdb_assert (complaints != NULL);
 
   complaint->counter++;
@@ -37,6 +37,12 @@ extern void internal_complaint (struct complaints **complaints,
 				const char *fmt,
 				...) ATTRIBUTE_PRINTF (4, 5);
 
+/* The number of complaints made by this thread while it was a worker
+   thread (see parallel-for.h).  Such complaints are not recorded;
+   the worker can check this count to find out whether it has to let
+   the main thread redo its work.  */
+extern thread_local unsigned int worker_complaint_count;
+
 /* Clear out / initialize all complaint counters that have ever been
    incremented.  If LESS_VERBOSE is 1, be less verbose about
    successive complaints, since the messages are appearing all
@@ -36,6 +36,7 @@
 #include <signal.h>
 #include "gdb_setjmp.h"
 #include "safe-ctype.h"
+#include "parallel-for.h"
 
 #define d_left(dc) (dc)->u.s_binary.left
 #define d_right(dc) (dc)->u.s_binary.right
@@ -1492,20 +1493,33 @@ cp_lookup_rtti_type (const char *name, struct block *block)
 
 static int catch_demangler_crashes = 1;
 
-/* Stack context and environment for demangler crash recovery.  */
+/* Stack context and environment for demangler crash recovery, while
+   this thread is in gdb_demangle.  */
 
-static SIGJMP_BUF gdb_demangle_jmp_buf;
+static thread_local SIGJMP_BUF *gdb_demangle_jmp_buf;
 
 /* If nonzero, attempt to dump core from the signal handler.  */
 
 static int gdb_demangle_attempt_core_dump = 1;
 
+/* Nonzero while parallel_for_demangling has the signal handler
+   installed for its worker threads.  */
+
+static int gdb_demangle_workers_protected;
+
 /* Signal handler for gdb_demangle.  */
 
 static void
 gdb_demangle_signal_handler (int signo)
 {
-  if (gdb_demangle_attempt_core_dump)
+  /* The crash is not in the demangler; let it happen.  */
+  if (gdb_demangle_jmp_buf == NULL)
+    {
+      signal (signo, SIG_DFL);
+      return;
+    }
+
+  if (gdb_demangle_attempt_core_dump && !in_worker_thread)
     {
       if (fork () == 0)
 	dump_core ();
@@ -1513,11 +1527,75 @@ gdb_demangle_signal_handler (int signo)
       gdb_demangle_attempt_core_dump = 0;
     }
 
-  SIGLONGJMP (gdb_demangle_jmp_buf, signo);
+  SIGLONGJMP (*gdb_demangle_jmp_buf, signo);
 }
 
+/* Install gdb_demangle_signal_handler for SIGSEGV, saving the old
+   action in *OLD_SA.  */
+
+#if defined (HAVE_SIGACTION) && defined (SA_RESTART)
+
+static void
+install_demangle_signal_handler (struct sigaction *old_sa)
+{
+  struct sigaction sa;
+
+  sa.sa_handler = gdb_demangle_signal_handler;
+  sigemptyset (&sa.sa_mask);
+#ifdef HAVE_SIGALTSTACK
+  sa.sa_flags = SA_ONSTACK;
+#else
+  sa.sa_flags = 0;
+#endif
+  sigaction (SIGSEGV, &sa, old_sa);
+}
+
+#endif
+
+#endif
+
+/* See cp-support.h.  */
+
+thread_local unsigned int worker_demangler_crashes;
+
+/* See cp-support.h.  */
+
+void
+parallel_for_demangling (unsigned int n,
+			 void (*fn) (unsigned int i, void *data),
+			 void *data)
+{
+#ifdef HAVE_WORKING_FORK
+  /* Signal handlers are shared by all threads, so the worker threads
+     can't install one for each call of gdb_demangle; install it once
+     for all of them.  Worker threads have no alternate signal stack,
+     so a stack overflow in the demangler is still fatal there.  */
+  if (catch_demangler_crashes)
+    {
+#if defined (HAVE_SIGACTION) && defined (SA_RESTART)
+      struct sigaction old_sa;
+
+      install_demangle_signal_handler (&old_sa);
+#else
+      sighandler_t ofunc = signal (SIGSEGV, gdb_demangle_signal_handler);
+#endif
+
+      gdb_demangle_workers_protected = 1;
+      parallel_for (n, fn, data);
+      gdb_demangle_workers_protected = 0;
+
+#if defined (HAVE_SIGACTION) && defined (SA_RESTART)
+      sigaction (SIGSEGV, &old_sa, NULL);
+#else
+      signal (SIGSEGV, ofunc);
+#endif
+      return;
+    }
 #endif
 
+  parallel_for (n, fn, data);
+}
+
 /* A wrapper for bfd_demangle.  */
 
 char *
@@ -1528,12 +1606,34 @@ gdb_demangle (const char *name, int options)
 
 #ifdef HAVE_WORKING_FORK
 #if defined (HAVE_SIGACTION) && defined (SA_RESTART)
-  struct sigaction sa, old_sa;
+  struct sigaction old_sa;
 #else
   sighandler_t ofunc;
 #endif
+  SIGJMP_BUF jmp;
   static int core_dump_allowed = -1;
 
+  /* Worker threads can only recover from crashes under
+     parallel_for_demangling, which has installed the signal handler
+     for them.  They leave the reporting to the main thread.  */
+  if (in_worker_thread)
+    {
+      if (!gdb_demangle_workers_protected)
+	return bfd_demangle (NULL, name, options);
+
+      gdb_demangle_jmp_buf = &jmp;
+      if (SIGSETJMP (jmp) == 0)
+	result = bfd_demangle (NULL, name, options);
+      else
+	{
+	  ++worker_demangler_crashes;
+	  result = NULL;
+	}
+      gdb_demangle_jmp_buf = NULL;
+
+      return result;
+    }
+
   if (core_dump_allowed == -1)
     {
       core_dump_allowed = can_dump_core (LIMIT_CUR);
@@ -1545,19 +1645,13 @@ gdb_demangle (const char *name, int options)
   if (catch_demangler_crashes)
     {
 #if defined (HAVE_SIGACTION) && defined (SA_RESTART)
-      sa.sa_handler = gdb_demangle_signal_handler;
-      sigemptyset (&sa.sa_mask);
-#ifdef HAVE_SIGALTSTACK
-      sa.sa_flags = SA_ONSTACK;
-#else
-      sa.sa_flags = 0;
-#endif
-      sigaction (SIGSEGV, &sa, &old_sa);
+      install_demangle_signal_handler (&old_sa);
 #else
       ofunc = signal (SIGSEGV, gdb_demangle_signal_handler);
 #endif
 
-      crash_signal = SIGSETJMP (gdb_demangle_jmp_buf);
+      gdb_demangle_jmp_buf = &jmp;
+      crash_signal = SIGSETJMP (jmp);
     }
 #endif
 
@@ -1567,6 +1661,7 @@ gdb_demangle (const char *name, int options)
 #ifdef HAVE_WORKING_FORK
   if (catch_demangler_crashes)
     {
+      gdb_demangle_jmp_buf = NULL;
 #if defined (HAVE_SIGACTION) && defined (SA_RESTART)
       sigaction (SIGSEGV, &old_sa, NULL);
 #else
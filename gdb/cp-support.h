@@ -158,6 +158,20 @@ extern struct cmd_list_element *maint_cplus_cmd_list;
 
 char *gdb_demangle (const char *name, int options);
 
+/* Like parallel_for, but if gdb_demangle is called by FN and the
+   demangler crashes in a worker thread, gdb_demangle returns NULL
+   and increments worker_demangler_crashes.  The main thread should
+   then demangle the name again, to report the crash.  */
+
+extern void parallel_for_demangling (unsigned int n,
+				     void (*fn) (unsigned int i, void *data),
+				     void *data);
+
+/* The number of times the demangler has crashed in this thread while
+   it was a worker of parallel_for_demangling.  */
+
+extern thread_local unsigned int worker_demangler_crashes;
+
 /* Like gdb_demangle, but suitable for use as la_sniff_from_mangled_name.  */
 
 int gdb_sniff_from_mangled_name (const char *mangled, char **demangled);
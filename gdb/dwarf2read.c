@@ -69,6 +69,8 @@
 #include "filestuff.h"
 #include "build-id.h"
 #include "namespace.h"
+#include "parallel-for.h"
+#include "index-cache.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -198,6 +200,11 @@ struct mapped_index
 
   /* A pointer to the constant pool.  */
   const char *constant_pool;
+
+  /* The used slots of SYMBOL_TABLE, sorted by name, or NULL if they
+     have not been needed yet.  See dw2_get_sorted_slots.  */
+  offset_type *sorted_slots;
+  offset_type n_sorted_slots;
 };
 
 typedef struct dwarf2_per_cu_data *dwarf2_per_cu_ptr;
@@ -229,6 +236,8 @@ struct dwarf2_per_objfile
   struct dwarf2_section_info frame;
   struct dwarf2_section_info eh_frame;
   struct dwarf2_section_info gdb_index;
+  struct dwarf2_section_info debug_names;
+  struct dwarf2_section_info aranges;
 
   VEC (dwarf2_section_info_def) *types;
 
@@ -294,6 +303,10 @@ struct dwarf2_per_objfile
   /* The mapped index, or NULL if .gdb_index is missing or not being used.  */
   struct mapped_index *index_table;
 
+  /* If index_table was not read from the .gdb_index section, but from
+     the index cache or converted from .debug_names, its contents.  */
+  gdb_byte *index_contents;
+
   /* When using index_table, this keeps track of all quick_file_names entries.
      TUs typically share line table entries with a CU, so we maintain a
      separate table of all line table entries to support the sharing.
@@ -341,6 +354,8 @@ static const struct dwarf2_debug_sections dwarf2_elf_names =
   { ".debug_frame", ".zdebug_frame" },
   { ".eh_frame", NULL },
   { ".gdb_index", ".zgdb_index" },
+  { ".debug_names", ".zdebug_names" },
+  { ".debug_aranges", ".zdebug_aranges" },
   23
 };
 
@@ -555,6 +570,29 @@ struct dwarf2_cu
      this information, but later versions do.  */
 
   unsigned int processing_has_namespace_info : 1;
+
+  /* Set while a worker thread reads the partial DIEs of this CU, see
+     preload_partial_comp_unit.  C++ names of partial DIEs are then
+     left as they are, and the partial symbols load_partial_dies
+     would add are queued on QUEUED_PSYMBOLS; both are dealt with on
+     the main thread.  */
+
+  unsigned int preloading : 1;
+  struct queued_psymbol *queued_psymbols;
+  struct queued_psymbol **queued_psymbols_tail;
+};
+
+/* A partial symbol queued by load_partial_dies for a CU that is being
+   preloaded.  */
+
+struct queued_psymbol
+{
+  struct queued_psymbol *next;
+
+  /* The tag and the uncanonicalized name of the DIE.  */
+
+  enum dwarf_tag tag;
+  const char *name;
 };
 
 /* Persistent data held for a compilation unit, even when not
@@ -1407,6 +1445,10 @@ static struct partial_symtab *create_partial_symtab
 
 static void dwarf2_build_psymtabs_hard (struct objfile *);
 
+static void dwarf2_store_index_in_cache (struct objfile *);
+
+static gdb_byte *debug_names_to_index (struct objfile *, ULONGEST *);
+
 static void scan_partial_symbols (struct partial_die_info *,
 				  CORE_ADDR *, CORE_ADDR *,
 				  int, struct dwarf2_cu *);
@@ -1454,6 +1496,12 @@ static unsigned int peek_abbrev_code (bfd *, const gdb_byte *);
 static struct partial_die_info *load_partial_dies
   (const struct die_reader_specs *, const gdb_byte *, int);
 
+static const char *partial_die_name (enum dwarf_tag, const char *,
+				     struct dwarf2_cu *);
+
+static void add_simple_partial_symbol (enum dwarf_tag, const char *,
+				       struct dwarf2_cu *);
+
 static const gdb_byte *read_partial_die (const struct die_reader_specs *,
 					 struct partial_die_info *,
 					 struct abbrev_info *,
@@ -1832,6 +1880,12 @@ static int create_all_type_units (struct objfile *);
 static void load_full_comp_unit (struct dwarf2_per_cu_data *,
 				 enum language);
 
+static struct dwarf2_cu *preload_full_comp_unit (struct dwarf2_per_cu_data *);
+
+static void free_detached_comp_unit (struct dwarf2_cu *);
+
+static int dwarf2_can_use_worker_threads (struct objfile *);
+
 static void process_full_comp_unit (struct dwarf2_per_cu_data *,
 				    enum language);
 
@@ -2274,6 +2328,16 @@ dwarf2_locate_sections (bfd *abfd, asection *sectp, void *vnames)
       dwarf2_per_objfile->gdb_index.s.section = sectp;
       dwarf2_per_objfile->gdb_index.size = bfd_get_section_size (sectp);
     }
+  else if (section_is_p (sectp->name, &names->debug_names))
+    {
+      dwarf2_per_objfile->debug_names.s.section = sectp;
+      dwarf2_per_objfile->debug_names.size = bfd_get_section_size (sectp);
+    }
+  else if (section_is_p (sectp->name, &names->aranges))
+    {
+      dwarf2_per_objfile->aranges.s.section = sectp;
+      dwarf2_per_objfile->aranges.size = bfd_get_section_size (sectp);
+    }
 
   if ((bfd_get_section_flags (abfd, sectp) & (SEC_LOAD | SEC_ALLOC))
       && bfd_section_vma (abfd, sectp) == 0)
@@ -2491,6 +2555,10 @@ dwarf2_get_dwz_file (void)
   if (dwarf2_per_objfile->dwz_file != NULL)
     return dwarf2_per_objfile->dwz_file;
 
+  /* Worker threads can't open files.  */
+  if (in_worker_thread)
+    error (_("Dwarf Error: the dwz file is not available to worker threads"));
+
   bfd_set_error (bfd_error_no_error);
   data = bfd_get_alt_debug_link_info (dwarf2_per_objfile->objfile->obfd,
 				      &buildid_len_arg, &buildid);
@@ -2760,6 +2828,143 @@ dw2_instantiate_symtab (struct dwarf2_per_cu_data *per_cu)
   return per_cu->v.quick->compunit_symtab;
 }
 
+/* The CUs of one batch preloaded by dw2_instantiate_symtabs.  */
+
+struct full_preload_batch
+{
+  /* The CUs of the batch, and the DIEs preloaded for each of them,
+     or NULL.  */
+
+  unsigned int n_units;
+  struct dwarf2_per_cu_data **per_cus;
+  struct dwarf2_cu **cus;
+};
+
+/* parallel_for callback for dw2_instantiate_symtabs.  */
+
+static void
+preload_full_batch_unit (unsigned int i, void *data)
+{
+  struct full_preload_batch *batch = (struct full_preload_batch *) data;
+
+  batch->cus[i] = preload_full_comp_unit (batch->per_cus[i]);
+}
+
+/* Free the preloaded CUs of the batch DATA that were not used.  */
+
+static void
+free_full_preload_batch (void *data)
+{
+  struct full_preload_batch *batch = (struct full_preload_batch *) data;
+  unsigned int i;
+
+  if (batch->cus == NULL)
+    return;
+  for (i = 0; i < batch->n_units; ++i)
+    if (batch->cus[i] != NULL)
+      free_detached_comp_unit (batch->cus[i]);
+  xfree (batch->cus);
+  batch->cus = NULL;
+}
+
+/* The amount of .debug_info, in bytes, whose DIEs
+   dw2_instantiate_symtabs preloads at a time.  Full DIEs take much
+   more memory than partial ones, so this is smaller than
+   PRELOAD_BATCH_SIZE.  */
+
+#define FULL_PRELOAD_BATCH_SIZE (4 * 1024 * 1024)
+
+/* Ensure that the symbols of each CU in PER_CUS, which belong to
+   OBJFILE, have been read in, in order.  For each symtab that is
+   expanded, call EXPANSION_NOTIFY, if not NULL, with DATA.
+
+   The DIEs of the CUs are read by worker threads, in batches, and
+   each batch is then expanded in order on the main thread, so the
+   result is the same as calling dw2_instantiate_symtab for each CU.  */
+
+static void
+dw2_instantiate_symtabs (struct objfile *objfile,
+			 VEC (dwarf2_per_cu_ptr) *per_cus,
+			 expand_symtabs_exp_notify_ftype *expansion_notify,
+			 void *data)
+{
+  unsigned int n = VEC_length (dwarf2_per_cu_ptr, per_cus);
+  struct full_preload_batch batch;
+  struct cleanup *cleanup;
+  unsigned int start, i;
+  int preload;
+
+  preload = n > 1 && dwarf2_can_use_worker_threads (objfile);
+  if (preload)
+    {
+      /* Worker threads may only use sections that are already read.  */
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->info);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->addr);
+    }
+
+  batch.n_units = 0;
+  batch.cus = NULL;
+  cleanup = make_cleanup (free_full_preload_batch, &batch);
+
+  for (start = 0; start < n; start += batch.n_units)
+    {
+      batch.per_cus = VEC_address (dwarf2_per_cu_ptr, per_cus) + start;
+      if (preload)
+	{
+	  ULONGEST size = 0;
+
+	  batch.n_units = 0;
+	  while (start + batch.n_units < n
+		 && size < FULL_PRELOAD_BATCH_SIZE)
+	    size += batch.per_cus[batch.n_units++]->length;
+
+	  batch.cus = XCNEWVEC (struct dwarf2_cu *, batch.n_units);
+	  parallel_for (batch.n_units, preload_full_batch_unit, &batch);
+	}
+      else
+	batch.n_units = n - start;
+
+      for (i = 0; i < batch.n_units; ++i)
+	{
+	  struct dwarf2_per_cu_data *per_cu = batch.per_cus[i];
+	  int symtab_was_null = per_cu->v.quick->compunit_symtab == NULL;
+
+	  QUIT;
+
+	  if (batch.cus != NULL && batch.cus[i] != NULL)
+	    {
+	      struct dwarf2_cu *cu = batch.cus[i];
+
+	      batch.cus[i] = NULL;
+
+	      /* Expanding an earlier CU may have expanded this one.  */
+	      if (!symtab_was_null || per_cu->cu != NULL)
+		free_detached_comp_unit (cu);
+	      else
+		{
+		  /* Attach the CU the way load_full_comp_unit would.  */
+		  per_cu->cu = cu;
+		  cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
+		  dwarf2_per_objfile->read_in_chain = per_cu;
+		}
+	    }
+
+	  dw2_instantiate_symtab (per_cu);
+
+	  if (expansion_notify != NULL
+	      && symtab_was_null
+	      && per_cu->v.quick->compunit_symtab != NULL)
+	    expansion_notify (per_cu->v.quick->compunit_symtab, data);
+	}
+
+      free_full_preload_batch (&batch);
+    }
+
+  do_cleanups (cleanup);
+}
+
 /* Return the CU/TU given its index.
 
    This is intended for loops like:
@@ -3063,44 +3268,37 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
     }
 }
 
-/* A helper function that reads the .gdb_index from SECTION and fills
-   in MAP.  FILENAME is the name of the file containing the section;
-   it is used for error reporting.  DEPRECATED_OK is nonzero if it is
-   ok to use deprecated sections.
+/* A helper function that reads a .gdb_index from the SIZE bytes at
+   ADDR and fills in MAP.  FILENAME is the name of the file containing
+   the index; it is used for error reporting.  DEPRECATED_OK is
+   nonzero if it is ok to use deprecated indices.
 
    CU_LIST, CU_LIST_ELEMENTS, TYPES_LIST, and TYPES_LIST_ELEMENTS are
    out parameters that are filled in with information about the CU and
-   TU lists in the section.
+   TU lists in the index.
 
    Returns 1 if all went well, 0 otherwise.  */
 
 static int
-read_index_from_section (struct objfile *objfile,
-			 const char *filename,
-			 int deprecated_ok,
-			 struct dwarf2_section_info *section,
-			 struct mapped_index *map,
-			 const gdb_byte **cu_list,
-			 offset_type *cu_list_elements,
-			 const gdb_byte **types_list,
-			 offset_type *types_list_elements)
+read_index_from_buffer (struct objfile *objfile,
+			const char *filename,
+			int deprecated_ok,
+			const gdb_byte *addr,
+			ULONGEST size,
+			struct mapped_index *map,
+			const gdb_byte **cu_list,
+			offset_type *cu_list_elements,
+			const gdb_byte **types_list,
+			offset_type *types_list_elements)
 {
-  const gdb_byte *addr;
   offset_type version;
   offset_type *metadata;
   int i;
 
-  if (dwarf2_section_empty_p (section))
-    return 0;
-
-  /* Older elfutils strip versions could keep the section in the main
-     executable while splitting it for the separate debug info file.  */
-  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+  /* The version and the offsets of the 5 parts of the index.  */
+  if (size < 6 * sizeof (offset_type))
     return 0;
 
-  dwarf2_read_section (objfile, section);
-
-  addr = section->buffer;
   /* Version check.  */
   version = MAYBE_SWAP (*(offset_type *) addr);
   /* Versions earlier than 3 emitted every copy of a psymbol.  This
@@ -3153,11 +3351,17 @@ to use the section anyway."),
   if (version > 8)
     return 0;
 
-  map->version = version;
-  map->total_size = section->size;
-
   metadata = (offset_type *) (addr + sizeof (offset_type));
 
+  /* The parts of the index must be in order and within it.  */
+  for (i = 0; i < 5; ++i)
+    if (MAYBE_SWAP (metadata[i]) > size
+	|| (i > 0 && MAYBE_SWAP (metadata[i]) < MAYBE_SWAP (metadata[i - 1])))
+      return 0;
+
+  map->version = version;
+  map->total_size = size;
+
   i = 0;
   *cu_list = addr + MAYBE_SWAP (metadata[i]);
   *cu_list_elements = ((MAYBE_SWAP (metadata[i + 1]) - MAYBE_SWAP (metadata[i]))
@@ -3186,6 +3390,110 @@ to use the section anyway."),
   return 1;
 }
 
+/* A helper function that reads the .gdb_index from SECTION and fills
+   in MAP, using read_index_from_buffer.  */
+
+static int
+read_index_from_section (struct objfile *objfile,
+			 const char *filename,
+			 int deprecated_ok,
+			 struct dwarf2_section_info *section,
+			 struct mapped_index *map,
+			 const gdb_byte **cu_list,
+			 offset_type *cu_list_elements,
+			 const gdb_byte **types_list,
+			 offset_type *types_list_elements)
+{
+  if (dwarf2_section_empty_p (section))
+    return 0;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return 0;
+
+  dwarf2_read_section (objfile, section);
+
+  return read_index_from_buffer (objfile, filename, deprecated_ok,
+				 section->buffer, section->size, map,
+				 cu_list, cu_list_elements,
+				 types_list, types_list_elements);
+}
+
+/* Convert the .debug_names section of OBJFILE to an index, and if that
+   works fill in MAP and the other out parameters as
+   read_index_from_section does.  Returns 1 if it did, 0 otherwise.  */
+
+static int
+read_index_from_debug_names (struct objfile *objfile,
+			     struct mapped_index *map,
+			     const gdb_byte **cu_list,
+			     offset_type *cu_list_elements,
+			     const gdb_byte **types_list,
+			     offset_type *types_list_elements)
+{
+  gdb_byte *contents;
+  ULONGEST size;
+
+  contents = debug_names_to_index (objfile, &size);
+  if (contents == NULL)
+    return 0;
+
+  if (!read_index_from_buffer (objfile, objfile_name (objfile), 1,
+			       contents, size, map,
+			       cu_list, cu_list_elements,
+			       types_list, types_list_elements))
+    {
+      xfree (contents);
+      return 0;
+    }
+
+  dwarf2_per_objfile->index_contents = contents;
+  return 1;
+}
+
+/* Look up an index for OBJFILE in the index cache, and if there is a
+   usable one fill in MAP and the other out parameters as
+   read_index_from_section does.  Returns 1 if it found one, 0
+   otherwise.  */
+
+static int
+read_index_from_cache (struct objfile *objfile,
+		       struct mapped_index *map,
+		       const gdb_byte **cu_list,
+		       offset_type *cu_list_elements,
+		       const gdb_byte **types_list,
+		       offset_type *types_list_elements)
+{
+  const struct bfd_build_id *build_id;
+  gdb_byte *contents;
+  ULONGEST size;
+
+  if (!index_cache_enabled_p ())
+    return 0;
+
+  build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id == NULL)
+    return 0;
+
+  contents = index_cache_lookup (build_id, &size);
+  if (contents == NULL)
+    return 0;
+
+  if (!read_index_from_buffer (objfile, objfile_name (objfile),
+			       use_deprecated_index_sections,
+			       contents, size, map,
+			       cu_list, cu_list_elements,
+			       types_list, types_list_elements))
+    {
+      xfree (contents);
+      return 0;
+    }
+
+  dwarf2_per_objfile->index_contents = contents;
+  return 1;
+}
+
 
 /* Read the index file.  If everything went ok, initialize the "quick"
    elements of all the CUs and return 1.  Otherwise, return 0.  */
@@ -3202,7 +3510,13 @@ dwarf2_read_index (struct objfile *objfile)
 				use_deprecated_index_sections,
 				&dwarf2_per_objfile->gdb_index, &local_map,
 				&cu_list, &cu_list_elements,
-				&types_list, &types_list_elements))
+				&types_list, &types_list_elements)
+      && !read_index_from_debug_names (objfile, &local_map,
+				       &cu_list, &cu_list_elements,
+				       &types_list, &types_list_elements)
+      && !read_index_from_cache (objfile, &local_map,
+				 &cu_list, &cu_list_elements,
+				 &types_list, &types_list_elements))
     return 0;
 
   /* Don't use the index if it's empty.  */
@@ -3254,6 +3568,8 @@ dwarf2_read_index (struct objfile *objfile)
 
   map = XOBNEW (&objfile->objfile_obstack, struct mapped_index);
   *map = local_map;
+  map->sorted_slots = NULL;
+  map->n_sorted_slots = 0;
 
   dwarf2_per_objfile->index_table = map;
   dwarf2_per_objfile->using_index = 1;
@@ -3875,18 +4191,125 @@ dw2_map_matching_symbols (struct objfile *objfile,
      does not look for non-Ada symbols this function should just return.  */
 }
 
+/* Compare the names of two slots of a mapped_index, for std::sort.  */
+
+struct mapped_index_slot_less
+{
+  explicit mapped_index_slot_less (const struct mapped_index *index)
+    : m_index (index)
+  {
+  }
+
+  bool operator() (offset_type a, offset_type b) const
+  {
+    return strcmp (slot_name (a), slot_name (b)) < 0;
+  }
+
+  const char *slot_name (offset_type slot) const
+  {
+    return (m_index->constant_pool
+	    + MAYBE_SWAP (m_index->symbol_table[2 * slot]));
+  }
+
+  const struct mapped_index *m_index;
+};
+
+/* Return the used slots of INDEX, sorted by name, computing them
+   the first time.  Store their number in *N_SLOTS.  */
+
+static const offset_type *
+dw2_get_sorted_slots (struct objfile *objfile, struct mapped_index *index,
+		      offset_type *n_slots)
+{
+  if (index->sorted_slots == NULL)
+    {
+      offset_type iter, n = 0;
+
+      for (iter = 0; iter < index->symbol_table_slots; ++iter)
+	if (index->symbol_table[2 * iter] != 0
+	    || index->symbol_table[2 * iter + 1] != 0)
+	  ++n;
+
+      index->sorted_slots = XOBNEWVEC (&objfile->objfile_obstack,
+				       offset_type, n);
+      n = 0;
+      for (iter = 0; iter < index->symbol_table_slots; ++iter)
+	if (index->symbol_table[2 * iter] != 0
+	    || index->symbol_table[2 * iter + 1] != 0)
+	  index->sorted_slots[n++] = iter;
+
+      std::sort (index->sorted_slots, index->sorted_slots + n,
+		 mapped_index_slot_less (index));
+      index->n_sorted_slots = n;
+    }
+
+  *n_slots = index->n_sorted_slots;
+  return index->sorted_slots;
+}
+
+/* Set *FIRST and *LAST to the range of SLOTS, the N_SLOTS slots of
+   INDEX sorted by dw2_get_sorted_slots, whose names begin with the
+   first PREFIX_LEN characters of PREFIX.  */
+
 static void
-dw2_expand_symtabs_matching
+dw2_find_prefix_range (const struct mapped_index *index,
+		       const offset_type *slots, offset_type n_slots,
+		       const char *prefix, size_t prefix_len,
+		       offset_type *first, offset_type *last)
+{
+  mapped_index_slot_less less (index);
+  offset_type lo, hi;
+
+  /* Find the first name that is not less than the prefix.  */
+  lo = 0;
+  hi = n_slots;
+  while (lo < hi)
+    {
+      offset_type mid = lo + (hi - lo) / 2;
+
+      if (strncmp (less.slot_name (slots[mid]), prefix, prefix_len) < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  *first = lo;
+
+  /* The names that begin with the prefix follow it.  */
+  hi = n_slots;
+  while (lo < hi)
+    {
+      offset_type mid = lo + (hi - lo) / 2;
+
+      if (strncmp (less.slot_name (slots[mid]), prefix, prefix_len) == 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  *last = lo;
+}
+
+/* Worker for dw2_expand_symtabs_matching and
+   dw2_expand_symtabs_with_prefix.  If PREFIX is not NULL, only the
+   names that begin with its first PREFIX_LEN characters are passed to
+   SYMBOL_MATCHER.  */
+
+static void
+dw2_expand_symtabs_matching_1
   (struct objfile *objfile,
    expand_symtabs_file_matcher_ftype *file_matcher,
+   const char *prefix, size_t prefix_len,
    expand_symtabs_symbol_matcher_ftype *symbol_matcher,
    expand_symtabs_exp_notify_ftype *expansion_notify,
    enum search_domain kind,
    void *data)
 {
   int i;
-  offset_type iter;
+  offset_type iter, sorted_iter, first, last, n_slots;
+  const offset_type *sorted_slots;
   struct mapped_index *index;
+  VEC (dwarf2_per_cu_ptr) *matched = NULL;
+  char *seen;
+  struct cleanup *back_to;
 
   dw2_setup (objfile);
 
@@ -3895,6 +4318,13 @@ dw2_expand_symtabs_matching
     return;
   index = dwarf2_per_objfile->index_table;
 
+  /* The matching CUs are collected first and then expanded together,
+     so that reading their DIEs can be spread over threads.  */
+  seen = XCNEWVEC (char, (dwarf2_per_objfile->n_comp_units
+			  + dwarf2_per_objfile->n_type_units));
+  back_to = make_cleanup (xfree, seen);
+  make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &matched);
+
   if (file_matcher != NULL)
     {
       struct cleanup *cleanup;
@@ -3974,15 +4404,34 @@ dw2_expand_symtabs_matching
       do_cleanups (cleanup);
     }
 
-  for (iter = 0; iter < index->symbol_table_slots; ++iter)
+  /* With a prefix, only look at the names that begin with it.  They
+     can be found in the sorted slots, unless names are compared
+     ignoring case.  */
+  if (prefix != NULL && case_sensitivity == case_sensitive_on)
+    {
+      sorted_slots = dw2_get_sorted_slots (objfile, index, &n_slots);
+      dw2_find_prefix_range (index, sorted_slots, n_slots,
+			     prefix, prefix_len, &first, &last);
+    }
+  else
+    {
+      sorted_slots = NULL;
+      first = 0;
+      last = index->symbol_table_slots;
+    }
+
+  for (sorted_iter = first; sorted_iter < last; ++sorted_iter)
     {
-      offset_type idx = 2 * iter;
+      offset_type idx;
       const char *name;
       offset_type *vec, vec_len, vec_idx;
       int global_seen = 0;
 
       QUIT;
 
+      iter = sorted_slots != NULL ? sorted_slots[sorted_iter] : sorted_iter;
+      idx = 2 * iter;
+
       if (index->symbol_table[idx] == 0 && index->symbol_table[idx + 1] == 0)
 	continue;
 
@@ -4055,23 +4504,46 @@ dw2_expand_symtabs_matching
 	    }
 
 	  per_cu = dw2_get_cutu (cu_index);
-	  if (file_matcher == NULL || per_cu->v.quick->mark)
+	  if ((file_matcher == NULL || per_cu->v.quick->mark)
+	      && !seen[cu_index])
 	    {
-	      int symtab_was_null =
-		(per_cu->v.quick->compunit_symtab == NULL);
-
-	      dw2_instantiate_symtab (per_cu);
-
-	      if (expansion_notify != NULL
-		  && symtab_was_null
-		  && per_cu->v.quick->compunit_symtab != NULL)
-		{
-		  expansion_notify (per_cu->v.quick->compunit_symtab,
-				    data);
-		}
+	      seen[cu_index] = 1;
+	      VEC_safe_push (dwarf2_per_cu_ptr, matched, per_cu);
 	    }
 	}
     }
+
+  dw2_instantiate_symtabs (objfile, matched, expansion_notify, data);
+
+  do_cleanups (back_to);
+}
+
+static void
+dw2_expand_symtabs_matching
+  (struct objfile *objfile,
+   expand_symtabs_file_matcher_ftype *file_matcher,
+   expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+   expand_symtabs_exp_notify_ftype *expansion_notify,
+   enum search_domain kind,
+   void *data)
+{
+  dw2_expand_symtabs_matching_1 (objfile, file_matcher, NULL, 0,
+				 symbol_matcher, expansion_notify, kind,
+				 data);
+}
+
+static void
+dw2_expand_symtabs_with_prefix
+  (struct objfile *objfile,
+   const char *prefix, size_t prefix_len,
+   expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+   expand_symtabs_exp_notify_ftype *expansion_notify,
+   enum search_domain kind,
+   void *data)
+{
+  dw2_expand_symtabs_matching_1 (objfile, NULL, prefix, prefix_len,
+				 symbol_matcher, expansion_notify, kind,
+				 data);
 }
 
 /* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
@@ -4222,7 +4694,8 @@ const struct quick_symbol_functions dwarf2_gdb_index_functions =
   dw2_map_matching_symbols,
   dw2_expand_symtabs_matching,
   dw2_find_pc_sect_compunit_symtab,
-  dw2_map_symbol_filenames
+  dw2_map_symbol_filenames,
+  dw2_expand_symtabs_with_prefix
 };
 
 /* Initialize for reading DWARF for this objfile.  Return 0 if this
@@ -4288,6 +4761,8 @@ dwarf2_build_psymtabs (struct objfile *objfile)
 
       dwarf2_build_psymtabs_hard (objfile);
       discard_cleanups (cleanups);
+
+      dwarf2_store_index_in_cache (objfile);
     }
   CATCH (except, RETURN_MASK_ERROR)
     {
@@ -5950,8 +6425,43 @@ struct process_psymtab_comp_unit_data
      language.  */
 
   enum language pretend_language;
+
+  /* If not NULL, the partial DIEs of the CU as read by
+     preload_partial_comp_unit.  */
+
+  struct preloaded_comp_unit *preloaded;
+};
+
+/* A compilation unit whose partial DIEs were read by a worker thread,
+   see preload_partial_comp_unit.  */
+
+struct preloaded_comp_unit
+{
+  /* The CU, or NULL if it was not preloaded or has been used.  It is
+     not attached to its dwarf2_per_cu_data until it is used.  */
+
+  struct dwarf2_cu *cu;
+
+  /* The value of the per-CU LOAD_ALL_DIES flag the DIEs were read
+     with.  */
+
+  int load_all_dies;
+
+  /* What init_cutu_and_read_dies would pass to
+     process_psymtab_comp_unit_reader.  */
+
+  struct die_info *comp_unit_die;
+  const gdb_byte *info_ptr;
+  int has_children;
+
+  /* What load_partial_dies returned.  */
+
+  struct partial_die_info *first_die;
 };
 
+static struct partial_die_info *finish_preloaded_partial_dies
+  (struct dwarf2_cu *, struct preloaded_comp_unit *);
+
 /* die_reader_func for process_psymtab_comp_unit.  */
 
 static void
@@ -6021,7 +6531,10 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
       lowpc = ((CORE_ADDR) -1);
       highpc = ((CORE_ADDR) 0);
 
-      first_die = load_partial_dies (reader, info_ptr, 1);
+      if (info->preloaded != NULL)
+	first_die = finish_preloaded_partial_dies (cu, info->preloaded);
+      else
+	first_die = load_partial_dies (reader, info_ptr, 1);
 
       scan_partial_symbols (first_die, &lowpc, &highpc,
 			    cu_bounds_kind <= PC_BOUNDS_INVALID, cu);
@@ -6104,6 +6617,7 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   gdb_assert (! this_cu->is_debug_types);
   info.want_partial_unit = want_partial_unit;
   info.pretend_language = pretend_language;
+  info.preloaded = NULL;
   init_cutu_and_read_dies (this_cu, NULL, 0, 0,
 			   process_psymtab_comp_unit_reader,
 			   &info);
@@ -6112,6 +6626,285 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   age_cached_comp_units ();
 }
 
+/* Free the CU of PRE, if it still has one.  */
+
+static void
+free_preloaded_comp_unit (struct preloaded_comp_unit *pre)
+{
+  if (pre->cu == NULL)
+    return;
+
+  free_detached_comp_unit (pre->cu);
+  pre->cu = NULL;
+}
+
+/* Read the top-level DIE and the partial DIEs of compilation unit
+   THIS_CU into PRE, the way process_psymtab_comp_unit would for
+   dwarf2_build_psymtabs_hard.  This runs in a worker thread, so it
+   only reads sections that are already in memory and fills in a new
+   dwarf2_cu of its own.  If the CU needs anything more, such as a DWO
+   file, or if reading it causes a complaint or an error, PRE->CU is
+   left NULL, and the main thread processes the CU as usual.  */
+
+static void
+preload_partial_comp_unit (struct dwarf2_per_cu_data *this_cu,
+			   struct preloaded_comp_unit *pre)
+{
+  struct dwarf2_section_info *section = this_cu->section;
+  struct dwarf2_cu *cu;
+  struct die_reader_specs reader;
+  const gdb_byte *begin_info_ptr, *info_ptr;
+  int ok = 0;
+
+  pre->cu = NULL;
+  if (this_cu->is_dwz)
+    return;
+
+  cu = XNEW (struct dwarf2_cu);
+  memset (cu, 0, sizeof (*cu));
+  cu->per_cu = this_cu;
+  cu->objfile = this_cu->objfile;
+  obstack_init (&cu->comp_unit_obstack);
+  cu->queued_psymbols_tail = &cu->queued_psymbols;
+  pre->cu = cu;
+  pre->load_all_dies = this_cu->load_all_dies;
+  pre->first_die = NULL;
+
+  worker_complaint_count = 0;
+  try
+    {
+      begin_info_ptr = info_ptr = section->buffer + this_cu->offset.sect_off;
+      info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+						get_abbrev_section_for_cu (this_cu),
+						info_ptr, 0);
+
+      /* Leave dummy compilation units to the main thread.  */
+      if (info_ptr < begin_info_ptr + this_cu->length
+	  && peek_abbrev_code (get_section_bfd_owner (section), info_ptr) != 0)
+	{
+	  dwarf2_read_abbrevs (cu, get_abbrev_section_for_cu (this_cu));
+	  init_cu_die_reader (&reader, cu, section, NULL);
+	  info_ptr = read_full_die (&reader, &pre->comp_unit_die, info_ptr,
+				    &pre->has_children);
+	  pre->info_ptr = info_ptr;
+
+	  if (pre->comp_unit_die->tag == DW_TAG_compile_unit
+	      && dwarf2_attr (pre->comp_unit_die, DW_AT_GNU_dwo_name,
+			      cu) == NULL)
+	    {
+	      prepare_one_comp_unit (cu, pre->comp_unit_die,
+				     language_minimal);
+	      cu->preloading = 1;
+	      if (pre->has_children)
+		pre->first_die = load_partial_dies (&reader, info_ptr, 1);
+	      ok = worker_complaint_count == 0;
+	    }
+	}
+    }
+  catch (const gdb_exception &ex)
+    {
+      xfree (const_cast<char *> (ex.message));
+    }
+
+  if (!ok)
+    free_preloaded_comp_unit (pre);
+}
+
+/* Process compilation unit THIS_CU for a psymtab, like
+   process_psymtab_comp_unit, using the partial DIEs in PRE.  */
+
+static void
+process_preloaded_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
+				     struct preloaded_comp_unit *pre)
+{
+  struct dwarf2_cu *cu = pre->cu;
+  struct process_psymtab_comp_unit_data info;
+  struct die_reader_specs reader;
+  struct cleanup *free_cu_cleanup;
+
+  /* Reading another CU may have found that this one needs all of its
+     DIEs loaded.  */
+  if (this_cu->load_all_dies != pre->load_all_dies)
+    {
+      free_preloaded_comp_unit (pre);
+      process_psymtab_comp_unit (this_cu, 0, language_minimal);
+      return;
+    }
+
+  /* See process_psymtab_comp_unit.  */
+  if (this_cu->cu != NULL)
+    free_one_cached_comp_unit (this_cu);
+
+  pre->cu = NULL;
+  this_cu->cu = cu;
+  cu->preloading = 0;
+  free_cu_cleanup = make_cleanup (free_heap_comp_unit, cu);
+  make_cleanup (dwarf2_free_abbrev_table, cu);
+
+  init_cu_die_reader (&reader, cu, this_cu->section, NULL);
+  info.want_partial_unit = 0;
+  info.pretend_language = language_minimal;
+  info.preloaded = pre;
+  process_psymtab_comp_unit_reader (&reader, pre->info_ptr,
+				    pre->comp_unit_die, pre->has_children,
+				    &info);
+
+  do_cleanups (free_cu_cleanup);
+
+  /* Age out any secondary CUs.  */
+  age_cached_comp_units ();
+}
+
+/* Canonicalize the names of PDI, its siblings and their children,
+   which were left alone by preload_partial_comp_unit.  */
+
+static void
+canonicalize_partial_die_names (struct partial_die_info *pdi,
+				struct dwarf2_cu *cu)
+{
+  for (; pdi != NULL; pdi = pdi->die_sibling)
+    {
+      if (pdi->name != NULL)
+	pdi->name = partial_die_name (pdi->tag, pdi->name, cu);
+      canonicalize_partial_die_names (pdi->die_child, cu);
+    }
+}
+
+/* Do the work that preload_partial_comp_unit left to the main thread
+   for CU, and return the first of the partial DIEs in PRE.  */
+
+static struct partial_die_info *
+finish_preloaded_partial_dies (struct dwarf2_cu *cu,
+			       struct preloaded_comp_unit *pre)
+{
+  struct queued_psymbol *queued;
+
+  if (cu->language == language_cplus)
+    canonicalize_partial_die_names (pre->first_die, cu);
+
+  for (queued = cu->queued_psymbols; queued != NULL; queued = queued->next)
+    add_simple_partial_symbol (queued->tag,
+			       partial_die_name (queued->tag, queued->name,
+						 cu),
+			       cu);
+  cu->queued_psymbols = NULL;
+
+  return pre->first_die;
+}
+
+/* The CUs of one batch preloaded by
+   process_psymtab_comp_units_in_parallel.  */
+
+struct preload_batch
+{
+  /* The index of the first CU of the batch.  */
+
+  int start;
+
+  /* The preloaded CUs.  */
+
+  int n_units;
+  struct preloaded_comp_unit *units;
+};
+
+/* parallel_for callback for process_psymtab_comp_units_in_parallel.  */
+
+static void
+preload_batch_unit (unsigned int i, void *data)
+{
+  struct preload_batch *batch = (struct preload_batch *) data;
+
+  preload_partial_comp_unit (dw2_get_cutu (batch->start + i),
+			     &batch->units[i]);
+}
+
+/* Free the CUs of the batch DATA that were not used.  */
+
+static void
+free_preload_batch (void *data)
+{
+  struct preload_batch *batch = (struct preload_batch *) data;
+  int i;
+
+  if (batch->units == NULL)
+    return;
+  for (i = 0; i < batch->n_units; ++i)
+    free_preloaded_comp_unit (&batch->units[i]);
+  xfree (batch->units);
+  batch->units = NULL;
+}
+
+/* Return non-zero if DIEs of OBJFILE may be read by worker threads.
+   The worker threads can't open the dwz file or print DIEs, so don't
+   bother if either could be needed.  */
+
+static int
+dwarf2_can_use_worker_threads (struct objfile *objfile)
+{
+  return (parallel_for_thread_count () > 1
+	  && !dwarf_die_debug
+	  && bfd_get_section_by_name (objfile->obfd,
+				      ".gnu_debugaltlink") == NULL);
+}
+
+/* The amount of .debug_info, in bytes, whose partial DIEs
+   process_psymtab_comp_units_in_parallel preloads at a time.  This
+   bounds the memory held by preloaded CUs.  */
+
+#define PRELOAD_BATCH_SIZE (16 * 1024 * 1024)
+
+/* Do what dwarf2_build_psymtabs_hard does for each CU of OBJFILE,
+   with the partial DIEs of the CUs read in parallel.  The CUs are
+   preloaded in batches by worker threads, and each batch is then
+   processed in order on the main thread, so the resulting psymtabs
+   are the same as if everything were done on the main thread.  */
+
+static void
+process_psymtab_comp_units_in_parallel (struct objfile *objfile)
+{
+  struct preload_batch batch;
+  struct cleanup *cleanup;
+  int i;
+
+  /* Worker threads may only use sections that are already read.  */
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->addr);
+
+  batch.units = NULL;
+  batch.n_units = 0;
+  cleanup = make_cleanup (free_preload_batch, &batch);
+
+  for (batch.start = 0;
+       batch.start < dwarf2_per_objfile->n_comp_units;
+       batch.start += batch.n_units)
+    {
+      ULONGEST size = 0;
+
+      batch.n_units = 0;
+      while (batch.start + batch.n_units < dwarf2_per_objfile->n_comp_units
+	     && size < PRELOAD_BATCH_SIZE)
+	size += dw2_get_cutu (batch.start + batch.n_units++)->length;
+
+      batch.units = XCNEWVEC (struct preloaded_comp_unit, batch.n_units);
+      parallel_for (batch.n_units, preload_batch_unit, &batch);
+
+      for (i = 0; i < batch.n_units; ++i)
+	{
+	  struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (batch.start + i);
+
+	  if (batch.units[i].cu != NULL)
+	    process_preloaded_psymtab_comp_unit (per_cu, &batch.units[i]);
+	  else
+	    process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	}
+
+      free_preload_batch (&batch);
+    }
+
+  do_cleanups (cleanup);
+}
+
 /* Reader function for build_type_psymtabs.  */
 
 static void
@@ -6495,11 +7288,18 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
   objfile->psymtabs_addrmap = addrmap_create_mutable (&temp_obstack);
   addrmap_cleanup = make_cleanup (psymtabs_addrmap_cleanup, objfile);
 
-  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+  /* Reading the partial DIEs of the CUs can be spread over threads.  */
+  if (dwarf2_per_objfile->n_comp_units > 1
+      && dwarf2_can_use_worker_threads (objfile))
+    process_psymtab_comp_units_in_parallel (objfile);
+  else
     {
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+      for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+	{
+	  struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
 
-      process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	  process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	}
     }
 
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
@@ -7756,10 +8556,95 @@ load_full_comp_unit (struct dwarf2_per_cu_data *this_cu,
 {
   gdb_assert (! this_cu->is_debug_types);
 
+  /* The DIEs may have been read by preload_full_comp_unit.  */
+  if (this_cu->cu != NULL && this_cu->cu->dies != NULL)
+    return;
+
   init_cutu_and_read_dies (this_cu, NULL, 1, 1,
 			   load_full_comp_unit_reader, &pretend_language);
 }
 
+/* Free CU, which is not attached to its dwarf2_per_cu_data, so
+   free_heap_comp_unit is not suitable.  */
+
+static void
+free_detached_comp_unit (struct dwarf2_cu *cu)
+{
+  dwarf2_free_abbrev_table (cu);
+  obstack_free (&cu->comp_unit_obstack, NULL);
+  xfree (cu);
+}
+
+/* Read the DIEs of compilation unit THIS_CU the way load_full_comp_unit
+   would, into a new dwarf2_cu that is not attached to THIS_CU, and
+   return it.  This runs in a worker thread, so it only reads sections
+   that are already in memory.  If the CU needs anything more, such as
+   a DWO file, or if reading it causes a complaint or an error, return
+   NULL; the main thread then reads the CU as usual.  */
+
+static struct dwarf2_cu *
+preload_full_comp_unit (struct dwarf2_per_cu_data *this_cu)
+{
+  struct dwarf2_section_info *section = this_cu->section;
+  struct dwarf2_section_info *abbrev_section;
+  struct dwarf2_cu *cu;
+  struct die_reader_specs reader;
+  struct die_info *comp_unit_die;
+  const gdb_byte *begin_info_ptr, *info_ptr;
+  enum language pretend_language = language_minimal;
+  int has_children;
+  int ok = 0;
+
+  if (this_cu->is_debug_types || this_cu->is_dwz || this_cu->cu != NULL)
+    return NULL;
+
+  cu = XNEW (struct dwarf2_cu);
+  memset (cu, 0, sizeof (*cu));
+  cu->per_cu = this_cu;
+  cu->objfile = this_cu->objfile;
+  obstack_init (&cu->comp_unit_obstack);
+
+  worker_complaint_count = 0;
+  try
+    {
+      abbrev_section = get_abbrev_section_for_cu (this_cu);
+      begin_info_ptr = info_ptr = section->buffer + this_cu->offset.sect_off;
+      info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+						abbrev_section, info_ptr, 0);
+
+      /* Leave dummy compilation units to the main thread.  */
+      if (info_ptr < begin_info_ptr + this_cu->length
+	  && peek_abbrev_code (get_section_bfd_owner (section), info_ptr) != 0)
+	{
+	  dwarf2_read_abbrevs (cu, abbrev_section);
+	  init_cu_die_reader (&reader, cu, section, NULL);
+	  info_ptr = read_full_die (&reader, &comp_unit_die, info_ptr,
+				    &has_children);
+
+	  if (dwarf2_attr (comp_unit_die, DW_AT_GNU_dwo_name, cu) == NULL)
+	    {
+	      load_full_comp_unit_reader (&reader, info_ptr, comp_unit_die,
+					  has_children, &pretend_language);
+	      ok = worker_complaint_count == 0;
+	    }
+	}
+    }
+  catch (const gdb_exception &ex)
+    {
+      xfree (const_cast<char *> (ex.message));
+    }
+
+  if (!ok)
+    {
+      free_detached_comp_unit (cu);
+      return NULL;
+    }
+
+  /* Like init_cutu_and_read_dies, don't keep the abbrevs.  */
+  dwarf2_free_abbrev_table (cu);
+  return cu;
+}
+
 /* Add a DIE to the delayed physname list.  */
 
 static void
@@ -15541,6 +16426,67 @@ is_type_tag_for_partial (int tag)
 
 /* Load all DIEs that are interesting for partial symbols into memory.  */
 
+/* Return the name to use for a partial DIE of CU with tag TAG and
+   DW_AT_name NAME.  */
+
+static const char *
+partial_die_name (enum dwarf_tag tag, const char *name,
+		  struct dwarf2_cu *cu)
+{
+  switch (tag)
+    {
+    case DW_TAG_compile_unit:
+    case DW_TAG_partial_unit:
+    case DW_TAG_type_unit:
+      /* Compilation units have a DW_AT_name that is a filename, not
+	 a source language identifier.  */
+    case DW_TAG_enumeration_type:
+    case DW_TAG_enumerator:
+      /* These tags always have simple identifiers already; no need
+	 to canonicalize them.  */
+      return name;
+    default:
+      return dwarf2_canonicalize_name (name, cu,
+				       &cu->objfile->per_bfd->storage_obstack);
+    }
+}
+
+/* Subroutine of load_partial_dies.  Add the partial symbol for a
+   simple top-level type, or for an enumerator, of CU, with tag TAG
+   and name NAME.  If CU is being preloaded, queue the symbol
+   instead.  */
+
+static void
+add_simple_partial_symbol (enum dwarf_tag tag, const char *name,
+			   struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+
+  if (cu->preloading)
+    {
+      struct queued_psymbol *queued
+	= XOBNEW (&cu->comp_unit_obstack, struct queued_psymbol);
+
+      queued->next = NULL;
+      queued->tag = tag;
+      queued->name = name;
+      *cu->queued_psymbols_tail = queued;
+      cu->queued_psymbols_tail = &queued->next;
+    }
+  else if (tag == DW_TAG_enumerator)
+    add_psymbol_to_list (name, strlen (name), 0,
+			 VAR_DOMAIN, LOC_CONST,
+			 cu->language == language_cplus
+			 ? &objfile->global_psymbols
+			 : &objfile->static_psymbols,
+			 0, cu->language, objfile);
+  else
+    add_psymbol_to_list (name, strlen (name), 0,
+			 VAR_DOMAIN, LOC_TYPEDEF,
+			 &objfile->static_psymbols,
+			 0, cu->language, objfile);
+}
+
 static struct partial_die_info *
 load_partial_dies (const struct die_reader_specs *reader,
 		   const gdb_byte *info_ptr, int building_psymtab)
@@ -15672,10 +16618,7 @@ load_partial_dies (const struct die_reader_specs *reader,
 	      || part_die->tag == DW_TAG_subrange_type))
 	{
 	  if (building_psymtab && part_die->name != NULL)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_TYPEDEF,
-				 &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    add_simple_partial_symbol (part_die->tag, part_die->name, cu);
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
 	}
@@ -15708,12 +16651,7 @@ load_partial_dies (const struct die_reader_specs *reader,
 	    complaint (&symfile_complaints,
 		       _("malformed enumerator DIE ignored"));
 	  else if (building_psymtab)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_CONST,
-				 cu->language == language_cplus
-				 ? &objfile->global_psymbols
-				 : &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    add_simple_partial_symbol (part_die->tag, part_die->name, cu);
 
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
@@ -15851,25 +16789,13 @@ read_partial_die (const struct die_reader_specs *reader,
       switch (attr.name)
 	{
 	case DW_AT_name:
-	  switch (part_die->tag)
-	    {
-	    case DW_TAG_compile_unit:
-	    case DW_TAG_partial_unit:
-	    case DW_TAG_type_unit:
-	      /* Compilation units have a DW_AT_name that is a filename, not
-		 a source language identifier.  */
-	    case DW_TAG_enumeration_type:
-	    case DW_TAG_enumerator:
-	      /* These tags always have simple identifiers already; no need
-		 to canonicalize them.  */
-	      part_die->name = DW_STRING (&attr);
-	      break;
-	    default:
-	      part_die->name
-		= dwarf2_canonicalize_name (DW_STRING (&attr), cu,
-					    &objfile->per_bfd->storage_obstack);
-	      break;
-	    }
+	  /* Canonicalization is not thread-safe; it is done later for
+	     CUs being preloaded.  */
+	  if (cu->preloading)
+	    part_die->name = DW_STRING (&attr);
+	  else
+	    part_die->name = partial_die_name (part_die->tag,
+					       DW_STRING (&attr), cu);
 	  break;
 	case DW_AT_linkage_name:
 	case DW_AT_MIPS_linkage_name:
@@ -22588,6 +23514,8 @@ dwarf2_per_objfile_free (struct objfile *objfile, void *d)
 
   if (data->dwz_file && data->dwz_file->dwz_bfd)
     gdb_bfd_unref (data->dwz_file->dwz_bfd);
+
+  xfree (data->index_contents);
 }
 
 
@@ -22797,7 +23725,8 @@ hash_expand (struct mapped_symtab *symtab)
 
 /* Add an entry to SYMTAB.  NAME is the name of the symbol.
    CU_INDEX is the index of the CU in which the symbol appears.
-   IS_STATIC is one if the symbol is static, otherwise zero (global).  */
+   IS_STATIC is one if the symbol is static, otherwise zero (global).
+   If KIND is GDB_INDEX_SYMBOL_KIND_NONE, no attributes are recorded.  */
 
 static void
 add_index_entry (struct mapped_symtab *symtab, const char *name,
@@ -22822,8 +23751,11 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
 
   cu_index_and_attrs = 0;
   DW2_GDB_INDEX_CU_SET_VALUE (cu_index_and_attrs, cu_index);
-  DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE (cu_index_and_attrs, is_static);
-  DW2_GDB_INDEX_SYMBOL_KIND_SET_VALUE (cu_index_and_attrs, kind);
+  if (kind != GDB_INDEX_SYMBOL_KIND_NONE)
+    {
+      DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE (cu_index_and_attrs, is_static);
+      DW2_GDB_INDEX_SYMBOL_KIND_SET_VALUE (cu_index_and_attrs, kind);
+    }
 
   /* We don't want to record an index value twice as we want to avoid the
      duplication.
@@ -23190,7 +24122,7 @@ write_obstack (FILE *file, struct obstack *obstack)
 static void
 unlink_if_set (void *p)
 {
-  char **filename = (char **) p;
+  const char **filename = (const char **) p;
   if (*filename)
     unlink (*filename);
 }
@@ -23273,20 +24205,66 @@ recursively_write_psymbols (struct objfile *objfile,
 		  1);
 }
 
-/* Create an index file for OBJFILE in the directory DIR.  */
+/* Write the header of an index whose parts are CU_LIST, TYPES_CU_LIST,
+   ADDR_OBSTACK, SYMTAB_OBSTACK and CONSTANT_POOL to CONTENTS.  The
+   parts follow the header in that order.  */
 
 static void
-write_psymtabs_to_index (struct objfile *objfile, const char *dir)
+write_index_header (struct obstack *contents, struct obstack *cu_list,
+		    struct obstack *types_cu_list,
+		    struct obstack *addr_obstack,
+		    struct obstack *symtab_obstack,
+		    struct obstack *constant_pool)
+{
+  offset_type val, size_of_contents, total_len;
+
+  size_of_contents = 6 * sizeof (offset_type);
+  total_len = size_of_contents;
+
+  /* The version number.  */
+  val = MAYBE_SWAP (8);
+  obstack_grow (contents, &val, sizeof (val));
+
+  /* The offset of the CU list from the start of the file.  */
+  val = MAYBE_SWAP (total_len);
+  obstack_grow (contents, &val, sizeof (val));
+  total_len += obstack_object_size (cu_list);
+
+  /* The offset of the types CU list from the start of the file.  */
+  val = MAYBE_SWAP (total_len);
+  obstack_grow (contents, &val, sizeof (val));
+  total_len += obstack_object_size (types_cu_list);
+
+  /* The offset of the address table from the start of the file.  */
+  val = MAYBE_SWAP (total_len);
+  obstack_grow (contents, &val, sizeof (val));
+  total_len += obstack_object_size (addr_obstack);
+
+  /* The offset of the symbol table from the start of the file.  */
+  val = MAYBE_SWAP (total_len);
+  obstack_grow (contents, &val, sizeof (val));
+  total_len += obstack_object_size (symtab_obstack);
+
+  /* The offset of the constant pool from the start of the file.  */
+  val = MAYBE_SWAP (total_len);
+  obstack_grow (contents, &val, sizeof (val));
+  total_len += obstack_object_size (constant_pool);
+
+  gdb_assert (obstack_object_size (contents) == size_of_contents);
+}
+
+/* Write an index for OBJFILE to the file FILENAME.  */
+
+static void
+write_psymtabs_to_index_file (struct objfile *objfile, const char *filename)
 {
   struct cleanup *cleanup;
-  char *filename, *cleanup_filename;
+  const char *cleanup_filename;
   struct obstack contents, addr_obstack, constant_pool, symtab_obstack;
   struct obstack cu_list, types_cu_list;
   int i;
   FILE *out_file;
   struct mapped_symtab *symtab;
-  offset_type val, size_of_contents, total_len;
-  struct stat st;
   htab_t psyms_seen;
   htab_t cu_index_htab;
   struct psymtab_cu_index_map *psymtab_cu_index_map;
@@ -23300,19 +24278,12 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   if (!objfile->psymtabs || !objfile->psymtabs_addrmap)
     return;
 
-  if (stat (objfile_name (objfile), &st) < 0)
-    perror_with_name (objfile_name (objfile));
-
-  filename = concat (dir, SLASH_STRING, lbasename (objfile_name (objfile)),
-		     INDEX_SUFFIX, (char *) NULL);
-  cleanup = make_cleanup (xfree, filename);
-
   out_file = gdb_fopen_cloexec (filename, "wb");
   if (!out_file)
     error (_("Can't open `%s' for writing"), filename);
 
   cleanup_filename = filename;
-  make_cleanup (unlink_if_set, &cleanup_filename);
+  cleanup = make_cleanup (unlink_if_set, &cleanup_filename);
 
   symtab = create_mapped_symtab ();
   make_cleanup (cleanup_mapped_symtab, symtab);
@@ -23408,39 +24379,8 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
 
   obstack_init (&contents);
   make_cleanup_obstack_free (&contents);
-  size_of_contents = 6 * sizeof (offset_type);
-  total_len = size_of_contents;
-
-  /* The version number.  */
-  val = MAYBE_SWAP (8);
-  obstack_grow (&contents, &val, sizeof (val));
-
-  /* The offset of the CU list from the start of the file.  */
-  val = MAYBE_SWAP (total_len);
-  obstack_grow (&contents, &val, sizeof (val));
-  total_len += obstack_object_size (&cu_list);
-
-  /* The offset of the types CU list from the start of the file.  */
-  val = MAYBE_SWAP (total_len);
-  obstack_grow (&contents, &val, sizeof (val));
-  total_len += obstack_object_size (&types_cu_list);
-
-  /* The offset of the address table from the start of the file.  */
-  val = MAYBE_SWAP (total_len);
-  obstack_grow (&contents, &val, sizeof (val));
-  total_len += obstack_object_size (&addr_obstack);
-
-  /* The offset of the symbol table from the start of the file.  */
-  val = MAYBE_SWAP (total_len);
-  obstack_grow (&contents, &val, sizeof (val));
-  total_len += obstack_object_size (&symtab_obstack);
-
-  /* The offset of the constant pool from the start of the file.  */
-  val = MAYBE_SWAP (total_len);
-  obstack_grow (&contents, &val, sizeof (val));
-  total_len += obstack_object_size (&constant_pool);
-
-  gdb_assert (obstack_object_size (&contents) == size_of_contents);
+  write_index_header (&contents, &cu_list, &types_cu_list, &addr_obstack,
+		      &symtab_obstack, &constant_pool);
 
   write_obstack (out_file, &contents);
   write_obstack (out_file, &cu_list);
@@ -23458,6 +24398,834 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   do_cleanups (cleanup);
 }
 
+/* Create an index file for OBJFILE in the directory DIR.  */
+
+static void
+write_psymtabs_to_index (struct objfile *objfile, const char *dir)
+{
+  struct cleanup *cleanup;
+  char *filename;
+  struct stat st;
+
+  if (stat (objfile_name (objfile), &st) < 0)
+    perror_with_name (objfile_name (objfile));
+
+  filename = concat (dir, SLASH_STRING, lbasename (objfile_name (objfile)),
+		     INDEX_SUFFIX, (char *) NULL);
+  cleanup = make_cleanup (xfree, filename);
+
+  write_psymtabs_to_index_file (objfile, filename);
+
+  do_cleanups (cleanup);
+}
+
+/* .debug_names support.
+
+   A .debug_names section holds one or more DWARF 5 name indexes,
+   for instance one per object file when the linker just concatenates
+   them.  Rather than looking names up in them directly, GDB converts
+   them to the .gdb_index format when the objfile is read, and then
+   uses the .gdb_index machinery.  The conversion only walks the name
+   tables, which is much cheaper than building psymtabs.
+
+   .debug_names has no address table, so the converted index takes
+   its address table from .debug_aranges; without .debug_aranges the
+   .debug_names section is not used.  Name indexes of type units are
+   not supported either.  */
+
+/* A compilation unit of .debug_info, for debug_names_to_index.  */
+
+struct debug_names_cu
+{
+  ULONGEST offset;
+  ULONGEST length;
+
+  /* Nonzero once a name index has listed this CU.  */
+  int seen;
+};
+
+typedef struct debug_names_cu debug_names_cu_def;
+DEF_VEC_O (debug_names_cu_def);
+
+/* An abbreviation of a name index.  */
+
+struct debug_names_abbrev
+{
+  ULONGEST code;
+  ULONGEST tag;
+
+  /* The (index attribute, form) pairs, as ULEB128 numbers terminated
+     by a pair of zeros.  */
+  const gdb_byte *attrs;
+};
+
+typedef struct debug_names_abbrev debug_names_abbrev_def;
+DEF_VEC_O (debug_names_abbrev_def);
+
+/* An entry of a name index.  */
+
+struct debug_names_entry
+{
+  /* The offset of the entry in the entry pool of its name index.  */
+  ULONGEST offset;
+
+  /* The offset of the parent entry, if HAS_PARENT.  */
+  ULONGEST parent;
+  int has_parent;
+
+  ULONGEST tag;
+
+  /* The index of the entry's CU in the converted index.  */
+  offset_type cu_index;
+
+  /* 1 if the entry has DW_IDX_GNU_internal, 0 if it has
+     DW_IDX_GNU_external, -1 if it has neither.  */
+  int is_static;
+
+  const char *name;
+
+  /* NAME qualified with the names of the parents, once computed.  */
+  const char *qualified_name;
+};
+
+typedef struct debug_names_entry debug_names_entry_def;
+DEF_VEC_O (debug_names_entry_def);
+
+/* qsort and bsearch comparison function for debug_names_abbrev.  */
+
+static int
+compare_debug_names_abbrevs (const void *ap, const void *bp)
+{
+  const struct debug_names_abbrev *a = (const struct debug_names_abbrev *) ap;
+  const struct debug_names_abbrev *b = (const struct debug_names_abbrev *) bp;
+
+  if (a->code != b->code)
+    return a->code < b->code ? -1 : 1;
+  return 0;
+}
+
+/* qsort and bsearch comparison function for debug_names_entry.  */
+
+static int
+compare_debug_names_entries (const void *ap, const void *bp)
+{
+  const struct debug_names_entry *a = (const struct debug_names_entry *) ap;
+  const struct debug_names_entry *b = (const struct debug_names_entry *) bp;
+
+  if (a->offset != b->offset)
+    return a->offset < b->offset ? -1 : 1;
+  return 0;
+}
+
+/* bsearch comparison function for debug_names_cu.  */
+
+static int
+compare_debug_names_cus (const void *ap, const void *bp)
+{
+  const struct debug_names_cu *a = (const struct debug_names_cu *) ap;
+  const struct debug_names_cu *b = (const struct debug_names_cu *) bp;
+
+  if (a->offset != b->offset)
+    return a->offset < b->offset ? -1 : 1;
+  return 0;
+}
+
+/* Read a value of FORM, one of the forms used in name indexes, from
+   *PTR, which must be before END, into *VALUE and advance *PTR past
+   it.  Return 0 if FORM is not supported or the data is truncated.  */
+
+static int
+read_debug_names_value (bfd *abfd, const gdb_byte **ptr,
+			const gdb_byte *end, ULONGEST form, ULONGEST *value)
+{
+  const gdb_byte *p = *ptr;
+  uint64_t uvalue;
+  size_t size;
+
+  switch (form)
+    {
+    case DW_FORM_flag_present:
+      *value = 1;
+      return 1;
+    case DW_FORM_udata:
+    case DW_FORM_ref_udata:
+      p = gdb_read_uleb128 (p, end, &uvalue);
+      if (p == NULL)
+	return 0;
+      *value = uvalue;
+      *ptr = p;
+      return 1;
+    case DW_FORM_flag:
+    case DW_FORM_data1:
+    case DW_FORM_ref1:
+      size = 1;
+      break;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:
+      size = 2;
+      break;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:
+      size = 4;
+      break;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:
+      size = 8;
+      break;
+    default:
+      return 0;
+    }
+
+  if (end - p < size)
+    return 0;
+  switch (size)
+    {
+    case 1:
+      *value = read_1_byte (abfd, p);
+      break;
+    case 2:
+      *value = read_2_bytes (abfd, p);
+      break;
+    case 4:
+      *value = read_4_bytes (abfd, p);
+      break;
+    default:
+      *value = read_8_bytes (abfd, p);
+      break;
+    }
+  *ptr = p + size;
+  return 1;
+}
+
+/* Return the kind of the gdb_index symbol for a name index entry of
+   DIE tag TAG.  */
+
+static gdb_index_symbol_kind
+debug_names_symbol_kind (ULONGEST tag)
+{
+  switch (tag)
+    {
+    case DW_TAG_subprogram:
+    case DW_TAG_inlined_subroutine:
+    case DW_TAG_entry_point:
+      return GDB_INDEX_SYMBOL_KIND_FUNCTION;
+    case DW_TAG_variable:
+    case DW_TAG_constant:
+    case DW_TAG_enumerator:
+      return GDB_INDEX_SYMBOL_KIND_VARIABLE;
+    case DW_TAG_base_type:
+    case DW_TAG_class_type:
+    case DW_TAG_enumeration_type:
+    case DW_TAG_interface_type:
+    case DW_TAG_namespace:
+    case DW_TAG_structure_type:
+    case DW_TAG_subrange_type:
+    case DW_TAG_typedef:
+    case DW_TAG_union_type:
+    case DW_TAG_unspecified_type:
+      return GDB_INDEX_SYMBOL_KIND_TYPE;
+    default:
+      return GDB_INDEX_SYMBOL_KIND_OTHER;
+    }
+}
+
+/* Return the name of ENTRY, one of the sorted ENTRIES of a name
+   index, qualified with the names of its parents.  New names are
+   allocated on OBSTACK.  DEPTH guards against parent cycles.  */
+
+static const char *
+debug_names_qualified_name (VEC (debug_names_entry_def) *entries,
+			    struct debug_names_entry *entry,
+			    struct obstack *obstack, int depth)
+{
+  struct debug_names_entry key, *parent;
+  const char *scope;
+
+  if (entry->qualified_name != NULL)
+    return entry->qualified_name;
+
+  parent = NULL;
+  if (entry->has_parent && depth < 100)
+    {
+      key.offset = entry->parent;
+      parent = ((struct debug_names_entry *)
+		bsearch (&key,
+			 VEC_address (debug_names_entry_def, entries),
+			 VEC_length (debug_names_entry_def, entries),
+			 sizeof (key), compare_debug_names_entries));
+    }
+
+  if (parent == NULL || parent == entry)
+    entry->qualified_name = entry->name;
+  else
+    {
+      scope = debug_names_qualified_name (entries, parent, obstack,
+					  depth + 1);
+      entry->qualified_name = obconcat (obstack, scope, "::", entry->name,
+					(char *) NULL);
+    }
+
+  return entry->qualified_name;
+}
+
+/* Read the name index at *PTR of the .debug_names section, which ends
+   at SECTION_END, and append its entries, with their qualified names,
+   to *SYMBOLS.  CUS are the CUs of .debug_info; mark the ones the name
+   index lists as seen.  Names are allocated on OBSTACK.  On success
+   advance *PTR past the name index and return 1, otherwise return
+   0.  */
+
+static int
+read_debug_names_index (struct objfile *objfile, const gdb_byte **ptr,
+			const gdb_byte *section_end,
+			VEC (debug_names_cu_def) *cus,
+			VEC (debug_names_entry_def) **symbols,
+			struct obstack *obstack)
+{
+  bfd *abfd = objfile->obfd;
+  struct dwarf2_section_info *str = &dwarf2_per_objfile->str;
+  const gdb_byte *p = *ptr, *end, *cu_list, *string_offsets;
+  const gdb_byte *entry_offsets, *abbrev_table, *entry_pool;
+  unsigned int bytes_read, offset_size;
+  ULONGEST length, i;
+  offset_type cu_count, local_tu_count, foreign_tu_count;
+  offset_type bucket_count, name_count, abbrev_table_size, augmentation_size;
+  offset_type *cu_indices;
+  VEC (debug_names_abbrev_def) *abbrevs = NULL;
+  VEC (debug_names_entry_def) *entries = NULL;
+  struct debug_names_entry *entry;
+  struct cleanup *cleanup;
+  int has_parents = 0, nested_names = 0, ok = 0;
+
+  if (section_end - p < 4)
+    return 0;
+  length = read_initial_length (abfd, p, &bytes_read);
+  offset_size = bytes_read == 4 ? 4 : 8;
+  p += bytes_read;
+  if (length > section_end - p || length < 36)
+    return 0;
+  end = p + length;
+
+  if (read_2_bytes (abfd, p) != 5)
+    return 0;
+  p += 4;
+  cu_count = read_4_bytes (abfd, p);
+  local_tu_count = read_4_bytes (abfd, p + 4);
+  foreign_tu_count = read_4_bytes (abfd, p + 8);
+  bucket_count = read_4_bytes (abfd, p + 12);
+  name_count = read_4_bytes (abfd, p + 16);
+  abbrev_table_size = read_4_bytes (abfd, p + 20);
+  augmentation_size = read_4_bytes (abfd, p + 24);
+  p += 28;
+
+  if (local_tu_count != 0 || foreign_tu_count != 0 || cu_count == 0)
+    return 0;
+
+  /* Locate the parts of the name index, checking that they fit.  */
+  if (augmentation_size > end - p)
+    return 0;
+  p += augmentation_size;
+  cu_list = p;
+  if ((ULONGEST) cu_count * offset_size > end - p)
+    return 0;
+  p += (ULONGEST) cu_count * offset_size;
+  if ((ULONGEST) bucket_count * 4 > end - p)
+    return 0;
+  p += (ULONGEST) bucket_count * 4;
+  if (bucket_count != 0)
+    {
+      if ((ULONGEST) name_count * 4 > end - p)
+	return 0;
+      p += (ULONGEST) name_count * 4;
+    }
+  string_offsets = p;
+  if ((ULONGEST) name_count * offset_size * 2 > end - p)
+    return 0;
+  p += (ULONGEST) name_count * offset_size;
+  entry_offsets = p;
+  p += (ULONGEST) name_count * offset_size;
+  abbrev_table = p;
+  if (abbrev_table_size > end - p)
+    return 0;
+  entry_pool = p + abbrev_table_size;
+
+  cleanup = make_cleanup (VEC_cleanup (debug_names_abbrev_def), &abbrevs);
+  make_cleanup (VEC_cleanup (debug_names_entry_def), &entries);
+  cu_indices = XNEWVEC (offset_type, cu_count);
+  make_cleanup (xfree, cu_indices);
+
+  /* Map the CUs of the name index to CUs of the converted index.  */
+  for (i = 0; i < cu_count; ++i)
+    {
+      struct debug_names_cu key, *cu;
+
+      key.offset = read_offset_1 (abfd, cu_list + i * offset_size,
+				  offset_size);
+      cu = ((struct debug_names_cu *)
+	    bsearch (&key, VEC_address (debug_names_cu_def, cus),
+		     VEC_length (debug_names_cu_def, cus),
+		     sizeof (key), compare_debug_names_cus));
+      if (cu == NULL || cu->seen)
+	goto out;
+      cu->seen = 1;
+      cu_indices[i] = cu - VEC_address (debug_names_cu_def, cus);
+    }
+
+  /* Read the abbreviations.  */
+  p = abbrev_table;
+  for (;;)
+    {
+      struct debug_names_abbrev abbrev;
+      uint64_t code, tag, attr, form;
+
+      p = gdb_read_uleb128 (p, entry_pool, &code);
+      if (p == NULL)
+	goto out;
+      if (code == 0)
+	break;
+      p = gdb_read_uleb128 (p, entry_pool, &tag);
+      if (p == NULL)
+	goto out;
+      abbrev.code = code;
+      abbrev.tag = tag;
+      abbrev.attrs = p;
+      do
+	{
+	  p = gdb_read_uleb128 (p, entry_pool, &attr);
+	  if (p != NULL)
+	    p = gdb_read_uleb128 (p, entry_pool, &form);
+	  if (p == NULL)
+	    goto out;
+	  if (attr == DW_IDX_parent)
+	    has_parents = 1;
+	}
+      while (attr != 0 || form != 0);
+      VEC_safe_push (debug_names_abbrev_def, abbrevs, &abbrev);
+    }
+  qsort (VEC_address (debug_names_abbrev_def, abbrevs),
+	 VEC_length (debug_names_abbrev_def, abbrevs),
+	 sizeof (struct debug_names_abbrev), compare_debug_names_abbrevs);
+
+  /* Read the entries of each name.  */
+  dwarf2_read_section (objfile, str);
+  for (i = 0; i < name_count; ++i)
+    {
+      ULONGEST str_offset, entry_offset;
+      const char *name;
+
+      str_offset = read_offset_1 (abfd, string_offsets + i * offset_size,
+				  offset_size);
+      if (str_offset >= str->size
+	  || memchr (str->buffer + str_offset, '\0',
+		     str->size - str_offset) == NULL)
+	goto out;
+      name = (const char *) str->buffer + str_offset;
+      if (startswith (name, "_Z"))
+	nested_names = 1;
+
+      entry_offset = read_offset_1 (abfd, entry_offsets + i * offset_size,
+				    offset_size);
+      if (entry_offset >= end - entry_pool)
+	goto out;
+      p = entry_pool + entry_offset;
+      for (;;)
+	{
+	  struct debug_names_abbrev key, *abbrev;
+	  struct debug_names_entry new_entry;
+	  const gdb_byte *attrs;
+	  ULONGEST cu = 0;
+	  uint64_t code;
+
+	  new_entry.offset = p - entry_pool;
+	  p = gdb_read_uleb128 (p, end, &code);
+	  if (p == NULL)
+	    goto out;
+	  if (code == 0)
+	    break;
+
+	  key.code = code;
+	  abbrev = ((struct debug_names_abbrev *)
+		    bsearch (&key,
+			     VEC_address (debug_names_abbrev_def, abbrevs),
+			     VEC_length (debug_names_abbrev_def, abbrevs),
+			     sizeof (key), compare_debug_names_abbrevs));
+	  if (abbrev == NULL)
+	    goto out;
+
+	  new_entry.tag = abbrev->tag;
+	  new_entry.has_parent = 0;
+	  new_entry.is_static = -1;
+	  new_entry.name = name;
+	  new_entry.qualified_name = NULL;
+	  if (abbrev->tag == DW_TAG_namespace)
+	    nested_names = 1;
+
+	  /* The abbreviation was checked when it was read.  */
+	  attrs = abbrev->attrs;
+	  for (;;)
+	    {
+	      uint64_t attr, form;
+	      ULONGEST value;
+
+	      attrs = gdb_read_uleb128 (attrs, entry_pool, &attr);
+	      attrs = gdb_read_uleb128 (attrs, entry_pool, &form);
+	      if (attr == 0 && form == 0)
+		break;
+	      if (!read_debug_names_value (abfd, &p, end, form, &value))
+		goto out;
+
+	      switch (attr)
+		{
+		case DW_IDX_compile_unit:
+		  cu = value;
+		  break;
+		case DW_IDX_type_unit:
+		  goto out;
+		case DW_IDX_parent:
+		  /* DW_FORM_flag_present says that the parent is not
+		     indexed.  Otherwise this is the offset of the
+		     parent's entry in the entry pool.  */
+		  if (form != DW_FORM_flag_present)
+		    {
+		      new_entry.has_parent = 1;
+		      new_entry.parent = value;
+		    }
+		  break;
+		case DW_IDX_GNU_internal:
+		  new_entry.is_static = 1;
+		  break;
+		case DW_IDX_GNU_external:
+		  new_entry.is_static = 0;
+		  break;
+		}
+	    }
+
+	  if (cu >= cu_count)
+	    goto out;
+	  new_entry.cu_index = cu_indices[cu];
+	  VEC_safe_push (debug_names_entry_def, entries, &new_entry);
+	}
+    }
+
+  /* Without DW_IDX_parent, the names of C++ entities nested in
+     namespaces or classes are not qualified, and the index is not
+     usable.  A namespace or a mangled name gives that case away.  */
+  if (nested_names && !has_parents)
+    goto out;
+
+  qsort (VEC_address (debug_names_entry_def, entries),
+	 VEC_length (debug_names_entry_def, entries),
+	 sizeof (struct debug_names_entry), compare_debug_names_entries);
+
+  for (i = 0; VEC_iterate (debug_names_entry_def, entries, i, entry); ++i)
+    {
+      const char *name;
+
+      /* Linkage names are indexed as well, but GDB looks symbols up
+	 by their search names.  */
+      if (startswith (entry->name, "_Z"))
+	continue;
+
+      name = debug_names_qualified_name (entries, entry, obstack, 0);
+      if (strchr (name, '<') != NULL || strstr (name, "operator") != NULL)
+	{
+	  std::string canonical = cp_canonicalize_string (name);
+
+	  if (!canonical.empty ())
+	    name = (const char *) obstack_copy0 (obstack, canonical.c_str (),
+						 canonical.length ());
+	}
+
+      entry->qualified_name = name;
+      VEC_safe_push (debug_names_entry_def, *symbols, entry);
+    }
+
+  *ptr = end;
+  ok = 1;
+
+ out:
+  do_cleanups (cleanup);
+  return ok;
+}
+
+/* Write the address ranges of .debug_aranges to ADDR_OBSTACK, in the
+   format of a .gdb_index address table for the CUs CUS.  Return 0 if
+   .debug_aranges is missing or can't be read.  */
+
+static int
+write_address_map_from_aranges (struct objfile *objfile,
+				VEC (debug_names_cu_def) *cus,
+				struct obstack *addr_obstack)
+{
+  bfd *abfd = objfile->obfd;
+  struct dwarf2_section_info *section = &dwarf2_per_objfile->aranges;
+  const gdb_byte *p, *section_end;
+
+  if (dwarf2_section_empty_p (section))
+    return 0;
+  dwarf2_read_section (objfile, section);
+  p = section->buffer;
+  section_end = p + section->size;
+
+  while (p < section_end)
+    {
+      const gdb_byte *set_start = p, *end;
+      unsigned int bytes_read, offset_size, address_size, tuple_size;
+      struct debug_names_cu key, *cu;
+      ULONGEST length;
+      offset_type cu_index;
+
+      if (section_end - p < 4)
+	return 0;
+      length = read_initial_length (abfd, p, &bytes_read);
+      offset_size = bytes_read == 4 ? 4 : 8;
+      p += bytes_read;
+      if (length > section_end - p || length < 4 + offset_size)
+	return 0;
+      end = p + length;
+
+      if (read_2_bytes (abfd, p) != 2)
+	return 0;
+      p += 2;
+      key.offset = read_offset_1 (abfd, p, offset_size);
+      p += offset_size;
+      address_size = read_1_byte (abfd, p);
+      if (read_1_byte (abfd, p + 1) != 0
+	  || (address_size != 4 && address_size != 8))
+	return 0;
+      p += 2;
+
+      cu = ((struct debug_names_cu *)
+	    bsearch (&key, VEC_address (debug_names_cu_def, cus),
+		     VEC_length (debug_names_cu_def, cus),
+		     sizeof (key), compare_debug_names_cus));
+      if (cu == NULL)
+	return 0;
+      cu_index = cu - VEC_address (debug_names_cu_def, cus);
+
+      /* The tuples are aligned to their size from the start of the
+	 set.  */
+      tuple_size = 2 * address_size;
+      p = set_start + (p - set_start + tuple_size - 1) / tuple_size * tuple_size;
+      for (; end - p >= tuple_size; p += tuple_size)
+	{
+	  ULONGEST start, range_length;
+	  gdb_byte buf[8];
+
+	  if (address_size == 4)
+	    {
+	      start = read_4_bytes (abfd, p);
+	      range_length = read_4_bytes (abfd, p + 4);
+	    }
+	  else
+	    {
+	      start = read_8_bytes (abfd, p);
+	      range_length = read_8_bytes (abfd, p + 8);
+	    }
+	  if (start == 0 && range_length == 0)
+	    break;
+	  if (range_length == 0)
+	    continue;
+
+	  store_unsigned_integer (buf, 8, BFD_ENDIAN_LITTLE, start);
+	  obstack_grow (addr_obstack, buf, 8);
+	  store_unsigned_integer (buf, 8, BFD_ENDIAN_LITTLE,
+				  start + range_length);
+	  obstack_grow (addr_obstack, buf, 8);
+	  store_unsigned_integer (buf, 4, BFD_ENDIAN_LITTLE, cu_index);
+	  obstack_grow (addr_obstack, buf, 4);
+	}
+
+      p = end;
+    }
+
+  return 1;
+}
+
+/* Convert the .debug_names section of OBJFILE to the .gdb_index
+   format.  Return the contents of the converted index, which the
+   caller must xfree, and set *SIZE to its size; or return NULL if the
+   section is missing or can't be converted.  */
+
+static gdb_byte *
+debug_names_to_index (struct objfile *objfile, ULONGEST *size)
+{
+  bfd *abfd = objfile->obfd;
+  struct dwarf2_section_info *info = &dwarf2_per_objfile->info;
+  struct dwarf2_section_info *section = &dwarf2_per_objfile->debug_names;
+  struct obstack contents, cu_list, types_cu_list, addr_obstack;
+  struct obstack constant_pool, symtab_obstack, names;
+  VEC (debug_names_cu_def) *cus = NULL;
+  VEC (debug_names_entry_def) *symbols = NULL;
+  struct debug_names_cu *cu;
+  struct debug_names_entry *entry;
+  struct mapped_symtab *symtab;
+  struct cleanup *cleanup;
+  const gdb_byte *p, *end;
+  gdb_byte *result = NULL, *out;
+  int i;
+
+  if (dwarf2_section_empty_p (section)
+      || (get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return NULL;
+
+  /* The index would also need the CUs of the dwz file and the type
+     units of .debug_types.  */
+  if (bfd_get_section_by_name (abfd, ".gnu_debugaltlink") != NULL
+      || !VEC_empty (dwarf2_section_info_def, dwarf2_per_objfile->types))
+    return NULL;
+
+  cleanup = make_cleanup (VEC_cleanup (debug_names_cu_def), &cus);
+  make_cleanup (VEC_cleanup (debug_names_entry_def), &symbols);
+
+  /* Find the CUs of .debug_info.  */
+  dwarf2_read_section (objfile, info);
+  p = info->buffer;
+  end = info->buffer + info->size;
+  while (p < end)
+    {
+      struct debug_names_cu new_cu;
+      unsigned int bytes_read;
+      ULONGEST length;
+
+      if (end - p < 4)
+	goto out;
+      length = read_initial_length (abfd, p, &bytes_read);
+      if (length > end - p - bytes_read)
+	goto out;
+      new_cu.offset = p - info->buffer;
+      new_cu.length = bytes_read + length;
+      new_cu.seen = 0;
+      VEC_safe_push (debug_names_cu_def, cus, &new_cu);
+      p += new_cu.length;
+    }
+  if (VEC_empty (debug_names_cu_def, cus))
+    goto out;
+
+  obstack_init (&names);
+  make_cleanup_obstack_free (&names);
+
+  /* Read each name index of the section.  */
+  dwarf2_read_section (objfile, section);
+  p = section->buffer;
+  end = section->buffer + section->size;
+  while (p < end)
+    if (!read_debug_names_index (objfile, &p, end, cus, &symbols, &names))
+      goto out;
+
+  /* The converted index replaces the psymtabs of all CUs, so it must
+     cover all of them.  */
+  for (i = 0; VEC_iterate (debug_names_cu_def, cus, i, cu); ++i)
+    if (!cu->seen)
+      goto out;
+
+  obstack_init (&addr_obstack);
+  make_cleanup_obstack_free (&addr_obstack);
+  if (!write_address_map_from_aranges (objfile, cus, &addr_obstack))
+    goto out;
+
+  obstack_init (&cu_list);
+  make_cleanup_obstack_free (&cu_list);
+  for (i = 0; VEC_iterate (debug_names_cu_def, cus, i, cu); ++i)
+    {
+      gdb_byte val[8];
+
+      store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, cu->offset);
+      obstack_grow (&cu_list, val, 8);
+      store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, cu->length);
+      obstack_grow (&cu_list, val, 8);
+    }
+
+  obstack_init (&types_cu_list);
+  make_cleanup_obstack_free (&types_cu_list);
+
+  symtab = create_mapped_symtab ();
+  make_cleanup (cleanup_mapped_symtab, symtab);
+  for (i = 0; VEC_iterate (debug_names_entry_def, symbols, i, entry); ++i)
+    {
+      /* Without the GNU extensions, nothing says whether the entity
+	 is static, so leave out the symbol's attributes.  */
+      if (entry->is_static == -1)
+	add_index_entry (symtab, entry->qualified_name, 0,
+			 GDB_INDEX_SYMBOL_KIND_NONE, entry->cu_index);
+      else
+	add_index_entry (symtab, entry->qualified_name, entry->is_static,
+			 debug_names_symbol_kind (entry->tag),
+			 entry->cu_index);
+    }
+  uniquify_cu_indices (symtab);
+
+  obstack_init (&constant_pool);
+  make_cleanup_obstack_free (&constant_pool);
+  obstack_init (&symtab_obstack);
+  make_cleanup_obstack_free (&symtab_obstack);
+  write_hash_table (symtab, &symtab_obstack, &constant_pool);
+
+  obstack_init (&contents);
+  make_cleanup_obstack_free (&contents);
+  write_index_header (&contents, &cu_list, &types_cu_list, &addr_obstack,
+		      &symtab_obstack, &constant_pool);
+
+  *size = (obstack_object_size (&contents)
+	   + obstack_object_size (&cu_list)
+	   + obstack_object_size (&types_cu_list)
+	   + obstack_object_size (&addr_obstack)
+	   + obstack_object_size (&symtab_obstack)
+	   + obstack_object_size (&constant_pool));
+  result = (gdb_byte *) xmalloc (*size);
+  out = result;
+  out = (gdb_byte *) mempcpy (out, obstack_base (&contents),
+			      obstack_object_size (&contents));
+  out = (gdb_byte *) mempcpy (out, obstack_base (&cu_list),
+			      obstack_object_size (&cu_list));
+  out = (gdb_byte *) mempcpy (out, obstack_base (&types_cu_list),
+			      obstack_object_size (&types_cu_list));
+  out = (gdb_byte *) mempcpy (out, obstack_base (&addr_obstack),
+			      obstack_object_size (&addr_obstack));
+  out = (gdb_byte *) mempcpy (out, obstack_base (&symtab_obstack),
+			      obstack_object_size (&symtab_obstack));
+  memcpy (out, obstack_base (&constant_pool),
+	  obstack_object_size (&constant_pool));
+
+ out:
+  do_cleanups (cleanup);
+  return result;
+}
+
+/* index_cache_store callback for dwarf2_store_index_in_cache.  */
+
+static void
+write_index_cache_file (const char *filename, void *data)
+{
+  write_psymtabs_to_index_file ((struct objfile *) data, filename);
+}
+
+/* If the index cache is enabled, store an index for OBJFILE, whose
+   psymtabs have just been built, in it.  */
+
+static void
+dwarf2_store_index_in_cache (struct objfile *objfile)
+{
+  const struct bfd_build_id *build_id;
+
+  if (!index_cache_enabled_p ())
+    return;
+
+  build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id == NULL)
+    return;
+
+  /* The index of a file that uses a dwz file needs the dwz file's
+     index too, which is not cached.  An index can't describe more
+     than one .debug_types section.  */
+  if (bfd_get_section_by_name (objfile->obfd, ".gnu_debugaltlink") != NULL
+      || VEC_length (dwarf2_section_info_def, dwarf2_per_objfile->types) > 1)
+    return;
+
+  index_cache_store (build_id, write_index_cache_file, objfile);
+}
+
 /* Implementation of the `save gdb-index' command.
    
    Note that the file format used by this command is documented in the
@@ -1055,6 +1055,10 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
 
   minimal_symbol_reader reader (objfile);
 
+  /* Nothing below looks at the names of the minimal symbols before
+     they are installed, so let the reader demangle them all at once.  */
+  reader.defer_names ();
+
   /* Allocate struct to keep track of the symfile.  */
   dbx = XCNEW (struct dbx_symfile_info);
   set_objfile_data (objfile, dbx_objfile_data_key, dbx);
@@ -33,6 +33,14 @@
 #include "target.h"
 #include "gdb/fileio.h"
 #include "inferior.h"
+#include "index-cache.h"
+#include <zlib.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#ifndef TMPFS_MAGIC
+#define TMPFS_MAGIC 0x01021994
+#endif
+#endif
 
 typedef bfd *bfdp;
 DEF_VEC_P (bfdp);
@@ -642,6 +650,188 @@ get_section_descriptor (asection *section)
   return result;
 }
 
+#ifdef HAVE_MMAP
+
+/* The value of "maint set decompressed-section-directory".  */
+
+static char *decompressed_section_directory;
+
+/* Implement "maint show decompressed-section-directory".  */
+
+static void
+show_decompressed_section_directory (struct ui_file *file, int from_tty,
+				     struct cmd_list_element *c,
+				     const char *value)
+{
+  if (*value == '\0')
+    fprintf_filtered (file, _("Large compressed sections are decompressed "
+			      "into files in the index cache directory.\n"));
+  else
+    fprintf_filtered (file, _("Large compressed sections are decompressed "
+			      "into files in \"%s\".\n"), value);
+}
+
+/* Return the directory in which to create the file that a compressed
+   section is decompressed into, or NULL if the section should be
+   decompressed into memory instead.  */
+
+static const char *
+decompressed_section_dir (void)
+{
+  const char *dir = decompressed_section_directory;
+
+  if (dir == NULL || *dir == '\0')
+    dir = index_cache_dir ();
+  if (dir == NULL)
+    return NULL;
+
+#ifdef __linux__
+  {
+    struct statfs st;
+
+    /* A file on tmpfs is held in memory and swap just like the
+       decompressed contents would be, so it gains nothing.  */
+    if (statfs (dir, &st) != 0 || st.f_type == TMPFS_MAGIC)
+      return NULL;
+  }
+#endif
+
+  return dir;
+}
+
+/* The size of the buffers used when decompressing a section.  */
+
+#define DECOMPRESS_CHUNK_SIZE (256 * 1024)
+
+/* Write LEN bytes of BUF to FD.  Return 0 on success, -1 on
+   failure.  */
+
+static int
+write_all (int fd, const gdb_byte *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = write (fd, buf, len);
+
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return -1;
+	}
+      buf += n;
+      len -= n;
+    }
+
+  return 0;
+}
+
+/* Decompress the compressed section SECTP of ABFD into an unlinked
+   temporary file in decompressed_section_dir, and map that file,
+   filling in DESCRIPTOR.  The
+   section is inflated a chunk at a time, so it is never held in
+   memory as a whole; once mapped, only the pages that are touched
+   become resident, and being backed by a file they can be reclaimed
+   by the kernel.  Return 1 on success, 0 if the caller should read
+   the section into memory instead.  */
+
+static int
+map_decompressed_section (bfd *abfd, asection *sectp,
+			  struct gdb_bfd_section_data *descriptor)
+{
+  int header_size, fd, zres, write_failed = 0, result = 0;
+  bfd_size_type size, remaining;
+  gdb_byte *in, *out;
+  const char *dir;
+  char *filename;
+  z_stream strm;
+  void *map;
+
+  if (sectp->compress_status != DECOMPRESS_SECTION_SIZED
+      || !bfd_is_section_compressed_with_header (abfd, sectp, &header_size,
+						 &size)
+      || header_size < 0
+      || size == 0)
+    return 0;
+
+  /* A .zdebug section starts with "ZLIB" and the 8-byte size.  */
+  if (header_size == 0)
+    header_size = 12;
+  if (sectp->compressed_size <= header_size)
+    return 0;
+  remaining = sectp->compressed_size - header_size;
+
+  dir = decompressed_section_dir ();
+  if (dir == NULL)
+    return 0;
+  filename = concat (dir, SLASH_STRING, "gdb-section-XXXXXX", (char *) NULL);
+  fd = mkstemp (filename);
+  if (fd >= 0)
+    unlink (filename);
+  xfree (filename);
+  if (fd < 0)
+    return 0;
+  fcntl (fd, F_SETFD, FD_CLOEXEC);
+
+  if (bfd_seek (abfd, sectp->filepos + header_size, SEEK_SET) != 0)
+    {
+      close (fd);
+      return 0;
+    }
+
+  in = (gdb_byte *) xmalloc (DECOMPRESS_CHUNK_SIZE);
+  out = (gdb_byte *) xmalloc (DECOMPRESS_CHUNK_SIZE);
+  memset (&strm, 0, sizeof (strm));
+  zres = inflateInit (&strm);
+  while (zres == Z_OK)
+    {
+      if (strm.avail_in == 0)
+	{
+	  bfd_size_type count = std::min (remaining,
+					  (bfd_size_type)
+					  DECOMPRESS_CHUNK_SIZE);
+
+	  if (count == 0 || bfd_bread (in, count, abfd) != count)
+	    break;
+	  remaining -= count;
+	  strm.next_in = in;
+	  strm.avail_in = count;
+	}
+
+      strm.next_out = out;
+      strm.avail_out = DECOMPRESS_CHUNK_SIZE;
+      zres = inflate (&strm, Z_NO_FLUSH);
+      if ((zres == Z_OK || zres == Z_STREAM_END)
+	  && write_all (fd, out,
+			DECOMPRESS_CHUNK_SIZE - strm.avail_out) != 0)
+	{
+	  write_failed = 1;
+	  break;
+	}
+    }
+  inflateEnd (&strm);
+  xfree (in);
+  xfree (out);
+
+  if (zres == Z_STREAM_END && !write_failed && strm.total_out == size)
+    {
+      map = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED)
+	{
+	  descriptor->size = size;
+	  descriptor->data = map;
+	  descriptor->map_addr = map;
+	  descriptor->map_len = size;
+	  result = 1;
+	}
+    }
+
+  close (fd);
+  return result;
+}
+
+#endif /* HAVE_MMAP */
+
 /* See gdb_bfd.h.  */
 
 const gdb_byte *
@@ -695,6 +885,9 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 	  memset (descriptor, 0, sizeof (*descriptor));
 	}
     }
+  else if (bfd_get_section_size (sectp) > 4 * getpagesize ()
+	   && map_decompressed_section (abfd, sectp, descriptor))
+    goto done;
 #endif /* HAVE_MMAP */
 
   /* Handle compressed sections, or ordinary uncompressed sections in
@@ -1025,4 +1218,21 @@ When non-zero, bfd cache specific debugging is enabled."),
 			     NULL,
 			     &show_bfd_cache_debug,
 			     &setdebuglist, &showdebuglist);
+
+#ifdef HAVE_MMAP
+  decompressed_section_directory = xstrdup ("");
+  add_setshow_optional_filename_cmd ("decompressed-section-directory",
+				     class_maintenance,
+				     &decompressed_section_directory, _("\
+Set the directory for decompressing large compressed sections."), _("\
+Show the directory for decompressing large compressed sections."), _("\
+Large compressed debug sections are decompressed into unlinked files\n\
+in this directory and mapped, instead of being read into memory.  When\n\
+empty, the index cache directory is used.  Sections are read into memory\n\
+if the directory does not exist or is on a tmpfs file system."),
+				     NULL,
+				     show_decompressed_section_directory,
+				     &maintenance_set_cmdlist,
+				     &maintenance_show_cmdlist);
+#endif
 }
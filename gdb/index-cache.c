@@ -0,0 +1,440 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "index-cache.h"
+#include "bfd.h"
+#include "build-id.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "filestuff.h"
+#include "filenames.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/* The suffix of the files in the cache.  */
+
+#define INDEX_CACHE_SUFFIX ".gdb-index"
+
+/* The value of "set index-cache enabled".  */
+
+static int index_cache_enabled = 0;
+
+/* The value of "set index-cache directory".  */
+
+static char *index_cache_directory;
+
+/* The value of "set index-cache size-limit", in megabytes.  -1 means
+   unlimited.  */
+
+static int index_cache_size_limit = 512;
+
+/* The value of "set debug index-cache".  */
+
+static unsigned int debug_index_cache = 0;
+
+/* Statistics, for "show index-cache stats".  */
+
+static unsigned int index_cache_hits;
+static unsigned int index_cache_misses;
+static unsigned int index_cache_stores;
+static unsigned int index_cache_evictions;
+
+static struct cmd_list_element *set_index_cache_list;
+static struct cmd_list_element *show_index_cache_list;
+
+/* See index-cache.h.  */
+
+int
+index_cache_enabled_p (void)
+{
+  return (index_cache_enabled
+	  && index_cache_directory != NULL
+	  && *index_cache_directory != '\0');
+}
+
+/* See index-cache.h.  */
+
+const char *
+index_cache_dir (void)
+{
+  if (index_cache_directory == NULL || *index_cache_directory == '\0')
+    return NULL;
+  return index_cache_directory;
+}
+
+/* Return the name of the cache file for BUILD_ID.  The result must
+   be xfree'd.  */
+
+static char *
+index_cache_file_name (const struct bfd_build_id *build_id)
+{
+  char *name, *p;
+  bfd_size_type i;
+
+  name = (char *) xmalloc (strlen (index_cache_directory)
+			   + strlen (SLASH_STRING)
+			   + 2 * build_id->size
+			   + strlen (INDEX_CACHE_SUFFIX) + 1);
+  p = name;
+  p += sprintf (p, "%s%s", index_cache_directory, SLASH_STRING);
+  for (i = 0; i < build_id->size; ++i)
+    p += sprintf (p, "%02x", (unsigned) build_id->data[i]);
+  strcpy (p, INDEX_CACHE_SUFFIX);
+
+  return name;
+}
+
+/* See index-cache.h.  */
+
+gdb_byte *
+index_cache_lookup (const struct bfd_build_id *build_id, ULONGEST *size)
+{
+  char *filename;
+  struct stat st;
+  gdb_byte *contents = NULL;
+  ULONGEST done;
+  int fd;
+
+  if (!index_cache_enabled_p () || build_id->size == 0)
+    return NULL;
+
+  filename = index_cache_file_name (build_id);
+  fd = gdb_open_cloexec (filename, O_RDONLY | O_BINARY, 0);
+  if (fd >= 0 && fstat (fd, &st) == 0 && st.st_size > 0)
+    {
+      contents = (gdb_byte *) xmalloc (st.st_size);
+      for (done = 0; done < st.st_size; )
+	{
+	  ssize_t n = read (fd, contents + done, st.st_size - done);
+
+	  if (n <= 0)
+	    break;
+	  done += n;
+	}
+      if (done != st.st_size)
+	{
+	  xfree (contents);
+	  contents = NULL;
+	}
+      else
+	*size = st.st_size;
+    }
+  if (fd >= 0)
+    close (fd);
+
+  if (contents != NULL)
+    {
+      ++index_cache_hits;
+      /* Eviction goes by modification time, so mark the file as
+	 recently used.  */
+      utime (filename, NULL);
+      if (debug_index_cache)
+	fprintf_unfiltered (gdb_stdlog, "index-cache: using %s\n", filename);
+    }
+  else
+    {
+      ++index_cache_misses;
+      if (debug_index_cache)
+	fprintf_unfiltered (gdb_stdlog, "index-cache: no usable %s\n",
+			    filename);
+    }
+
+  xfree (filename);
+  return contents;
+}
+
+/* Create the directory DIR, and any missing parents of it.  Throw an
+   error on failure.  */
+
+static void
+make_index_cache_directory (const char *dir)
+{
+  std::string path (dir);
+  size_t pos;
+
+  for (pos = 1; pos <= path.size (); ++pos)
+    if (pos == path.size () || IS_DIR_SEPARATOR (path[pos]))
+      {
+	std::string prefix = path.substr (0, pos);
+
+	if (mkdir (prefix.c_str (), 0700) != 0 && errno != EEXIST)
+	  perror_with_name (prefix.c_str ());
+      }
+}
+
+/* A file in the cache, for trim_index_cache.  */
+
+struct index_cache_entry
+{
+  std::string name;
+  time_t mtime;
+  off_t size;
+};
+
+/* Return true if entry A was used less recently than entry B.  */
+
+static bool
+index_cache_entry_older (const index_cache_entry &a,
+			 const index_cache_entry &b)
+{
+  return a.mtime < b.mtime;
+}
+
+/* Remove the least recently used files from the cache until it fits
+   within its size limit.  KEEP, the file just stored, is never
+   removed.  */
+
+static void
+trim_index_cache (const char *keep)
+{
+  std::vector<index_cache_entry> entries;
+  ULONGEST total = 0, limit;
+  size_t suffix_len = strlen (INDEX_CACHE_SUFFIX);
+  struct dirent *ent;
+  DIR *dir;
+  size_t i;
+
+  if (index_cache_size_limit == -1)
+    return;
+  limit = (ULONGEST) index_cache_size_limit * 1024 * 1024;
+
+  dir = opendir (index_cache_directory);
+  if (dir == NULL)
+    return;
+  while ((ent = readdir (dir)) != NULL)
+    {
+      size_t len = strlen (ent->d_name);
+      index_cache_entry entry;
+      struct stat st;
+
+      if (len <= suffix_len
+	  || strcmp (ent->d_name + len - suffix_len, INDEX_CACHE_SUFFIX) != 0)
+	continue;
+
+      entry.name = std::string (index_cache_directory) + SLASH_STRING
+		   + ent->d_name;
+      if (stat (entry.name.c_str (), &st) != 0 || !S_ISREG (st.st_mode))
+	continue;
+      entry.mtime = st.st_mtime;
+      entry.size = st.st_size;
+      total += st.st_size;
+      entries.push_back (entry);
+    }
+  closedir (dir);
+
+  if (total <= limit)
+    return;
+
+  std::sort (entries.begin (), entries.end (), index_cache_entry_older);
+  for (i = 0; i < entries.size () && total > limit; ++i)
+    {
+      if (entries[i].name == keep)
+	continue;
+      if (unlink (entries[i].name.c_str ()) == 0)
+	{
+	  total -= entries[i].size;
+	  ++index_cache_evictions;
+	  if (debug_index_cache)
+	    fprintf_unfiltered (gdb_stdlog, "index-cache: evicted %s\n",
+				entries[i].name.c_str ());
+	}
+    }
+}
+
+/* See index-cache.h.  */
+
+void
+index_cache_store (const struct bfd_build_id *build_id,
+		   void (*write_fn) (const char *filename, void *data),
+		   void *data)
+{
+  char *filename, *temp_filename;
+  struct cleanup *cleanup;
+
+  if (!index_cache_enabled_p () || build_id->size == 0)
+    return;
+
+  filename = index_cache_file_name (build_id);
+  cleanup = make_cleanup (xfree, filename);
+  temp_filename = xstrprintf ("%s.tmp%ld", filename, (long) getpid ());
+  make_cleanup (xfree, temp_filename);
+
+  TRY
+    {
+      make_index_cache_directory (index_cache_directory);
+
+      /* Write to a temporary file and rename it into place, so that
+	 other GDBs never see a partially written index.  */
+      write_fn (temp_filename, data);
+      if (rename (temp_filename, filename) != 0)
+	{
+	  int save_errno = errno;
+
+	  unlink (temp_filename);
+	  errno = save_errno;
+	  perror_with_name (filename);
+	}
+
+      ++index_cache_stores;
+      if (debug_index_cache)
+	fprintf_unfiltered (gdb_stdlog, "index-cache: stored %s\n", filename);
+
+      trim_index_cache (filename);
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      if (debug_index_cache)
+	exception_fprintf (gdb_stdlog, except,
+			   _("index-cache: could not store %s: "),
+			   filename);
+    }
+  END_CATCH
+
+  do_cleanups (cleanup);
+}
+
+/* Implement "set index-cache".  */
+
+static void
+set_index_cache_command (char *arg, int from_tty)
+{
+  printf_unfiltered (_("\
+\"set index-cache\" must be followed by an appropriate subcommand.\n"));
+  help_list (set_index_cache_list, "set index-cache ", all_commands,
+	     gdb_stdout);
+}
+
+/* Implement "show index-cache".  */
+
+static void
+show_index_cache_command (char *arg, int from_tty)
+{
+  cmd_show_list (show_index_cache_list, from_tty, "");
+}
+
+/* Implement "show index-cache size-limit".  */
+
+static void
+show_index_cache_size_limit (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  if (index_cache_size_limit == -1)
+    fprintf_filtered (file, _("The index cache size is unlimited.\n"));
+  else
+    fprintf_filtered (file, _("The index cache size limit is %s "
+			      "megabytes.\n"), value);
+}
+
+/* Implement "show index-cache stats".  */
+
+static void
+show_index_cache_stats_command (char *arg, int from_tty)
+{
+  printf_filtered (_("  Cache hits (this session): %u\n"),
+		   index_cache_hits);
+  printf_filtered (_("Cache misses (this session): %u\n"),
+		   index_cache_misses);
+  printf_filtered (_("Cache stores (this session): %u\n"),
+		   index_cache_stores);
+  printf_filtered (_("   Evictions (this session): %u\n"),
+		   index_cache_evictions);
+}
+
+/* Return the default cache directory, or NULL if there is no
+   sensible one.  */
+
+static char *
+default_index_cache_directory (void)
+{
+  const char *dir = getenv ("XDG_CACHE_HOME");
+
+  if (dir != NULL && IS_ABSOLUTE_PATH (dir))
+    return concat (dir, SLASH_STRING, "gdb", (char *) NULL);
+
+  dir = getenv ("HOME");
+  if (dir != NULL && *dir != '\0')
+    return concat (dir, SLASH_STRING, ".cache", SLASH_STRING, "gdb",
+		   (char *) NULL);
+
+  return NULL;
+}
+
+extern initialize_file_ftype _initialize_index_cache; /* -Wmissing-prototypes */
+
+void
+_initialize_index_cache (void)
+{
+  index_cache_directory = default_index_cache_directory ();
+
+  add_prefix_cmd ("index-cache", class_files, set_index_cache_command, _("\
+Set index-cache options."),
+		  &set_index_cache_list, "set index-cache ",
+		  0/*allow-unknown*/, &setlist);
+  add_prefix_cmd ("index-cache", class_files, show_index_cache_command, _("\
+Show index-cache options."),
+		  &show_index_cache_list, "show index-cache ",
+		  0/*allow-unknown*/, &showlist);
+
+  add_setshow_boolean_cmd ("enabled", class_files, &index_cache_enabled, _("\
+Set whether GDB caches the indexes it creates."), _("\
+Show whether GDB caches the indexes it creates."), _("\
+When on, GDB saves the index it computes for a file with a build-id\n\
+but no index of its own in the index cache directory, and reads it\n\
+from there the next time the file is loaded."),
+			   NULL, NULL,
+			   &set_index_cache_list, &show_index_cache_list);
+
+  add_setshow_filename_cmd ("directory", class_files, &index_cache_directory,
+			    _("\
+Set the directory of the index cache."), _("\
+Show the directory of the index cache."), _("\
+The default is $XDG_CACHE_HOME/gdb, or $HOME/.cache/gdb."),
+			    NULL, NULL,
+			    &set_index_cache_list, &show_index_cache_list);
+
+  add_setshow_zuinteger_unlimited_cmd ("size-limit", class_files,
+				       &index_cache_size_limit, _("\
+Set the size limit of the index cache, in megabytes."), _("\
+Show the size limit of the index cache, in megabytes."), _("\
+When a new index makes the cache exceed this size, the least recently\n\
+used indexes are removed.  \"unlimited\" disables the limit."),
+				       NULL, show_index_cache_size_limit,
+				       &set_index_cache_list,
+				       &show_index_cache_list);
+
+  add_cmd ("stats", class_files, show_index_cache_stats_command, _("\
+Show statistics about the use of the index cache."),
+	   &show_index_cache_list);
+
+  add_setshow_zuinteger_cmd ("index-cache", class_maintenance,
+			     &debug_index_cache, _("\
+Set display of index cache debugging info."), _("\
+Show display of index cache debugging info."), _("\
+When non-zero, GDB reports what it reads from and writes to the\n\
+index cache."),
+			     NULL, NULL,
+			     &setdebuglist, &showdebuglist);
+}
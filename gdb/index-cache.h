@@ -0,0 +1,57 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INDEX_CACHE_H
+#define INDEX_CACHE_H
+
+struct bfd_build_id;
+
+/* The index cache keeps the indexes GDB computes for objfiles that
+   have no index of their own in a directory, one file per build-id,
+   so that later sessions can read the index instead of the DWARF.
+   The cache is controlled by the "set index-cache" commands.  */
+
+/* Return nonzero if the index cache is enabled.  */
+
+extern int index_cache_enabled_p (void);
+
+/* Return the directory of the index cache, or NULL if there is none.
+   The directory need not exist.  */
+
+extern const char *index_cache_dir (void);
+
+/* Look up the cached index for BUILD_ID.  If there is one, return its
+   contents, which the caller must xfree, and set *SIZE to its size.
+   Otherwise return NULL.  */
+
+extern gdb_byte *index_cache_lookup (const struct bfd_build_id *build_id,
+				     ULONGEST *size);
+
+/* Store an index for BUILD_ID in the cache.  WRITE_FN (FILENAME, DATA)
+   is called to write the index to the file FILENAME, and may throw an
+   error to abandon the store.  The cache is then trimmed to its size
+   limit.  Errors are not propagated, since the cache is only an
+   optimization.  */
+
+extern void index_cache_store (const struct bfd_build_id *build_id,
+			       void (*write_fn) (const char *filename,
+						 void *data),
+			       void *data);
+
+#endif /* INDEX_CACHE_H */
@@ -51,6 +51,7 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include "parallel-for.h"
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -62,8 +63,18 @@ struct msym_bunch
   {
     struct msym_bunch *next;
     struct minimal_symbol contents[BUNCH_SIZE];
+
+    /* For symbols whose names are deferred, whether the name was
+       copied into a temporary xmalloc'd string.  */
+    bool name_copied[BUNCH_SIZE];
   };
 
+/* The minimum number of minimal symbols for which install demangles
+   names on worker threads.  Below it, starting the threads costs more
+   than it saves.  */
+
+#define MIN_PARALLEL_DEMANGLE_COUNT 1024
+
 /* See minsyms.h.  */
 
 unsigned int
@@ -95,37 +106,117 @@ msymbol_hash (const char *string)
   return hash;
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym hash table, TABLE.  */
+/* Return the slot of a minsym hash table with SIZE slots at which the
+   search for a name with hash HASH starts.  The low bits of the name
+   hashes are poorly distributed, so mix them first.  */
+
+static inline unsigned int
+minsym_hash_start (unsigned int hash, unsigned int size)
+{
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  return hash & (size - 1);
+}
+
+/* Allocate the slots of TABLE, an objfile's minsym hash table, on
+   OBSTACK, making room for COUNT symbols.  The table is kept at most
+   three quarters full, so that probe sequences stay short and always
+   end at an empty slot.  */
+
 static void
-add_minsym_to_hash_table (struct minimal_symbol *sym,
-			  struct minimal_symbol **table)
+init_minsym_hash_table (struct minsym_hash_table *table,
+			struct obstack *obstack, unsigned int count)
 {
-  if (sym->hash_next == NULL)
-    {
-      unsigned int hash
-	= msymbol_hash (MSYMBOL_LINKAGE_NAME (sym)) % MINIMAL_SYMBOL_HASH_SIZE;
+  table->slots = NULL;
+  table->size = 0;
+  table->count = 0;
+  table->max_probes = 0;
 
-      sym->hash_next = table[hash];
-      table[hash] = sym;
-    }
+  if (count == 0)
+    return;
+
+  table->size = 16;
+  while (table->size / 4 * 3 < count)
+    table->size *= 2;
+  table->slots = XOBNEWVEC (obstack, struct minsym_hash_slot, table->size);
+  memset (table->slots, 0, table->size * sizeof (struct minsym_hash_slot));
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym demangled hash table,
-   TABLE.  */
+/* Add the minimal symbol SYM, whose name hashes to HASH, to an objfile's
+   minsym hash table, TABLE.  Symbols with the same hash are found by
+   lookups in the order in which they were added.  */
+
 static void
-add_minsym_to_demangled_hash_table (struct minimal_symbol *sym,
-                                  struct minimal_symbol **table)
+add_minsym_to_hash_table (struct minimal_symbol *sym, unsigned int hash,
+			  struct minsym_hash_table *table)
 {
-  if (sym->demangled_hash_next == NULL)
+  unsigned int slot = minsym_hash_start (hash, table->size);
+  unsigned int probes = 1;
+
+  gdb_assert (table->count < table->size);
+
+  while (table->slots[slot].msymbol != NULL)
     {
-      unsigned int hash = msymbol_hash_iw (MSYMBOL_SEARCH_NAME (sym))
-	% MINIMAL_SYMBOL_HASH_SIZE;
+      slot = (slot + 1) & (table->size - 1);
+      ++probes;
+    }
+
+  table->slots[slot].hash = hash;
+  table->slots[slot].msymbol = sym;
+  ++table->count;
+  if (probes > table->max_probes)
+    table->max_probes = probes;
+}
 
-      sym->demangled_hash_next = table[hash];
-      table[hash] = sym;
+/* Scan TABLE from *SLOT for a minimal symbol whose name hashes to HASH.
+   Return the symbol and leave *SLOT at its slot, or return NULL if the
+   probe sequence ends first.  */
+
+static struct minimal_symbol *
+minsym_hash_scan (struct minsym_hash_table *table, unsigned int hash,
+		  unsigned int *slot)
+{
+  for (;;)
+    {
+      const struct minsym_hash_slot *entry = &table->slots[*slot];
+
+      ++table->probes;
+      if (entry->msymbol == NULL)
+	return NULL;
+      if (entry->hash == hash)
+	return entry->msymbol;
+      *slot = (*slot + 1) & (table->size - 1);
     }
 }
 
+/* Return the first minimal symbol in TABLE whose name hashes to HASH,
+   or NULL if there is none.  *SLOT is set so that minsym_hash_next can
+   continue the search.  The caller must still compare the names.  */
+
+static struct minimal_symbol *
+minsym_hash_first (struct minsym_hash_table *table, unsigned int hash,
+		   unsigned int *slot)
+{
+  if (table->size == 0)
+    return NULL;
+
+  ++table->lookups;
+  *slot = minsym_hash_start (hash, table->size);
+  return minsym_hash_scan (table, hash, slot);
+}
+
+/* Return the next minimal symbol in TABLE after the one at *SLOT whose
+   name hashes to HASH, or NULL if there are no more.  */
+
+static struct minimal_symbol *
+minsym_hash_next (struct minsym_hash_table *table, unsigned int hash,
+		  unsigned int *slot)
+{
+  *slot = (*slot + 1) & (table->size - 1);
+  return minsym_hash_scan (table, hash, slot);
+}
+
 /* Look through all the current minimal symbol tables and find the
    first minimal symbol that matches NAME.  If OBJF is non-NULL, limit
    the search to that objfile.  If SFILE is non-NULL, the only file-scope
@@ -155,8 +246,8 @@ lookup_minimal_symbol (const char *name, const char *sfile,
   struct bound_minimal_symbol found_file_symbol = { NULL, NULL };
   struct bound_minimal_symbol trampoline_symbol = { NULL, NULL };
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
-  unsigned int dem_hash = msymbol_hash_iw (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
+  unsigned int dem_hash = msymbol_hash_iw (name);
 
   const char *modified_name = name;
 
@@ -198,11 +289,22 @@ lookup_minimal_symbol (const char *name, const char *sfile,
 
         for (pass = 1; pass <= 2 && found_symbol.minsym == NULL; pass++)
 	    {
-            /* Select hash list according to pass.  */
+	    struct minsym_hash_table *table;
+	    unsigned int table_hash, slot;
+
+            /* Select hash table according to pass.  */
             if (pass == 1)
-              msymbol = objfile->per_bfd->msymbol_hash[hash];
+	      {
+		table = &objfile->per_bfd->msymbol_hash;
+		table_hash = hash;
+	      }
             else
-              msymbol = objfile->per_bfd->msymbol_demangled_hash[dem_hash];
+	      {
+		table = &objfile->per_bfd->msymbol_demangled_hash;
+		table_hash = dem_hash;
+	      }
+
+	    msymbol = minsym_hash_first (table, table_hash, &slot);
 
             while (msymbol != NULL && found_symbol.minsym == NULL)
 		{
@@ -260,11 +362,8 @@ lookup_minimal_symbol (const char *name, const char *sfile,
                       }
 		    }
 
-                /* Find the next symbol on the hash chain.  */
-                if (pass == 1)
-                  msymbol = msymbol->hash_next;
-                else
-                  msymbol = msymbol->demangled_hash_next;
+                /* Find the next symbol with the same hash.  */
+		msymbol = minsym_hash_next (table, table_hash, &slot);
 		}
 	    }
 	}
@@ -342,29 +441,121 @@ iterate_over_minimal_symbols (struct objfile *objf, const char *name,
 						void *),
 			      void *user_data)
 {
-  unsigned int hash;
+  unsigned int hash, slot;
+  struct minsym_hash_table *table;
   struct minimal_symbol *iter;
   int (*cmp) (const char *, const char *);
 
   /* The first pass is over the ordinary hash table.  */
-  hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
-  iter = objf->per_bfd->msymbol_hash[hash];
+  hash = msymbol_hash (name);
+  table = &objf->per_bfd->msymbol_hash;
+  iter = minsym_hash_first (table, hash, &slot);
   cmp = (case_sensitivity == case_sensitive_on ? strcmp : strcasecmp);
   while (iter)
     {
       if (cmp (MSYMBOL_LINKAGE_NAME (iter), name) == 0)
 	(*callback) (iter, user_data);
-      iter = iter->hash_next;
+      iter = minsym_hash_next (table, hash, &slot);
     }
 
   /* The second pass is over the demangled table.  */
-  hash = msymbol_hash_iw (name) % MINIMAL_SYMBOL_HASH_SIZE;
-  iter = objf->per_bfd->msymbol_demangled_hash[hash];
+  hash = msymbol_hash_iw (name);
+  table = &objf->per_bfd->msymbol_demangled_hash;
+  iter = minsym_hash_first (table, hash, &slot);
   while (iter)
     {
       if (MSYMBOL_MATCHES_SEARCH_NAME (iter, name))
 	(*callback) (iter, user_data);
-      iter = iter->demangled_hash_next;
+      iter = minsym_hash_next (table, hash, &slot);
+    }
+}
+
+/* Compare two minimal symbols, given by pointers to pointers to them,
+   by natural name, for qsort.  */
+
+static int
+compare_minimal_symbols_by_name (const void *fn1p, const void *fn2p)
+{
+  const struct minimal_symbol *fn1
+    = *(const struct minimal_symbol * const *) fn1p;
+  const struct minimal_symbol *fn2
+    = *(const struct minimal_symbol * const *) fn2p;
+
+  return strcmp (MSYMBOL_NATURAL_NAME (fn1), MSYMBOL_NATURAL_NAME (fn2));
+}
+
+/* Return the minimal symbols of OBJF sorted by natural name, sorting
+   them the first time.  */
+
+static struct minimal_symbol **
+minimal_symbols_by_name (struct objfile *objf)
+{
+  struct objfile_per_bfd_storage *per_bfd = objf->per_bfd;
+
+  if (per_bfd->msymbols_by_name == NULL)
+    {
+      int i;
+
+      per_bfd->msymbols_by_name
+	= XOBNEWVEC (&per_bfd->storage_obstack, struct minimal_symbol *,
+		     per_bfd->minimal_symbol_count);
+      for (i = 0; i < per_bfd->minimal_symbol_count; ++i)
+	per_bfd->msymbols_by_name[i] = &per_bfd->msymbols[i];
+      qsort (per_bfd->msymbols_by_name, per_bfd->minimal_symbol_count,
+	     sizeof (struct minimal_symbol *),
+	     compare_minimal_symbols_by_name);
+    }
+
+  return per_bfd->msymbols_by_name;
+}
+
+/* See minsyms.h.  */
+
+void
+iterate_over_minimal_symbols_with_prefix
+  (struct objfile *objf, const char *prefix, size_t len,
+   void (*callback) (struct minimal_symbol *, void *),
+   void *user_data)
+{
+  struct minimal_symbol **sorted;
+  int lo, hi;
+
+  if (objf->per_bfd->minimal_symbol_count == 0)
+    return;
+
+  /* The names are sorted case-sensitively, so without case
+     sensitivity every symbol has to be looked at.  */
+  if (case_sensitivity != case_sensitive_on)
+    {
+      struct minimal_symbol *msymbol;
+
+      ALL_OBJFILE_MSYMBOLS (objf, msymbol)
+	if (strncasecmp (MSYMBOL_NATURAL_NAME (msymbol), prefix, len) == 0)
+	  (*callback) (msymbol, user_data);
+      return;
+    }
+
+  sorted = minimal_symbols_by_name (objf);
+
+  /* Find the first name that is not less than the prefix; the names
+     that begin with the prefix follow it.  */
+  lo = 0;
+  hi = objf->per_bfd->minimal_symbol_count;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (strncmp (MSYMBOL_NATURAL_NAME (sorted[mid]), prefix, len) < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  for (; lo < objf->per_bfd->minimal_symbol_count; ++lo)
+    {
+      if (strncmp (MSYMBOL_NATURAL_NAME (sorted[lo]), prefix, len) != 0)
+	break;
+      (*callback) (sorted[lo], user_data);
     }
 }
 
@@ -378,7 +569,7 @@ lookup_minimal_symbol_text (const char *name, struct objfile *objf)
   struct bound_minimal_symbol found_symbol = { NULL, NULL };
   struct bound_minimal_symbol found_file_symbol = { NULL, NULL };
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL && found_symbol.minsym == NULL;
@@ -387,9 +578,12 @@ lookup_minimal_symbol_text (const char *name, struct objfile *objf)
       if (objf == NULL || objf == objfile
 	  || objf == objfile->separate_debug_objfile_backlink)
 	{
-	  for (msymbol = objfile->per_bfd->msymbol_hash[hash];
+	  struct minsym_hash_table *table = &objfile->per_bfd->msymbol_hash;
+	  unsigned int slot;
+
+	  for (msymbol = minsym_hash_first (table, hash, &slot);
 	       msymbol != NULL && found_symbol.minsym == NULL;
-	       msymbol = msymbol->hash_next)
+	       msymbol = minsym_hash_next (table, hash, &slot))
 	    {
 	      if (strcmp (MSYMBOL_LINKAGE_NAME (msymbol), name) == 0 &&
 		  (MSYMBOL_TYPE (msymbol) == mst_text
@@ -428,7 +622,7 @@ lookup_minimal_symbol_by_pc_name (CORE_ADDR pc, const char *name,
   struct objfile *objfile;
   struct minimal_symbol *msymbol;
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL;
@@ -437,9 +631,12 @@ lookup_minimal_symbol_by_pc_name (CORE_ADDR pc, const char *name,
       if (objf == NULL || objf == objfile
 	  || objf == objfile->separate_debug_objfile_backlink)
 	{
-	  for (msymbol = objfile->per_bfd->msymbol_hash[hash];
+	  struct minsym_hash_table *table = &objfile->per_bfd->msymbol_hash;
+	  unsigned int slot;
+
+	  for (msymbol = minsym_hash_first (table, hash, &slot);
 	       msymbol != NULL;
-	       msymbol = msymbol->hash_next)
+	       msymbol = minsym_hash_next (table, hash, &slot))
 	    {
 	      if (MSYMBOL_VALUE_ADDRESS (objfile, msymbol) == pc
 		  && strcmp (MSYMBOL_LINKAGE_NAME (msymbol), name) == 0)
@@ -461,7 +658,7 @@ lookup_minimal_symbol_solib_trampoline (const char *name,
   struct minimal_symbol *msymbol;
   struct bound_minimal_symbol found_symbol = { NULL, NULL };
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL;
@@ -470,9 +667,12 @@ lookup_minimal_symbol_solib_trampoline (const char *name,
       if (objf == NULL || objf == objfile
 	  || objf == objfile->separate_debug_objfile_backlink)
 	{
-	  for (msymbol = objfile->per_bfd->msymbol_hash[hash];
+	  struct minsym_hash_table *table = &objfile->per_bfd->msymbol_hash;
+	  unsigned int slot;
+
+	  for (msymbol = minsym_hash_first (table, hash, &slot);
 	       msymbol != NULL;
-	       msymbol = msymbol->hash_next)
+	       msymbol = minsym_hash_next (table, hash, &slot))
 	    {
 	      if (strcmp (MSYMBOL_LINKAGE_NAME (msymbol), name) == 0 &&
 		  MSYMBOL_TYPE (msymbol) == mst_solib_trampoline)
@@ -864,15 +1064,17 @@ lookup_minimal_symbol_and_objfile (const char *name)
 {
   struct bound_minimal_symbol result;
   struct objfile *objfile;
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   ALL_OBJFILES (objfile)
     {
+      struct minsym_hash_table *table = &objfile->per_bfd->msymbol_hash;
       struct minimal_symbol *msym;
+      unsigned int slot;
 
-      for (msym = objfile->per_bfd->msymbol_hash[hash];
+      for (msym = minsym_hash_first (table, hash, &slot);
 	   msym != NULL;
-	   msym = msym->hash_next)
+	   msym = minsym_hash_next (table, hash, &slot))
 	{
 	  if (strcmp (MSYMBOL_LINKAGE_NAME (msym), name) == 0)
 	    {
@@ -910,7 +1112,8 @@ minimal_symbol_reader::minimal_symbol_reader (struct objfile *obj)
      first call to save a minimal symbol to allocate the memory for
      the first bunch.  */
   m_msym_bunch_index (BUNCH_SIZE),
-  m_msym_count (0)
+  m_msym_count (0),
+  m_defer_names (false)
 {
 }
 
@@ -928,6 +1131,13 @@ minimal_symbol_reader::~minimal_symbol_reader ()
 
   while (m_msym_bunch != NULL)
     {
+      int i;
+
+      /* Free the names that install did not get to.  */
+      for (i = 0; i < BUNCH_SIZE; i++)
+	if (m_msym_bunch->name_copied[i])
+	  xfree ((char *) m_msym_bunch->contents[i].mginfo.name);
+
       next = m_msym_bunch->next;
       xfree (m_msym_bunch);
       m_msym_bunch = next;
@@ -1007,7 +1217,26 @@ minimal_symbol_reader::record_full (const char *name, int name_len,
   msymbol = &m_msym_bunch->contents[m_msym_bunch_index];
   MSYMBOL_SET_LANGUAGE (msymbol, language_auto,
 			&m_objfile->per_bfd->storage_obstack);
-  MSYMBOL_SET_NAMES (msymbol, name, name_len, copy_name, m_objfile);
+  if (m_defer_names && !m_objfile->per_bfd->minsyms_read)
+    {
+      /* Keep a NUL-terminated name around for install.  */
+      if (copy_name || name[name_len] != '\0')
+	{
+	  char *copy = (char *) xmalloc (name_len + 1);
+
+	  memcpy (copy, name, name_len);
+	  copy[name_len] = '\0';
+	  msymbol->mginfo.name = copy;
+	  m_msym_bunch->name_copied[m_msym_bunch_index] = true;
+	}
+      else
+	{
+	  msymbol->mginfo.name = name;
+	  m_msym_bunch->name_copied[m_msym_bunch_index] = false;
+	}
+    }
+  else
+    MSYMBOL_SET_NAMES (msymbol, name, name_len, copy_name, m_objfile);
 
   SET_MSYMBOL_VALUE_ADDRESS (msymbol, address);
   MSYMBOL_SECTION (msymbol) = section;
@@ -1019,11 +1248,6 @@ minimal_symbol_reader::record_full (const char *name, int name_len,
      as it would also set the has_size flag.  */
   msymbol->size = 0;
 
-  /* The hash pointers must be cleared! If they're not,
-     add_minsym_to_hash_table will NOT add this msymbol to the hash table.  */
-  msymbol->hash_next = NULL;
-  msymbol->demangled_hash_next = NULL;
-
   /* If we already read minimal symbols for this objfile, then don't
      ever allocate a new one.  */
   if (!m_objfile->per_bfd->minsyms_read)
@@ -1149,32 +1373,182 @@ compact_minimal_symbols (struct minimal_symbol *msymbol, int mcount,
 static void
 build_minimal_symbol_hash_tables (struct objfile *objfile)
 {
+  struct objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
   int i;
+  unsigned int demangled_count;
   struct minimal_symbol *msym;
 
-  /* Clear the hash tables.  */
-  for (i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
-    {
-      objfile->per_bfd->msymbol_hash[i] = 0;
-      objfile->per_bfd->msymbol_demangled_hash[i] = 0;
-    }
-
-  /* Now, (re)insert the actual entries.  */
-  for ((i = objfile->per_bfd->minimal_symbol_count,
-	msym = objfile->per_bfd->msymbols);
+  /* Size the tables from the number of symbols that go in each.  */
+  demangled_count = 0;
+  for ((i = per_bfd->minimal_symbol_count, msym = per_bfd->msymbols);
        i > 0;
        i--, msym++)
+    if (MSYMBOL_SEARCH_NAME (msym) != MSYMBOL_LINKAGE_NAME (msym))
+      ++demangled_count;
+
+  /* The table sorted by name is rebuilt when needed.  */
+  per_bfd->msymbols_by_name = NULL;
+
+  init_minsym_hash_table (&per_bfd->msymbol_hash,
+			  &per_bfd->storage_obstack,
+			  per_bfd->minimal_symbol_count);
+  init_minsym_hash_table (&per_bfd->msymbol_demangled_hash,
+			  &per_bfd->storage_obstack, demangled_count);
+
+  /* Now, (re)insert the actual entries.  Lookups have always seen
+     symbols with the same name from the end of the table backwards,
+     so insert them in that order.  */
+  for ((i = per_bfd->minimal_symbol_count,
+	msym = per_bfd->msymbols + per_bfd->minimal_symbol_count - 1);
+       i > 0;
+       i--, msym--)
     {
-      msym->hash_next = 0;
-      add_minsym_to_hash_table (msym, objfile->per_bfd->msymbol_hash);
+      add_minsym_to_hash_table (msym,
+				msymbol_hash (MSYMBOL_LINKAGE_NAME (msym)),
+				&per_bfd->msymbol_hash);
 
-      msym->demangled_hash_next = 0;
       if (MSYMBOL_SEARCH_NAME (msym) != MSYMBOL_LINKAGE_NAME (msym))
-	add_minsym_to_demangled_hash_table (msym,
-                                            objfile->per_bfd->msymbol_demangled_hash);
+	add_minsym_to_hash_table (msym,
+				  msymbol_hash_iw (MSYMBOL_SEARCH_NAME (msym)),
+				  &per_bfd->msymbol_demangled_hash);
     }
 }
 
+/* Print the statistics for TABLE, an objfile's minsym hash table
+   described by WHAT.  */
+
+static void
+print_minsym_hash_table_statistics (const struct minsym_hash_table *table,
+				    const char *what)
+{
+  printf_filtered (_("  %s: %u symbols in %u slots, "
+		     "longest probe sequence %u\n"),
+		   what, table->count, table->size, table->max_probes);
+  if (table->lookups > 0)
+    printf_filtered (_("  %s lookups: %s, slots probed: %s "
+		       "(%.2f per lookup)\n"),
+		     what, pulongest (table->lookups),
+		     pulongest (table->probes),
+		     (double) table->probes / table->lookups);
+}
+
+/* See minsyms.h.  */
+
+void
+print_minimal_symbol_hash_statistics (struct objfile *objfile)
+{
+  print_minsym_hash_table_statistics (&objfile->per_bfd->msymbol_hash,
+				      _("Minimal symbol hash table"));
+  print_minsym_hash_table_statistics
+    (&objfile->per_bfd->msymbol_demangled_hash,
+     _("Minimal symbol demangled hash table"));
+}
+
+/* A minimal symbol whose name is set by install, and the result of
+   demangling it.  */
+
+struct deferred_msym_name
+{
+  struct minimal_symbol *msymbol;
+
+  /* Whether the name is a temporary copy.  */
+  bool *name_copied;
+
+  /* What symbol_find_demangled_name returned, and the language it
+     chose.  */
+  char *demangled;
+  enum language language;
+
+  /* Whether the name still has to be demangled, because the demangler
+     crashed or no worker thread was used.  */
+  bool crashed;
+};
+
+/* Demangle the name of the Ith symbol of DATA, an array of struct
+   deferred_msym_name.  This runs on worker threads.  */
+
+static void
+demangle_deferred_msym_name (unsigned int i, void *data)
+{
+  struct deferred_msym_name *d = &((struct deferred_msym_name *) data)[i];
+  /* symbol_find_demangled_name may change the language of the symbol,
+     which must only happen when its name is set.  */
+  struct general_symbol_info info = d->msymbol->mginfo;
+  unsigned int crashes = worker_demangler_crashes;
+
+  d->demangled = symbol_find_demangled_name (&info, info.name);
+  d->language = info.language;
+  d->crashed = worker_demangler_crashes != crashes;
+}
+
+/* Set the names of the COUNT minimal symbols of OBJFILE in BUNCHES,
+   whose names were deferred.  NEWEST_COUNT is the number of symbols
+   in the first, newest, bunch.  The names are set in the order in
+   which the symbols were recorded, which, since demangled names are
+   shared, is what decides their languages.  */
+
+static void
+set_deferred_msym_names (struct objfile *objfile, struct msym_bunch *bunches,
+			 int newest_count, int count)
+{
+  struct deferred_msym_name *names;
+  struct msym_bunch *bunch;
+  int n, bindex, bunch_count;
+
+  if (count == 0)
+    return;
+
+  /* The bunches are newest first, so fill the array from its end.  */
+  names = XCNEWVEC (struct deferred_msym_name, count);
+  n = count;
+  bunch_count = newest_count;
+  for (bunch = bunches; bunch != NULL; bunch = bunch->next)
+    {
+      for (bindex = bunch_count - 1; bindex >= 0; bindex--)
+	{
+	  --n;
+	  names[n].msymbol = &bunch->contents[bindex];
+	  names[n].name_copied = &bunch->name_copied[bindex];
+	}
+      bunch_count = BUNCH_SIZE;
+    }
+  gdb_assert (n == 0);
+
+  if (parallel_for_thread_count () > 1
+      && count >= MIN_PARALLEL_DEMANGLE_COUNT)
+    parallel_for_demangling (count, demangle_deferred_msym_name, names);
+  else
+    {
+      for (n = 0; n < count; n++)
+	names[n].crashed = true;
+    }
+
+  for (n = 0; n < count; n++)
+    {
+      struct deferred_msym_name *d = &names[n];
+      const char *name = d->msymbol->mginfo.name;
+      int copy_name = *d->name_copied;
+
+      /* Demangling here also reports a crash of the demangler as
+	 usual.  */
+      if (d->crashed)
+	MSYMBOL_SET_NAMES (d->msymbol, name, strlen (name), copy_name,
+			   objfile);
+      else
+	symbol_set_names_demangled (&d->msymbol->mginfo, name, strlen (name),
+				    copy_name, objfile, d->language,
+				    d->demangled);
+
+      if (copy_name)
+	{
+	  xfree ((char *) name);
+	  *d->name_copied = false;
+	}
+    }
+
+  xfree (names);
+}
+
 /* Add the minimal symbols in the existing bunches to the objfile's official
    minimal symbol table.  In most cases there is no minimal symbol table yet
    for this objfile, and the existing bunches are used to create one.  Once
@@ -1219,6 +1593,10 @@ minimal_symbol_reader::install ()
 			      m_msym_count, objfile_name (m_objfile));
 	}
 
+      if (m_defer_names)
+	set_deferred_msym_names (m_objfile, m_msym_bunch, m_msym_bunch_index,
+				 m_msym_count);
+
       /* Allocate enough space in the obstack, into which we will gather the
          bunches of new and existing minimal symbols, sort them, and then
          compact out the duplicate entries.  Once we have a final table,
@@ -124,6 +124,17 @@ class minimal_symbol_reader
     return record_full (name, strlen (name), true, address, ms_type, section);
   }
 
+  /* Don't set the names of the symbols when they are recorded, but
+     demangle them all in install, possibly on several threads.  The
+     names of the recorded symbols must not be used until then, and,
+     since demangled names are shared, no other symbols of the objfile
+     may have their names set in the meantime.  */
+
+  void defer_names ()
+  {
+    m_defer_names = true;
+  }
+
  private:
 
   /* No need for these.  They are intentionally not defined anywhere.  */
@@ -146,6 +157,10 @@ class minimal_symbol_reader
      objfile.  */
 
   int m_msym_count;
+
+  /* Whether defer_names was called.  */
+
+  bool m_defer_names;
 };
 
 /* Create the terminating entry of OBJFILE's minimal symbol table.
@@ -155,6 +170,11 @@ class minimal_symbol_reader
 
 void terminate_minimal_symbol_table (struct objfile *objfile);
 
+/* Print statistics about the minimal symbol hash tables of OBJFILE,
+   for "maint print statistics".  */
+
+void print_minimal_symbol_hash_statistics (struct objfile *objfile);
+
 
 
 /* Compute a hash code for the string argument.  */
@@ -263,6 +283,18 @@ void iterate_over_minimal_symbols (struct objfile *objf,
 						     void *),
 				   void *user_data);
 
+/* Iterate over all the minimal symbols in the objfile OBJF whose
+   natural names begin with the first LEN characters of PREFIX, in
+   order of their names.  Names are compared as case_sensitivity says.
+
+   For each matching symbol, CALLBACK is called with the symbol and
+   USER_DATA as arguments.  */
+
+void iterate_over_minimal_symbols_with_prefix
+  (struct objfile *objf, const char *prefix, size_t len,
+   void (*callback) (struct minimal_symbol *, void *),
+   void *user_data);
+
 /* Compute the upper bound of MINSYM.  The upper bound is the last
    address thought to be part of the symbol.  If the symbol has a
    size, it is used.  Otherwise use the lesser of the next minimal
@@ -873,6 +873,8 @@ objfile_relocate1 (struct objfile *objfile,
 	    }
 	}
     }
+
+    reindex_objfile_compunits (objfile);
   }
 
   /* Relocate isolated symbols.  */
@@ -174,8 +174,51 @@ struct objstats
 extern void print_objfile_statistics (void);
 extern void print_symbol_bcache_statistics (void);
 
-/* Number of entries in the minimal symbol hash table.  */
-#define MINIMAL_SYMBOL_HASH_SIZE 2039
+/* A slot in a minimal symbol hash table.  */
+
+struct minsym_hash_slot
+{
+  /* The full hash of the symbol's name.  */
+
+  unsigned int hash;
+
+  /* The symbol, or NULL if the slot is empty.  */
+
+  struct minimal_symbol *msymbol;
+};
+
+/* A hash table indexing minimal symbols by name.  This uses open
+   addressing with linear probing.  It is sized from the number of
+   minimal symbols when they are installed, and each slot records the
+   full hash of the symbol's name so that most non-matching slots are
+   skipped without comparing names.  */
+
+struct minsym_hash_table
+{
+  /* The slots, allocated on the per-BFD obstack.  */
+
+  struct minsym_hash_slot *slots;
+
+  /* The number of slots.  This is either zero or a power of two.  */
+
+  unsigned int size;
+
+  /* The number of symbols in the table.  */
+
+  unsigned int count;
+
+  /* The greatest number of slots that must be examined to find any
+     one symbol in the table.  */
+
+  unsigned int max_probes;
+
+  /* The number of lookups done in this table, and the total number of
+     slots they examined.  These are reported by "maint print
+     statistics".  */
+
+  unsigned long lookups;
+  unsigned long probes;
+};
 
 /* Some objfile data is hung off the BFD.  This enables sharing of the
    data across all objfiles using the BFD.  The data is stored in an
@@ -255,12 +298,18 @@ struct objfile_per_bfd_storage
 
   /* This is a hash table used to index the minimal symbols by name.  */
 
-  struct minimal_symbol *msymbol_hash[MINIMAL_SYMBOL_HASH_SIZE];
+  struct minsym_hash_table msymbol_hash;
 
   /* This hash table is used to index the minimal symbols by their
      demangled names.  */
 
-  struct minimal_symbol *msymbol_demangled_hash[MINIMAL_SYMBOL_HASH_SIZE];
+  struct minsym_hash_table msymbol_demangled_hash;
+
+  /* The minimal symbols, sorted by natural name, or NULL if they have
+     not been needed since the table was built.  See
+     iterate_over_minimal_symbols_with_prefix.  */
+
+  struct minimal_symbol **msymbols_by_name;
 };
 
 /* Master structure for keeping track of each file from which
@@ -0,0 +1,220 @@
+/* Run independent pieces of work on several threads.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "parallel-for.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+/* The value of "maint set worker-threads".  -1 means one thread per
+   host CPU.  */
+
+static int worker_threads = -1;
+
+/* If the last parallel_for call could not start all the threads it
+   wanted, the error that stopped it, and the number of threads that
+   did the work.  NULL if all the threads were started.  */
+
+static char *thread_start_error;
+static unsigned int threads_used;
+
+/* Implement "maint show worker-threads".  */
+
+static void
+show_worker_threads (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  if (worker_threads == -1)
+    fprintf_filtered (file, _("The number of worker threads GDB "
+			      "can use is unlimited (currently %u).\n"),
+		      parallel_for_thread_count ());
+  else
+    fprintf_filtered (file, _("The number of worker threads GDB "
+			      "can use is %s.\n"), value);
+
+#ifndef HAVE_PTHREAD
+  fprintf_filtered (file, _("Worker threads are not supported on this "
+			    "host; all the work is done on the main "
+			    "thread.\n"));
+#endif
+  if (thread_start_error != NULL)
+    fprintf_filtered (file, _("Worker threads could not be started (%s); "
+			      "the work was done on %u thread(s).\n"),
+		      thread_start_error, threads_used);
+}
+
+/* See parallel-for.h.  */
+
+unsigned int
+parallel_for_thread_count (void)
+{
+#ifdef HAVE_PTHREAD
+  if (worker_threads == -1)
+    {
+      unsigned int n = std::thread::hardware_concurrency ();
+
+      return n > 0 ? n : 1;
+    }
+  return worker_threads > 0 ? worker_threads : 1;
+#else
+  return 1;
+#endif
+}
+
+#ifdef HAVE_PTHREAD
+
+/* An RAII-based object that blocks all signals in the calling thread,
+   and restores the previous signal mask when it is destroyed.  A
+   thread starts with the signal mask of the thread that creates it,
+   so worker threads created while this object exists never receive
+   SIGINT, SIGCHLD, SIGWINCH and the other signals GDB handles; those
+   are delivered to the main thread.  */
+
+class scoped_block_signals
+{
+ public:
+
+  scoped_block_signals ()
+  {
+    sigset_t mask;
+
+    sigfillset (&mask);
+    pthread_sigmask (SIG_BLOCK, &mask, &m_old_mask);
+  }
+
+  ~scoped_block_signals ()
+  {
+    pthread_sigmask (SIG_SETMASK, &m_old_mask, NULL);
+  }
+
+ private:
+
+  /* No need for these.  They are intentionally not defined
+     anywhere.  */
+  scoped_block_signals (const scoped_block_signals &);
+  scoped_block_signals &operator= (const scoped_block_signals &);
+
+  /* The signal mask to restore.  */
+  sigset_t m_old_mask;
+};
+
+#endif
+
+/* The state shared by the threads of one parallel_for call.  */
+
+struct parallel_for_state
+{
+  unsigned int n;
+  void (*fn) (unsigned int, void *);
+  void *data;
+
+  /* The next index to hand out.  */
+  std::atomic<unsigned int> next;
+};
+
+/* Make calls for STATE until there are none left.  */
+
+static void
+parallel_for_worker (struct parallel_for_state *state)
+{
+  bool saved_in_worker_thread = in_worker_thread;
+  unsigned int i;
+
+  in_worker_thread = true;
+  while ((i = state->next++) < state->n)
+    state->fn (i, state->data);
+  in_worker_thread = saved_in_worker_thread;
+}
+
+/* See parallel-for.h.  */
+
+void
+parallel_for (unsigned int n, void (*fn) (unsigned int, void *), void *data)
+{
+  struct parallel_for_state state;
+  std::vector<std::thread> threads;
+  unsigned int n_threads = parallel_for_thread_count ();
+  unsigned int i;
+
+  state.n = n;
+  state.fn = fn;
+  state.data = data;
+  state.next = 0;
+
+  if (n_threads > n)
+    n_threads = n;
+
+#ifdef HAVE_PTHREAD
+  /* If a thread can't be started, the threads that could be, and
+     the calling thread, do all the work.  Remember why, so that
+     "maint show worker-threads" can report it.  */
+  xfree (thread_start_error);
+  thread_start_error = NULL;
+  {
+    /* The signals GDB handles must not be delivered to the worker
+       threads, whose handlers would then run in the middle of the
+       work.  */
+    scoped_block_signals blocker;
+
+    for (i = 1; i < n_threads; ++i)
+      {
+	try
+	  {
+	    threads.emplace_back (parallel_for_worker, &state);
+	  }
+	catch (const std::system_error &e)
+	  {
+	    thread_start_error = xstrdup (e.what ());
+	    threads_used = i;
+	    break;
+	  }
+      }
+  }
+#endif
+
+  parallel_for_worker (&state);
+
+  for (std::thread &thread : threads)
+    thread.join ();
+}
+
+extern initialize_file_ftype _initialize_parallel_for; /* -Wmissing-prototypes */
+
+void
+_initialize_parallel_for (void)
+{
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads", class_maintenance,
+				       &worker_threads, _("\
+Set the number of worker threads GDB can use."), _("\
+Show the number of worker threads GDB can use."), _("\
+Some work, such as reading partial symbols, can be spread over several\n\
+threads.  Specifying \"unlimited\" or -1 uses one thread per host CPU,\n\
+and 1 does all the work on the main thread."),
+				       NULL, show_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+}
@@ -0,0 +1,52 @@
+/* Run independent pieces of work on several threads.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+/* Most of GDB is not thread-safe, so work handed to other threads
+   must be self-contained: it may read data that nothing else changes
+   while it runs, and write only to data of its own.  Such work runs
+   with IN_WORKER_THREAD set (see common-exceptions.h), so that:
+
+   - complaints are not issued but only counted in
+     worker_complaint_count (see complaints.h);
+   - errors skip the cleanup chain, and must be caught by the work
+     function itself with a C++ catch of gdb_exception, which must
+     then xfree the exception's message.
+
+   A worker that complains or fails usually just gives up, and lets
+   the main thread redo the work in the ordinary way.  */
+
+/* Return the number of threads, including the calling one, that
+   parallel_for may use.  This is controlled by "maint set
+   worker-threads".  */
+
+extern unsigned int parallel_for_thread_count (void);
+
+/* Call FN (I, DATA) for each I from 0 to N - 1, spreading the calls
+   over up to parallel_for_thread_count threads.  The calling thread
+   takes part, also with IN_WORKER_THREAD set.  The calls are made in
+   no particular order; parallel_for returns when all are done.  */
+
+extern void parallel_for (unsigned int n,
+			  void (*fn) (unsigned int i, void *data),
+			  void *data);
+
+#endif /* PARALLEL_FOR_H */
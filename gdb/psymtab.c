@@ -1467,7 +1467,8 @@ const struct quick_symbol_functions psym_functions =
   psym_map_matching_symbols,
   psym_expand_symtabs_matching,
   psym_find_pc_sect_compunit_symtab,
-  psym_map_symbol_filenames
+  psym_map_symbol_filenames,
+  NULL
 };
 
 
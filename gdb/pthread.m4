@@ -0,0 +1,65 @@
+dnl Copyright (C) 2017 Free Software Foundation, Inc.
+dnl
+dnl This file is part of GDB.
+dnl
+dnl This program is free software; you can redistribute it and/or modify
+dnl it under the terms of the GNU General Public License as published by
+dnl the Free Software Foundation; either version 3 of the License, or
+dnl (at your option) any later version.
+dnl
+dnl This program is distributed in the hope that it will be useful,
+dnl but WITHOUT ANY WARRANTY; without even the implied warranty of
+dnl MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+dnl GNU General Public License for more details.
+dnl
+dnl You should have received a copy of the GNU General Public License
+dnl along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+dnl Find the flags needed to use POSIX threads, in the manner of
+dnl AX_PTHREAD from the Autoconf Archive: try to link a program that
+dnl starts a thread with each of the usual flags in turn, and with
+dnl none.  Set and substitute PTHREAD_CFLAGS and PTHREAD_LIBS, and
+dnl define HAVE_PTHREAD if one of them works.
+
+AC_DEFUN([GDB_AC_PTHREAD],
+[
+AC_CACHE_CHECK([for the flags needed to use threads], gdb_cv_pthread_flags,
+[gdb_cv_pthread_flags=no
+gdb_save_CFLAGS=$CFLAGS
+gdb_save_LIBS=$LIBS
+for gdb_flags in -pthread none -lpthread -mthreads; do
+  case $gdb_flags in
+    none) ;;
+    -l*) LIBS="$gdb_flags $gdb_save_LIBS" ;;
+    *) CFLAGS="$gdb_save_CFLAGS $gdb_flags"
+       LIBS="$gdb_flags $gdb_save_LIBS" ;;
+  esac
+  AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <pthread.h>
+static void *fn (void *arg) { return arg; }]],
+[[pthread_t t;
+pthread_create (&t, 0, fn, 0);
+pthread_join (t, 0);]])],
+    [gdb_cv_pthread_flags=$gdb_flags])
+  CFLAGS=$gdb_save_CFLAGS
+  LIBS=$gdb_save_LIBS
+  if test "$gdb_cv_pthread_flags" != no; then
+    break
+  fi
+done])
+
+PTHREAD_CFLAGS=
+PTHREAD_LIBS=
+case $gdb_cv_pthread_flags in
+  no) ;;
+  none) ;;
+  -l*) PTHREAD_LIBS=$gdb_cv_pthread_flags ;;
+  *) PTHREAD_CFLAGS=$gdb_cv_pthread_flags
+     PTHREAD_LIBS=$gdb_cv_pthread_flags ;;
+esac
+if test "$gdb_cv_pthread_flags" != no; then
+  AC_DEFINE(HAVE_PTHREAD, 1,
+	    [Define to 1 if threads can be used, with PTHREAD_CFLAGS and PTHREAD_LIBS.])
+fi
+AC_SUBST(PTHREAD_CFLAGS)
+AC_SUBST(PTHREAD_LIBS)
+])
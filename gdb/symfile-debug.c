@@ -369,6 +369,41 @@ debug_qf_map_symbol_filenames (struct objfile *objfile,
 						 need_fullname);
 }
 
+static void
+debug_qf_expand_symtabs_with_prefix
+  (struct objfile *objfile,
+   const char *prefix, size_t prefix_len,
+   expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+   expand_symtabs_exp_notify_ftype *expansion_notify,
+   enum search_domain kind, void *data)
+{
+  const struct debug_sym_fns_data *debug_data
+    = ((const struct debug_sym_fns_data *)
+       objfile_data (objfile, symfile_debug_objfile_data_key));
+
+  fprintf_filtered (gdb_stdlog,
+		    "qf->expand_symtabs_with_prefix (%s, \"%.*s\", %s, %s,"
+		    " %s, %s)\n",
+		    objfile_debug_name (objfile),
+		    (int) prefix_len, prefix,
+		    host_address_to_string (symbol_matcher),
+		    host_address_to_string (expansion_notify),
+		    search_domain_name (kind),
+		    host_address_to_string (data));
+
+  if (debug_data->real_sf->qf->expand_symtabs_with_prefix != NULL)
+    debug_data->real_sf->qf->expand_symtabs_with_prefix (objfile,
+							 prefix, prefix_len,
+							 symbol_matcher,
+							 expansion_notify,
+							 kind, data);
+  else
+    debug_data->real_sf->qf->expand_symtabs_matching (objfile, NULL,
+						      symbol_matcher,
+						      expansion_notify,
+						      kind, data);
+}
+
 static const struct quick_symbol_functions debug_sym_quick_functions =
 {
   debug_qf_has_symbols,
@@ -385,7 +420,8 @@ static const struct quick_symbol_functions debug_sym_quick_functions =
   debug_qf_map_matching_symbols,
   debug_qf_expand_symtabs_matching,
   debug_qf_find_pc_sect_compunit_symtab,
-  debug_qf_map_symbol_filenames
+  debug_qf_map_symbol_filenames,
+  debug_qf_expand_symtabs_with_prefix
 };
 
 /* Debugging version of struct sym_probe_fns.  */
@@ -2614,6 +2614,10 @@ reread_symbols (void)
 	  memset (&objfile->static_psymbols, 0,
 		  sizeof (objfile->static_psymbols));
 
+	  /* The compunits are about to be freed along with the
+	     objfile_obstack, so forget their addresses.  */
+	  remove_objfile_from_pc_index (objfile);
+
 	  /* Free the obstacks for non-reusable objfiles.  */
 	  psymbol_bcache_free (objfile->psymbol_cache);
 	  objfile->psymbol_cache = psymbol_bcache_init ();
@@ -2952,6 +2956,7 @@ add_compunit_symtab_to_objfile (struct compunit_symtab *cu)
 {
   cu->next = cu->objfile->compunit_symtabs;
   cu->objfile->compunit_symtabs = cu;
+  add_compunit_to_pc_index (cu);
 }
 
 
@@ -3899,6 +3904,38 @@ expand_symtabs_matching (expand_symtabs_file_matcher_ftype *file_matcher,
   }
 }
 
+/* Wrapper around the quick_symbol_functions expand_symtabs_with_prefix
+   "method".  Expand all symtabs with symbols that begin with PREFIX and
+   match SYMBOL_MATCHER.
+   See quick_symbol_functions.expand_symtabs_with_prefix for details.  */
+
+void
+expand_symtabs_with_prefix (const char *prefix, size_t prefix_len,
+			    expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+			    expand_symtabs_exp_notify_ftype *expansion_notify,
+			    enum search_domain kind,
+			    void *data)
+{
+  struct objfile *objfile;
+
+  ALL_OBJFILES (objfile)
+  {
+    if (objfile->sf == NULL)
+      continue;
+    if (objfile->sf->qf->expand_symtabs_with_prefix != NULL)
+      objfile->sf->qf->expand_symtabs_with_prefix (objfile, prefix,
+						   prefix_len,
+						   symbol_matcher,
+						   expansion_notify, kind,
+						   data);
+    else
+      objfile->sf->qf->expand_symtabs_matching (objfile, NULL,
+						symbol_matcher,
+						expansion_notify, kind,
+						data);
+  }
+}
+
 /* Wrapper around the quick_symbol_functions map_symbol_filenames "method".
    Map function FUN over every file.
    See quick_symbol_functions.map_symbol_filenames for details.  */
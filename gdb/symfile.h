@@ -313,6 +313,19 @@ struct quick_symbol_functions
   void (*map_symbol_filenames) (struct objfile *objfile,
 				symbol_filename_ftype *fun, void *data,
 				int need_fullname);
+
+  /* Like expand_symtabs_matching with a NULL FILE_MATCHER, for when
+     SYMBOL_MATCHER can only match names that begin with the first
+     PREFIX_LEN characters of PREFIX.  This lets the reader find the
+     candidate names without walking all of them.  This may be NULL,
+     in which case expand_symtabs_matching is used.  */
+  void (*expand_symtabs_with_prefix)
+    (struct objfile *objfile,
+     const char *prefix, size_t prefix_len,
+     expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+     expand_symtabs_exp_notify_ftype *expansion_notify,
+     enum search_domain kind,
+     void *data);
 };
 
 /* Structure of functions used for probe support.  If one of these functions
@@ -569,6 +582,11 @@ void expand_symtabs_matching (expand_symtabs_file_matcher_ftype *,
 			      expand_symtabs_exp_notify_ftype *,
 			      enum search_domain kind, void *data);
 
+void expand_symtabs_with_prefix (const char *prefix, size_t prefix_len,
+				 expand_symtabs_symbol_matcher_ftype *,
+				 expand_symtabs_exp_notify_ftype *,
+				 enum search_domain kind, void *data);
+
 void map_symbol_filenames (symbol_filename_ftype *fun, void *data,
 			   int need_fullname);
 
@@ -608,6 +626,8 @@ struct dwarf2_debug_sections {
   struct dwarf2_section_names frame;
   struct dwarf2_section_names eh_frame;
   struct dwarf2_section_names gdb_index;
+  struct dwarf2_section_names debug_names;
+  struct dwarf2_section_names aranges;
   /* This field has no meaning, but exists solely to catch changes to
      this structure which are not reflected in some instance.  */
   int sentinel;
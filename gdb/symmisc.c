@@ -39,6 +39,7 @@
 #include "readline/readline.h"
 
 #include "psymtab.h"
+#include "minsyms.h"
 
 /* Unfortunately for debugging, stderr is usually a macro.  This is painful
    when calling functions that take FILE *'s from the debugger.
@@ -108,6 +109,8 @@ print_objfile_statistics (void)
     if (objfile->per_bfd->n_minsyms > 0)
       printf_filtered (_("  Number of \"minimal\" symbols read: %d\n"),
 		       objfile->per_bfd->n_minsyms);
+    if (objfile->per_bfd->minimal_symbol_count > 0)
+      print_minimal_symbol_hash_statistics (objfile);
     if (OBJSTAT (objfile, n_psyms) > 0)
       printf_filtered (_("  Number of \"partial\" symbols read: %d\n"),
 		       OBJSTAT (objfile, n_psyms));
@@ -111,6 +111,10 @@ struct main_info
 
 static const struct program_space_data *symbol_cache_key;
 
+/* Program space key for finding its PC index.  */
+
+static const struct program_space_data *pc_index_key;
+
 /* The default symbol cache size.
    There is no extra cpu cost for large N (except when flushing the cache,
    which is rare).  The value here is just a first attempt.  A better default
@@ -741,7 +745,7 @@ create_demangled_names_hash (struct objfile *objfile)
    then set the language appropriately.  The returned name is allocated
    by the demangler and should be xfree'd.  */
 
-static char *
+char *
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
@@ -784,12 +788,17 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 
    The hash table corresponding to OBJFILE is used, and the memory
    comes from the per-BFD storage_obstack.  LINKAGE_NAME is copied,
-   so the pointer can be discarded after calling this function.  */
+   so the pointer can be discarded after calling this function.
 
-void
-symbol_set_names (struct general_symbol_info *gsymbol,
-		  const char *linkage_name, int len, int copy_name,
-		  struct objfile *objfile)
+   If PRECOMPUTED is nonzero, LANGUAGE and DEMANGLED are what
+   symbol_find_demangled_name returned for LINKAGE_NAME, and are used
+   instead of calling it.  DEMANGLED is xfree'd in any case.  */
+
+static void
+symbol_set_names_1 (struct general_symbol_info *gsymbol,
+		    const char *linkage_name, int len, int copy_name,
+		    struct objfile *objfile, int precomputed,
+		    enum language language, char *demangled)
 {
   struct demangled_name_entry **slot;
   /* A 0-terminated copy of the linkage name.  */
@@ -813,6 +822,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	  gsymbol->name = name;
 	}
       symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
+      xfree (demangled);
 
       return;
     }
@@ -845,9 +855,19 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       || (gsymbol->language == language_go
 	  && (*slot)->demangled[0] == '\0'))
     {
-      char *demangled_name = symbol_find_demangled_name (gsymbol,
-							 linkage_name_copy);
-      int demangled_len = demangled_name ? strlen (demangled_name) : 0;
+      char *demangled_name;
+      int demangled_len;
+
+      if (precomputed)
+	{
+	  gsymbol->language = language;
+	  demangled_name = demangled;
+	  demangled = NULL;
+	}
+      else
+	demangled_name = symbol_find_demangled_name (gsymbol,
+						     linkage_name_copy);
+      demangled_len = demangled_name ? strlen (demangled_name) : 0;
 
       /* Suppose we have demangled_name==NULL, copy_name==0, and
 	 linkage_name_copy==linkage_name.  In this case, we already have the
@@ -892,6 +912,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       else
 	(*slot)->demangled[0] = '\0';
     }
+  xfree (demangled);
 
   gsymbol->name = (*slot)->mangled;
   if ((*slot)->demangled[0] != '\0')
@@ -901,6 +922,29 @@ symbol_set_names (struct general_symbol_info *gsymbol,
     symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
 }
 
+/* See symtab.h.  */
+
+void
+symbol_set_names (struct general_symbol_info *gsymbol,
+		  const char *linkage_name, int len, int copy_name,
+		  struct objfile *objfile)
+{
+  symbol_set_names_1 (gsymbol, linkage_name, len, copy_name, objfile,
+		      0, language_unknown, NULL);
+}
+
+/* See symtab.h.  */
+
+void
+symbol_set_names_demangled (struct general_symbol_info *gsymbol,
+			    const char *linkage_name, int len,
+			    int copy_name, struct objfile *objfile,
+			    enum language language, char *demangled)
+{
+  symbol_set_names_1 (gsymbol, linkage_name, len, copy_name, objfile,
+		      1, language, demangled);
+}
+
 /* Return the source code name of a symbol.  In languages where
    demangling is necessary, this is the demangled name.  */
 
@@ -1638,6 +1682,7 @@ static void
 symtab_free_objfile_observer (struct objfile *objfile)
 {
   symbol_cache_flush (objfile->pspace);
+  remove_objfile_from_pc_index (objfile);
 }
 
 /* Debug symbols usually don't have section information.  We need to dig that
@@ -2804,6 +2849,342 @@ iterate_over_symbols (const struct block *block, const char *name,
     }
 }
 
+/* The PC index of a program space maps code addresses to the
+   compunit symtabs whose global block covers them, so that
+   find_pc_sect_compunit_symtab does not have to look at every
+   compunit of every objfile.  */
+
+/* An entry of the PC index.  */
+
+typedef struct pc_index_entry
+{
+  /* The range of the global block of CUST, when it was indexed.  */
+  CORE_ADDR start;
+  CORE_ADDR end;
+
+  /* The largest END of this entry and of all the entries before it in
+     the index.  Searching back from an entry can stop at the first
+     one whose MAX_END does not exceed the PC.  */
+  CORE_ADDR max_end;
+
+  struct compunit_symtab *cust;
+
+  /* Compunits added to an objfile later have larger serial numbers.
+     Since new compunits go at the front of the objfile's list, this
+     gives the order in which ALL_COMPUNITS visits them.  */
+  unsigned long serial;
+} pc_index_entry_s;
+
+DEF_VEC_O (pc_index_entry_s);
+
+struct pc_index
+{
+  /* The indexed compunits, sorted by START.  */
+  VEC (pc_index_entry_s) *entries;
+
+  /* Compunits added since the last lookup.  Their blocks may not be
+     complete when they are added, so they are only indexed when
+     needed.  */
+  VEC (pc_index_entry_s) *pending;
+
+  /* The serial number of the next compunit added.  */
+  unsigned long next_serial;
+};
+
+/* Return the PC index of PSPACE, creating it if needed.  */
+
+static struct pc_index *
+get_pc_index (struct program_space *pspace)
+{
+  struct pc_index *index
+    = (struct pc_index *) program_space_data (pspace, pc_index_key);
+
+  if (index == NULL)
+    {
+      index = XCNEW (struct pc_index);
+      set_program_space_data (pspace, pc_index_key, index);
+    }
+
+  return index;
+}
+
+/* Free the PC index of PSPACE.  Called when PSPACE is destroyed.  */
+
+static void
+pc_index_cleanup (struct program_space *pspace, void *data)
+{
+  struct pc_index *index = (struct pc_index *) data;
+
+  VEC_free (pc_index_entry_s, index->entries);
+  VEC_free (pc_index_entry_s, index->pending);
+  xfree (index);
+}
+
+/* See symtab.h.  */
+
+void
+add_compunit_to_pc_index (struct compunit_symtab *cust)
+{
+  struct pc_index *index = get_pc_index (COMPUNIT_OBJFILE (cust)->pspace);
+  pc_index_entry_s entry;
+
+  memset (&entry, 0, sizeof (entry));
+  entry.cust = cust;
+  entry.serial = index->next_serial++;
+  VEC_safe_push (pc_index_entry_s, index->pending, &entry);
+}
+
+/* Remove the entries of OBJFILE's compunits from VEC.  */
+
+static void
+remove_objfile_pc_index_entries (VEC (pc_index_entry_s) *vec,
+				 struct objfile *objfile)
+{
+  pc_index_entry_s *entry;
+  unsigned int i, j;
+
+  for (i = 0, j = 0; VEC_iterate (pc_index_entry_s, vec, i, entry); i++)
+    if (COMPUNIT_OBJFILE (entry->cust) != objfile)
+      *VEC_index (pc_index_entry_s, vec, j++) = *entry;
+  VEC_truncate (pc_index_entry_s, vec, j);
+}
+
+/* Recompute the MAX_END of the indexed entries of INDEX.  */
+
+static void
+update_pc_index_max_ends (struct pc_index *index)
+{
+  pc_index_entry_s *entry;
+  CORE_ADDR max_end = 0;
+  unsigned int i;
+
+  for (i = 0; VEC_iterate (pc_index_entry_s, index->entries, i, entry); i++)
+    {
+      if (entry->end > max_end)
+	max_end = entry->end;
+      entry->max_end = max_end;
+    }
+}
+
+/* See symtab.h.  */
+
+void
+remove_objfile_from_pc_index (struct objfile *objfile)
+{
+  struct pc_index *index
+    = (struct pc_index *) program_space_data (objfile->pspace, pc_index_key);
+
+  if (index == NULL)
+    return;
+
+  remove_objfile_pc_index_entries (index->entries, objfile);
+  remove_objfile_pc_index_entries (index->pending, objfile);
+  update_pc_index_max_ends (index);
+}
+
+/* See symtab.h.  */
+
+void
+reindex_objfile_compunits (struct objfile *objfile)
+{
+  struct compunit_symtab *cust;
+
+  remove_objfile_from_pc_index (objfile);
+
+  /* Add them oldest first, so that the serial numbers keep their
+     order.  */
+  {
+    VEC (compunit_symtab_ptr) *custs = NULL;
+    struct cleanup *back_to
+      = make_cleanup (VEC_cleanup (compunit_symtab_ptr), &custs);
+    int i;
+
+    ALL_OBJFILE_COMPUNITS (objfile, cust)
+      VEC_safe_push (compunit_symtab_ptr, custs, cust);
+    for (i = VEC_length (compunit_symtab_ptr, custs) - 1; i >= 0; i--)
+      add_compunit_to_pc_index (VEC_index (compunit_symtab_ptr, custs, i));
+
+    do_cleanups (back_to);
+  }
+}
+
+/* Compare two PC index entries by start address, for qsort.  */
+
+static int
+compare_pc_index_entries (const void *a, const void *b)
+{
+  const pc_index_entry_s *ea = (const pc_index_entry_s *) a;
+  const pc_index_entry_s *eb = (const pc_index_entry_s *) b;
+
+  if (ea->start < eb->start)
+    return -1;
+  if (ea->start > eb->start)
+    return 1;
+  return 0;
+}
+
+/* Index the pending compunits of INDEX whose blocks are complete.  */
+
+static void
+flush_pc_index (struct pc_index *index)
+{
+  VEC (pc_index_entry_s) *ready = NULL;
+  VEC (pc_index_entry_s) *merged = NULL;
+  pc_index_entry_s *entry;
+  unsigned int i, j, still_pending;
+
+  if (VEC_empty (pc_index_entry_s, index->pending))
+    return;
+
+  /* Take the compunits that have their blocks, leaving the others
+     pending.  */
+  for (i = 0, still_pending = 0;
+       VEC_iterate (pc_index_entry_s, index->pending, i, entry);
+       i++)
+    {
+      const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (entry->cust);
+
+      if (bv == NULL)
+	*VEC_index (pc_index_entry_s, index->pending, still_pending++)
+	  = *entry;
+      else
+	{
+	  struct block *b = BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK);
+
+	  entry->start = BLOCK_START (b);
+	  entry->end = BLOCK_END (b);
+	  VEC_safe_push (pc_index_entry_s, ready, entry);
+	}
+    }
+  VEC_truncate (pc_index_entry_s, index->pending, still_pending);
+
+  if (VEC_empty (pc_index_entry_s, ready))
+    return;
+
+  /* Merge them into the index.  */
+  qsort (VEC_address (pc_index_entry_s, ready),
+	 VEC_length (pc_index_entry_s, ready), sizeof (pc_index_entry_s),
+	 compare_pc_index_entries);
+  VEC_reserve (pc_index_entry_s, merged,
+	       VEC_length (pc_index_entry_s, index->entries)
+	       + VEC_length (pc_index_entry_s, ready));
+  i = 0;
+  j = 0;
+  while (i < VEC_length (pc_index_entry_s, index->entries)
+	 || j < VEC_length (pc_index_entry_s, ready))
+    {
+      if (j == VEC_length (pc_index_entry_s, ready)
+	  || (i < VEC_length (pc_index_entry_s, index->entries)
+	      && (VEC_index (pc_index_entry_s, index->entries, i)->start
+		  <= VEC_index (pc_index_entry_s, ready, j)->start)))
+	entry = VEC_index (pc_index_entry_s, index->entries, i++);
+      else
+	entry = VEC_index (pc_index_entry_s, ready, j++);
+      VEC_quick_push (pc_index_entry_s, merged, entry);
+    }
+
+  VEC_free (pc_index_entry_s, index->entries);
+  VEC_free (pc_index_entry_s, ready);
+  index->entries = merged;
+  update_pc_index_max_ends (index);
+}
+
+/* A compunit whose global block contains the PC looked up, and the
+   position of its objfile in the program space's list.  */
+
+struct pc_candidate
+{
+  struct compunit_symtab *cust;
+  unsigned long serial;
+  int objfile_pos;
+};
+
+/* Compare two candidates by the order in which ALL_COMPUNITS visits
+   them, for qsort.  */
+
+static int
+compare_pc_candidates (const void *a, const void *b)
+{
+  const struct pc_candidate *ca = (const struct pc_candidate *) a;
+  const struct pc_candidate *cb = (const struct pc_candidate *) b;
+
+  if (ca->objfile_pos != cb->objfile_pos)
+    return ca->objfile_pos < cb->objfile_pos ? -1 : 1;
+  if (ca->serial != cb->serial)
+    return ca->serial > cb->serial ? -1 : 1;
+  return 0;
+}
+
+/* Find the compunits of the current program space whose global block
+   contains PC, using its PC index.  Return their number, and store
+   them in *CANDIDATES, in the order in which ALL_COMPUNITS would
+   visit them.  The caller must xfree *CANDIDATES.  */
+
+static int
+find_pc_candidates (CORE_ADDR pc, struct pc_candidate **candidates)
+{
+  struct pc_index *index = get_pc_index (current_program_space);
+  pc_index_entry_s *entries;
+  struct pc_candidate *result = NULL;
+  int n_result = 0, max_result = 0;
+  int lo, hi, i;
+  int same_objfile = 1;
+
+  flush_pc_index (index);
+  entries = VEC_address (pc_index_entry_s, index->entries);
+
+  /* Find the first entry that starts after PC.  */
+  lo = 0;
+  hi = VEC_length (pc_index_entry_s, index->entries);
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (entries[mid].start <= pc)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  for (i = lo - 1; i >= 0 && entries[i].max_end > pc; i--)
+    {
+      if (entries[i].end <= pc)
+	continue;
+
+      if (n_result == max_result)
+	{
+	  max_result = max_result ? max_result * 2 : 4;
+	  result = XRESIZEVEC (struct pc_candidate, result, max_result);
+	}
+      result[n_result].cust = entries[i].cust;
+      result[n_result].serial = entries[i].serial;
+      result[n_result].objfile_pos = 0;
+      if (COMPUNIT_OBJFILE (entries[i].cust)
+	  != COMPUNIT_OBJFILE (result[0].cust))
+	same_objfile = 0;
+      n_result++;
+    }
+
+  if (!same_objfile)
+    {
+      struct objfile *objfile;
+      int pos = 0;
+
+      ALL_OBJFILES (objfile)
+	{
+	  for (i = 0; i < n_result; i++)
+	    if (COMPUNIT_OBJFILE (result[i].cust) == objfile)
+	      result[i].objfile_pos = pos;
+	  pos++;
+	}
+    }
+  if (n_result > 1)
+    qsort (result, n_result, sizeof (result[0]), compare_pc_candidates);
+
+  *candidates = result;
+  return n_result;
+}
+
 /* Find the compunit symtab associated with PC and SECTION.
    This will read in debug info as necessary.  */
 
@@ -2815,6 +3196,9 @@ find_pc_sect_compunit_symtab (CORE_ADDR pc, struct obj_section *section)
   struct objfile *objfile;
   CORE_ADDR distance = 0;
   struct bound_minimal_symbol msymbol;
+  struct pc_candidate *candidates;
+  int n_candidates, i;
+  struct cleanup *back_to;
 
   /* If we know that this is not a text address, return failure.  This is
      necessary because we loop based on the block's high and low code
@@ -2843,59 +3227,72 @@ find_pc_sect_compunit_symtab (CORE_ADDR pc, struct obj_section *section)
      like xcoff does (I'm not sure).
 
      It also happens for objfiles that have their functions reordered.
-     For these, the symtab we are looking for is not necessarily read in.  */
+     For these, the symtab we are looking for is not necessarily read in.
 
-  ALL_COMPUNITS (objfile, cust)
-  {
-    struct block *b;
-    const struct blockvector *bv;
+     The PC index gives the symtabs that contain our address, in the
+     order in which ALL_COMPUNITS would visit them.  */
 
-    bv = COMPUNIT_BLOCKVECTOR (cust);
-    b = BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK);
+  n_candidates = find_pc_candidates (pc, &candidates);
+  back_to = make_cleanup (xfree, candidates);
 
-    if (BLOCK_START (b) <= pc
-	&& BLOCK_END (b) > pc
-	&& (distance == 0
-	    || BLOCK_END (b) - BLOCK_START (b) < distance))
-      {
-	/* For an objfile that has its functions reordered,
-	   find_pc_psymtab will find the proper partial symbol table
-	   and we simply return its corresponding symtab.  */
-	/* In order to better support objfiles that contain both
-	   stabs and coff debugging info, we continue on if a psymtab
-	   can't be found.  */
-	if ((objfile->flags & OBJF_REORDERED) && objfile->sf)
-	  {
-	    struct compunit_symtab *result;
-
-	    result
-	      = objfile->sf->qf->find_pc_sect_compunit_symtab (objfile,
-							       msymbol,
-							       pc, section,
-							       0);
-	    if (result != NULL)
-	      return result;
-	  }
-	if (section != 0)
-	  {
-	    struct block_iterator iter;
-	    struct symbol *sym = NULL;
+  for (i = 0; i < n_candidates; i++)
+    {
+      struct block *b;
+      const struct blockvector *bv;
 
-	    ALL_BLOCK_SYMBOLS (b, iter, sym)
-	      {
-		fixup_symbol_section (sym, objfile);
-		if (matching_obj_sections (SYMBOL_OBJ_SECTION (objfile, sym),
-					   section))
-		  break;
-	      }
-	    if (sym == NULL)
-	      continue;		/* No symbol in this symtab matches
+      cust = candidates[i].cust;
+      objfile = COMPUNIT_OBJFILE (cust);
+      bv = COMPUNIT_BLOCKVECTOR (cust);
+      b = BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK);
+
+      if (BLOCK_START (b) <= pc
+	  && BLOCK_END (b) > pc
+	  && (distance == 0
+	      || BLOCK_END (b) - BLOCK_START (b) < distance))
+	{
+	  /* For an objfile that has its functions reordered,
+	     find_pc_psymtab will find the proper partial symbol table
+	     and we simply return its corresponding symtab.  */
+	  /* In order to better support objfiles that contain both
+	     stabs and coff debugging info, we continue on if a psymtab
+	     can't be found.  */
+	  if ((objfile->flags & OBJF_REORDERED) && objfile->sf)
+	    {
+	      struct compunit_symtab *result;
+
+	      result
+		= objfile->sf->qf->find_pc_sect_compunit_symtab (objfile,
+								 msymbol,
+								 pc, section,
+								 0);
+	      if (result != NULL)
+		{
+		  do_cleanups (back_to);
+		  return result;
+		}
+	    }
+	  if (section != 0)
+	    {
+	      struct block_iterator iter;
+	      struct symbol *sym = NULL;
+
+	      ALL_BLOCK_SYMBOLS (b, iter, sym)
+		{
+		  fixup_symbol_section (sym, objfile);
+		  if (matching_obj_sections (SYMBOL_OBJ_SECTION (objfile, sym),
+					     section))
+		    break;
+		}
+	      if (sym == NULL)
+		continue;	/* No symbol in this symtab matches
 				   section.  */
-	  }
-	distance = BLOCK_END (b) - BLOCK_START (b);
-	best_cust = cust;
-      }
-  }
+	    }
+	  distance = BLOCK_END (b) - BLOCK_START (b);
+	  best_cust = cust;
+	}
+    }
+
+  do_cleanups (back_to);
 
   if (best_cust != NULL)
     return best_cust;
@@ -5111,7 +5508,8 @@ completion_list_add_fields (struct symbol *sym, const char *sym_text,
 }
 
 /* Type of the user_data argument passed to add_macro_name,
-   symbol_completion_matcher and symtab_expansion_callback.  */
+   add_minsym_name, add_objc_minsym_name, symbol_completion_matcher
+   and symtab_expansion_callback.  */
 
 struct add_name_data
 {
@@ -5140,6 +5538,33 @@ add_macro_name (const char *name, const struct macro_definition *ignore,
 			    datum->text, datum->word);
 }
 
+/* A callback used with iterate_over_minimal_symbols_with_prefix.
+   This adds a minimal symbol's name to the current completion list.  */
+
+static void
+add_minsym_name (struct minimal_symbol *msymbol, void *user_data)
+{
+  struct add_name_data *datum = (struct add_name_data *) user_data;
+
+  QUIT;
+  MCOMPLETION_LIST_ADD_SYMBOL (msymbol, datum->sym_text, datum->sym_text_len,
+			       datum->text, datum->word);
+}
+
+/* A callback used with iterate_over_minimal_symbols_with_prefix.
+   This adds the completions for an ObjC method to the current
+   completion list.  */
+
+static void
+add_objc_minsym_name (struct minimal_symbol *msymbol, void *user_data)
+{
+  struct add_name_data *datum = (struct add_name_data *) user_data;
+
+  QUIT;
+  completion_list_objc_symbol (msymbol, datum->sym_text, datum->sym_text_len,
+			       datum->text, datum->word);
+}
+
 /* A callback for expand_symtabs_matching.  */
 
 static int
@@ -5206,7 +5631,6 @@ default_make_symbol_completion_list_break_on_1 (const char *text,
 
   struct symbol *sym;
   struct compunit_symtab *cust;
-  struct minimal_symbol *msymbol;
   struct objfile *objfile;
   const struct block *b;
   const struct block *surrounding_static_block, *surrounding_global_block;
@@ -5295,21 +5719,25 @@ default_make_symbol_completion_list_break_on_1 (const char *text,
   datum.word = word;
   datum.code = code;
 
-  /* At this point scan through the misc symbol vectors and add each
-     symbol you find to the list.  Eventually we want to ignore
-     anything that isn't a text symbol (everything else will be
-     handled by the psymtab code below).  */
+  /* At this point look up the misc symbols that begin with SYM_TEXT
+     and add each one you find to the list.  Eventually we want to
+     ignore anything that isn't a text symbol (everything else will be
+     handled by the psymtab code below).  ObjC methods, whose names
+     begin with '-' or '+', can complete on their selectors too.  */
 
   if (code == TYPE_CODE_UNDEF)
     {
-      ALL_MSYMBOLS (objfile, msymbol)
+      ALL_OBJFILES (objfile)
 	{
-	  QUIT;
-	  MCOMPLETION_LIST_ADD_SYMBOL (msymbol, sym_text, sym_text_len, text,
-				       word);
-
-	  completion_list_objc_symbol (msymbol, sym_text, sym_text_len, text,
-				       word);
+	  iterate_over_minimal_symbols_with_prefix (objfile, sym_text,
+						    sym_text_len,
+						    add_minsym_name, &datum);
+	  iterate_over_minimal_symbols_with_prefix (objfile, "-", 1,
+						    add_objc_minsym_name,
+						    &datum);
+	  iterate_over_minimal_symbols_with_prefix (objfile, "+", 1,
+						    add_objc_minsym_name,
+						    &datum);
 	}
     }
 
@@ -5322,9 +5750,10 @@ default_make_symbol_completion_list_break_on_1 (const char *text,
      by matching SYM_TEXT.  Expand all CUs that you find to the list.
      symtab_expansion_callback is called for each expanded symtab,
      causing those symtab's completions to be added to the list too.  */
-  expand_symtabs_matching (NULL, symbol_completion_matcher,
-			   symtab_expansion_callback, ALL_DOMAIN,
-			   &datum);
+  expand_symtabs_with_prefix (sym_text, sym_text_len,
+			      symbol_completion_matcher,
+			      symtab_expansion_callback, ALL_DOMAIN,
+			      &datum);
 
   /* Search upwards from currently selected frame (so that we can
      complete on local vars).  Also catch fields of types defined in
@@ -6154,6 +6583,9 @@ _initialize_symtab (void)
   symbol_cache_key
     = register_program_space_data_with_cleanup (NULL, symbol_cache_cleanup);
 
+  pc_index_key
+    = register_program_space_data_with_cleanup (NULL, pc_index_cleanup);
+
   add_info ("variables", variables_info, _("\
 All global and static variable names, or those matching REGEXP."));
   if (dbx_commands)
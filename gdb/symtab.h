@@ -214,6 +214,28 @@ extern void symbol_set_names (struct general_symbol_info *symbol,
 			      const char *linkage_name, int len, int copy_name,
 			      struct objfile *objfile);
 
+/* Like symbol_set_names, but LANGUAGE and DEMANGLED are the language
+   and demangled name that symbol_find_demangled_name computed
+   earlier for LINKAGE_NAME, possibly in a worker thread, on a copy of
+   SYMBOL.  They are only used if the name has not been seen before,
+   so the result is the same as that of symbol_set_names.  This takes
+   ownership of DEMANGLED.  */
+extern void symbol_set_names_demangled (struct general_symbol_info *symbol,
+					const char *linkage_name, int len,
+					int copy_name,
+					struct objfile *objfile,
+					enum language language,
+					char *demangled);
+
+/* Try to determine the demangled name of MANGLED, the linkage name
+   of SYMBOL, based on the language of SYMBOL.  If the language is
+   language_auto, this tries every demangler and sets the language of
+   SYMBOL to the first that works.  The result must be xfree'd.  This
+   does not use any objfile state, so it can be called from worker
+   threads.  */
+extern char *symbol_find_demangled_name (struct general_symbol_info *symbol,
+					 const char *mangled);
+
 /* Now come lots of name accessor macros.  Short version as to when to
    use which: Use SYMBOL_NATURAL_NAME to refer to the name of the
    symbol in the original source code.  Use SYMBOL_LINKAGE_NAME if you
@@ -362,16 +384,6 @@ struct minimal_symbol
      Symbol size information can sometimes not be determined, because
      the object file format may not carry that piece of information.  */
   unsigned int has_size : 1;
-
-  /* Minimal symbols with the same hash key are kept on a linked
-     list.  This is the link.  */
-
-  struct minimal_symbol *hash_next;
-
-  /* Minimal symbols are stored in two different hash tables.  This is
-     the `next' pointer for the demangled hash table.  */
-
-  struct minimal_symbol *demangled_hash_next;
 };
 
 #define MSYMBOL_TARGET_FLAG_1(msymbol)  (msymbol)->target_flag_1
@@ -1360,6 +1372,22 @@ extern struct compunit_symtab *find_pc_compunit_symtab (CORE_ADDR);
 extern struct compunit_symtab *
   find_pc_sect_compunit_symtab (CORE_ADDR, struct obj_section *);
 
+/* Add CUST to the index of code addresses used by
+   find_pc_sect_compunit_symtab.  Called when CUST is added to its
+   objfile; its blocks need only be complete by the next lookup.  */
+
+extern void add_compunit_to_pc_index (struct compunit_symtab *cust);
+
+/* Index the compunits of OBJFILE again, after their addresses
+   changed.  */
+
+extern void reindex_objfile_compunits (struct objfile *objfile);
+
+/* Remove OBJFILE's compunits from the index of code addresses of its
+   program space.  This must be done before they are freed.  */
+
+extern void remove_objfile_from_pc_index (struct objfile *objfile);
+
 extern int find_pc_line_pc_range (CORE_ADDR, CORE_ADDR *, CORE_ADDR *);
 
 extern void reread_symbols (void);
@@ -0,0 +1,44 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Enough types and functions that the debug sections are larger than
+   the size above which GDB maps them rather than reading them.  */
+
+#define FUNC(n)							\
+  struct s_##n { int a_##n; long b_##n; char c_##n[n]; };	\
+  int								\
+  func_##n (struct s_##n *p)					\
+  {								\
+    return p->a_##n + (int) p->b_##n + p->c_##n[0];		\
+  }
+
+#define FUNC10(n)							\
+  FUNC (n##0) FUNC (n##1) FUNC (n##2) FUNC (n##3) FUNC (n##4)		\
+  FUNC (n##5) FUNC (n##6) FUNC (n##7) FUNC (n##8) FUNC (n##9)
+
+FUNC10 (1) FUNC10 (2) FUNC10 (3) FUNC10 (4) FUNC10 (5)
+FUNC10 (6) FUNC10 (7) FUNC10 (8) FUNC10 (9) FUNC10 (10)
+FUNC10 (11) FUNC10 (12) FUNC10 (13) FUNC10 (14) FUNC10 (15)
+FUNC10 (16) FUNC10 (17) FUNC10 (18) FUNC10 (19) FUNC10 (20)
+
+int
+main (void)
+{
+  struct s_150 s = { 1, 2, { 3 } };
+
+  return func_150 (&s) == 6 ? 0 : 1;
+}
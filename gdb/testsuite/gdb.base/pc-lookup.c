@@ -0,0 +1,35 @@
+/* Copyright 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+extern int func_2 (int);
+
+volatile int x;
+
+/* Each compilation unit has a static function with the same name, so
+   only the PC tells which one is meant.  */
+
+static int __attribute__ ((noinline))
+helper (int i)
+{
+  return i + x;
+}
+
+int
+main (void)
+{
+  return func_2 (helper (1));
+}
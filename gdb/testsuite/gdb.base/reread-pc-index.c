@@ -0,0 +1,45 @@
+/* Copyright 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int x;
+
+#ifdef REBUILT
+/* Move the functions below to new addresses in the rebuilt
+   program.  */
+
+void
+padding (void)
+{
+  x += 1;
+  x += 2;
+  x += 3;
+  x += 4;
+}
+#endif
+
+void
+foo (void)
+{
+  x++;
+}
+
+int
+main (void)
+{
+  foo ();
+  return 0;
+}
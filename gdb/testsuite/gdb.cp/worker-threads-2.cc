@@ -0,0 +1,51 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace wt_two
+{
+  class wt_shape
+  {
+  public:
+    virtual int wt_area () const { return 0; }
+    virtual ~wt_shape () {}
+  };
+
+  class wt_square : public wt_shape
+  {
+  public:
+    wt_square (int side) : m_side (side) {}
+    int wt_area () const { return m_side * m_side; }
+
+  private:
+    int m_side;
+  };
+
+  int wt_func (int x) { return x * 2; }
+  double wt_func (double x) { return x * 2; }
+}
+
+static int wt_counter = 2;
+
+int
+wt_two_entry (int x)
+{
+  wt_two::wt_square sq (x);
+  const wt_two::wt_shape &shape = sq;
+
+  return shape.wt_area () + wt_two::wt_func (x)
+    + (int) wt_two::wt_func (1.5) + wt_counter;
+}
@@ -0,0 +1,69 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace wt_three
+{
+  enum wt_color { wt_red, wt_green, wt_blue };
+
+  typedef wt_color wt_color_t;
+
+  struct wt_node
+  {
+    wt_color_t color;
+    wt_node *next;
+  };
+
+  static int
+  wt_count (const wt_node *n)
+  {
+    int count = 0;
+
+    for (; n != 0; n = n->next)
+      ++count;
+    return count;
+  }
+}
+
+/* Enough functions for GDB to demangle the names of the minimal
+   symbols on worker threads.  */
+
+#define MANY_1(n) int f_ ## n (int x) { return x + n; }
+#define MANY_10(n) MANY_1 (n ## 0) MANY_1 (n ## 1) MANY_1 (n ## 2) \
+  MANY_1 (n ## 3) MANY_1 (n ## 4) MANY_1 (n ## 5) MANY_1 (n ## 6) \
+  MANY_1 (n ## 7) MANY_1 (n ## 8) MANY_1 (n ## 9)
+#define MANY_100(n) MANY_10 (n ## 0) MANY_10 (n ## 1) MANY_10 (n ## 2) \
+  MANY_10 (n ## 3) MANY_10 (n ## 4) MANY_10 (n ## 5) MANY_10 (n ## 6) \
+  MANY_10 (n ## 7) MANY_10 (n ## 8) MANY_10 (n ## 9)
+#define MANY_1000(n) MANY_100 (n ## 0) MANY_100 (n ## 1) \
+  MANY_100 (n ## 2) MANY_100 (n ## 3) MANY_100 (n ## 4) \
+  MANY_100 (n ## 5) MANY_100 (n ## 6) MANY_100 (n ## 7) \
+  MANY_100 (n ## 8) MANY_100 (n ## 9)
+
+namespace many
+{
+  MANY_1000 (1)
+  MANY_1000 (2)
+}
+
+int
+wt_three_entry (int x)
+{
+  wt_three::wt_node second = { wt_three::wt_blue, 0 };
+  wt_three::wt_node first = { wt_three::wt_red, &second };
+
+  return wt_three::wt_count (&first) + many::f_1000 (x);
+}
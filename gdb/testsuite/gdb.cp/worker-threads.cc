@@ -0,0 +1,52 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace wt_one
+{
+  struct wt_point
+  {
+    int x, y;
+  };
+
+  int wt_counter = 1;
+
+  int
+  wt_func (wt_point p)
+  {
+    return p.x + p.y + wt_counter;
+  }
+
+  template<typename T>
+  T
+  wt_twice (T v)
+  {
+    return v + v;
+  }
+}
+
+extern int wt_two_entry (int);
+extern int wt_three_entry (int);
+
+int
+main ()
+{
+  wt_one::wt_point p = { 1, 2 };
+
+  return (wt_one::wt_func (p) + wt_one::wt_twice (3)
+	  + (int) wt_one::wt_twice (4.0) + wt_two_entry (5)
+	  + wt_three_entry (6));
+}
@@ -25,6 +25,8 @@
 #include <cerrno>
 #include <cstring>
 #include <climits>
+#include <algorithm>
+#include <set>
 #include <vector>
 #include "libiberty.h"
 #include "filenames.h"
@@ -178,6 +180,7 @@ struct Archive::Archive_header
 unsigned int Archive::total_archives;
 unsigned int Archive::total_members;
 unsigned int Archive::total_members_loaded;
+unsigned int Archive::total_armap_checks;
 
 // Archive methods.
 
@@ -198,7 +201,8 @@ const char Archive::sym64name[7] = { '/', 'S', 'Y', 'M', '6', '4', '/' };
 Archive::Archive(const std::string& name, Input_file* input_file,
                  bool is_thin_archive, Dirsearch* dirpath, Task* task)
   : Library_base(task), name_(name), input_file_(input_file), armap_(),
-    armap_names_(), extended_names_(), armap_checked_(), seen_offsets_(),
+    armap_names_(), extended_names_(), armap_checked_(), armap_index_(),
+    seen_offsets_(),
     members_(), is_thin_archive_(is_thin_archive), included_member_(false),
     nested_archives_(), dirpath_(dirpath), num_members_(0),
     included_all_members_(false)
@@ -702,7 +706,7 @@ Archive::get_elf_object_for_member(off_t off, bool* punconfigured)
 
   if (parameters->options().has_plugins())
     {
-      Object* plugin_obj
+      Pluginobj* plugin_obj
 	= parameters->options().plugins()->claim_file(input_file,
 						      memoff,
 						      memsize,
@@ -714,6 +718,7 @@ Archive::get_elf_object_for_member(off_t off, bool* punconfigured)
 	  // Delete its elf object.
 	  if (obj != NULL)
 	    delete obj;
+	  plugin_obj->hash_symbol_names();
           return plugin_obj;
         }
     }
@@ -767,6 +772,16 @@ Archive::read_symbols(off_t off)
 // the normal case, false if the first member we tried to add from
 // this archive had an incompatible target.
 
+// The answer for an archive map entry can only change when the
+// symbol table entry for its name changes, and while we are here that
+// only happens when we include a member.  So after the first pass
+// over the whole archive map, each later pass only looks at the
+// entries for the names of the global symbols of the members
+// included since they were last checked.  We still visit those
+// entries in archive map order, and pick up entries after the current
+// one in the same pass, so we include the same members in the same
+// order as a full scan of every unchecked entry on every pass would.
+
 bool
 Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 		     Input_objects* input_objects, Mapfile* mapfile)
@@ -788,72 +803,210 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   // offset we saw that was present in the seen_offsets_ set.
   off_t last_seen_offset = -1;
 
-  // Track which symbols in the symbol table we've already found to be
-  // defined.
-
   char* tmpbuf = NULL;
   size_t tmpbuflen = 0;
-  bool added_new_object;
-  do
+
+  // The entries to check again in the current pass and in the next
+  // one.
+  std::set<size_t> current;
+  std::set<size_t> next;
+
+  bool ok = true;
+  for (size_t i = 0; i < armap_size; ++i)
     {
-      added_new_object = false;
-      for (size_t i = 0; i < armap_size; ++i)
+      Object* obj;
+      if (!this->check_armap_entry(symtab, layout, input_objects, mapfile, i,
+				   &last_seen_offset, &tmpbuf, &tmpbuflen,
+				   &obj))
 	{
-          if (this->armap_checked_[i])
-            continue;
-	  if (this->armap_[i].file_offset == last_seen_offset)
-            {
-              this->armap_checked_[i] = true;
-              continue;
-            }
-	  if (this->seen_offsets_.find(this->armap_[i].file_offset)
-              != this->seen_offsets_.end())
+	  ok = false;
+	  break;
+	}
+      // The rest of this pass will look at every entry anyhow.
+      if (obj != NULL)
+	this->find_changed_entries(obj, i, NULL, &next);
+    }
+
+  while (ok && !next.empty())
+    {
+      current.swap(next);
+      next.clear();
+      while (!current.empty())
+	{
+	  size_t i = *current.begin();
+	  current.erase(current.begin());
+
+	  Object* obj;
+	  if (!this->check_armap_entry(symtab, layout, input_objects, mapfile,
+				       i, &last_seen_offset, &tmpbuf,
+				       &tmpbuflen, &obj))
 	    {
-              this->armap_checked_[i] = true;
-	      last_seen_offset = this->armap_[i].file_offset;
-	      continue;
+	      ok = false;
+	      break;
 	    }
+	  if (obj != NULL)
+	    this->find_changed_entries(obj, i, &current, &next);
+	}
+    }
+
+  if (tmpbuf != NULL)
+    free(tmpbuf);
 
-	  const char* sym_name = (this->armap_names_.data()
-				  + this->armap_[i].name_offset);
+  if (!ok)
+    return false;
 
-          Symbol* sym;
-          std::string why;
-          Archive::Should_include t =
-	    Archive::should_include_member(symtab, layout, sym_name, &sym,
-					   &why, &tmpbuf, &tmpbuflen);
+  // A full scan would have marked the entries for all the included
+  // members as checked; defines_symbol and the unused symbol iterator
+  // rely on that.
+  for (size_t i = 0; i < armap_size; ++i)
+    if (!this->armap_checked_[i]
+	&& (this->seen_offsets_.find(this->armap_[i].file_offset)
+	    != this->seen_offsets_.end()))
+      this->armap_checked_[i] = true;
 
-	  if (t == Archive::SHOULD_INCLUDE_NO
-              || t == Archive::SHOULD_INCLUDE_YES)
-	    this->armap_checked_[i] = true;
+  input_objects->archive_stop(this);
 
-	  if (t != Archive::SHOULD_INCLUDE_YES)
-	    continue;
+  return true;
+}
+
+// Look up archive map entry I in the symbol table, and include the
+// member if it defines a symbol that we need.  Set *POBJ to the
+// object whose symbols were added to the symbol table, or NULL.
+// Return false if the member had an incompatible target.
+
+bool
+Archive::check_armap_entry(Symbol_table* symtab, Layout* layout,
+			   Input_objects* input_objects, Mapfile* mapfile,
+			   size_t i, off_t* last_seen_offset, char** tmpbufp,
+			   size_t* tmpbuflen, Object** pobj)
+{
+  *pobj = NULL;
+
+  if (this->armap_checked_[i])
+    return true;
+  if (this->armap_[i].file_offset == *last_seen_offset)
+    {
+      this->armap_checked_[i] = true;
+      return true;
+    }
+  if (this->seen_offsets_.find(this->armap_[i].file_offset)
+      != this->seen_offsets_.end())
+    {
+      this->armap_checked_[i] = true;
+      *last_seen_offset = this->armap_[i].file_offset;
+      return true;
+    }
+
+  const char* sym_name = (this->armap_names_.data()
+			  + this->armap_[i].name_offset);
+
+  ++Archive::total_armap_checks;
 
-	  // We want to include this object in the link.
-	  last_seen_offset = this->armap_[i].file_offset;
-	  this->seen_offsets_.insert(last_seen_offset);
+  Symbol* sym;
+  std::string why;
+  Archive::Should_include t =
+    Archive::should_include_member(symtab, layout, sym_name, &sym,
+				   &why, tmpbufp, tmpbuflen);
 
-	  if (!this->include_member(symtab, layout, input_objects,
-				    last_seen_offset, mapfile, sym,
-				    why.c_str()))
+  if (t == Archive::SHOULD_INCLUDE_NO
+      || t == Archive::SHOULD_INCLUDE_YES)
+    this->armap_checked_[i] = true;
+
+  if (t != Archive::SHOULD_INCLUDE_YES)
+    return true;
+
+  // We want to include this object in the link.
+  *last_seen_offset = this->armap_[i].file_offset;
+  this->seen_offsets_.insert(*last_seen_offset);
+
+  return this->include_member(symtab, layout, input_objects,
+			      *last_seen_offset, mapfile, sym, why.c_str(),
+			      pobj);
+}
+
+// Sort the archive map entries by the hash code of the symbol name,
+// ignoring any version, so that we can find the entries for a name
+// without scanning the whole archive map.
+
+void
+Archive::build_armap_index()
+{
+  const size_t armap_size = this->armap_.size();
+  this->armap_index_.reserve(armap_size);
+  for (size_t i = 0; i < armap_size; ++i)
+    {
+      const char* name = (this->armap_names_.data()
+			  + this->armap_[i].name_offset);
+      const char* ver = strchr(name, '@');
+      size_t len = ver != NULL ? ver - name : strlen(name);
+      this->armap_index_.push_back(std::make_pair(string_hash(name, len), i));
+    }
+  std::sort(this->armap_index_.begin(), this->armap_index_.end());
+}
+
+// OBJ has just been included in the link, which may have changed the
+// symbol table entries for the names of its global symbols.  Find the
+// unchecked archive map entries with those names, which need to be
+// looked up again.
+
+void
+Archive::find_changed_entries(Object* obj, size_t pos,
+			      std::set<size_t>* current,
+			      std::set<size_t>* next)
+{
+  const Object::Symbols* syms = obj->get_global_symbols();
+  if (syms == NULL)
+    {
+      // We don't know which symbols changed, so check everything.
+      for (size_t i = 0; i < this->armap_.size(); ++i)
+	{
+	  if (this->armap_checked_[i])
+	    continue;
+	  if (i > pos)
 	    {
-	      if (tmpbuf != NULL)
-		free(tmpbuf);
-	      return false;
+	      if (current != NULL)
+		current->insert(i);
 	    }
-
-	  added_new_object = true;
+	  else
+	    next->insert(i);
 	}
+      return;
     }
-  while (added_new_object);
 
-  if (tmpbuf != NULL)
-    free(tmpbuf);
+  if (this->armap_index_.empty())
+    this->build_armap_index();
 
-  input_objects->archive_stop(this);
-
-  return true;
+  for (Object::Symbols::const_iterator p = syms->begin();
+       p != syms->end();
+       ++p)
+    {
+      if (*p == NULL)
+	continue;
+      const char* name = (*p)->name();
+      size_t len = strlen(name);
+      size_t hash = string_hash(name, len);
+      std::vector<Armap_index_entry>::const_iterator q =
+	std::lower_bound(this->armap_index_.begin(), this->armap_index_.end(),
+			 std::make_pair(hash, static_cast<size_t>(0)));
+      for (; q != this->armap_index_.end() && q->first == hash; ++q)
+	{
+	  size_t i = q->second;
+	  if (this->armap_checked_[i])
+	    continue;
+	  const char* armap_name = (this->armap_names_.data()
+				    + this->armap_[i].name_offset);
+	  if (strncmp(armap_name, name, len) != 0
+	      || (armap_name[len] != '\0' && armap_name[len] != '@'))
+	    continue;
+	  if (i > pos)
+	    {
+	      if (current != NULL)
+		current->insert(i);
+	    }
+	  else
+	    next->insert(i);
+	}
+    }
 }
 
 // Return whether the archive includes a member which defines the
@@ -915,7 +1068,7 @@ Archive::include_all_members(Symbol_table* symtab, Layout* layout,
            ++p)
         {
           if (!this->include_member(symtab, layout, input_objects, p->first,
-				    mapfile, NULL, "--whole-archive"))
+				    mapfile, NULL, "--whole-archive", NULL))
 	    return false;
           ++Archive::total_members;
         }
@@ -927,7 +1080,7 @@ Archive::include_all_members(Symbol_table* symtab, Layout* layout,
            ++p)
         {
           if (!this->include_member(symtab, layout, input_objects, p->off,
-				    mapfile, NULL, "--whole-archive"))
+				    mapfile, NULL, "--whole-archive", NULL))
 	    return false;
           ++Archive::total_members;
         }
@@ -980,17 +1133,23 @@ class Thin_archive_object_unlocker
 
 // Include an archive member in the link.  OFF is the file offset of
 // the member header.  WHY is the reason we are including this member.
-// Return true if we added the member or if we had an error, return
-// false if this was the first member we tried to add from this
-// archive and it had an incompatible format.
+// If POBJ is not NULL, set *POBJ to the object if we added its
+// symbols to the symbol table, NULL otherwise.  Return true if we
+// added the member or if we had an error, return false if this was
+// the first member we tried to add from this archive and it had an
+// incompatible format.
 
 bool
 Archive::include_member(Symbol_table* symtab, Layout* layout,
 			Input_objects* input_objects, off_t off,
-			Mapfile* mapfile, Symbol* sym, const char* why)
+			Mapfile* mapfile, Symbol* sym, const char* why,
+			Object** pobj)
 {
   ++Archive::total_members_loaded;
 
+  if (pobj != NULL)
+    *pobj = NULL;
+
   std::map<off_t, Archive_member>::const_iterator p = this->members_.find(off);
   if (p != this->members_.end())
     {
@@ -1004,6 +1163,8 @@ Archive::include_member(Symbol_table* symtab, Layout* layout,
           obj->layout(symtab, layout, sd);
           obj->add_symbols(symtab, sd, layout);
 	  this->included_member_ = true;
+	  if (pobj != NULL)
+	    *pobj = obj;
         }
       delete sd;
       return true;
@@ -1038,6 +1199,8 @@ Archive::include_member(Symbol_table* symtab, Layout* layout,
     {
       pluginobj->add_symbols(symtab, NULL, layout);
       this->included_member_ = true;
+      if (pobj != NULL)
+	*pobj = obj;
       return true;
     }
 
@@ -1058,6 +1221,8 @@ Archive::include_member(Symbol_table* symtab, Layout* layout,
   }
 
   this->included_member_ = true;
+  if (pobj != NULL)
+    *pobj = obj;
   return true;
 }
 
@@ -1087,6 +1252,8 @@ Archive::print_stats()
           program_name, Archive::total_members);
   fprintf(stderr, _("%s: loaded archive members: %u\n"),
           program_name, Archive::total_members_loaded);
+  fprintf(stderr, _("%s: archive symbol table lookups: %u\n"),
+          program_name, Archive::total_armap_checks);
 }
 
 // Add_archive_symbols methods.
@@ -1120,6 +1287,10 @@ Add_archive_symbols::locks(Task_locker* tl)
 void
 Add_archive_symbols::run(Workqueue* workqueue)
 {
+  // Members are selected by looking at the symbol table, so it must
+  // be complete.
+  this->symtab_->add_pending_symbols();
+
   // For an incremental link, begin recording layout information.
   Incremental_inputs* incremental_inputs = this->layout_->incremental_inputs();
   if (incremental_inputs != NULL)
@@ -1342,6 +1513,8 @@ Add_lib_group_symbols::locks(Task_locker* tl)
 void
 Add_lib_group_symbols::run(Workqueue*)
 {
+  this->symtab_->add_pending_symbols();
+
   // For an incremental link, begin recording layout information.
   Incremental_inputs* incremental_inputs = this->layout_->incremental_inputs();
   if (incremental_inputs != NULL)
@@ -23,6 +23,7 @@
 #ifndef GOLD_ARCHIVE_H
 #define GOLD_ARCHIVE_H
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -286,6 +287,8 @@ class Archive : public Library_base
   static unsigned int total_members;
   // Number of archive members loaded.
   static unsigned int total_members_loaded;
+  // Number of archive map entries looked up in the symbol table.
+  static unsigned int total_armap_checks;
 
   // Get a view into the underlying file.
   const unsigned char*
@@ -335,10 +338,30 @@ class Archive : public Library_base
   bool
   include_all_members(Symbol_table*, Layout*, Input_objects*, Mapfile*);
 
-  // Include an archive member in the link.
+  // Include an archive member in the link.  If POBJ is not NULL,
+  // set *POBJ to the object whose symbols were added, or NULL.
   bool
   include_member(Symbol_table*, Layout*, Input_objects*, off_t off,
-		 Mapfile*, Symbol*, const char* why);
+		 Mapfile*, Symbol*, const char* why, Object** pobj);
+
+  // Look up archive map entry I in the symbol table, and include its
+  // member in the link if needed.  Used by add_symbols.
+  bool
+  check_armap_entry(Symbol_table*, Layout*, Input_objects*, Mapfile*,
+		    size_t i, off_t* last_seen_offset, char** tmpbufp,
+		    size_t* tmpbuflen, Object** pobj);
+
+  // Sort the archive map entries by the hash code of their names.
+  void
+  build_armap_index();
+
+  // Find the unchecked archive map entries for symbols with the same
+  // names as the global symbols of OBJ, which was just included.
+  // Entries after POS are added to CURRENT, if it is not NULL, and
+  // the others are added to NEXT.
+  void
+  find_changed_entries(Object* obj, size_t pos, std::set<size_t>* current,
+		       std::set<size_t>* next);
 
   // Return whether we found this archive by searching a directory.
   bool
@@ -369,6 +392,10 @@ class Archive : public Library_base
     off_t file_offset;
   };
 
+  // An entry in the archive map index: the hash code of the symbol
+  // name without any version, and the index in armap_.
+  typedef std::pair<size_t, size_t> Armap_index_entry;
+
   // A simple hash code for off_t values.
   class Seen_hash
   {
@@ -393,6 +420,9 @@ class Archive : public Library_base
   // Track which symbols in the archive map are for elements which are
   // defined or which have already been included in the link.
   std::vector<bool> armap_checked_;
+  // The archive map entries sorted by name hash code.  This is built
+  // the first time we include a member.
+  std::vector<Armap_index_entry> armap_index_;
   // Track which elements have been included by offset.
   Unordered_set<off_t, Seen_hash> seen_offsets_;
   // Table of objects whose symbols have been pre-read.
@@ -0,0 +1,873 @@
+// debug-names.cc -- merge DWARF 5 .debug_names sections
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <algorithm>
+
+#include "debug-names.h"
+#include "dwarf_reader.h"
+#include "dwarf.h"
+#include "int_encoding.h"
+#include "object.h"
+#include "output.h"
+
+namespace gold
+{
+
+// Sizes of the fixed parts of a name index.
+const int debug_names_version = 5;
+const int debug_names_offset_size = 4;
+const int debug_names_hdr_size = 4 + 2 + 2 + 7 * debug_names_offset_size;
+
+// Read an unsigned LEB128 value from *PP, which must not go past END.
+
+static bool
+read_uleb128(const unsigned char** pp, const unsigned char* end,
+	     uint64_t* value)
+{
+  const unsigned char* p = *pp;
+  uint64_t result = 0;
+  int shift = 0;
+
+  while (p < end)
+    {
+      unsigned char byte = *p++;
+      if (shift < 64)
+	result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+      if ((byte & 0x80) == 0)
+	{
+	  *pp = p;
+	  *value = result;
+	  return true;
+	}
+    }
+  return false;
+}
+
+// Read an index attribute value of form FORM from *PP, which must not
+// go past END.  Return false if the form is not supported.
+
+static bool
+read_index_value(unsigned int form, const unsigned char** pp,
+		 const unsigned char* end, uint64_t* value)
+{
+  const unsigned char* p = *pp;
+  int len;
+
+  switch (form)
+    {
+    case elfcpp::DW_FORM_flag_present:
+      *value = 1;
+      return true;
+    case elfcpp::DW_FORM_udata:
+    case elfcpp::DW_FORM_ref_udata:
+      return read_uleb128(pp, end, value);
+    case elfcpp::DW_FORM_data1:
+    case elfcpp::DW_FORM_ref1:
+    case elfcpp::DW_FORM_flag:
+      len = 1;
+      break;
+    case elfcpp::DW_FORM_data2:
+    case elfcpp::DW_FORM_ref2:
+      len = 2;
+      break;
+    case elfcpp::DW_FORM_data4:
+    case elfcpp::DW_FORM_ref4:
+      len = 4;
+      break;
+    case elfcpp::DW_FORM_data8:
+    case elfcpp::DW_FORM_ref8:
+    case elfcpp::DW_FORM_ref_sig8:
+      len = 8;
+      break;
+    default:
+      return false;
+    }
+
+  if (end - p < len)
+    return false;
+  switch (len)
+    {
+    case 1:
+      *value = *p;
+      break;
+    case 2:
+      *value = read_from_pointer<16>(p);
+      break;
+    case 4:
+      *value = read_from_pointer<32>(p);
+      break;
+    default:
+      *value = read_from_pointer<64>(p);
+      break;
+    }
+  *pp = p + len;
+  return true;
+}
+
+// Return the size of an index attribute value VALUE of form FORM.
+
+static section_size_type
+index_value_size(unsigned int form, uint64_t value)
+{
+  switch (form)
+    {
+    case elfcpp::DW_FORM_flag_present:
+      return 0;
+    case elfcpp::DW_FORM_udata:
+    case elfcpp::DW_FORM_ref_udata:
+      return get_length_as_unsigned_LEB_128(value);
+    case elfcpp::DW_FORM_data1:
+    case elfcpp::DW_FORM_ref1:
+    case elfcpp::DW_FORM_flag:
+      return 1;
+    case elfcpp::DW_FORM_data2:
+    case elfcpp::DW_FORM_ref2:
+      return 2;
+    case elfcpp::DW_FORM_data4:
+    case elfcpp::DW_FORM_ref4:
+      return 4;
+    default:
+      return 8;
+    }
+}
+
+// Append an index attribute value VALUE of form FORM to BUFFER.
+
+static void
+write_index_value(std::vector<unsigned char>* buffer, unsigned int form,
+		  uint64_t value)
+{
+  switch (form)
+    {
+    case elfcpp::DW_FORM_flag_present:
+      break;
+    case elfcpp::DW_FORM_udata:
+    case elfcpp::DW_FORM_ref_udata:
+      write_unsigned_LEB_128(buffer, value);
+      break;
+    case elfcpp::DW_FORM_data1:
+    case elfcpp::DW_FORM_ref1:
+    case elfcpp::DW_FORM_flag:
+      buffer->push_back(value);
+      break;
+    case elfcpp::DW_FORM_data2:
+    case elfcpp::DW_FORM_ref2:
+      insert_into_vector<16>(buffer, value);
+      break;
+    case elfcpp::DW_FORM_data4:
+    case elfcpp::DW_FORM_ref4:
+      insert_into_vector<32>(buffer, value);
+      break;
+    default:
+      insert_into_vector<64>(buffer, value);
+      break;
+    }
+}
+
+// Return the hash of NAME as used by the DWARF 5 name index: the DJB
+// hash of the case-folded name.  Case folding is only done for ASCII
+// names; return false for any other name.
+
+static bool
+debug_names_hash(const char* name, uint32_t* hash)
+{
+  uint32_t h = 5381;
+
+  for (const unsigned char* p = reinterpret_cast<const unsigned char*>(name);
+       *p != '\0';
+       ++p)
+    {
+      unsigned char c = *p;
+      if (c >= 0x80)
+	return false;
+      if (c >= 'A' && c <= 'Z')
+	c += 'a' - 'A';
+      h = h * 33 + c;
+    }
+  *hash = h;
+  return true;
+}
+
+// Return the number of hash buckets for COUNT distinct hashes.  This
+// is the load factor LLVM uses.
+
+static unsigned int
+debug_names_bucket_count(unsigned int count)
+{
+  if (count > 1024)
+    return count / 4;
+  if (count > 16)
+    return count / 2;
+  return count > 0 ? count : 1;
+}
+
+// Return the offset in the output section of OFFSET in input section
+// SHNDX of OBJECT.
+
+static uint64_t
+input_output_offset(Relobj* object, unsigned int shndx, off_t offset)
+{
+  uint64_t section_offset = object->output_section_offset(shndx);
+  if (section_offset != -1ULL)
+    return section_offset + offset;
+  Output_section* os = object->output_section(shndx);
+  gold_assert(os != NULL);
+  return os->output_offset(object, shndx, offset);
+}
+
+// Write a 4-byte VALUE to P in the byte order of the target.
+
+static void
+write_offset(unsigned char* p, uint64_t value)
+{
+  if (value > 0xffffffffU)
+    gold_error(_(".debug_names: offset does not fit in 32 bits"));
+  if (parameters->target().is_big_endian())
+    elfcpp::Swap_unaligned<32, true>::writeval(p, value);
+  else
+    elfcpp::Swap_unaligned<32, false>::writeval(p, value);
+}
+
+// Sort the names by hash bucket, then by hash.
+
+class Debug_names_name_order
+{
+ public:
+  Debug_names_name_order(const std::vector<uint32_t>* hashes,
+			 unsigned int bucket_count)
+    : hashes_(hashes), bucket_count_(bucket_count)
+  { }
+
+  bool
+  operator()(unsigned int a, unsigned int b) const
+  {
+    uint32_t ha = (*this->hashes_)[a];
+    uint32_t hb = (*this->hashes_)[b];
+    if (ha % this->bucket_count_ != hb % this->bucket_count_)
+      return ha % this->bucket_count_ < hb % this->bucket_count_;
+    if (ha != hb)
+      return ha < hb;
+    return a < b;
+  }
+
+ private:
+  const std::vector<uint32_t>* hashes_;
+  unsigned int bucket_count_;
+};
+
+// class Debug_names
+
+Debug_names::~Debug_names()
+{
+  if (this->str_is_new_)
+    delete[] this->str_contents_;
+}
+
+// Return the string at OFFSET in the string section SHNDX of OBJECT.
+// The strings must end up in the output .debug_str section, where
+// do_write can find their offsets.
+
+const char*
+Debug_names::get_string(Relobj* object, unsigned int shndx, off_t offset)
+{
+  if (object != this->str_object_ || shndx != this->str_shndx_)
+    {
+      Output_section* os = object->output_section(shndx);
+      if (os == NULL || strcmp(os->name(), ".debug_str") != 0)
+	return NULL;
+
+      if (this->str_is_new_)
+	delete[] this->str_contents_;
+      this->str_object_ = NULL;
+      bool is_new;
+      this->str_contents_ =
+	object->decompressed_section_contents(shndx, &this->str_size_,
+					      &is_new);
+      this->str_is_new_ = is_new;
+      if (this->str_contents_ == NULL)
+	return NULL;
+      this->str_object_ = object;
+      this->str_shndx_ = shndx;
+    }
+
+  if (offset < 0 || static_cast<section_size_type>(offset) >= this->str_size_)
+    return NULL;
+  const char* str = reinterpret_cast<const char*>(this->str_contents_
+						  + offset);
+  if (memchr(str, '\0', this->str_size_ - offset) == NULL)
+    return NULL;
+  return str;
+}
+
+// Return the section and offset that the relocated 4-byte field at P
+// refers to, or 0 if there is no relocation for it.
+
+unsigned int
+Debug_names::read_reloc_target(Elf_reloc_mapper* reloc_mapper,
+			       unsigned int reloc_type,
+			       const unsigned char* contents,
+			       const unsigned char* p, off_t* target_offset)
+{
+  off_t value;
+  unsigned int shndx = reloc_mapper->get_reloc_target(p - contents, &value);
+  if (shndx == 0)
+    return 0;
+  *target_offset = value;
+  if (reloc_type == elfcpp::SHT_REL)
+    *target_offset += read_from_pointer<32>(p);
+  return shndx;
+}
+
+// Return the index of ABBREV in ABBREVS_, adding it if needed.
+
+unsigned int
+Debug_names::find_abbrev(const Abbrev& abbrev)
+{
+  std::pair<Abbrev_map::iterator, bool> ins =
+    this->abbrev_map_.insert(std::make_pair(abbrev, 0));
+  if (ins.second)
+    {
+      ins.first->second = this->abbrevs_.size();
+      this->abbrevs_.push_back(abbrev);
+    }
+  return ins.first->second;
+}
+
+// Read the name index at *PP in CONTENTS.  Add its compilation units,
+// abbreviations and entries, and append its names to PENDING.
+
+bool
+Debug_names::read_name_index(Relobj* object, Elf_reloc_mapper* reloc_mapper,
+			     unsigned int reloc_type,
+			     const unsigned char* contents,
+			     const unsigned char** pp,
+			     const unsigned char* end,
+			     std::vector<Pending_name>* pending)
+{
+  const unsigned char* p = *pp;
+
+  // Only the 32-bit DWARF format is supported.
+  if (end - p < debug_names_hdr_size)
+    return false;
+  uint32_t unit_length = read_from_pointer<32>(p);
+  p += 4;
+  if (unit_length >= 0xfffffff0U
+      || unit_length > static_cast<uint64_t>(end - p))
+    return false;
+  const unsigned char* unit_end = p + unit_length;
+  if (unit_length < debug_names_hdr_size - 4)
+    return false;
+
+  unsigned int version = read_from_pointer<16>(p);
+  p += 4;
+  if (version != debug_names_version)
+    return false;
+  uint32_t comp_unit_count = read_from_pointer<32>(p);
+  uint32_t local_type_unit_count = read_from_pointer<32>(p + 4);
+  uint32_t foreign_type_unit_count = read_from_pointer<32>(p + 8);
+  uint32_t bucket_count = read_from_pointer<32>(p + 12);
+  uint32_t name_count = read_from_pointer<32>(p + 16);
+  uint32_t abbrev_table_size = read_from_pointer<32>(p + 20);
+  uint32_t augmentation_string_size = read_from_pointer<32>(p + 24);
+  p += 28;
+
+  // Type units would need .debug_types-style signatures merged as
+  // well; leave such indexes alone.
+  if (local_type_unit_count != 0 || foreign_type_unit_count != 0)
+    return false;
+
+  uint64_t tables_size = (static_cast<uint64_t>(comp_unit_count)
+			  + bucket_count
+			  + (bucket_count != 0 ? name_count : 0)
+			  + 2 * static_cast<uint64_t>(name_count));
+  tables_size *= debug_names_offset_size;
+  tables_size += augmentation_string_size;
+  tables_size += abbrev_table_size;
+  if (tables_size > static_cast<uint64_t>(unit_end - p))
+    return false;
+  p += augmentation_string_size;
+
+  // The compilation unit list.
+  unsigned int cu_base = this->comp_units_.size();
+  for (uint32_t i = 0; i < comp_unit_count; ++i, p += 4)
+    {
+      off_t offset;
+      unsigned int shndx = this->read_reloc_target(reloc_mapper, reloc_type,
+						   contents, p, &offset);
+      if (shndx == 0)
+	return false;
+      this->comp_units_.push_back(Input_location(object, shndx, offset));
+    }
+
+  const unsigned char* hashes = NULL;
+  if (bucket_count != 0)
+    {
+      p += bucket_count * debug_names_offset_size;
+      hashes = p;
+      p += name_count * debug_names_offset_size;
+    }
+  const unsigned char* string_offsets = p;
+  p += name_count * debug_names_offset_size;
+  const unsigned char* entry_offsets = p;
+  p += name_count * debug_names_offset_size;
+
+  // The abbreviation table.  Map the input codes to output
+  // abbreviations.
+  const unsigned char* abbrev_end = p + abbrev_table_size;
+  const unsigned char* pool = abbrev_end;
+  struct Input_abbrev
+  {
+    unsigned int abbrev;
+    std::vector<std::pair<unsigned int, unsigned int> > attrs;
+  };
+  std::map<uint64_t, Input_abbrev> input_abbrevs;
+  while (true)
+    {
+      uint64_t code, tag;
+      if (!read_uleb128(&p, abbrev_end, &code))
+	return false;
+      if (code == 0)
+	break;
+      if (!read_uleb128(&p, abbrev_end, &tag))
+	return false;
+
+      Input_abbrev& in = input_abbrevs[code];
+      if (!in.attrs.empty())
+	return false;
+      Abbrev abbrev;
+      abbrev.push_back(tag);
+      while (true)
+	{
+	  uint64_t idx, form;
+	  if (!read_uleb128(&p, abbrev_end, &idx)
+	      || !read_uleb128(&p, abbrev_end, &form))
+	    return false;
+	  if (idx == 0 && form == 0)
+	    break;
+	  if (idx == 0 || idx == elfcpp::DW_IDX_type_unit)
+	    return false;
+	  in.attrs.push_back(std::make_pair(idx, form));
+	  if (idx == elfcpp::DW_IDX_compile_unit)
+	    continue;
+	  // Parents are rewritten as offsets in the output entry pool,
+	  // which need 4 bytes.  Producers disagree on whether they are
+	  // constants or references, so keep the class of the form.
+	  if (idx == elfcpp::DW_IDX_parent
+	      && form != elfcpp::DW_FORM_flag_present)
+	    {
+	      if (form == elfcpp::DW_FORM_ref1
+		  || form == elfcpp::DW_FORM_ref2
+		  || form == elfcpp::DW_FORM_ref4
+		  || form == elfcpp::DW_FORM_ref8
+		  || form == elfcpp::DW_FORM_ref_udata)
+		form = elfcpp::DW_FORM_ref4;
+	      else
+		form = elfcpp::DW_FORM_data4;
+	    }
+	  abbrev.push_back(idx);
+	  abbrev.push_back(form);
+	}
+      in.abbrev = this->find_abbrev(abbrev);
+    }
+
+  // The entries, in the order of their names.  Entries are found by
+  // their offset in the input entry pool when resolving parents.
+  typedef std::map<uint64_t, unsigned int> Entry_map;
+  Entry_map entry_map;
+  std::vector<std::pair<unsigned int, uint64_t> > parents;
+  for (uint32_t i = 0; i < name_count; ++i)
+    {
+      off_t str_offset;
+      const unsigned char* pstr = string_offsets + i * debug_names_offset_size;
+      unsigned int str_shndx = this->read_reloc_target(reloc_mapper,
+						       reloc_type, contents,
+						       pstr, &str_offset);
+      if (str_shndx == 0)
+	return false;
+      const char* name = this->get_string(object, str_shndx, str_offset);
+      if (name == NULL)
+	return false;
+
+      uint32_t hash;
+      if (hashes != NULL)
+	hash = read_from_pointer<32>(hashes + i * debug_names_offset_size);
+      else if (!debug_names_hash(name, &hash))
+	return false;
+
+      uint32_t entry_offset =
+	read_from_pointer<32>(entry_offsets + i * debug_names_offset_size);
+      if (entry_offset >= static_cast<uint64_t>(unit_end - pool))
+	return false;
+      const unsigned char* q = pool + entry_offset;
+      unsigned int first_entry = this->entries_.size();
+      while (true)
+	{
+	  uint64_t offset = q - pool;
+	  uint64_t code;
+	  if (!read_uleb128(&q, unit_end, &code))
+	    return false;
+	  if (code == 0)
+	    break;
+	  std::map<uint64_t, Input_abbrev>::const_iterator pa =
+	    input_abbrevs.find(code);
+	  if (pa == input_abbrevs.end())
+	    return false;
+
+	  // Without DW_IDX_compile_unit, entries belong to the only
+	  // compilation unit.
+	  uint64_t cu_index = 0;
+	  bool has_cu = false;
+	  unsigned int first_value = this->values_.size();
+	  for (size_t j = 0; j < pa->second.attrs.size(); ++j)
+	    {
+	      unsigned int idx = pa->second.attrs[j].first;
+	      unsigned int form = pa->second.attrs[j].second;
+	      uint64_t value;
+	      if (!read_index_value(form, &q, unit_end, &value))
+		return false;
+	      if (idx == elfcpp::DW_IDX_compile_unit)
+		{
+		  cu_index = value;
+		  has_cu = true;
+		  continue;
+		}
+	      if (idx == elfcpp::DW_IDX_parent
+		  && form != elfcpp::DW_FORM_flag_present)
+		parents.push_back(std::make_pair(this->values_.size(), value));
+	      this->values_.push_back(value);
+	    }
+	  if (has_cu ? cu_index >= comp_unit_count : comp_unit_count != 1)
+	    return false;
+
+	  if (!entry_map.insert(std::make_pair(offset,
+					       this->entries_.size())).second)
+	    return false;
+	  this->entries_.push_back(Entry(pa->second.abbrev,
+					 cu_base + cu_index, first_value));
+	}
+
+      pending->push_back(Pending_name(name, hash,
+				      Input_location(object, str_shndx,
+						     str_offset),
+				      first_entry,
+				      this->entries_.size() - first_entry));
+    }
+
+  for (size_t i = 0; i < parents.size(); ++i)
+    {
+      Entry_map::const_iterator pe = entry_map.find(parents[i].second);
+      if (pe == entry_map.end())
+	return false;
+      this->values_[parents[i].first] = pe->second;
+    }
+
+  *pp = unit_end;
+  return true;
+}
+
+// Merge the name indexes in the .debug_names input section SHNDX of
+// OBJECT.
+
+bool
+Debug_names::add_input_section(Relobj* object, const unsigned char* symbols,
+			       off_t symbols_size, unsigned int shndx,
+			       unsigned int reloc_shndx,
+			       unsigned int reloc_type)
+{
+  // The offsets of the compilation units and names are only known
+  // from the relocations.
+  if (reloc_shndx == 0 || object->is_incremental())
+    return false;
+
+  section_size_type len;
+  bool is_new;
+  const unsigned char* contents =
+    object->decompressed_section_contents(shndx, &len, &is_new);
+  if (contents == NULL)
+    return false;
+
+  Elf_reloc_mapper* reloc_mapper = make_elf_reloc_mapper(object, symbols,
+							 symbols_size);
+  reloc_mapper->initialize(reloc_shndx, reloc_type);
+
+  // A section may hold several name indexes, for instance after a
+  // relocatable link.  Either all of them are merged or none.
+  size_t comp_unit_count = this->comp_units_.size();
+  size_t abbrev_count = this->abbrevs_.size();
+  size_t entry_count = this->entries_.size();
+  size_t value_count = this->values_.size();
+  std::vector<Pending_name> pending;
+  const unsigned char* p = contents;
+  const unsigned char* end = contents + len;
+  bool ok = true;
+  while (ok && p < end)
+    ok = this->read_name_index(object, reloc_mapper, reloc_type, contents,
+			       &p, end, &pending);
+
+  if (ok)
+    {
+      for (size_t i = 0; i < pending.size(); ++i)
+	{
+	  const Pending_name& pn = pending[i];
+	  std::pair<Name_map::iterator, bool> ins =
+	    this->name_map_.insert(std::make_pair(pn.name,
+						  this->names_.size()));
+	  if (ins.second)
+	    this->names_.push_back(Name(pn.hash, pn.string));
+	  Name& name = this->names_[ins.first->second];
+	  for (unsigned int j = 0; j < pn.entry_count; ++j)
+	    name.entries.push_back(pn.first_entry + j);
+	}
+    }
+  else
+    {
+      this->comp_units_.resize(comp_unit_count, Input_location(NULL, 0, 0));
+      for (size_t i = abbrev_count; i < this->abbrevs_.size(); ++i)
+	this->abbrev_map_.erase(this->abbrevs_[i]);
+      this->abbrevs_.resize(abbrev_count);
+      this->entries_.resize(entry_count, Entry(0, 0, 0));
+      this->values_.resize(value_count);
+    }
+
+  delete reloc_mapper;
+  if (is_new)
+    delete[] contents;
+  if (this->str_is_new_)
+    delete[] this->str_contents_;
+  this->str_object_ = NULL;
+  this->str_contents_ = NULL;
+  this->str_is_new_ = false;
+  return ok;
+}
+
+// Return the size in the entry pool of ENTRY.
+
+section_size_type
+Debug_names::entry_size(const Entry& entry) const
+{
+  const Abbrev& abbrev = this->abbrevs_[entry.abbrev];
+  section_size_type size = get_length_as_unsigned_LEB_128(entry.abbrev + 1);
+  size += index_value_size(this->cu_form_, 0);
+  for (size_t i = 1, j = entry.first_value; i < abbrev.size(); i += 2, ++j)
+    {
+      if (abbrev[i] == elfcpp::DW_IDX_parent)
+	size += index_value_size(abbrev[i + 1], 0);
+      else
+	size += index_value_size(abbrev[i + 1], this->values_[j]);
+    }
+  return size;
+}
+
+// Set the size of the .debug_names section, and lay out everything
+// except the offsets that are only known when writing it.
+
+void
+Debug_names::set_final_data_size()
+{
+  if (!this->contents_.empty())
+    {
+      this->set_data_size(this->contents_.size());
+      return;
+    }
+
+  // The names are no longer looked up.
+  this->name_map_.clear();
+
+  unsigned int cu_count = this->comp_units_.size();
+  if (cu_count <= 0xff)
+    this->cu_form_ = elfcpp::DW_FORM_data1;
+  else if (cu_count <= 0xffff)
+    this->cu_form_ = elfcpp::DW_FORM_data2;
+  else
+    this->cu_form_ = elfcpp::DW_FORM_data4;
+
+  // Put the names in bucket order.
+  unsigned int name_count = this->names_.size();
+  std::vector<uint32_t> hashes(name_count);
+  for (unsigned int i = 0; i < name_count; ++i)
+    hashes[i] = this->names_[i].hash;
+  std::vector<uint32_t> unique_hashes(hashes);
+  std::sort(unique_hashes.begin(), unique_hashes.end());
+  unsigned int unique_count =
+    std::unique(unique_hashes.begin(), unique_hashes.end())
+    - unique_hashes.begin();
+  this->bucket_count_ = debug_names_bucket_count(unique_count);
+  this->name_order_.resize(name_count);
+  for (unsigned int i = 0; i < name_count; ++i)
+    this->name_order_[i] = i;
+  std::sort(this->name_order_.begin(), this->name_order_.end(),
+	    Debug_names_name_order(&hashes, this->bucket_count_));
+
+  // Assign the entries their offsets in the entry pool.
+  std::vector<uint32_t> name_offsets(name_count);
+  uint64_t pool_size = 0;
+  for (unsigned int i = 0; i < name_count; ++i)
+    {
+      Name& name = this->names_[this->name_order_[i]];
+      name_offsets[i] = pool_size;
+      for (size_t j = 0; j < name.entries.size(); ++j)
+	{
+	  Entry& entry = this->entries_[name.entries[j]];
+	  entry.offset = pool_size;
+	  pool_size += this->entry_size(entry);
+	}
+      // The terminating 0 of the list of entries.
+      ++pool_size;
+    }
+
+  std::vector<unsigned char> abbrev_table;
+  for (size_t i = 0; i < this->abbrevs_.size(); ++i)
+    {
+      const Abbrev& abbrev = this->abbrevs_[i];
+      write_unsigned_LEB_128(&abbrev_table, i + 1);
+      write_unsigned_LEB_128(&abbrev_table, abbrev[0]);
+      write_unsigned_LEB_128(&abbrev_table, elfcpp::DW_IDX_compile_unit);
+      write_unsigned_LEB_128(&abbrev_table, this->cu_form_);
+      for (size_t j = 1; j < abbrev.size(); ++j)
+	write_unsigned_LEB_128(&abbrev_table, abbrev[j]);
+      write_unsigned_LEB_128(&abbrev_table, 0);
+      write_unsigned_LEB_128(&abbrev_table, 0);
+    }
+  write_unsigned_LEB_128(&abbrev_table, 0);
+
+  uint64_t unit_length = (debug_names_hdr_size - 4
+			  + (cu_count + this->bucket_count_
+			     + 3 * static_cast<uint64_t>(name_count))
+			    * debug_names_offset_size
+			  + abbrev_table.size()
+			  + pool_size);
+  if (unit_length >= 0xfffffff0U)
+    {
+      gold_error(_(".debug_names: merged name index is too large"));
+      unit_length = 0;
+    }
+
+  std::vector<unsigned char>& contents(this->contents_);
+  contents.reserve(unit_length + 4);
+
+  // The header.
+  insert_into_vector<32>(&contents, unit_length);
+  insert_into_vector<16>(&contents, debug_names_version);
+  insert_into_vector<16>(&contents, 0);
+  insert_into_vector<32>(&contents, cu_count);
+  insert_into_vector<32>(&contents, 0);
+  insert_into_vector<32>(&contents, 0);
+  insert_into_vector<32>(&contents, this->bucket_count_);
+  insert_into_vector<32>(&contents, name_count);
+  insert_into_vector<32>(&contents, abbrev_table.size());
+  insert_into_vector<32>(&contents, 0);
+  gold_assert(contents.size() == debug_names_hdr_size);
+
+  // The compilation unit list, filled in by do_write.
+  this->cu_list_offset_ = contents.size();
+  contents.resize(contents.size() + cu_count * debug_names_offset_size);
+
+  // The hash buckets hold the 1-based index of the first name in
+  // each bucket, or 0.
+  std::vector<uint32_t> buckets(this->bucket_count_);
+  for (unsigned int i = name_count; i > 0; --i)
+    buckets[hashes[this->name_order_[i - 1]] % this->bucket_count_] = i;
+  for (unsigned int i = 0; i < this->bucket_count_; ++i)
+    insert_into_vector<32>(&contents, buckets[i]);
+  for (unsigned int i = 0; i < name_count; ++i)
+    insert_into_vector<32>(&contents, hashes[this->name_order_[i]]);
+
+  // The string offsets, filled in by do_write.
+  this->str_offsets_offset_ = contents.size();
+  contents.resize(contents.size() + name_count * debug_names_offset_size);
+
+  for (unsigned int i = 0; i < name_count; ++i)
+    insert_into_vector<32>(&contents, name_offsets[i]);
+
+  contents.insert(contents.end(), abbrev_table.begin(), abbrev_table.end());
+
+  // The entry pool.
+  section_size_type pool_start = contents.size();
+  for (unsigned int i = 0; i < name_count; ++i)
+    {
+      const Name& name = this->names_[this->name_order_[i]];
+      for (size_t j = 0; j < name.entries.size(); ++j)
+	{
+	  const Entry& entry = this->entries_[name.entries[j]];
+	  const Abbrev& abbrev = this->abbrevs_[entry.abbrev];
+	  gold_assert(contents.size() - pool_start == entry.offset);
+	  write_unsigned_LEB_128(&contents, entry.abbrev + 1);
+	  write_index_value(&contents, this->cu_form_, entry.comp_unit);
+	  for (size_t k = 1, v = entry.first_value;
+	       k < abbrev.size();
+	       k += 2, ++v)
+	    {
+	      uint64_t value = this->values_[v];
+	      if (abbrev[k] == elfcpp::DW_IDX_parent
+		  && abbrev[k + 1] != elfcpp::DW_FORM_flag_present)
+		value = this->entries_[value].offset;
+	      write_index_value(&contents, abbrev[k + 1], value);
+	    }
+	}
+      contents.push_back(0);
+    }
+  gold_assert(contents.size() - pool_start == pool_size);
+
+  // Only the names and compilation units are needed from now on.
+  std::vector<Entry>().swap(this->entries_);
+  std::vector<uint64_t>().swap(this->values_);
+
+  this->set_data_size(contents.size());
+}
+
+// Write the data to the file.
+
+void
+Debug_names::do_write(Output_file* of)
+{
+  const off_t off = this->offset();
+  const off_t oview_size = this->data_size();
+  unsigned char* const oview = of->get_output_view(off, oview_size);
+
+  gold_assert(static_cast<off_t>(this->contents_.size()) == oview_size);
+  memcpy(oview, &this->contents_[0], oview_size);
+
+  // The offsets of the compilation units in .debug_info.
+  unsigned char* pov = oview + this->cu_list_offset_;
+  for (size_t i = 0; i < this->comp_units_.size(); ++i)
+    {
+      const Input_location& cu = this->comp_units_[i];
+      write_offset(pov, input_output_offset(cu.object, cu.shndx, cu.offset));
+      pov += debug_names_offset_size;
+    }
+
+  // The offsets of the names in .debug_str.
+  pov = oview + this->str_offsets_offset_;
+  for (size_t i = 0; i < this->name_order_.size(); ++i)
+    {
+      const Input_location& str = this->names_[this->name_order_[i]].string;
+      write_offset(pov, input_output_offset(str.object, str.shndx,
+					    str.offset));
+      pov += debug_names_offset_size;
+    }
+
+  of->write_output_view(off, oview_size, oview);
+}
+
+} // End namespace gold.
@@ -0,0 +1,228 @@
+// debug-names.h -- merge DWARF 5 .debug_names sections  -*- C++ -*-
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include <sys/types.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gold.h"
+#include "output.h"
+#include "mapfile.h"
+
+#ifndef GOLD_DEBUG_NAMES_H
+#define GOLD_DEBUG_NAMES_H
+
+namespace gold
+{
+
+class Output_section;
+class Output_file;
+class Mapfile;
+class Relobj;
+class Elf_reloc_mapper;
+
+// This class manages the .debug_names section.  The compiler emits a
+// DWARF 5 name index for the compilation units of each object file.
+// Concatenating them gives a valid section, but one in which a
+// debugger has to search a separate hash table for every object, so
+// instead we merge them into a single name index covering all the
+// compilation units of the output.
+
+class Debug_names : public Output_section_data
+{
+ public:
+  Debug_names()
+    : Output_section_data(1), comp_units_(), abbrevs_(), abbrev_map_(),
+      entries_(), values_(), names_(), name_map_(), name_order_(),
+      bucket_count_(0), cu_form_(0), cu_list_offset_(0),
+      str_offsets_offset_(0), contents_(), str_object_(NULL),
+      str_shndx_(0), str_contents_(NULL), str_size_(0), str_is_new_(false)
+  { }
+
+  ~Debug_names();
+
+  // Merge the name indexes in the .debug_names input section SHNDX of
+  // OBJECT, whose relocations are in section RELOC_SHNDX of type
+  // RELOC_TYPE.  Return false, leaving the output unchanged, if the
+  // section can not be merged; the caller should then lay it out as
+  // an ordinary input section.
+  bool
+  add_input_section(Relobj* object, const unsigned char* symbols,
+		    off_t symbols_size, unsigned int shndx,
+		    unsigned int reloc_shndx, unsigned int reloc_type);
+
+ protected:
+  // This is called to update the section size prior to assigning
+  // the address and file offset.
+  void
+  update_data_size()
+  { this->set_final_data_size(); }
+
+  // Set the final data size.
+  void
+  set_final_data_size();
+
+  // Write the data to the file.
+  void
+  do_write(Output_file*);
+
+  // Write to a map file.
+  void
+  do_print_to_mapfile(Mapfile* mapfile) const
+  { mapfile->print_output_data(this, _("** debug_names")); }
+
+ private:
+  // A location in an input section, which is only mapped to an
+  // output offset when the section is written.
+  struct Input_location
+  {
+    Input_location(Relobj* obj, unsigned int sec, off_t off)
+      : object(obj), shndx(sec), offset(off)
+    { }
+    Relobj* object;
+    unsigned int shndx;
+    off_t offset;
+  };
+
+  // An abbreviation: the tag followed by the index attributes and
+  // their forms.  DW_IDX_compile_unit is not included; every output
+  // entry starts with it, in a form chosen from the number of
+  // compilation units.
+  typedef std::vector<uint64_t> Abbrev;
+
+  // An entry of the name index.
+  struct Entry
+  {
+    Entry(unsigned int abbrev_index, unsigned int cu_index,
+	  unsigned int first)
+      : abbrev(abbrev_index), comp_unit(cu_index), first_value(first),
+	offset(0)
+    { }
+    // The index of the abbreviation in ABBREVS_.
+    unsigned int abbrev;
+    // The index of the compilation unit in COMP_UNITS_.
+    unsigned int comp_unit;
+    // The index in VALUES_ of the value of the first attribute.  The
+    // value of DW_IDX_parent is the index of the parent entry.
+    unsigned int first_value;
+    // The offset of the entry in the output entry pool.
+    uint32_t offset;
+  };
+
+  // A name of the name index, and its entries.
+  struct Name
+  {
+    Name(uint32_t h, const Input_location& loc)
+      : hash(h), string(loc), entries()
+    { }
+    uint32_t hash;
+    // Where the name is in an input .debug_str section.
+    Input_location string;
+    // The indexes of the entries in ENTRIES_.
+    std::vector<unsigned int> entries;
+  };
+
+  // A name read from an input name index, which is added to NAMES_
+  // once the whole input section has been read.
+  struct Pending_name
+  {
+    Pending_name(const std::string& n, uint32_t h, const Input_location& loc,
+		 unsigned int first, unsigned int count)
+      : name(n), hash(h), string(loc), first_entry(first),
+	entry_count(count)
+    { }
+    std::string name;
+    uint32_t hash;
+    Input_location string;
+    unsigned int first_entry;
+    unsigned int entry_count;
+  };
+
+  // Read the name index at *PP in CONTENTS, which ends at END, and
+  // advance *PP past it.
+  bool
+  read_name_index(Relobj* object, Elf_reloc_mapper* reloc_mapper,
+		  unsigned int reloc_type, const unsigned char* contents,
+		  const unsigned char** pp, const unsigned char* end,
+		  std::vector<Pending_name>* pending);
+
+  // Return the section and offset that the relocated 4-byte field at
+  // P in CONTENTS refers to.
+  unsigned int
+  read_reloc_target(Elf_reloc_mapper* reloc_mapper, unsigned int reloc_type,
+		    const unsigned char* contents, const unsigned char* p,
+		    off_t* target_offset);
+
+  // Return the string at OFFSET in the string section SHNDX of OBJECT,
+  // or NULL.
+  const char*
+  get_string(Relobj* object, unsigned int shndx, off_t offset);
+
+  // Return the index of ABBREV in ABBREVS_, adding it if needed.
+  unsigned int
+  find_abbrev(const Abbrev& abbrev);
+
+  // Return the size in the entry pool of an entry.
+  section_size_type
+  entry_size(const Entry& entry) const;
+
+  typedef std::map<Abbrev, unsigned int> Abbrev_map;
+  typedef Unordered_map<std::string, unsigned int> Name_map;
+
+  // The compilation units, as offsets in input .debug_info sections.
+  std::vector<Input_location> comp_units_;
+  // The abbreviations.
+  std::vector<Abbrev> abbrevs_;
+  // Maps abbreviations to their indexes in ABBREVS_.
+  Abbrev_map abbrev_map_;
+  // The entries.
+  std::vector<Entry> entries_;
+  // The attribute values of the entries.
+  std::vector<uint64_t> values_;
+  // The names.
+  std::vector<Name> names_;
+  // Maps strings to their indexes in NAMES_.
+  Name_map name_map_;
+  // The indexes of the names in NAMES_, in output order.
+  std::vector<unsigned int> name_order_;
+  // The number of hash buckets.
+  unsigned int bucket_count_;
+  // The form of DW_IDX_compile_unit.
+  unsigned int cu_form_;
+  // The offsets in CONTENTS_ of the compilation unit list and of the
+  // string offsets, which are filled in by do_write.
+  section_size_type cu_list_offset_;
+  section_size_type str_offsets_offset_;
+  // The contents of the section.
+  std::vector<unsigned char> contents_;
+  // The string section last read by get_string, while reading an
+  // input section.
+  Relobj* str_object_;
+  unsigned int str_shndx_;
+  const unsigned char* str_contents_;
+  section_size_type str_size_;
+  bool str_is_new_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_DEBUG_NAMES_H)
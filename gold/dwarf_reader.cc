@@ -89,7 +89,10 @@ Sized_elf_reloc_mapper<size, big_endian>::do_get_reloc_target(
   return target_shndx;
 }
 
-static inline Elf_reloc_mapper*
+// Return a relocation mapper for OBJECT, whose ELF symbol table is
+// SYMTAB of SYMTAB_SIZE bytes.
+
+Elf_reloc_mapper*
 make_elf_reloc_mapper(Relobj* object, const unsigned char* symtab,
 		      off_t symtab_size)
 {
@@ -107,6 +107,13 @@ class Elf_reloc_mapper
   do_reset(uint64_t checkpoint) = 0;
 };
 
+// Return a new relocation mapper for OBJECT, whose ELF symbol table
+// is SYMTAB of SYMTAB_SIZE bytes.
+
+Elf_reloc_mapper*
+make_elf_reloc_mapper(Relobj* object, const unsigned char* symtab,
+		      off_t symtab_size);
+
 template<int size, bool big_endian>
 class Sized_elf_reloc_mapper : public Elf_reloc_mapper
 {
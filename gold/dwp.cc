@@ -28,6 +28,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <unistd.h>
 
 #include <vector>
 #include <algorithm>
@@ -45,6 +46,7 @@
 #include "compressed_output.h"
 #include "stringpool.h"
 #include "dwarf_reader.h"
+#include "gold-threads.h"
 
 static void
 usage(FILE* fd, int) ATTRIBUTE_NORETURN;
@@ -108,8 +110,8 @@ class Dwo_file
 {
  public:
   Dwo_file(const char* name)
-    : name_(name), obj_(NULL), input_file_(NULL), is_compressed_(),
-      sect_offsets_(), str_offset_map_()
+    : name_(name), obj_(NULL), input_file_(NULL), machine_(0), osabi_(0),
+      abiversion_(0), is_compressed_(), sect_offsets_(), str_offset_map_()
   { }
 
   ~Dwo_file();
@@ -119,6 +121,13 @@ class Dwo_file
   void
   read_executable(File_list* files);
 
+  // Open the input file and read its debug sections into memory,
+  // decompressing them if necessary.  This does not touch the output
+  // file, so it may be done on a worker thread before read() is
+  // called.
+  void
+  load();
+
   // Read the input file and send its contents to OUTPUT_FILE.
   void
   read(Dwp_output_file* output_file);
@@ -146,14 +155,15 @@ class Dwo_file
 
   // Create a Sized_relobj_dwo of the given size and endianness,
   // and record the target info.  P is a pointer to the ELF header
-  // in memory.
+  // in memory.  If READ_SECTIONS is true, also read the debug
+  // sections into memory.
   Relobj*
-  make_object(Dwp_output_file* output_file);
+  make_object(Dwp_output_file* output_file, bool read_sections = false);
 
   template <int size, bool big_endian>
   Relobj*
   sized_make_object(const unsigned char* p, Input_file* input_file,
-		    Dwp_output_file* output_file);
+		    Dwp_output_file* output_file, bool read_sections);
 
   // Return the number of sections in the input object file.
   unsigned int
@@ -232,6 +242,10 @@ class Dwo_file
   Relobj* obj_;
   // The Input_file object.
   Input_file* input_file_;
+  // The target info from the ELF header.
+  int machine_;
+  int osabi_;
+  int abiversion_;
   // Flags indicating which sections are compressed.
   std::vector<bool> is_compressed_;
   // Map input section index onto output section offset and size.
@@ -258,12 +272,17 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   { }
 
   ~Sized_relobj_dwo()
-  { }
+  { this->discard_decompressed_sections(); }
 
   // Setup the section information.
   void
   setup();
 
+  // Read the debug sections into memory, and keep the decompressed
+  // contents of the compressed ones.
+  void
+  read_debug_sections();
+
  protected:
   // Return section type.
   unsigned int
@@ -440,6 +459,86 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
   elfcpp::Elf_file<size, big_endian, Object> elf_file_;
 };
 
+// The output .debug_str.dwo section.  Strings get their offsets in
+// the order they are first added, which is the same as an unoptimized
+// Stringpool would give them.  The contents are held in memory until
+// they exceed the memory budget, and are then moved to a temporary
+// file; only a hash table of the offsets of the strings stays in
+// memory.  Strings that have been moved to the temporary file are
+// read back to check for a match when a string with the same hash
+// code is added again.
+
+class Dwp_string_table
+{
+ public:
+  Dwp_string_table(const char* output_name)
+    : output_name_(output_name), strings_(), buffer_(), size_(0),
+      spilled_size_(0), spill_fd_(NULL), compare_buffer_()
+  { }
+
+  ~Dwp_string_table();
+
+  // Add the string STR of length LEN, and return its offset.
+  section_offset_type
+  add(const char* str, size_t len);
+
+  // Return true if no strings have been added.
+  bool
+  empty() const
+  { return this->size_ == 0; }
+
+  // Return the size of the section.
+  section_size_type
+  size() const
+  { return this->size_; }
+
+  // Return the number of bytes of string contents held in memory.
+  section_size_type
+  buffered_size() const
+  { return this->buffer_.size(); }
+
+  // Move the strings held in memory to the temporary file.
+  void
+  spill();
+
+  // Write the section to FD at its current position.
+  void
+  write(FILE* fd, const char* section_name);
+
+ private:
+  // This class can not be copied.
+  Dwp_string_table(const Dwp_string_table&);
+  Dwp_string_table& operator=(const Dwp_string_table&);
+
+  // A string already in the table.
+  struct String_entry
+  {
+    section_offset_type offset;
+    size_t len;
+  };
+
+  typedef Unordered_multimap<size_t, String_entry> String_map;
+
+  // Return true if the string ENTRY is equal to STR.
+  bool
+  matches(const String_entry& entry, const char* str);
+
+  // The name of the output file, for error messages.
+  const char* output_name_;
+  // Map from hash code to the strings with that hash code.
+  String_map strings_;
+  // The contents of the strings from SPILLED_SIZE_ to SIZE_.
+  std::vector<char> buffer_;
+  // The size of the section so far.
+  section_size_type size_;
+  // The size of the part of the section in the temporary file.
+  section_size_type spilled_size_;
+  // The temporary file, or NULL.
+  FILE* spill_fd_;
+  // A buffer for reading strings back from the temporary file.
+  std::vector<char> compare_buffer_;
+};
+
 // The output file.
 // This class is responsible for collecting the debug index information
 // and writing the .dwp file in ELF format.
@@ -447,15 +546,15 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
 class Dwp_output_file
 {
  public:
-  Dwp_output_file(const char* name)
+  Dwp_output_file(const char* name, uint64_t memory_budget)
     : name_(name), machine_(0), size_(0), big_endian_(false), osabi_(0),
       abiversion_(0), fd_(NULL), next_file_offset_(0), shnum_(1), sections_(),
-      section_id_map_(), shoff_(0), shstrndx_(0), have_strings_(false),
-      stringpool_(), shstrtab_(), cu_index_(), tu_index_(), last_type_sig_(0),
-      last_tu_slot_(0)
+      section_id_map_(), shoff_(0), shstrndx_(0), strings_(name),
+      shstrtab_(), cu_index_(), tu_index_(), last_type_sig_(0),
+      last_tu_slot_(0), memory_budget_(memory_budget), buffered_bytes_(0),
+      spill_fd_(NULL), spill_size_(0)
   {
     this->section_id_map_.resize(elfcpp::DW_SECT_MAX + 1);
-    this->stringpool_.set_no_zero_null();
   }
 
   // Record the target info from an input file.
@@ -490,12 +589,16 @@ class Dwp_output_file
   finalize();
 
  private:
-  // Contributions to output sections.
+  // Contributions to output sections.  While the contribution is
+  // held in memory, CONTENTS points to it; once it has been spilled
+  // to the temporary file, CONTENTS is NULL and SPILL_OFFSET gives
+  // its location in that file.
   struct Contribution
   {
     section_offset_type output_offset;
     section_size_type size;
     const unsigned char* contents;
+    off_t spill_offset;
   };
 
   // Sections in the output file.
@@ -605,6 +708,11 @@ class Dwp_output_file
   unsigned int
   add_output_section(const char* section_name, int align);
 
+  // Add a new section of LEN bytes at the end of the output file,
+  // and return its file offset.
+  off_t
+  add_new_section(const char* section_name, section_size_type len, int align);
+
   // Write a new section to the output file.
   void
   write_new_section(const char* section_name, const unsigned char* contents,
@@ -636,6 +744,22 @@ class Dwp_output_file
   void
   write_contributions(const Section& sect);
 
+  // If the buffered contributions and strings exceed the memory
+  // budget, move them to the spill files.
+  void
+  check_memory_budget();
+
+  // Move all buffered contributions to the spill file, freeing
+  // their memory.
+  void
+  spill_contributions();
+
+  // Copy a spilled contribution back from the spill file to
+  // FILE_OFFSET in the output file.
+  void
+  copy_spilled_contribution(const Contribution& c, off_t file_offset,
+			    const char* section_name);
+
   // Write a CU or TU index section.
   template<bool big_endian>
   void
@@ -663,10 +787,8 @@ class Dwp_output_file
   off_t shoff_;
   // Section index of the section string table.
   unsigned int shstrndx_;
-  // TRUE if we have added any strings to the string pool.
-  bool have_strings_;
-  // String pool for the output .debug_str.dwo section.
-  Stringpool stringpool_;
+  // The output .debug_str.dwo section.
+  Dwp_string_table strings_;
   // String pool for the .shstrtab section.
   Stringpool shstrtab_;
   // The compilation unit index.
@@ -677,6 +799,41 @@ class Dwp_output_file
   uint64_t last_type_sig_;
   // Cache of the slot index for the last type signature.
   unsigned int last_tu_slot_;
+  // Maximum number of bytes of section contributions and strings to
+  // hold in memory before spilling them to temporary files; 0 means
+  // no limit.
+  uint64_t memory_budget_;
+  // Number of bytes of contributions currently held in memory.
+  uint64_t buffered_bytes_;
+  // The temporary file for spilled contributions, or NULL.
+  FILE* spill_fd_;
+  // Current size of the spill file.
+  off_t spill_size_;
+};
+
+// Load a batch of input files on several threads.  Merging the input
+// files into the output must be done in order so that the output is
+// deterministic, but for large packages much of the time goes into
+// opening, reading and decompressing the inputs.  This job does that
+// part for the files from FIRST to LAST in FILES, and leaves the
+// loaded files in DWO_FILES for the main thread to merge.
+
+class Dwo_load_job : public Parallel_job
+{
+ public:
+  Dwo_load_job(const File_list& files, size_t first, size_t last,
+	       std::vector<Dwo_file*>* dwo_files)
+    : files_(files), first_(first), last_(last), dwo_files_(dwo_files)
+  { }
+
+  void
+  run_piece(int index, int count);
+
+ private:
+  const File_list& files_;
+  size_t first_;
+  size_t last_;
+  std::vector<Dwo_file*>* dwo_files_;
 };
 
 // A specialization of Dwarf_info_reader, for reading dwo_names from
@@ -805,6 +962,49 @@ Sized_relobj_dwo<size, big_endian>::setup()
     this->set_compressed_sections(compressed_sections);
 }
 
+// Read the debug sections into memory.  The decompressed contents of
+// compressed sections are kept in the compressed section map, where
+// decompressed_section_contents() will find them.  The views of the
+// other sections are cached, and their pages touched so that they
+// are read in now.
+
+template <int size, bool big_endian>
+void
+Sized_relobj_dwo<size, big_endian>::read_debug_sections()
+{
+  Compressed_section_map* compressed_sections = this->compressed_sections();
+  const unsigned int shnum = this->elf_file_.shnum();
+  for (unsigned int i = 1; i < shnum; ++i)
+    {
+      if (this->elf_file_.section_type(i) != elfcpp::SHT_PROGBITS)
+	continue;
+      std::string name = this->elf_file_.section_name(i);
+      if (!is_prefix_of(".debug_", name.c_str())
+	  && !is_prefix_of(".zdebug_", name.c_str()))
+	continue;
+
+      Compressed_section_map::iterator p;
+      if (compressed_sections != NULL
+	  && (p = compressed_sections->find(i)) != compressed_sections->end())
+	{
+	  section_size_type len;
+	  bool is_new;
+	  const unsigned char* contents =
+	      this->decompressed_section_contents(i, &len, &is_new);
+	  if (is_new)
+	    p->second.contents = contents;
+	}
+      else
+	{
+	  section_size_type len;
+	  const unsigned char* contents = this->section_contents(i, &len, true);
+	  volatile unsigned char sum = 0;
+	  for (section_size_type j = 0; j < len; j += 4096)
+	    sum += contents[j];
+	}
+    }
+}
+
 // Return a view of the contents of a section.
 
 template <int size, bool big_endian>
@@ -880,12 +1080,26 @@ Dwo_file::read_executable(File_list* files)
     }
 }
 
+// Open the input file and read its debug sections into memory.
+
+void
+Dwo_file::load()
+{
+  this->obj_ = this->make_object(NULL, true);
+}
+
 // Read the input file and send its contents to OUTPUT_FILE.
 
 void
 Dwo_file::read(Dwp_output_file* output_file)
 {
-  this->obj_ = this->make_object(output_file);
+  if (this->obj_ == NULL)
+    this->obj_ = this->make_object(output_file);
+  else
+    output_file->record_target_info(this->name_, this->machine_,
+				    this->obj_->elfsize(),
+				    this->obj_->is_big_endian(),
+				    this->osabi_, this->abiversion_);
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -1024,7 +1238,7 @@ Dwo_file::verify(const File_list& files)
 // and record the target info.
 
 Relobj*
-Dwo_file::make_object(Dwp_output_file* output_file)
+Dwo_file::make_object(Dwp_output_file* output_file, bool read_sections)
 {
   // Open the input file.
   Input_file* input_file = new Input_file(this->name_);
@@ -1059,14 +1273,14 @@ Dwo_file::make_object(Dwp_output_file* output_file)
       if (big_endian)
 #ifdef HAVE_TARGET_32_BIG
 	return this->sized_make_object<32, true>(elf_header, input_file,
-						 output_file);
+						 output_file, read_sections);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_32_LITTLE
 	return this->sized_make_object<32, false>(elf_header, input_file,
-						  output_file);
+						  output_file, read_sections);
 #else
 	gold_unreachable();
 #endif
@@ -1076,14 +1290,14 @@ Dwo_file::make_object(Dwp_output_file* output_file)
       if (big_endian)
 #ifdef HAVE_TARGET_64_BIG
 	return this->sized_make_object<64, true>(elf_header, input_file,
-						 output_file);
+						 output_file, read_sections);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_64_LITTLE
 	return this->sized_make_object<64, false>(elf_header, input_file,
-						  output_file);
+						  output_file, read_sections);
 #else
 	gold_unreachable();
 #endif
@@ -1098,17 +1312,21 @@ Dwo_file::make_object(Dwp_output_file* output_file)
 template <int size, bool big_endian>
 Relobj*
 Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file,
-			    Dwp_output_file* output_file)
+			    Dwp_output_file* output_file, bool read_sections)
 {
   elfcpp::Ehdr<size, big_endian> ehdr(p);
   Sized_relobj_dwo<size, big_endian>* obj =
       new Sized_relobj_dwo<size, big_endian>(this->name_, input_file, ehdr);
   obj->setup();
+  if (read_sections)
+    obj->read_debug_sections();
+  this->machine_ = ehdr.get_e_machine();
+  this->osabi_ = ehdr.get_e_ident()[elfcpp::EI_OSABI];
+  this->abiversion_ = ehdr.get_e_ident()[elfcpp::EI_ABIVERSION];
   if (output_file != NULL)
-    output_file->record_target_info(
-	this->name_, ehdr.get_e_machine(), size, big_endian,
-	ehdr.get_e_ident()[elfcpp::EI_OSABI],
-	ehdr.get_e_ident()[elfcpp::EI_ABIVERSION]);
+    output_file->record_target_info(this->name_, this->machine_, size,
+				    big_endian, this->osabi_,
+				    this->abiversion_);
   return obj;
 }
 
@@ -1539,6 +1757,111 @@ Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
   reader.add_units(output_file, debug_shndx[elfcpp::DW_SECT_ABBREV], sections);
 }
 
+// Class Dwp_string_table.
+
+Dwp_string_table::~Dwp_string_table()
+{
+  // The temporary file is deleted automatically when it is closed.
+  if (this->spill_fd_ != NULL)
+    ::fclose(this->spill_fd_);
+}
+
+// Add the string STR of length LEN, and return its offset.
+
+section_offset_type
+Dwp_string_table::add(const char* str, size_t len)
+{
+  size_t hash = Stringpool::hash_string(str, len);
+  std::pair<String_map::const_iterator, String_map::const_iterator> range =
+      this->strings_.equal_range(hash);
+  for (String_map::const_iterator p = range.first; p != range.second; ++p)
+    if (p->second.len == len && this->matches(p->second, str))
+      return p->second.offset;
+
+  String_entry entry = { static_cast<section_offset_type>(this->size_), len };
+  this->strings_.insert(std::make_pair(hash, entry));
+  this->buffer_.insert(this->buffer_.end(), str, str + len);
+  this->buffer_.push_back('\0');
+  this->size_ += len + 1;
+  return entry.offset;
+}
+
+// Return true if the string ENTRY is equal to STR, which has the
+// same length.
+
+bool
+Dwp_string_table::matches(const String_entry& entry, const char* str)
+{
+  section_size_type offset = entry.offset;
+  if (offset >= this->spilled_size_)
+    return memcmp(&this->buffer_[offset - this->spilled_size_], str,
+		  entry.len) == 0;
+
+  if (entry.len == 0)
+    return true;
+  this->compare_buffer_.resize(entry.len);
+  if (::pread(fileno(this->spill_fd_), &this->compare_buffer_[0], entry.len,
+	      offset) != static_cast<ssize_t>(entry.len))
+    gold_fatal(_("%s: error reading temporary file: %s"), this->output_name_,
+	       strerror(errno));
+  return memcmp(&this->compare_buffer_[0], str, entry.len) == 0;
+}
+
+// Move the strings held in memory to the end of the temporary file.
+// Their offsets in the file are the same as in the section.
+
+void
+Dwp_string_table::spill()
+{
+  if (this->buffer_.empty())
+    return;
+
+  if (this->spill_fd_ == NULL)
+    {
+      this->spill_fd_ = ::tmpfile();
+      if (this->spill_fd_ == NULL)
+	gold_fatal(_("%s: cannot create temporary file: %s"),
+		   this->output_name_, strerror(errno));
+    }
+
+  if (::pwrite(fileno(this->spill_fd_), &this->buffer_[0],
+	       this->buffer_.size(), this->spilled_size_)
+      != static_cast<ssize_t>(this->buffer_.size()))
+    gold_fatal(_("%s: error writing temporary file: %s"), this->output_name_,
+	       strerror(errno));
+  this->spilled_size_ = this->size_;
+  std::vector<char>().swap(this->buffer_);
+}
+
+// Write the section to FD at its current position, copying the part
+// in the temporary file through a bounded buffer.
+
+void
+Dwp_string_table::write(FILE* fd, const char* section_name)
+{
+  const section_size_type bufsize = 1024 * 1024;
+  std::vector<char> buf(std::min(bufsize, this->spilled_size_));
+  section_size_type offset = 0;
+  while (offset < this->spilled_size_)
+    {
+      section_size_type n = std::min(bufsize, this->spilled_size_ - offset);
+      if (::pread(fileno(this->spill_fd_), &buf[0], n, offset)
+	  != static_cast<ssize_t>(n))
+	gold_fatal(_("%s: error reading temporary file: %s"),
+		   this->output_name_, strerror(errno));
+      if (::fwrite(&buf[0], 1, n, fd) < n)
+	gold_fatal(_("%s: error writing section '%s'"), this->output_name_,
+		   section_name);
+      offset += n;
+    }
+
+  if (!this->buffer_.empty()
+      && (::fwrite(&this->buffer_[0], 1, this->buffer_.size(), fd)
+	  < this->buffer_.size()))
+    gold_fatal(_("%s: error writing section '%s'"), this->output_name_,
+	       section_name);
+}
+
 // Class Dwp_output_file.
 
 // Record the target info from an input file.  On first call, we
@@ -1584,13 +1907,9 @@ Dwp_output_file::record_target_info(const char*, int machine,
 section_offset_type
 Dwp_output_file::add_string(const char* str, size_t len)
 {
-  Stringpool::Key key;
-  this->stringpool_.add_with_length(str, len, true, &key);
-  this->have_strings_ = true;
-  // We aren't supposed to call get_offset() until after
-  // calling set_string_offsets(), but the offsets will
-  // not change unless optimizing the string pool.
-  return this->stringpool_.get_offset_from_key(key);
+  section_offset_type offset = this->strings_.add(str, len);
+  this->check_memory_budget();
+  return offset;
 }
 
 // Align the file offset to the given boundary.
@@ -1681,13 +2000,95 @@ Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
 	section.align = align;
       section_offset = align_offset(section.size, align);
       section.size = section_offset + len;
-      Contribution contrib = { section_offset, len, contents };
+      Contribution contrib = { section_offset, len, contents, 0 };
       section.contributions.push_back(contrib);
+
+      this->buffered_bytes_ += len;
+      this->check_memory_budget();
     }
 
   return section_offset;
 }
 
+// If we are now holding more than the budget allows, push everything
+// we have buffered out to the spill files.
+
+void
+Dwp_output_file::check_memory_budget()
+{
+  if (this->memory_budget_ == 0
+      || (this->buffered_bytes_ + this->strings_.buffered_size()
+	  <= this->memory_budget_))
+    return;
+  this->spill_contributions();
+  this->strings_.spill();
+}
+
+// Move all buffered contributions to the spill file.  The layout of
+// the sections other than .debug_info.dwo is not known until we
+// finalize the output file, so we can't write them to their final
+// place yet; the spill file lets us bound the amount of memory we use
+// for them at the cost of copying the data one extra time.
+
+void
+Dwp_output_file::spill_contributions()
+{
+  if (this->spill_fd_ == NULL)
+    {
+      this->spill_fd_ = ::tmpfile();
+      if (this->spill_fd_ == NULL)
+	gold_fatal(_("%s: cannot create temporary file: %s"), this->name_,
+		   strerror(errno));
+    }
+
+  ::fseek(this->spill_fd_, this->spill_size_, SEEK_SET);
+  for (unsigned int i = 0; i < this->sections_.size(); ++i)
+    {
+      Section& sect = this->sections_[i];
+      for (unsigned int j = 0; j < sect.contributions.size(); ++j)
+	{
+	  Contribution& c = sect.contributions[j];
+	  if (c.contents == NULL)
+	    continue;
+	  if (::fwrite(c.contents, 1, c.size, this->spill_fd_) < c.size)
+	    gold_fatal(_("%s: error writing temporary file: %s"), this->name_,
+		       strerror(errno));
+	  delete[] c.contents;
+	  c.contents = NULL;
+	  c.spill_offset = this->spill_size_;
+	  this->spill_size_ += c.size;
+	}
+    }
+  this->buffered_bytes_ = 0;
+}
+
+// Copy a spilled contribution from the spill file to FILE_OFFSET in the
+// output file, using a bounded buffer.
+
+void
+Dwp_output_file::copy_spilled_contribution(const Contribution& c,
+					   off_t file_offset,
+					   const char* section_name)
+{
+  const section_size_type bufsize = 1024 * 1024;
+  unsigned char* buf = new unsigned char[std::min(bufsize, c.size)];
+  ::fseek(this->spill_fd_, c.spill_offset, SEEK_SET);
+  ::fseek(this->fd_, file_offset, SEEK_SET);
+  section_size_type left = c.size;
+  while (left > 0)
+    {
+      section_size_type n = std::min(bufsize, left);
+      if (::fread(buf, 1, n, this->spill_fd_) < n)
+	gold_fatal(_("%s: error reading temporary file: %s"), this->name_,
+		   strerror(errno));
+      if (::fwrite(buf, 1, n, this->fd_) < n)
+	gold_fatal(_("%s: error writing section '%s'"), this->name_,
+		   section_name);
+      left -= n;
+    }
+  delete[] buf;
+}
+
 // Add a set of .debug_info and related sections to the output file.
 
 void
@@ -1853,14 +2254,12 @@ Dwp_output_file::finalize()
     }
 
   // Write the debug string table.
-  if (this->have_strings_)
+  if (!this->strings_.empty())
     {
-      this->stringpool_.set_string_offsets();
-      section_size_type len = this->stringpool_.get_strtab_size();
-      buf = new unsigned char[len];
-      this->stringpool_.write_to_buffer(buf, len);
-      this->write_new_section(".debug_str.dwo", buf, len, 1);
-      delete[] buf;
+      off_t file_offset = this->add_new_section(".debug_str.dwo",
+						this->strings_.size(), 1);
+      ::fseek(this->fd_, file_offset, SEEK_SET);
+      this->strings_.write(this->fd_, ".debug_str.dwo");
     }
 
   // Write the CU and TU indexes.
@@ -1925,6 +2324,11 @@ Dwp_output_file::finalize()
 	gold_fatal(_("%s: %s"), this->name_, strerror(errno));
     }
   this->fd_ = NULL;
+
+  // The spill file is deleted automatically when it is closed.
+  if (this->spill_fd_ != NULL)
+    ::fclose(this->spill_fd_);
+  this->spill_fd_ = NULL;
 }
 
 // Write the contributions to an output section.
@@ -1935,6 +2339,12 @@ Dwp_output_file::write_contributions(const Section& sect)
   for (unsigned int i = 0; i < sect.contributions.size(); ++i)
     {
       const Contribution& c = sect.contributions[i];
+      if (c.contents == NULL)
+	{
+	  this->copy_spilled_contribution(c, sect.offset + c.output_offset,
+					  sect.name);
+	  continue;
+	}
       ::fseek(this->fd_, sect.offset + c.output_offset, SEEK_SET);
       if (::fwrite(c.contents, 1, c.size, this->fd_) < c.size)
 	gold_fatal(_("%s: error writing section '%s'"), this->name_, sect.name);
@@ -1948,6 +2358,19 @@ void
 Dwp_output_file::write_new_section(const char* section_name,
 				   const unsigned char* contents,
 				   section_size_type len, int align)
+{
+  off_t file_offset = this->add_new_section(section_name, len, align);
+  ::fseek(this->fd_, file_offset, SEEK_SET);
+  if (::fwrite(contents, 1, len, this->fd_) < len)
+    gold_fatal(_("%s: error writing section '%s'"), this->name_, section_name);
+}
+
+// Add a new section of LEN bytes at the end of the output file, and
+// return its file offset.
+
+off_t
+Dwp_output_file::add_new_section(const char* section_name,
+				 section_size_type len, int align)
 {
   section_name = this->shstrtab_.add_with_length(section_name,
 						 strlen(section_name),
@@ -1958,10 +2381,8 @@ Dwp_output_file::write_new_section(const char* section_name,
   file_offset = align_offset(file_offset, align);
   section.offset = file_offset;
   section.size = len;
-  ::fseek(this->fd_, file_offset, SEEK_SET);
-  if (::fwrite(contents, 1, len, this->fd_) < len)
-    gold_fatal(_("%s: error writing section '%s'"), this->name_, section_name);
   this->next_file_offset_ = file_offset + len;
+  return file_offset;
 }
 
 // Write a CU or TU index section.
@@ -2284,6 +2705,19 @@ Unit_reader::visit_type_unit(off_t, off_t tu_length, off_t,
   this->output_file_->add_tu_set(unit_set);
 }
 
+// Class Dwo_load_job.
+
+void
+Dwo_load_job::run_piece(int index, int count)
+{
+  for (size_t i = this->first_ + index; i < this->last_; i += count)
+    {
+      Dwo_file* dwo_file = new Dwo_file(this->files_[i].dwo_name.c_str());
+      dwo_file->load();
+      (*this->dwo_files_)[i - this->first_] = dwo_file;
+    }
+}
+
 }; // End namespace gold
 
 using namespace gold;
@@ -2292,13 +2726,17 @@ using namespace gold;
 
 enum Dwp_options {
   VERIFY_ONLY = 0x101,
+  THREADS = 0x102,
+  MEMORY_BUDGET = 0x103,
 };
 
 struct option dwp_options[] =
   {
     { "exec", required_argument, NULL, 'e' },
     { "help", no_argument, NULL, 'h' },
+    { "memory-budget", required_argument, NULL, MEMORY_BUDGET },
     { "output", required_argument, NULL, 'o' },
+    { "threads", required_argument, NULL, THREADS },
     { "verbose", no_argument, NULL, 'v' },
     { "verify-only", no_argument, NULL, VERIFY_ONLY },
     { "version", no_argument, NULL, 'V' },
@@ -2314,7 +2752,13 @@ usage(FILE* fd, int exit_status)
   fprintf(fd, _("  -h, --help               Print this help message\n"));
   fprintf(fd, _("  -e EXE, --exec EXE       Get list of dwo files from EXE"
 					   " (defaults output to EXE.dwp)\n"));
+  fprintf(fd, _("  --memory-budget SIZE     Hold at most SIZE megabytes of"
+					   " output data in memory\n"));
+  fprintf(fd, _("                           (K, M or G after SIZE sets the"
+					   " unit; default: no limit)\n"));
   fprintf(fd, _("  -o FILE, --output FILE   Set output dwp file name\n"));
+  fprintf(fd, _("  --threads N              Open and decompress input"
+					   " files on N threads\n"));
   fprintf(fd, _("  -v, --verbose            Verbose output\n"));
   fprintf(fd, _("  --verify-only            Verify output file against"
 					   " exec file\n"));
@@ -2363,12 +2807,6 @@ main(int argc, char** argv)
   Errors errors(program_name);
   set_parameters_errors(&errors);
 
-  // Initialize gold's global options.  We don't use these in
-  // this program, but they need to be initialized so that
-  // functions we call from libgold work properly.
-  General_options options;
-  set_parameters_options(&options);
-
   // In libiberty; expands @filename to the args in "filename".
   expandargv(&argc, &argv);
 
@@ -2378,6 +2816,12 @@ main(int argc, char** argv)
   const char* exe_filename = NULL;
   bool verbose = false;
   bool verify_only = false;
+  int thread_count = 1;
+  uint64_t memory_budget = 0;
+  long lval;
+  unsigned long long ullval;
+  unsigned long long unit;
+  char* endptr;
   int c;
   while ((c = getopt_long(argc, argv, "e:ho:vV", dwp_options, NULL)) != -1)
     {
@@ -2397,6 +2841,30 @@ main(int argc, char** argv)
 	  case VERIFY_ONLY:
 	    verify_only = true;
 	    break;
+	  case THREADS:
+	    errno = 0;
+	    lval = strtol(optarg, &endptr, 0);
+	    if (*optarg == '\0' || *endptr != '\0' || errno != 0
+		|| lval < 1 || lval > 64)
+	      gold_fatal(_("invalid thread count: %s"), optarg);
+	    thread_count = lval;
+	    break;
+	  case MEMORY_BUDGET:
+	    // The size is in megabytes, unless followed by K, M or G.
+	    errno = 0;
+	    ullval = strtoull(optarg, &endptr, 0);
+	    unit = 1024 * 1024;
+	    if (*endptr == 'K' || *endptr == 'k')
+	      unit = 1024;
+	    else if (*endptr == 'G' || *endptr == 'g')
+	      unit = 1024 * 1024 * 1024;
+	    if (*endptr != '\0' && strchr("KkMmGg", *endptr) != NULL)
+	      ++endptr;
+	    if (*optarg == '\0' || *optarg == '-' || *endptr != '\0'
+		|| errno != 0 || ullval > -1ULL / unit)
+	      gold_fatal(_("invalid memory budget: %s"), optarg);
+	    memory_budget = ullval * unit;
+	    break;
 	  case 'V':
 	    print_version();
 	  case '?':
@@ -2405,6 +2873,32 @@ main(int argc, char** argv)
 	}
     }
 
+  // Initialize gold's global options.  We don't use most of these
+  // in this program, but they need to be initialized so that
+  // functions we call from libgold work properly.  If we are going to
+  // read the input files on several threads, pass that on, so that
+  // the locks in libgold are real ones.
+  Command_line command_line;
+  if (thread_count > 1)
+    {
+#ifdef ENABLE_THREADS
+      char count[16];
+      snprintf(count, sizeof count, "%d", thread_count);
+      const char* thread_args[] =
+	{ "--threads", "--thread-count-final", count, NULL };
+      bool no_more_options = false;
+      for (int i = 0; thread_args[i] != NULL; )
+	i = command_line.process_one_option(3, thread_args, i,
+					    &no_more_options);
+#else
+      gold_warning(_("ignoring --threads: "
+		     "%s was compiled without thread support"),
+		   program_name);
+      thread_count = 1;
+#endif
+    }
+  set_parameters_options(&command_line.options());
+
   if (output_filename.empty())
     {
       if (exe_filename == NULL)
@@ -2436,14 +2930,32 @@ main(int argc, char** argv)
       return ok ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-  // Process each file, adding its contents to the output file.
-  Dwp_output_file output_file(output_filename.c_str());
-  for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
+  // Process each file, adding its contents to the output file.  With
+  // more than one thread, open and read the files a batch at a time on
+  // worker threads, and then merge them in order on this thread.
+  Dwp_output_file output_file(output_filename.c_str(), memory_budget);
+  const size_t batch_size = 2 * static_cast<size_t>(thread_count);
+  std::vector<Dwo_file*> dwo_files;
+  for (size_t first = 0; first < files.size(); first += batch_size)
     {
-      if (verbose)
-	fprintf(stderr, "%s\n", f->dwo_name.c_str());
-      Dwo_file dwo_file(f->dwo_name.c_str());
-      dwo_file.read(&output_file);
+      size_t last = std::min(first + batch_size, files.size());
+      dwo_files.assign(last - first, NULL);
+      if (thread_count > 1)
+	{
+	  Dwo_load_job job(files, first, last, &dwo_files);
+	  run_parallel_job(&job, std::min(thread_count,
+					  static_cast<int>(last - first)));
+	}
+      for (size_t i = first; i < last; ++i)
+	{
+	  if (verbose)
+	    fprintf(stderr, "%s\n", files[i].dwo_name.c_str());
+	  Dwo_file* dwo_file = dwo_files[i - first];
+	  if (dwo_file == NULL)
+	    dwo_file = new Dwo_file(files[i].dwo_name.c_str());
+	  dwo_file->read(&output_file);
+	  delete dwo_file;
+	}
     }
   output_file.finalize();
 
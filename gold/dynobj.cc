@@ -451,6 +451,10 @@ Sized_dynobj<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
 			? NULL
 			: sd->symbol_names->data()),
 		       sd->symbol_names_size);
+
+  // Hash the symbol names now, while we are running in parallel
+  // with other objects.
+  Symbol_table::hash_symbol_names<size, big_endian>(sd, false);
 }
 
 // Return the Xindex structure to use for object with lots of
@@ -734,10 +738,12 @@ Sized_dynobj<size, big_endian>::do_add_symbols(Symbol_table* symtab,
   Version_map version_map;
   this->make_version_map(sd, &version_map);
 
-  // If printing symbol counts or a cross reference table or
-  // preparing for an incremental link, we want to track symbols.
+  // If printing symbol counts, a cross reference table or a
+  // statistics file, or preparing for an incremental link, we want to
+  // track symbols.
   if (parameters->options().user_set_print_symbol_counts()
       || parameters->options().cref()
+      || parameters->options().stats_file() != NULL
       || parameters->incremental())
     {
       this->symbols_ = new Symbols();
@@ -748,6 +754,9 @@ Sized_dynobj<size, big_endian>::do_add_symbols(Symbol_table* symtab,
     reinterpret_cast<const char*>(sd->symbol_names->data());
   symtab->add_from_dynobj(this, sd->symbols->data(), symcount,
 			  sym_names, sd->symbol_names_size,
+			  (sd->global_name_hashes.empty()
+			   ? NULL
+			   : &sd->global_name_hashes[0]),
 			  (sd->versym == NULL
 			   ? NULL
 			   : sd->versym->data()),
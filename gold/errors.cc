@@ -218,6 +218,80 @@ Errors::debug(const char* format, ...)
   fputc('\n', stderr);
 }
 
+// Class Deferred_diagnostics.
+
+// Record an error.
+
+void
+Deferred_diagnostics::error(const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  this->add(DEFERRED_ERROR, format, args);
+  va_end(args);
+}
+
+// Record a warning.
+
+void
+Deferred_diagnostics::warning(const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  this->add(DEFERRED_WARNING, format, args);
+  va_end(args);
+}
+
+// Record an informational message.
+
+void
+Deferred_diagnostics::info(const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  this->add(DEFERRED_INFO, format, args);
+  va_end(args);
+}
+
+// Format a diagnostic and record it.
+
+void
+Deferred_diagnostics::add(Kind kind, const char* format, va_list args)
+{
+  char* buf = NULL;
+  if (vasprintf(&buf, format, args) < 0)
+    gold_nomem();
+  this->diagnostics_.push_back(std::make_pair(kind, std::string(buf)));
+  free(buf);
+}
+
+// Issue the diagnostics.
+
+void
+Deferred_diagnostics::issue() const
+{
+  for (std::vector<std::pair<Kind, std::string> >::const_iterator p =
+	 this->diagnostics_.begin();
+       p != this->diagnostics_.end();
+       ++p)
+    {
+      switch (p->first)
+	{
+	case DEFERRED_ERROR:
+	  gold_error("%s", p->second.c_str());
+	  break;
+	case DEFERRED_WARNING:
+	  gold_warning("%s", p->second.c_str());
+	  break;
+	case DEFERRED_INFO:
+	  gold_info("%s", p->second.c_str());
+	  break;
+	default:
+	  gold_unreachable();
+	}
+    }
+}
+
 // The functions which the rest of the code actually calls.
 
 // Report a fatal error.
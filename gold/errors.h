@@ -24,6 +24,9 @@
 #define GOLD_ERRORS_H
 
 #include <cstdarg>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "gold-threads.h"
 
@@ -133,6 +136,60 @@ class Errors
   Unordered_map<const Symbol*, int> undefined_symbols_;
 };
 
+// This class holds diagnostics which are issued later.  It is used
+// when symbols are resolved in parallel, so that the diagnostics are
+// issued in the same order however the work is spread over the
+// threads.
+
+class Deferred_diagnostics
+{
+ public:
+  Deferred_diagnostics()
+    : diagnostics_()
+  { }
+
+  // Record an error.
+  void
+  error(const char* format, ...) ATTRIBUTE_PRINTF_2;
+
+  // Record a warning.
+  void
+  warning(const char* format, ...) ATTRIBUTE_PRINTF_2;
+
+  // Record an informational message.
+  void
+  info(const char* format, ...) ATTRIBUTE_PRINTF_2;
+
+  // Whether there are no diagnostics.
+  bool
+  empty() const
+  { return this->diagnostics_.empty(); }
+
+  // Exchange the diagnostics with those of OTHER.
+  void
+  swap(Deferred_diagnostics& other)
+  { this->diagnostics_.swap(other.diagnostics_); }
+
+  // Issue the diagnostics, in the order in which they were recorded.
+  void
+  issue() const;
+
+ private:
+  enum Kind
+  {
+    DEFERRED_ERROR,
+    DEFERRED_WARNING,
+    DEFERRED_INFO
+  };
+
+  // Record a diagnostic of kind KIND.
+  void
+  add(Kind kind, const char* format, va_list);
+
+  // The kind and the text of each diagnostic.
+  std::vector<std::pair<Kind, std::string> > diagnostics_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_ERRORS_H)
@@ -124,6 +124,19 @@ static Initialize_lock file_counts_initialize_lock(&file_counts_lock);
 unsigned long long File_read::total_mapped_bytes;
 unsigned long long File_read::current_mapped_bytes;
 unsigned long long File_read::maximum_mapped_bytes;
+unsigned long long File_read::total_view_hits;
+unsigned long long File_read::total_view_misses;
+unsigned long long File_read::total_view_rereads;
+unsigned long long File_read::total_dropped_bytes;
+std::set<std::string> File_read::opened_files;
+
+// A lock for the view cache used for --view-cache-size.  When this
+// and the view lock of a file are both held, this is acquired first.
+static Lock* view_cache_lock = NULL;
+static Initialize_lock view_cache_initialize_lock(&view_cache_lock);
+
+File_read::View_cache File_read::view_cache;
+unsigned long long File_read::view_cache_bytes;
 
 // Class File_read::View.
 
@@ -176,6 +189,17 @@ File_read::View::is_locked()
 File_read::~File_read()
 {
   gold_assert(this->token_.is_writable());
+  if (this->view_lock_ != NULL)
+    {
+      view_cache_initialize_lock.initialize();
+      Hold_optional_lock hl(view_cache_lock);
+      if (this->in_view_cache_)
+	{
+	  File_read::view_cache.erase(this->view_cache_position_);
+	  File_read::view_cache_bytes -= this->cached_bytes_;
+	  this->in_view_cache_ = false;
+	}
+    }
   if (this->is_descriptor_opened_)
     {
       release_descriptor(this->descriptor_, true);
@@ -184,6 +208,7 @@ File_read::~File_read()
     }
   this->name_.clear();
   this->clear_views(CLEAR_VIEWS_ALL);
+  delete this->view_lock_;
 }
 
 // Open the file.
@@ -211,6 +236,21 @@ File_read::open(const Task* task, const std::string& name)
       gold_debug(DEBUG_FILES, "Attempt to open %s succeeded",
 		 this->name_.c_str());
       this->token_.add_writer(task);
+
+      // Plugins may hold on to views of claimed files after the file
+      // is released, so we never drop views when there are plugins.
+      if (parameters->options_valid()
+	  && parameters->options().view_cache_size() != 0
+	  && !parameters->options().has_plugins())
+	this->view_lock_ = new Lock();
+
+      if (parameters->options_valid()
+	  && parameters->options().relink_cache() != NULL)
+	{
+	  file_counts_initialize_lock.initialize();
+	  Hold_optional_lock hl(file_counts_lock);
+	  File_read::opened_files.insert(this->name_);
+	}
     }
 
   return this->descriptor_ >= 0;
@@ -259,6 +299,9 @@ File_read::release()
 {
   gold_assert(this->is_locked());
 
+  // Keep other threads from dropping the views while we clear them.
+  this->note_use();
+
   if (!parameters->options_valid() || parameters->options().stats())
     {
       file_counts_initialize_lock.initialize();
@@ -267,9 +310,15 @@ File_read::release()
       File_read::current_mapped_bytes += this->mapped_bytes_;
       if (File_read::current_mapped_bytes > File_read::maximum_mapped_bytes)
 	File_read::maximum_mapped_bytes = File_read::current_mapped_bytes;
+      File_read::total_view_hits += this->view_hits_;
+      File_read::total_view_misses += this->view_misses_;
+      File_read::total_view_rereads += this->view_rereads_;
     }
 
   this->mapped_bytes_ = 0;
+  this->view_hits_ = 0;
+  this->view_misses_ = 0;
+  this->view_rereads_ = 0;
 
   // Only clear views if there is only one attached object.  Otherwise
   // we waste time trying to clear cached archive views.  Similarly
@@ -285,6 +334,111 @@ File_read::release()
     }
 
   this->released_ = true;
+
+  if (this->view_lock_ != NULL)
+    {
+      size_t bytes;
+      {
+	Hold_lock hl(*this->view_lock_);
+	this->in_use_ = false;
+	bytes = this->droppable_bytes();
+      }
+      this->update_view_cache(bytes);
+    }
+}
+
+// Note that the views of this file are in use.  Once this is set
+// under the view lock, no other thread will touch the views until the
+// file is released, so the caller can use them without the lock.
+
+void
+File_read::note_use()
+{
+  if (this->view_lock_ != NULL)
+    {
+      Hold_lock hl(*this->view_lock_);
+      this->in_use_ = true;
+    }
+}
+
+// Return the bytes of the views of this file which could be dropped.
+
+size_t
+File_read::droppable_bytes() const
+{
+  size_t bytes = 0;
+  for (Views::const_iterator p = this->views_.begin();
+       p != this->views_.end();
+       ++p)
+    if (!p->second->is_locked() && !p->second->is_permanent_view())
+      bytes += p->second->size();
+  return bytes;
+}
+
+// Record that this file keeps BYTES of views now that it has been
+// released.  If that puts the views of all released files over the
+// --view-cache-size budget, drop the views of the files which were
+// released longest ago.
+
+void
+File_read::update_view_cache(size_t bytes)
+{
+  const unsigned long long budget = parameters->options().view_cache_size();
+
+  view_cache_initialize_lock.initialize();
+  Hold_optional_lock hl(view_cache_lock);
+
+  if (this->in_view_cache_)
+    {
+      File_read::view_cache.erase(this->view_cache_position_);
+      File_read::view_cache_bytes -= this->cached_bytes_;
+      this->in_view_cache_ = false;
+    }
+  this->cached_bytes_ = bytes;
+  if (bytes > 0)
+    {
+      File_read::view_cache.push_front(this);
+      this->view_cache_position_ = File_read::view_cache.begin();
+      this->in_view_cache_ = true;
+      File_read::view_cache_bytes += bytes;
+    }
+
+  while (File_read::view_cache_bytes > budget
+	 && !File_read::view_cache.empty()
+	 && File_read::view_cache.back() != this)
+    {
+      File_read* victim = File_read::view_cache.back();
+      File_read::view_cache.pop_back();
+      File_read::view_cache_bytes -= victim->cached_bytes_;
+      victim->cached_bytes_ = 0;
+      victim->in_view_cache_ = false;
+      victim->drop_views();
+    }
+}
+
+// Drop the views of this file to stay within --view-cache-size.  This
+// is called from some other thread with the view cache lock held.  If
+// the file has been used again since it went into the cache, its
+// views are left alone; the file is put back into the cache when it
+// is released.
+
+void
+File_read::drop_views()
+{
+  Hold_lock hl(*this->view_lock_);
+  if (this->in_use_)
+    return;
+
+  size_t bytes = this->droppable_bytes();
+  this->clear_views(CLEAR_VIEWS_UNLOCKED);
+  this->views_dropped_ = true;
+
+  if (parameters->options().stats())
+    {
+      file_counts_initialize_lock.initialize();
+      Hold_optional_lock hlc(file_counts_lock);
+      File_read::total_dropped_bytes += bytes;
+    }
 }
 
 // Lock the file.
@@ -425,9 +579,12 @@ File_read::do_read(off_t start, section_size_type size, void* p)
 void
 File_read::read(off_t start, section_size_type size, void* p)
 {
+  this->note_use();
+
   const File_read::View* pv = this->find_view(start, size, -1U, NULL);
   if (pv != NULL)
     {
+      ++this->view_hits_;
       memcpy(p, pv->data() + (start - pv->start() + pv->byteshift()), size);
       return;
     }
@@ -516,6 +673,10 @@ File_read::make_view(off_t start, section_size_type size,
 	}
     }
 
+  ++this->view_misses_;
+  if (this->views_dropped_)
+    ++this->view_rereads_;
+
   const unsigned char* pbytes = static_cast<const unsigned char*>(p);
   File_read::View* v = new File_read::View(poff, psize, pbytes, byteshift,
 					   cache, ownership);
@@ -575,6 +736,7 @@ File_read::find_or_make_view(off_t offset, off_t start,
 				       &vshifted);
   if (v != NULL)
     {
+      ++this->view_hits_;
       if (cache)
 	v->set_cache();
       return v;
@@ -615,6 +777,7 @@ const unsigned char*
 File_read::get_view(off_t offset, off_t start, section_size_type size,
 		    bool aligned, bool cache)
 {
+  this->note_use();
   File_read::View* pv = this->find_or_make_view(offset, start, size,
 						aligned, cache);
   return pv->data() + (offset + start - pv->start() + pv->byteshift());
@@ -624,6 +787,7 @@ File_view*
 File_read::get_lasting_view(off_t offset, off_t start, section_size_type size,
 			    bool aligned, bool cache)
 {
+  this->note_use();
   File_read::View* pv = this->find_or_make_view(offset, start, size,
 						aligned, cache);
   pv->lock();
@@ -705,6 +869,8 @@ File_read::do_readv(off_t base, const Read_multiple& rm, size_t start,
 void
 File_read::read_multiple(off_t base, const Read_multiple& rm)
 {
+  this->note_use();
+
   static size_t iov_max = GOLD_IOV_MAX;
   size_t count = rm.size();
   size_t i = 0;
@@ -773,6 +939,7 @@ File_read::clear_view_cache_marks()
   if (this->object_count_ > 1)
     return;
 
+  this->note_use();
   for (Views::iterator p = this->views_.begin();
        p != this->views_.end();
        ++p)
@@ -799,7 +966,7 @@ File_read::clear_views(Clear_views_mode mode)
       bool should_delete;
       if (p->second->is_locked() || p->second->is_permanent_view())
 	should_delete = false;
-      else if (mode == CLEAR_VIEWS_ALL)
+      else if (mode == CLEAR_VIEWS_ALL || mode == CLEAR_VIEWS_UNLOCKED)
 	should_delete = true;
       else if ((p->second->should_cache()
 		|| p->second == this->whole_file_view_)
@@ -856,6 +1023,28 @@ File_read::print_stats()
 	  program_name, File_read::total_mapped_bytes);
   fprintf(stderr, _("%s: maximum bytes mapped for read at one time: %llu\n"),
 	  program_name, File_read::maximum_mapped_bytes);
+  fprintf(stderr, _("%s: input file view hits: %llu\n"),
+	  program_name, File_read::total_view_hits);
+  fprintf(stderr, _("%s: input file view misses: %llu\n"),
+	  program_name, File_read::total_view_misses);
+  fprintf(stderr, _("%s: input file views read again after being dropped: "
+		    "%llu\n"),
+	  program_name, File_read::total_view_rereads);
+  if (parameters->options().view_cache_size() != 0)
+    fprintf(stderr, _("%s: bytes of input file views dropped to stay "
+		      "within --view-cache-size: %llu\n"),
+	    program_name, File_read::total_dropped_bytes);
+}
+
+// Return the names of the files opened during the link.
+
+void
+File_read::get_opened_files(std::vector<std::string>* files)
+{
+  file_counts_initialize_lock.initialize();
+  Hold_optional_lock hl(file_counts_lock);
+  files->assign(File_read::opened_files.begin(),
+		File_read::opened_files.end());
 }
 
 // Class File_view.
@@ -863,6 +1052,7 @@ File_read::print_stats()
 File_view::~File_view()
 {
   gold_assert(this->file_.is_locked());
+  this->file_.note_use();
   this->view_->unlock();
 }
 
@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -35,6 +36,8 @@
 namespace gold
 {
 
+class Lock;
+
 // Since not all system supports stat.st_mtim and struct timespec,
 // we define our own structure and fill the nanoseconds if we can.
 
@@ -72,7 +75,10 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      released_(true), whole_file_view_(NULL), view_lock_(NULL),
+      in_use_(false), in_view_cache_(false), view_cache_position_(),
+      cached_bytes_(0), views_dropped_(false), view_hits_(0),
+      view_misses_(0), view_rereads_(0)
   { }
 
   ~File_read();
@@ -177,7 +183,10 @@ class File_read
   // interface, and it would be nice to have something more automatic.
   void
   clear_uncached_views()
-  { this->clear_views(CLEAR_VIEWS_ARCHIVE); }
+  {
+    this->note_use();
+    this->clear_views(CLEAR_VIEWS_ARCHIVE);
+  }
 
   // A struct used to do a multiple read.
   struct Read_multiple_entry
@@ -207,6 +216,12 @@ class File_read
   static void
   print_stats();
 
+  // Store in *FILES the names of all the files successfully opened
+  // during the link, sorted and without duplicates.  This is only
+  // recorded when --relink-cache is used.
+  static void
+  get_opened_files(std::vector<std::string>* files);
+
   // Return the open file descriptor (for plugins).
   int
   descriptor()
@@ -228,6 +243,8 @@ class File_read
     CLEAR_VIEWS_NORMAL,
     // Clear all uncached views (including in an archive).
     CLEAR_VIEWS_ARCHIVE,
+    // Clear all unlocked views, to stay within --view-cache-size.
+    CLEAR_VIEWS_UNLOCKED,
     // Clear all views (i.e., we're destroying the file).
     CLEAR_VIEWS_ALL
   };
@@ -239,6 +256,9 @@ class File_read
   // Total bytes mapped into memory during the link if --stats.
   static unsigned long long total_mapped_bytes;
 
+  // The names of the files opened during the link if --relink-cache.
+  static std::set<std::string> opened_files;
+
   // Current number of bytes mapped into memory during the link if
   // --stats.
   static unsigned long long current_mapped_bytes;
@@ -247,6 +267,21 @@ class File_read
   // --stats.
   static unsigned long long maximum_mapped_bytes;
 
+  // Views found, views made, and views made again after being
+  // dropped for --view-cache-size, if --stats.
+  static unsigned long long total_view_hits;
+  static unsigned long long total_view_misses;
+  static unsigned long long total_view_rereads;
+
+  // Bytes of views dropped for --view-cache-size.
+  static unsigned long long total_dropped_bytes;
+
+  // For --view-cache-size, the released files which keep views, most
+  // recently released first, and the size of those views.
+  typedef std::list<File_read*> View_cache;
+  static View_cache view_cache;
+  static unsigned long long view_cache_bytes;
+
   // A view into the file.
   class View
   {
@@ -392,6 +427,25 @@ class File_read
   void
   clear_views(Clear_views_mode);
 
+  // Note that the views of this file are being used, so that they
+  // are not dropped by another thread for --view-cache-size.
+  void
+  note_use();
+
+  // The bytes held by views which could be dropped.
+  size_t
+  droppable_bytes() const;
+
+  // Put this file at the front of the view cache, holding BYTES, and
+  // drop the views of the least recently used files while the cache
+  // is over budget.
+  void
+  update_view_cache(size_t bytes);
+
+  // Drop the unlocked views of this file, unless it is in use.
+  void
+  drop_views();
+
   // The size of a file page for buffering data.
   static const off_t page_size = 8192;
 
@@ -442,6 +496,25 @@ class File_read
   // - The contents was specified in the constructor.  Used only for
   //   testing purposes).
   View* whole_file_view_;
+  // For --view-cache-size, controls access to IN_USE_ and to the views
+  // when another thread drops them; NULL otherwise.
+  Lock* view_lock_;
+  // Whether the views have been used since the file was last
+  // released.  The views of a file in use are never dropped.
+  bool in_use_;
+  // Whether this file is in VIEW_CACHE, and where.
+  bool in_view_cache_;
+  View_cache::iterator view_cache_position_;
+  // The bytes this file contributes to VIEW_CACHE_BYTES.
+  size_t cached_bytes_;
+  // Whether views of this file have been dropped.
+  bool views_dropped_;
+  // Views found, made, and made again since the file was last
+  // released, if --stats.  These are only changed while the file is
+  // locked.
+  unsigned int view_hits_;
+  unsigned int view_misses_;
+  unsigned int view_rereads_;
 };
 
 // A view of file data that persists even when the file is unlocked.
@@ -23,6 +23,9 @@
 #include "gold.h"
 
 #include <cstring>
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
 
 #ifdef ENABLE_THREADS
 #include <pthread.h>
@@ -447,4 +450,100 @@ Initialize_lock::do_run_once(void*)
   *this->pplock_ = new Lock();
 }
 
+// Parallel jobs.
+
+// Return the number of threads to use for a Parallel_job.  The
+// --thread-count options are tuned for the workqueue, where most
+// tasks wait for I/O; here we want one thread per processor.
+
+int
+parallel_job_threads()
+{
+#ifndef ENABLE_THREADS
+  return 1;
+#else
+  if (!parameters->options_valid() || !parameters->options().threads())
+    return 1;
+  int count = parameters->options().thread_count_final();
+  if (count == 0)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+      count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      if (count < 1)
+	count = 1;
+    }
+  return std::min(count, 64);
+#endif
+}
+
+#ifdef ENABLE_THREADS
+
+// A piece of a Parallel_job running on its own thread.
+
+struct Parallel_job_piece
+{
+  Parallel_job* job;
+  int index;
+  int count;
+};
+
+// Passed to pthread_create.
+
+extern "C"
+void*
+parallel_job_thread_body(void* arg)
+{
+  Parallel_job_piece* piece = static_cast<Parallel_job_piece*>(arg);
+  piece->job->run_piece(piece->index, piece->count);
+  return NULL;
+}
+
+#endif // defined(ENABLE_THREADS)
+
+// Run COUNT pieces of JOB.  Piece 0 runs on the calling thread.  If
+// we can't start a thread for a piece, we run it on the calling
+// thread instead.
+
+void
+run_parallel_job(Parallel_job* job, int count)
+{
+#ifdef ENABLE_THREADS
+  if (count > 1 && parallel_job_threads() > 1)
+    {
+      std::vector<Parallel_job_piece> pieces(count);
+      std::vector<pthread_t> tids(count);
+      std::vector<bool> started(count, false);
+      for (int i = 1; i < count; ++i)
+	{
+	  pieces[i].job = job;
+	  pieces[i].index = i;
+	  pieces[i].count = count;
+	  int err = pthread_create(&tids[i], NULL, parallel_job_thread_body,
+				   &pieces[i]);
+	  if (err == 0)
+	    started[i] = true;
+	}
+
+      job->run_piece(0, count);
+
+      for (int i = 1; i < count; ++i)
+	{
+	  if (!started[i])
+	    job->run_piece(i, count);
+	  else
+	    {
+	      int err = pthread_join(tids[i], NULL);
+	      if (err != 0)
+		gold_fatal(_("pthread_join failed: %s"), strerror(err));
+	    }
+	}
+      return;
+    }
+#endif
+
+  for (int i = 0; i < count; ++i)
+    job->run_piece(i, count);
+}
+
 } // End namespace gold.
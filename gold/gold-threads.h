@@ -262,6 +262,39 @@ class Initialize_lock : public Once
   Lock** const pplock_;
 };
 
+// A job which can be split into pieces that run at the same time on
+// different threads.  This is for CPU bound work done within a single
+// Task, such as sorting a large table, during which the other
+// workqueue threads would otherwise sit idle.
+
+class Parallel_job
+{
+ public:
+  Parallel_job()
+  { }
+
+  virtual
+  ~Parallel_job()
+  { }
+
+  // Run piece INDEX of COUNT pieces.  Different pieces may run at
+  // the same time.
+  virtual void
+  run_piece(int index, int count) = 0;
+};
+
+// Return the number of threads worth using for a Parallel_job.  This
+// is 1 unless we are running with --threads.
+
+extern int
+parallel_job_threads();
+
+// Run COUNT pieces of JOB, and return when they have all finished.
+// The pieces run on separate threads when threads are enabled.
+
+extern void
+run_parallel_job(Parallel_job* job, int count);
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_THREADS_H)
@@ -200,10 +200,23 @@ queue_initial_tasks(const General_options& options,
 
   if (parameters->incremental_update())
     {
+      // If there is no output file to update, start from the relink
+      // cache's copy of the last output linked with this command line.
+      Relink_cache* relink_cache = layout->relink_cache();
+      const char* base_name = options.incremental_base();
+      std::string cached_base;
+      if (relink_cache != NULL
+	  && base_name == NULL
+	  && ::access(options.output_file_name(), F_OK) != 0
+	  && relink_cache->find_incremental_base(&cached_base))
+	base_name = cached_base.c_str();
+
       Output_file* of = new Output_file(options.output_file_name());
-      if (of->open_base_file(options.incremental_base(), true))
+      if (of->open_base_file(base_name, true))
 	{
 	  ibase = open_incremental_binary(of);
+	  if (ibase != NULL)
+	    ibase->set_relink_cache(relink_cache);
 	  if (ibase != NULL
 	      && ibase->check_inputs(cmdline, layout->incremental_inputs()))
 	    ibase->init_layout(layout);
@@ -443,6 +456,22 @@ queue_middle_gc_tasks(const General_options& options,
 		      Workqueue* workqueue,
 		      Mapfile* mapfile)
 {
+  // All the input files have been read, so an identical earlier link
+  // may be found in the relink cache.  If it is, the output file is
+  // already in place: queue nothing more, and let main finish once
+  // the workqueue is empty.
+  if (layout->relink_cache() != NULL
+      && layout->relink_cache()->fetch_output())
+    {
+      Timer* timer = parameters->timer();
+      if (timer != NULL)
+	{
+	  timer->stamp(0);
+	  timer->stamp(1);
+	}
+      return;
+    }
+
   // Read_relocs for all the objects must be done and processed to find
   // unused sections before any scanning of the relocs can take place.
   Task_token* this_blocker = NULL;
@@ -492,6 +521,20 @@ queue_middle_tasks(const General_options& options,
   if (timer != NULL)
     timer->stamp(0);
 
+  // Add any symbols still queued by the last input files.
+  symtab->add_pending_symbols();
+
+  // All the input files have been read, so an identical earlier link
+  // may be found in the relink cache.  If it is, the output file is
+  // already in place, and there is nothing more to do.
+  if (layout->relink_cache() != NULL
+      && layout->relink_cache()->fetch_output())
+    {
+      if (timer != NULL)
+	timer->stamp(1);
+      return;
+    }
+
   // We have to support the case of not seeing any input objects, and
   // generate an empty file.  Existing builds depend on being able to
   // pass an empty archive to the linker and get an empty object file
@@ -533,6 +576,10 @@ queue_middle_tasks(const General_options& options,
       symtab->icf()->find_identical_sections(input_objects, symtab);
     }
 
+  // Now that the symbols are resolved, find the hot text sections.
+  if (parameters->options().hot_text_segment())
+    layout->map_hot_text_sections(task, symtab);
+
   // Call Object::layout for the second time to determine the
   // output_sections for all referenced input sections.  When
   // --gc-sections or --icf is turned on, or when certain input
@@ -563,6 +610,10 @@ queue_middle_tasks(const General_options& options,
   // Finalize the .eh_frame section.
   layout->finalize_eh_frame_section();
 
+  // Order the text sections named by a call graph profile.
+  if (parameters->options().call_graph_ordering_file())
+    layout->order_sections_by_call_graph(task, symtab);
+
   /* If plugins have specified a section order, re-arrange input sections
      according to a specified section order.  If --section-ordering-file is
      also specified, do not do anything here.  */
@@ -805,6 +856,11 @@ queue_final_tasks(const General_options& options,
 
   bool any_postprocessing_sections = layout->any_postprocessing_sections();
 
+  // For a chunked build ID, find the chunks which can be hashed as
+  // soon as they are written.  This must be done before any of the
+  // tasks which write the output file are queued.
+  layout->create_output_chunks(of);
+
   // Use a blocker to wait until all the input sections have been
   // written out.
   Task_token* input_sections_blocker = NULL;
@@ -880,7 +936,7 @@ queue_final_tasks(const General_options& options,
     }
 
   // Create tasks for tree-style build ID computation, if necessary.
-  if (strcmp(options.build_id(), "tree") == 0)
+  if (Layout::build_id_is_chunked())
     {
       // Queue a task to compute the build id.  This will be blocked by
       // FINAL_BLOCKER, and will in turn schedule the task to close
@@ -23,8 +23,18 @@
 #include "gold.h"
 
 #include <set>
+#include <algorithm>
+#include <cerrno>
 #include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <dirent.h>
 #include "libiberty.h"
+#include "sha1.h"
 
 #include "elfcpp.h"
 #include "options.h"
@@ -37,6 +47,8 @@
 #include "target.h"
 #include "fileread.h"
 #include "script.h"
+#include "debug.h"
+#include "gold-threads.h"
 
 namespace gold {
 
@@ -492,10 +504,27 @@ Sized_incremental_binary<size, big_endian>::do_file_has_changed(
   if (disp == INCREMENTAL_STARTUP)
     disp = parameters->options().incremental_startup_disposition();
 
+  const char* filename = input_file.filename();
   if (disp != INCREMENTAL_CHECK)
-    return disp == INCREMENTAL_CHANGED;
+    {
+      if (disp == INCREMENTAL_CHANGED)
+	return true;
+      if (this->relink_cache_ != NULL)
+	this->relink_cache_->note_unchanged_file(filename);
+      return false;
+    }
+
+  // If the base file came from the relink cache, its recorded
+  // modification times belong to another build tree, so compare
+  // contents instead.
+  if (this->relink_cache_ != NULL)
+    {
+      bool known;
+      bool changed = this->relink_cache_->file_has_changed(filename, &known);
+      if (known)
+	return changed;
+    }
 
-  const char* filename = input_file.filename();
   Timespec old_mtime = input_file.get_mtime();
   Timespec new_mtime;
   if (!get_mtime(filename, &new_mtime))
@@ -511,6 +540,8 @@ Sized_incremental_binary<size, big_endian>::do_file_has_changed(
   if (new_mtime.seconds == old_mtime.seconds
       && new_mtime.nanoseconds > old_mtime.nanoseconds)
     return true;
+  if (this->relink_cache_ != NULL)
+    this->relink_cache_->note_unchanged_file(filename);
   return false;
 }
 
@@ -3074,6 +3105,580 @@ Incremental_library::do_for_all_unused_symbols(Symbol_visitor_base* v) const
   v->visit(p->c_str());
 }
 
+// Class Relink_cache.
+
+// Return the option name in ARG without its leading dashes, or NULL
+// if ARG is not an option.
+
+static const char*
+relink_cache_option_name(const char* arg)
+{
+  if (arg[0] != '-')
+    return NULL;
+  return arg[1] == '-' ? arg + 2 : arg + 1;
+}
+
+// Return true if OPTION, without leading dashes, is one of NAMES,
+// either by itself or followed by '='.  Set *TAKES_ARG if it is by
+// itself, so that its argument is in the next element of argv.
+
+static bool
+relink_cache_option_matches(const char* option, const char* const* names,
+			    bool* takes_arg)
+{
+  for (const char* const* p = names; *p != NULL; ++p)
+    {
+      size_t len = strlen(*p);
+      if (strncmp(option, *p, len) != 0)
+	continue;
+      if (option[len] == '\0')
+	{
+	  *takes_arg = true;
+	  return true;
+	}
+      if (option[len] == '=')
+	{
+	  *takes_arg = false;
+	  return true;
+	}
+    }
+  return false;
+}
+
+// Convert the digest in DIGEST to hex.
+
+static std::string
+relink_cache_hex(const unsigned char* digest, size_t len)
+{
+  static const char hexdigits[] = "0123456789abcdef";
+  std::string ret;
+  ret.reserve(len * 2);
+  for (size_t i = 0; i < len; ++i)
+    {
+      ret += hexdigits[digest[i] >> 4];
+      ret += hexdigits[digest[i] & 0xf];
+    }
+  return ret;
+}
+
+Relink_cache::Relink_cache(const char* dir, int argc,
+			   const char* const* argv)
+  : dir_(dir), options_key_(), link_key_(), opened_files_(),
+    base_files_(), unchanged_files_(), have_manifest_(false),
+    base_from_cache_(false), fetch_attempted_(false),
+    output_fetched_(false)
+{
+  // Options which do not change the contents of the output file.
+  // These take an argument.
+  static const char* const ignored_with_arg[] =
+  {
+    "o", "output", "relink-cache", "relink-cache-size", "debug",
+    "task-trace", "stats-file",
+    "incremental-base", "incremental-patch", "thread-count",
+    "thread-count-initial", "thread-count-middle", "thread-count-final",
+    NULL
+  };
+  // These do not.
+  static const char* const ignored[] =
+  {
+    "stats", "threads", "no-threads", "incremental",
+    "incremental-full", "incremental-update", "incremental-changed",
+    "incremental-unchanged", "incremental-unknown",
+    "incremental-startup-unchanged", NULL
+  };
+
+  sha1_ctx ctx;
+  sha1_init_ctx(&ctx);
+
+  std::string version(get_version_string());
+  sha1_process_bytes(version.c_str(), version.length() + 1, &ctx);
+
+  for (int i = 1; i < argc; ++i)
+    {
+      const char* option = relink_cache_option_name(argv[i]);
+      bool takes_arg;
+      if (option != NULL
+	  && relink_cache_option_matches(option, ignored_with_arg,
+					 &takes_arg))
+	{
+	  if (takes_arg)
+	    ++i;
+	  continue;
+	}
+      if (option != NULL
+	  && relink_cache_option_matches(option, ignored, &takes_arg)
+	  && takes_arg)
+	continue;
+      sha1_process_bytes(argv[i], strlen(argv[i]) + 1, &ctx);
+    }
+
+  // These files are read directly rather than as input files.
+  const char* extra_files[4];
+  extra_files[0] = parameters->options().retain_symbols_file();
+  extra_files[1] = parameters->options().section_ordering_file();
+  extra_files[2] = parameters->options().call_graph_ordering_file();
+  extra_files[3] = parameters->options().hot_text_file();
+  for (int i = 0; i < 4; ++i)
+    {
+      if (extra_files[i] == NULL)
+	continue;
+      Digest digest(Relink_cache::hash_file(extra_files[i]));
+      sha1_process_bytes(digest.c_str(), digest.length() + 1, &ctx);
+    }
+
+  unsigned char result[20];
+  sha1_finish_ctx(&ctx, result);
+  this->options_key_ = relink_cache_hex(result, sizeof result);
+}
+
+// Return whether the output of this link may be copied from, or
+// stored into, the cache.  Links which write other files, which must
+// report what they did, or whose output is not determined by their
+// inputs, do not use the cache.  Incremental links keep their own
+// base file in the cache instead.
+
+bool
+Relink_cache::is_cacheable() const
+{
+  const General_options& options(parameters->options());
+  return (!parameters->incremental()
+	  && !options.has_plugins()
+	  && strcmp(options.output_file_name(), "-") != 0
+	  && !options.user_set_Map()
+	  && !options.cref()
+	  && !options.user_set_print_symbol_counts()
+	  && !options.print_gc_sections()
+	  && !options.print_icf_sections()
+	  && (!options.user_set_build_id()
+	      || strcmp(options.build_id(), "uuid") != 0));
+}
+
+// Return the digest of the contents of FILENAME.
+
+Relink_cache::Digest
+Relink_cache::hash_file(const char* filename)
+{
+  int fd = ::open(filename, O_RDONLY);
+  if (fd < 0)
+    return Digest();
+
+  sha1_ctx ctx;
+  sha1_init_ctx(&ctx);
+  const size_t bufsize = 64 * 1024;
+  char* buf = new char[bufsize];
+  bool ok = true;
+  while (true)
+    {
+      ssize_t len = ::read(fd, buf, bufsize);
+      if (len < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  ok = false;
+	  break;
+	}
+      if (len == 0)
+	break;
+      sha1_process_bytes(buf, len, &ctx);
+    }
+  delete[] buf;
+  ::close(fd);
+  if (!ok)
+    return Digest();
+
+  unsigned char result[20];
+  sha1_finish_ctx(&ctx, result);
+  return relink_cache_hex(result, sizeof result);
+}
+
+// A job to compute the digests of a list of files, several files at a
+// time.
+
+class Relink_cache_hash_job : public Parallel_job
+{
+ public:
+  Relink_cache_hash_job(const std::vector<std::string>& files,
+			std::vector<std::string>* digests)
+    : files_(files), digests_(digests)
+  { }
+
+  void
+  run_piece(int index, int count);
+
+ private:
+  const std::vector<std::string>& files_;
+  std::vector<std::string>* digests_;
+};
+
+void
+Relink_cache_hash_job::run_piece(int index, int count)
+{
+  for (size_t i = index; i < this->files_.size(); i += count)
+    (*this->digests_)[i] = Relink_cache::hash_file(this->files_[i].c_str());
+}
+
+// Compute the digests of the files opened during the link, and from
+// them the key for the link.
+
+void
+Relink_cache::hash_opened_files()
+{
+  if (!this->link_key_.empty())
+    return;
+
+  std::vector<std::string> files;
+  File_read::get_opened_files(&files);
+  std::vector<std::string> digests(files.size());
+
+  Relink_cache_hash_job job(files, &digests);
+  int threads = parallel_job_threads();
+  if (threads > static_cast<int>(files.size()))
+    threads = files.size();
+  run_parallel_job(&job, threads < 1 ? 1 : threads);
+
+  sha1_ctx ctx;
+  sha1_init_ctx(&ctx);
+  sha1_process_bytes(this->options_key_.c_str(),
+		     this->options_key_.length() + 1, &ctx);
+  for (size_t i = 0; i < files.size(); ++i)
+    {
+      this->opened_files_[files[i]] = digests[i];
+      sha1_process_bytes(digests[i].c_str(), digests[i].length() + 1, &ctx);
+    }
+  unsigned char result[20];
+  sha1_finish_ctx(&ctx, result);
+  this->link_key_ = relink_cache_hex(result, sizeof result);
+}
+
+// Copy FROM to TO.  The copy is written to a temporary file in
+// TMPDIR, which is then renamed, so that readers never see a partial
+// file.
+
+bool
+Relink_cache::copy_file(const std::string& from, const std::string& to,
+			const std::string& tmpdir)
+{
+  int in = ::open(from.c_str(), O_RDONLY);
+  if (in < 0)
+    return false;
+  struct stat st;
+  if (::fstat(in, &st) < 0 || !S_ISREG(st.st_mode))
+    {
+      ::close(in);
+      return false;
+    }
+
+  std::string tmpname(tmpdir + "/.relink-XXXXXX");
+  char* tmp = new char[tmpname.length() + 1];
+  strcpy(tmp, tmpname.c_str());
+  int out = ::mkstemp(tmp);
+  tmpname = tmp;
+  delete[] tmp;
+  if (out < 0)
+    {
+      ::close(in);
+      return false;
+    }
+
+  const size_t bufsize = 64 * 1024;
+  char* buf = new char[bufsize];
+  bool ok = true;
+  while (ok)
+    {
+      ssize_t len = ::read(in, buf, bufsize);
+      if (len < 0 && errno == EINTR)
+	continue;
+      if (len <= 0)
+	{
+	  ok = len == 0;
+	  break;
+	}
+      const char* p = buf;
+      while (len > 0)
+	{
+	  ssize_t written = ::write(out, p, len);
+	  if (written < 0 && errno == EINTR)
+	    continue;
+	  if (written <= 0)
+	    {
+	      ok = false;
+	      break;
+	    }
+	  p += written;
+	  len -= written;
+	}
+    }
+  delete[] buf;
+  ::close(in);
+
+  if (::fchmod(out, st.st_mode & 07777) < 0)
+    ok = false;
+  if (::close(out) < 0)
+    ok = false;
+  if (ok && ::rename(tmpname.c_str(), to.c_str()) < 0)
+    ok = false;
+  if (!ok)
+    ::unlink(tmpname.c_str());
+  return ok;
+}
+
+// Look up the output of a link that read the same files.
+
+bool
+Relink_cache::fetch_output()
+{
+  if (this->fetch_attempted_ || !this->is_cacheable())
+    return false;
+  this->fetch_attempted_ = true;
+
+  this->hash_opened_files();
+
+  std::string cached(this->cache_file(this->link_key_ + ".out"));
+  const char* output = parameters->options().output_file_name();
+
+  // The temporary file must be on the same file system as the output.
+  std::string outdir(output);
+  size_t slash = outdir.rfind('/');
+  if (slash == std::string::npos)
+    outdir = ".";
+  else
+    outdir.resize(slash == 0 ? 1 : slash);
+
+  if (!Relink_cache::copy_file(cached, output, outdir))
+    {
+      gold_debug(DEBUG_FILES, "relink cache miss for %s", output);
+      return false;
+    }
+  gold_debug(DEBUG_FILES, "relink cache hit for %s", output);
+
+  // Mark the cached output as recently used, so that trim keeps it.
+  ::utime(cached.c_str(), NULL);
+
+  this->output_fetched_ = true;
+  return true;
+}
+
+// Store the output of a successful link.
+
+void
+Relink_cache::store_output()
+{
+  const char* output = parameters->options().output_file_name();
+
+  // Create the cache directory the first time it is used.  Any other
+  // problem with it shows up when storing the output below.
+  ::mkdir(this->dir_.c_str(), 0777);
+
+  if (parameters->incremental())
+    {
+      // Keep the output as the base for the next incremental link
+      // with this command line, along with the digests of its inputs.
+      // Inputs which were taken from the old base file were not
+      // opened by this link; they were recorded by
+      // note_unchanged_file.
+      this->hash_opened_files();
+      this->base_files_ = this->unchanged_files_;
+      for (File_digests::const_iterator p = this->opened_files_.begin();
+	   p != this->opened_files_.end();
+	   ++p)
+	this->base_files_[p->first] = p->second;
+
+      std::string base("base-" + this->options_key_);
+      if (!this->write_manifest(base + ".inputs")
+	  || !Relink_cache::copy_file(output, this->cache_file(base + ".out"),
+				      this->dir_))
+	gold_debug(DEBUG_FILES, "unable to store %s in relink cache",
+		   output);
+      this->trim();
+      return;
+    }
+
+  if (!this->is_cacheable())
+    return;
+
+  this->hash_opened_files();
+  if (!Relink_cache::copy_file(output,
+			       this->cache_file(this->link_key_ + ".out"),
+			       this->dir_))
+    gold_debug(DEBUG_FILES, "unable to store %s in relink cache", output);
+  this->trim();
+}
+
+// An output file in the cache, for trim.
+
+struct Relink_cache_entry
+{
+  // The file name, without the directory.
+  std::string name;
+  // The size of the file.
+  off_t size;
+  // When the file was last stored or fetched.
+  time_t mtime;
+};
+
+// Sort cache entries so that the least recently used comes first.
+
+struct Relink_cache_entry_compare
+{
+  bool
+  operator()(const Relink_cache_entry& a, const Relink_cache_entry& b) const
+  {
+    if (a.mtime != b.mtime)
+      return a.mtime < b.mtime;
+    return a.name < b.name;
+  }
+};
+
+// Remove the least recently used outputs from the cache until it is
+// no larger than --relink-cache-size.  Other links may be using the
+// cache at the same time, so a file which has already gone is not
+// an error.
+
+void
+Relink_cache::trim() const
+{
+  uint64_t limit = parameters->options().relink_cache_size();
+  if (limit == 0)
+    return;
+
+  DIR* dir = ::opendir(this->dir_.c_str());
+  if (dir == NULL)
+    return;
+  std::vector<Relink_cache_entry> entries;
+  uint64_t total = 0;
+  struct dirent* de;
+  while ((de = ::readdir(dir)) != NULL)
+    {
+      std::string name(de->d_name);
+      if (name.length() < 4
+	  || name.compare(name.length() - 4, 4, ".out") != 0)
+	continue;
+      struct stat st;
+      if (::stat(this->cache_file(name).c_str(), &st) < 0
+	  || !S_ISREG(st.st_mode))
+	continue;
+      Relink_cache_entry entry;
+      entry.name = name;
+      entry.size = st.st_size;
+      entry.mtime = st.st_mtime;
+      entries.push_back(entry);
+      total += st.st_size;
+    }
+  ::closedir(dir);
+
+  if (total <= limit)
+    return;
+
+  std::sort(entries.begin(), entries.end(), Relink_cache_entry_compare());
+  for (std::vector<Relink_cache_entry>::const_iterator p = entries.begin();
+       p != entries.end() && total > limit;
+       ++p)
+    {
+      gold_debug(DEBUG_FILES, "removing %s from relink cache",
+		 p->name.c_str());
+      ::unlink(this->cache_file(p->name).c_str());
+      // An incremental base is only useful with its manifest.
+      if (p->name.compare(0, 5, "base-") == 0)
+	{
+	  std::string inputs(p->name.substr(0, p->name.length() - 4)
+			     + ".inputs");
+	  ::unlink(this->cache_file(inputs).c_str());
+	}
+      total -= p->size;
+    }
+}
+
+// Read the manifest of the cached incremental base, which has one
+// line per input file, holding its digest and its name.
+
+void
+Relink_cache::read_manifest()
+{
+  if (this->have_manifest_)
+    return;
+  this->have_manifest_ = true;
+
+  std::string name(this->cache_file("base-" + this->options_key_
+				    + ".inputs"));
+  std::ifstream in(name.c_str());
+  std::string line;
+  while (std::getline(in, line))
+    {
+      size_t space = line.find(' ');
+      if (space == std::string::npos)
+	continue;
+      this->base_files_[line.substr(space + 1)] = line.substr(0, space);
+    }
+}
+
+// Write the manifest NAME for the base file.
+
+bool
+Relink_cache::write_manifest(const std::string& name) const
+{
+  std::string tmpname(this->cache_file(name + ".tmp"));
+  FILE* f = ::fopen(tmpname.c_str(), "w");
+  if (f == NULL)
+    return false;
+  for (File_digests::const_iterator p = this->base_files_.begin();
+       p != this->base_files_.end();
+       ++p)
+    if (!p->second.empty())
+      fprintf(f, "%s %s\n", p->second.c_str(), p->first.c_str());
+  bool ok = ::fclose(f) == 0;
+  if (ok && ::rename(tmpname.c_str(), this->cache_file(name).c_str()) < 0)
+    ok = false;
+  if (!ok)
+    ::unlink(tmpname.c_str());
+  return ok;
+}
+
+// Return the cached base file for an incremental link.
+
+bool
+Relink_cache::find_incremental_base(std::string* path)
+{
+  std::string base(this->cache_file("base-" + this->options_key_ + ".out"));
+  if (::access(base.c_str(), R_OK) != 0)
+    return false;
+  this->read_manifest();
+  this->base_from_cache_ = true;
+  *path = base;
+  return true;
+}
+
+// Return true if FILENAME has changed since the cached base was
+// linked.
+
+bool
+Relink_cache::file_has_changed(const char* filename, bool* known)
+{
+  File_digests::const_iterator p = this->base_files_.find(filename);
+  if (!this->base_from_cache_ || p == this->base_files_.end())
+    {
+      *known = false;
+      return true;
+    }
+  *known = true;
+  Digest digest(Relink_cache::hash_file(filename));
+  if (digest != p->second)
+    return true;
+  this->unchanged_files_[filename] = digest;
+  return false;
+}
+
+// Record that FILENAME was taken from the base file.
+
+void
+Relink_cache::note_unchanged_file(const char* filename)
+{
+  if (this->unchanged_files_.find(filename) != this->unchanged_files_.end())
+    return;
+  Digest digest(Relink_cache::hash_file(filename));
+  if (!digest.empty())
+    this->unchanged_files_[filename] = digest;
+}
+
 // Instantiate the templates we need.
 
 #ifdef HAVE_TARGET_32_LITTLE
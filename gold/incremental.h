@@ -45,6 +45,7 @@ class Incremental_archive_entry;
 class Incremental_inputs;
 class Incremental_binary;
 class Incremental_library;
+class Relink_cache;
 class Object;
 
 // Incremental input type as stored in .gnu_incremental_inputs.
@@ -1342,7 +1343,7 @@ class Incremental_binary
  public:
   Incremental_binary(Output_file* output, Target* /*target*/)
     : input_args_map_(), library_map_(), script_map_(),
-      output_(output)
+      relink_cache_(NULL), output_(output)
   { }
 
   virtual
@@ -1431,6 +1432,13 @@ class Incremental_binary
   file_has_changed(unsigned int n) const
   { return this->do_file_has_changed(n); }
 
+  // Use the input file contents recorded by a relink cache, rather
+  // than modification times, to decide whether input files have
+  // changed, and record the inputs which have not.
+  void
+  set_relink_cache(Relink_cache* relink_cache)
+  { this->relink_cache_ = relink_cache; }
+
   // Return the Input_argument for input file N.  Returns NULL if
   // the Input_argument is not available.
   const Input_argument*
@@ -1576,6 +1584,8 @@ class Incremental_binary
   std::vector<Incremental_library*> library_map_;
   // Map from an input file index to a Script_info.
   std::vector<Script_info*> script_map_;
+  // The relink cache, or NULL.
+  Relink_cache* relink_cache_;
 
  private:
   // Edited output file object.
@@ -2250,6 +2260,126 @@ class Incremental_library : public Library_base
   bool is_reported_;
 };
 
+// This class implements --relink-cache=DIR.  The cache directory
+// holds the outputs of earlier links, named by a hash of the
+// normalized command line and of the contents of every file the link
+// read.  A link whose key is found in the cache copies the stored
+// output instead of laying out and writing a new one.  For
+// incremental links, the cache also keeps the most recent output for
+// each command line, together with a manifest of the contents of its
+// inputs, so that a build tree without an output file can start from
+// an incremental update instead of a full link, and so that inputs
+// are treated as unchanged when their contents are unchanged even if
+// their modification times are not.  When the directory holds more
+// than --relink-cache-size bytes, the least recently used outputs are
+// removed.
+
+class Relink_cache
+{
+ public:
+  Relink_cache(const char* dir, int argc, const char* const* argv);
+
+  // Return whether the output of this link may be copied from, or
+  // stored into, the cache.
+  bool
+  is_cacheable() const;
+
+  // Look up the output of a link that read the same files as this
+  // one.  If it is found, copy it to the output file and return true.
+  // This is only called once all the input files have been read.
+  bool
+  fetch_output();
+
+  // Return whether fetch_output found the output in the cache.
+  bool
+  output_fetched() const
+  { return this->output_fetched_; }
+
+  // Store the output file of a successful link.
+  void
+  store_output();
+
+  // If the cache holds a base file for an incremental link with this
+  // command line, set *PATH to its name and return true.
+  bool
+  find_incremental_base(std::string* path);
+
+  // If the incremental base came from the cache, return true if
+  // FILENAME's contents differ from those it had when the base was
+  // linked.  Set *KNOWN to false if the base did not come from the
+  // cache or its manifest does not list FILENAME.
+  bool
+  file_has_changed(const char* filename, bool* known);
+
+  // Record that FILENAME is unchanged since the base file was linked,
+  // so that it is listed in the manifest of the next base.
+  void
+  note_unchanged_file(const char* filename);
+
+  // A SHA-1 digest in hex.
+  typedef std::string Digest;
+
+  // Return the digest of the contents of FILENAME, or an empty string
+  // if it can not be read.
+  static Digest
+  hash_file(const char* filename);
+
+ private:
+  // Map from file name to the digest of its contents.
+  typedef std::map<std::string, Digest> File_digests;
+
+  // Compute the digests of the files opened during the link.
+  void
+  hash_opened_files();
+
+  // Return the name of the cache file NAME.
+  std::string
+  cache_file(const std::string& name) const
+  { return this->dir_ + '/' + name; }
+
+  // Copy FROM to TO through a temporary file, so that TO is replaced
+  // atomically.  Return true on success.
+  static bool
+  copy_file(const std::string& from, const std::string& to,
+	    const std::string& tmpdir);
+
+  // Read and write the manifest of an incremental base.
+  void
+  read_manifest();
+
+  bool
+  write_manifest(const std::string& name) const;
+
+  // Remove the least recently used outputs until the cache is no
+  // larger than --relink-cache-size.
+  void
+  trim() const;
+
+  // The cache directory.
+  std::string dir_;
+  // Digest of the normalized command line, the linker version, and
+  // any files read outside of the input file machinery.
+  Digest options_key_;
+  // Digest of the options and of all the files opened during the
+  // link; empty until computed.
+  Digest link_key_;
+  // The digests of the files opened during the link.
+  File_digests opened_files_;
+  // The digests recorded in the manifest of the cached incremental
+  // base.
+  File_digests base_files_;
+  // The digests of the inputs taken unchanged from the base file.
+  File_digests unchanged_files_;
+  // Whether base_files_ has been read.
+  bool have_manifest_;
+  // Whether the incremental base file came from the cache.
+  bool base_from_cache_;
+  // Whether fetch_output has been called.
+  bool fetch_attempted_;
+  // Whether fetch_output found the output in the cache.
+  bool output_fetched_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_INCREMENTAL_H)
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <utility>
 #include <fcntl.h>
 #include <fnmatch.h>
@@ -49,6 +50,7 @@
 #include "dynobj.h"
 #include "ehframe.h"
 #include "gdb-index.h"
+#include "debug-names.h"
 #include "compressed_output.h"
 #include "reduced_debug_output.h"
 #include "object.h"
@@ -239,7 +241,109 @@ Free_list::print_stats()
 	  program_name, Free_list::num_allocate_visits);
 }
 
-// A Hash_task computes the MD5 checksum of an array of char.
+// The 64-bit xxHash (XXH64) of LEN bytes at P, used for
+// --build-id=fast.  This is much faster than MD5 or SHA-1, and is
+// good enough to identify a build, but it is not a cryptographic
+// hash.
+
+static const uint64_t xxh_prime1 = 0x9e3779b185ebca87ULL;
+static const uint64_t xxh_prime2 = 0xc2b2ae3d27d4eb4fULL;
+static const uint64_t xxh_prime3 = 0x165667b19e3779f9ULL;
+static const uint64_t xxh_prime4 = 0x85ebca77c2b2ae63ULL;
+static const uint64_t xxh_prime5 = 0x27d4eb2f165667c5ULL;
+
+static inline uint64_t
+xxh_rotl(uint64_t x, int r)
+{ return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t
+xxh_round(uint64_t acc, const unsigned char* p)
+{
+  acc += elfcpp::Swap_unaligned<64, false>::readval(p) * xxh_prime2;
+  return xxh_rotl(acc, 31) * xxh_prime1;
+}
+
+static inline uint64_t
+xxh_merge_round(uint64_t acc, uint64_t val)
+{
+  val = xxh_rotl(val * xxh_prime2, 31) * xxh_prime1;
+  return (acc ^ val) * xxh_prime1 + xxh_prime4;
+}
+
+static uint64_t
+xxhash64(const unsigned char* p, size_t len, uint64_t seed)
+{
+  const unsigned char* const pend = p + len;
+  uint64_t h;
+
+  if (len >= 32)
+    {
+      uint64_t v1 = seed + xxh_prime1 + xxh_prime2;
+      uint64_t v2 = seed + xxh_prime2;
+      uint64_t v3 = seed;
+      uint64_t v4 = seed - xxh_prime1;
+      const unsigned char* const plimit = pend - 32;
+      do
+	{
+	  v1 = xxh_round(v1, p);
+	  v2 = xxh_round(v2, p + 8);
+	  v3 = xxh_round(v3, p + 16);
+	  v4 = xxh_round(v4, p + 24);
+	  p += 32;
+	}
+      while (p <= plimit);
+      h = (xxh_rotl(v1, 1) + xxh_rotl(v2, 7) + xxh_rotl(v3, 12)
+	   + xxh_rotl(v4, 18));
+      h = xxh_merge_round(h, v1);
+      h = xxh_merge_round(h, v2);
+      h = xxh_merge_round(h, v3);
+      h = xxh_merge_round(h, v4);
+    }
+  else
+    h = seed + xxh_prime5;
+
+  h += len;
+
+  for (; p + 8 <= pend; p += 8)
+    {
+      h ^= xxh_round(0, p);
+      h = xxh_rotl(h, 27) * xxh_prime1 + xxh_prime4;
+    }
+  if (p + 4 <= pend)
+    {
+      h ^= elfcpp::Swap_unaligned<32, false>::readval(p) * xxh_prime1;
+      h = xxh_rotl(h, 23) * xxh_prime2 + xxh_prime3;
+      p += 4;
+    }
+  for (; p < pend; ++p)
+    {
+      h ^= *p * xxh_prime5;
+      h = xxh_rotl(h, 11) * xxh_prime1;
+    }
+
+  h ^= h >> 33;
+  h *= xxh_prime2;
+  h ^= h >> 29;
+  h *= xxh_prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+// Write the --build-id=fast ID of a buffer holding either the whole
+// output file or the hashes of its chunks.  The ID is 128 bits, made
+// of two XXH64 hashes with different seeds.
+
+static void
+fast_build_id(const unsigned char* p, size_t len, unsigned char* dst)
+{
+  elfcpp::Swap_unaligned<64, false>::writeval(dst, xxhash64(p, len, 0));
+  elfcpp::Swap_unaligned<64, false>::writeval(dst + 8,
+					      xxhash64(p, len, xxh_prime5));
+}
+
+// A Hash_task computes the MD5 checksum, or for --build-id=fast the
+// XXH64 hash, of an array of char.  For --output-writeback it may then
+// write that part of the output file back to disk.
 
 class Hash_task : public Task
 {
@@ -248,9 +352,11 @@ class Hash_task : public Task
 	    size_t offset,
 	    size_t size,
 	    unsigned char* dst,
+	    bool is_fast,
+	    bool write_back,
 	    Task_token* final_blocker)
-    : of_(of), offset_(offset), size_(size), dst_(dst),
-      final_blocker_(final_blocker)
+    : of_(of), offset_(offset), size_(size), dst_(dst), is_fast_(is_fast),
+      write_back_(write_back), final_blocker_(final_blocker)
   { }
 
   void
@@ -258,8 +364,14 @@ class Hash_task : public Task
   {
     const unsigned char* iv =
 	this->of_->get_input_view(this->offset_, this->size_);
-    md5_buffer(reinterpret_cast<const char*>(iv), this->size_, this->dst_);
+    if (this->is_fast_)
+      elfcpp::Swap_unaligned<64, false>::writeval(this->dst_,
+						  xxhash64(iv, this->size_, 0));
+    else
+      md5_buffer(reinterpret_cast<const char*>(iv), this->size_, this->dst_);
     this->of_->free_input_view(this->offset_, this->size_, iv);
+    if (this->write_back_)
+      this->of_->write_back(this->offset_, this->size_);
   }
 
   Task_token*
@@ -280,9 +392,203 @@ class Hash_task : public Task
   const size_t offset_;
   const size_t size_;
   unsigned char* const dst_;
+  const bool is_fast_;
+  const bool write_back_;
   Task_token* const final_blocker_;
 };
 
+// Output_chunks methods.
+
+const unsigned int Output_chunks::not_early;
+
+Output_chunks::Output_chunks(Output_file* of, size_t filesize,
+			     size_t chunk_size, bool is_hashing, bool is_fast,
+			     bool is_writeback)
+  : of_(of), filesize_(filesize), chunk_size_(chunk_size),
+    chunk_count_((filesize - 1) / chunk_size + 1), is_hashing_(is_hashing),
+    is_fast_(is_fast), is_writeback_(is_writeback), hashes_(NULL),
+    pending_(this->chunk_count_, not_early), object_chunks_(),
+    early_chunks_(), early_chunk_count_(0), lock_(), blocker_(NULL)
+{
+  if (is_hashing)
+    {
+      this->hashes_ = new unsigned char[this->chunk_count_
+					* this->hash_size()];
+      this->blocker_ = new Task_token(true);
+      this->blocker_->add_blockers(this->chunk_count_);
+    }
+}
+
+// A chunk is complete early if it lies entirely within output
+// sections which hold nothing but ordinary input sections.  Those are
+// written by the Relocate_tasks of the objects which own the input
+// sections, and by Write_sections_task for any code fill between
+// them.  Everything else waits for the whole file.
+
+void
+Output_chunks::find_early_chunks(const Layout* layout)
+{
+  if (parameters->incremental()
+      || parameters->options().relocatable()
+      || parameters->options().emit_relocs()
+      || parameters->target().may_relax()
+      || layout->any_postprocessing_sections())
+    return;
+
+  // The ranges of the file covered by suitable output sections, and
+  // the ranges of their input sections.
+  std::vector<std::pair<off_t, off_t> > covered;
+  std::vector<Output_section::Input_section_range> ranges;
+  const Layout::Section_list& sections(layout->section_list());
+  for (Layout::Section_list::const_iterator p = sections.begin();
+       p != sections.end();
+       ++p)
+    {
+      const Output_section* os = *p;
+      if (os->type() == elfcpp::SHT_NOBITS || os->data_size() == 0)
+	continue;
+      if (os->get_input_section_ranges(&ranges))
+	covered.push_back(std::make_pair(os->offset(),
+					 os->offset() + os->data_size()));
+    }
+  if (covered.empty())
+    return;
+  std::sort(covered.begin(), covered.end());
+
+  // Mark each chunk covered by a contiguous run of suitable sections.
+  const off_t chunk_size = this->chunk_size_;
+  std::vector<std::pair<off_t, off_t> >::const_iterator pc = covered.begin();
+  off_t run_start = pc->first;
+  off_t run_end = pc->second;
+  ++pc;
+  for (size_t i = 0; i < this->chunk_count_; ++i)
+    {
+      off_t start = i * chunk_size;
+      off_t end = std::min(start + chunk_size,
+			   static_cast<off_t>(this->filesize_));
+      while (run_end < end && pc != covered.end())
+	{
+	  if (pc->first > run_end)
+	    run_start = pc->first;
+	  run_end = std::max(run_end, pc->second);
+	  ++pc;
+	}
+      if (run_start <= start && run_end >= end)
+	{
+	  // Write_sections_task.
+	  this->pending_[i] = 1;
+	  this->early_chunks_.push_back(i);
+	}
+    }
+  if (this->early_chunks_.empty())
+    return;
+
+  for (std::vector<Output_section::Input_section_range>::const_iterator p =
+	 ranges.begin();
+       p != ranges.end();
+       ++p)
+    {
+      size_t first = p->offset / chunk_size;
+      size_t last = (p->offset + p->size - 1) / chunk_size;
+      for (size_t i = first; i <= last; ++i)
+	if (this->pending_[i] != not_early)
+	  this->object_chunks_[p->relobj].push_back(i);
+    }
+
+  for (Object_chunks::iterator p = this->object_chunks_.begin();
+       p != this->object_chunks_.end();
+       ++p)
+    {
+      std::vector<size_t>& chunks(p->second);
+      std::sort(chunks.begin(), chunks.end());
+      chunks.erase(std::unique(chunks.begin(), chunks.end()), chunks.end());
+      for (std::vector<size_t>::const_iterator pi = chunks.begin();
+	   pi != chunks.end();
+	   ++pi)
+	++this->pending_[*pi];
+    }
+}
+
+void
+Output_chunks::object_written(Workqueue* workqueue, const Relobj* object)
+{
+  Object_chunks::const_iterator p = this->object_chunks_.find(object);
+  if (p == this->object_chunks_.end())
+    return;
+  for (std::vector<size_t>::const_iterator pi = p->second.begin();
+       pi != p->second.end();
+       ++pi)
+    this->writer_done(workqueue, *pi);
+}
+
+void
+Output_chunks::sections_written(Workqueue* workqueue)
+{
+  for (std::vector<size_t>::const_iterator p = this->early_chunks_.begin();
+       p != this->early_chunks_.end();
+       ++p)
+    this->writer_done(workqueue, *p);
+}
+
+void
+Output_chunks::writer_done(Workqueue* workqueue, size_t index)
+{
+  {
+    Hold_lock hl(this->lock_);
+    gold_assert(this->pending_[index] != not_early
+		&& this->pending_[index] > 0);
+    --this->pending_[index];
+    if (this->pending_[index] > 0)
+      return;
+    ++this->early_chunk_count_;
+  }
+  if (this->is_hashing_)
+    this->queue_chunk(workqueue, index, this->is_writeback_);
+  else if (this->is_writeback_)
+    {
+      size_t offset = index * this->chunk_size_;
+      this->of_->write_back(offset, std::min(this->chunk_size_,
+					     this->filesize_ - offset));
+    }
+}
+
+void
+Output_chunks::queue_remaining_chunks(Workqueue* workqueue)
+{
+  gold_assert(this->is_hashing_);
+
+  // Every writer has finished by now, so no other thread touches
+  // PENDING_.  These chunks are not written back, since one of them
+  // holds the build ID note, which is not written yet.
+  for (size_t i = 0; i < this->chunk_count_; ++i)
+    {
+      if (this->pending_[i] == not_early)
+	this->queue_chunk(workqueue, i, false);
+      else
+	gold_assert(this->pending_[i] == 0);
+    }
+}
+
+void
+Output_chunks::queue_chunk(Workqueue* workqueue, size_t index,
+			   bool write_back)
+{
+  size_t offset = index * this->chunk_size_;
+  size_t size = std::min(this->chunk_size_, this->filesize_ - offset);
+  workqueue->queue(new Hash_task(this->of_, offset, size,
+				 this->hashes_ + index * this->hash_size(),
+				 this->is_fast_, write_back, this->blocker_));
+}
+
+unsigned char*
+Output_chunks::release_hashes(size_t* size)
+{
+  unsigned char* ret = this->hashes_;
+  *size = this->chunk_count_ * this->hash_size();
+  this->hashes_ = NULL;
+  return ret;
+}
+
 // Layout::Relaxation_debug_check methods.
 
 // Check that sections and special data are in reset states.
@@ -448,6 +754,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     added_eh_frame_data_(false),
     eh_frame_hdr_section_(NULL),
     gdb_index_data_(NULL),
+    debug_names_data_(NULL),
     build_id_note_(NULL),
     debug_abbrev_(NULL),
     debug_info_(NULL),
@@ -473,7 +780,15 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     section_segment_map_(),
     input_section_position_(),
     input_section_glob_(),
+    call_graph_edges_(),
+    hot_text_functions_(),
+    hot_text_segment_(),
+    call_graph_sections_(0),
+    call_graph_clusters_(0),
+    call_graph_text_size_(0),
     incremental_base_(NULL),
+    relink_cache_(NULL),
+    output_chunks_(NULL),
     free_list_()
 {
   // Make space for more than enough segments for a typical file.
@@ -519,7 +834,7 @@ static const char* gdb_sections[] =
 {
   "abbrev",
   "addr",         // Fission extension
-  // "aranges",   // not used by gdb as of 7.4
+  "aranges",      // used with .debug_names
   "frame",
   "gdb_scripts",
   "info",
@@ -528,6 +843,7 @@ static const char* gdb_sections[] =
   "loc",
   "macinfo",
   "macro",
+  "names",
   // "pubnames",  // not used by gdb as of 7.4
   // "pubtypes",  // not used by gdb as of 7.4
   // "gnu_pubnames",  // Fission extension
@@ -1208,6 +1524,11 @@ Layout::layout(Sized_relobj_file<size, big_endian>* object, unsigned int shndx,
 	      os->set_is_unique_segment();
 	      os->set_extra_segment_flags(it->second->flags);
 	      os->set_segment_alignment(it->second->align);
+	      if (it->second->align_contents)
+		{
+		  os->set_addralign(it->second->align);
+		  os->set_is_padded_to_alignment();
+		}
 	    }
 	}
       if (os == NULL)
@@ -1613,6 +1934,36 @@ Layout::add_to_gdb_index(bool is_type_unit,
 					 reloc_type);
 }
 
+// Merge a .debug_names section into the output name index.
+
+template<int size, bool big_endian>
+bool
+Layout::add_to_debug_names(Sized_relobj<size, big_endian>* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type)
+{
+  if (this->debug_names_data_ == NULL)
+    {
+      Output_section* os = this->choose_output_section(NULL, ".debug_names",
+						       elfcpp::SHT_PROGBITS, 0,
+						       false, ORDER_INVALID,
+						       false, false, false);
+      if (os == NULL)
+	return false;
+
+      this->debug_names_data_ = new Debug_names();
+      os->add_output_section_data(this->debug_names_data_);
+      os->set_after_input_sections();
+    }
+
+  return this->debug_names_data_->add_input_section(object, symbols,
+						    symbols_size, shndx,
+						    reloc_shndx, reloc_type);
+}
+
 // Add POSD to an output section using NAME, TYPE, and FLAGS.  Return
 // the output section.
 
@@ -2230,6 +2581,40 @@ Layout::define_section_symbols(Symbol_table* symtab)
 					true); // only_if_ref
 	}
     }
+
+  // The hot text section's name is not a C identifier, so give the
+  // program other names for its bounds.
+  if (parameters->options().hot_text_segment())
+    {
+      Output_section* os = this->find_output_section(".text.hot");
+      if (os != NULL && os->is_unique_segment())
+	{
+	  symtab->define_in_output_data("__hot_text_start",
+					NULL, // version
+					Symbol_table::PREDEFINED,
+					os,
+					0, // value
+					0, // symsize
+					elfcpp::STT_NOTYPE,
+					elfcpp::STB_GLOBAL,
+					elfcpp::STV_HIDDEN,
+					0, // nonvis
+					false, // offset_is_from_end
+					true); // only_if_ref
+	  symtab->define_in_output_data("__hot_text_end",
+					NULL, // version
+					Symbol_table::PREDEFINED,
+					os,
+					0, // value
+					0, // symsize
+					elfcpp::STT_NOTYPE,
+					elfcpp::STB_GLOBAL,
+					elfcpp::STV_HIDDEN,
+					0, // nonvis
+					true, // offset_is_from_end
+					true); // only_if_ref
+	}
+    }
 }
 
 // Define symbols for group signatures.
@@ -2660,6 +3045,355 @@ Layout::read_layout_from_file()
     }
 }
 
+// Read the call graph profile from the file specified with option
+// --call-graph-ordering-file.  Each line names a calling function, a
+// called function, and a weight, such as a count of samples of the
+// call, separated by white space.
+
+void
+Layout::read_call_graph_profile()
+{
+  const char* filename = parameters->options().call_graph_ordering_file();
+  std::ifstream in;
+  std::string line;
+
+  in.open(filename);
+  if (!in)
+    gold_fatal(_("unable to open --call-graph-ordering-file file %s: %s"),
+	       filename, strerror(errno));
+
+  this->set_section_ordering_specified();
+
+  unsigned int lineno = 0;
+  while (std::getline(in, line))
+    {
+      ++lineno;
+      // Ignore blank lines and comments, beginning with '#'.
+      size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+	continue;
+
+      std::istringstream fields(line);
+      Call_graph_edge edge;
+      std::string extra;
+      if (!(fields >> edge.caller >> edge.callee >> edge.weight)
+	  || (fields >> extra))
+	{
+	  gold_warning(_("%s:%u: expected CALLER CALLEE WEIGHT"),
+		       filename, lineno);
+	  continue;
+	}
+      this->call_graph_edges_.push_back(edge);
+    }
+}
+
+// Set *ID to the input section which defines the symbol NAME.  Return
+// false if NAME is not defined in a regular object file.
+
+static bool
+defining_section(const Symbol_table* symtab, const std::string& name,
+		 Section_id* id)
+{
+  Symbol* sym = symtab->lookup(name.c_str());
+  if (sym == NULL)
+    return false;
+  if (sym->is_forwarder())
+    sym = symtab->resolve_forwards(sym);
+  bool is_ordinary;
+  unsigned int shndx = sym->shndx(&is_ordinary);
+  if (sym->source() != Symbol::FROM_OBJECT
+      || sym->object()->is_dynamic()
+      || !is_ordinary
+      || shndx == elfcpp::SHN_UNDEF)
+    return false;
+  *id = Section_id(static_cast<Relobj*>(sym->object()), shndx);
+  return true;
+}
+
+// A section, or a cluster of sections, in the call graph ordering.
+
+struct Call_graph_cluster
+{
+  Call_graph_cluster(const Section_id& id, Output_section* os, uint64_t size)
+    : sections(1, id), output_section(os), size(size), weight(0),
+      initial_weight(0), best_pred(-1U), best_pred_weight(0)
+  { }
+
+  // Sections in the cluster, in order.  Empty once the cluster has
+  // been merged into another one.
+  std::vector<Section_id> sections;
+  // The output section holding the sections.
+  Output_section* output_section;
+  // Total size of the sections.
+  uint64_t size;
+  // Total weight of the calls into the sections.
+  uint64_t weight;
+  // Weight of the calls into the first section.
+  uint64_t initial_weight;
+  // The section which calls the first section most often, and the
+  // weight of those calls.
+  unsigned int best_pred;
+  uint64_t best_pred_weight;
+
+  double
+  density() const
+  { return static_cast<double>(this->weight) / (this->size ? this->size : 1); }
+};
+
+// Sort clusters by decreasing density.
+
+class Call_graph_density_compare
+{
+ public:
+  Call_graph_density_compare(const std::vector<Call_graph_cluster>& clusters)
+    : clusters_(clusters)
+  { }
+
+  bool
+  operator()(unsigned int c1, unsigned int c2) const
+  { return this->clusters_[c1].density() > this->clusters_[c2].density(); }
+
+ private:
+  const std::vector<Call_graph_cluster>& clusters_;
+};
+
+// Return the cluster which now holds the section of cluster C.
+
+static unsigned int
+call_graph_leader(std::vector<unsigned int>* leaders, unsigned int c)
+{
+  while ((*leaders)[c] != c)
+    {
+      (*leaders)[c] = (*leaders)[(*leaders)[c]];
+      c = (*leaders)[c];
+    }
+  return c;
+}
+
+// Order the sections named by the call graph profile.  This uses the
+// Call-Chain Clustering (C3) heuristic: starting from the densest
+// section, each section is appended to the cluster of the function
+// which calls it most often, unless that would make the cluster
+// too large or much less dense.  The clusters are then placed in order
+// of decreasing density, so that the most frequently executed code is
+// packed into as few pages as possible.
+
+void
+Layout::order_sections_by_call_graph(const Task* task,
+				     const Symbol_table* symtab)
+{
+  // Clusters larger than this are unlikely to improve locality.
+  const uint64_t max_cluster_size = 1024 * 1024;
+  // Don't merge a cluster into one whose density would drop below
+  // this fraction.
+  const double min_density_ratio = 1.0 / 8;
+
+  std::vector<Call_graph_cluster> clusters;
+  std::map<Section_id, unsigned int> cluster_map;
+
+  for (std::vector<Call_graph_edge>::const_iterator p =
+	 this->call_graph_edges_.begin();
+       p != this->call_graph_edges_.end();
+       ++p)
+    {
+      // Find the text sections defining the two functions.
+      Section_id ids[2];
+      Output_section* oses[2];
+      const std::string* names[2] = { &p->caller, &p->callee };
+      int found = 0;
+      for (; found < 2; ++found)
+	{
+	  if (!defining_section(symtab, *names[found], &ids[found]))
+	    break;
+	  oses[found] = ids[found].first->output_section(ids[found].second);
+	  if (oses[found] == NULL
+	      || (oses[found]->flags() & elfcpp::SHF_EXECINSTR) == 0)
+	    break;
+	}
+
+      // Calls within a section, or between output sections, don't
+      // affect the order.
+      if (found < 2 || ids[0] == ids[1] || oses[0] != oses[1])
+	continue;
+
+      unsigned int ends[2];
+      for (int i = 0; i < 2; ++i)
+	{
+	  std::pair<std::map<Section_id, unsigned int>::iterator, bool> ins =
+	    cluster_map.insert(std::make_pair(ids[i], clusters.size()));
+	  if (ins.second)
+	    {
+	      Relobj* relobj = ids[i].first;
+	      uint64_t size;
+	      {
+		Task_lock_obj<Object> tl(task, relobj);
+		size = relobj->section_size(ids[i].second);
+	      }
+	      clusters.push_back(Call_graph_cluster(ids[i], oses[i], size));
+	    }
+	  ends[i] = ins.first->second;
+	}
+
+      Call_graph_cluster& to(clusters[ends[1]]);
+      to.weight += p->weight;
+      to.initial_weight += p->weight;
+      if (to.best_pred == -1U || to.best_pred_weight < p->weight)
+	{
+	  to.best_pred = ends[0];
+	  to.best_pred_weight = p->weight;
+	}
+    }
+
+  if (clusters.empty())
+    return;
+
+  std::vector<unsigned int> sorted(clusters.size());
+  std::vector<unsigned int> leaders(clusters.size());
+  for (unsigned int i = 0; i < clusters.size(); ++i)
+    sorted[i] = leaders[i] = i;
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   Call_graph_density_compare(clusters));
+
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      Call_graph_cluster& c(clusters[*p]);
+      // Skip sections whose most frequent caller accounts for only a
+      // small part of their calls.
+      if (c.best_pred == -1U || c.best_pred_weight * 10 <= c.initial_weight)
+	continue;
+      unsigned int pred = call_graph_leader(&leaders, c.best_pred);
+      if (pred == *p)
+	continue;
+      Call_graph_cluster& pc(clusters[pred]);
+      if (c.size + pc.size > max_cluster_size)
+	continue;
+      double new_density = (static_cast<double>(c.weight + pc.weight)
+			    / (c.size + pc.size ? c.size + pc.size : 1));
+      if (new_density < pc.density() * min_density_ratio)
+	continue;
+
+      leaders[*p] = pred;
+      pc.sections.insert(pc.sections.end(), c.sections.begin(),
+			 c.sections.end());
+      pc.size += c.size;
+      pc.weight += c.weight;
+      c.sections.clear();
+      c.size = 0;
+      c.weight = 0;
+    }
+
+  // Drop the merged clusters, and place the rest by density.
+  std::vector<unsigned int> order;
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    if (!clusters[*p].sections.empty())
+      order.push_back(*p);
+  std::stable_sort(order.begin(), order.end(),
+		   Call_graph_density_compare(clusters));
+
+  unsigned int index = 1;
+  for (std::vector<unsigned int>::const_iterator p = order.begin();
+       p != order.end();
+       ++p)
+    {
+      const Call_graph_cluster& c(clusters[*p]);
+      for (std::vector<Section_id>::const_iterator q = c.sections.begin();
+	   q != c.sections.end();
+	   ++q)
+	this->section_order_map_[*q] = index++;
+      this->call_graph_text_size_ += c.size;
+    }
+  this->call_graph_sections_ = index - 1;
+  this->call_graph_clusters_ = order.size();
+
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    if (((*p)->flags() & elfcpp::SHF_EXECINSTR) != 0)
+      (*p)->update_section_layout(&this->section_order_map_);
+}
+
+// Read the list of hot functions from the file specified with option
+// --hot-text-file.  There is one function name per line.
+
+void
+Layout::read_hot_text_file()
+{
+  const char* filename = parameters->options().hot_text_file();
+  std::ifstream in;
+  std::string line;
+
+  in.open(filename);
+  if (!in)
+    gold_fatal(_("unable to open --hot-text-file file %s: %s"),
+	       filename, strerror(errno));
+
+  while (std::getline(in, line))
+    {
+      // Ignore blank lines and comments, beginning with '#'.
+      size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+	continue;
+      size_t end = line.find_last_not_of(" \t\r");
+      this->hot_text_functions_.push_back(line.substr(start,
+						      end + 1 - start));
+    }
+}
+
+// Map the sections defining the hot functions, which are those listed
+// with --hot-text-file and those named in the call graph profile, to
+// a unique segment.  The output section for the segment is aligned
+// to the huge page size, and its size is padded to a multiple of it,
+// so that the program can remap exactly those pages onto huge pages.
+
+void
+Layout::map_hot_text_sections(const Task* task, const Symbol_table* symtab)
+{
+  gold_assert(this->unique_segment_for_sections_specified_);
+
+  Unique_segment_info* s = &this->hot_text_segment_;
+  s->name = ".text.hot";
+  s->flags = 0;
+  s->align = parameters->options().hot_text_page_size();
+  s->align_contents = true;
+
+  std::vector<const std::string*> names;
+  for (std::vector<std::string>::const_iterator p =
+	 this->hot_text_functions_.begin();
+       p != this->hot_text_functions_.end();
+       ++p)
+    names.push_back(&*p);
+  for (std::vector<Call_graph_edge>::const_iterator p =
+	 this->call_graph_edges_.begin();
+       p != this->call_graph_edges_.end();
+       ++p)
+    {
+      names.push_back(&p->caller);
+      names.push_back(&p->callee);
+    }
+
+  for (std::vector<const std::string*>::const_iterator p = names.begin();
+       p != names.end();
+       ++p)
+    {
+      Section_id id;
+      if (!defining_section(symtab, **p, &id))
+	continue;
+      uint64_t flags;
+      {
+	Task_lock_obj<Object> tl(task, id.first);
+	flags = id.first->section_flags(id.second);
+      }
+      if ((flags & elfcpp::SHF_EXECINSTR) != 0)
+	this->insert_section_segment_map(Const_section_id(id.first,
+							  id.second),
+					  s);
+    }
+}
+
 // Finalize the layout.  When this is called, we have created all the
 // output sections and all the output segments which are based on
 // input sections.  We have several things to do, and we have to do
@@ -3085,6 +3819,8 @@ Layout::create_build_id()
     descsz = 128 / 8;
   else if ((strcmp(style, "sha1") == 0) || (strcmp(style, "tree") == 0))
     descsz = 160 / 8;
+  else if (strcmp(style, "fast") == 0)
+    descsz = 128 / 8;
   else if (strcmp(style, "uuid") == 0)
     {
 #ifndef __MINGW32__
@@ -3186,6 +3922,83 @@ Layout::create_build_id()
     }
 }
 
+// Return true if the build ID may be computed from hashes of chunks
+// of the output file.
+
+bool
+Layout::build_id_is_chunked()
+{
+  if (!parameters->options().user_set_build_id())
+    return false;
+  const char* style = parameters->options().build_id();
+  return strcmp(style, "tree") == 0 || strcmp(style, "fast") == 0;
+}
+
+// Return true if we track when chunks of the output file are
+// complete.  In that case we keep the list of input sections of each
+// output section, so that we know which objects write each chunk.
+
+bool
+Layout::tracks_output_chunks()
+{
+  return (Layout::build_id_is_chunked()
+	  || parameters->options().output_writeback());
+}
+
+// Return true if the build ID of an output file of FILESIZE bytes is
+// computed from hashes of its chunks.
+
+static bool
+build_id_uses_tree(size_t filesize)
+{
+  const General_options& options(parameters->options());
+  return (Layout::build_id_is_chunked()
+	  && options.build_id_chunk_size_for_treehash() > 0
+	  && filesize > 0
+	  && (strcmp(options.build_id(), "fast") == 0
+	      || filesize >= options.build_id_min_file_size_for_treehash()));
+}
+
+// Set up tracking of the chunks of the output file before it is
+// written, so that chunks can be hashed for the build ID or written
+// back as soon as their contents are complete.  If there are
+// sections which require postprocessing the file size may still
+// change, so we leave the hashing to Build_id_task_runner and the
+// writing to Output_file::close.
+
+void
+Layout::create_output_chunks(Output_file* of)
+{
+  if (!Layout::tracks_output_chunks()
+      || this->any_postprocessing_sections_
+      || this->output_file_size() <= 0)
+    return;
+
+  const General_options& options(parameters->options());
+  const size_t filesize = static_cast<size_t>(this->output_file_size());
+  const size_t chunk_size = options.build_id_chunk_size_for_treehash();
+  const bool is_hashing = (this->build_id_note_ != NULL
+			   && build_id_uses_tree(filesize));
+  const bool is_writeback = options.output_writeback();
+  if ((!is_hashing && !is_writeback) || chunk_size == 0)
+    return;
+
+  if (is_writeback)
+    {
+      // If the whole file is read back once it is written, the data
+      // has to stay in memory when the file is not mapped.
+      bool reads_output = ((this->build_id_note_ != NULL && !is_hashing)
+			   || (options.oformat_enum()
+			       != General_options::OBJECT_FORMAT_ELF));
+      of->start_writeback(!reads_output);
+    }
+
+  this->output_chunks_ =
+    new Output_chunks(of, filesize, chunk_size, is_hashing,
+		      strcmp(options.build_id(), "fast") == 0, is_writeback);
+  this->output_chunks_->find_early_chunks(this);
+}
+
 // If we have both .stabXX and .stabXXstr sections, then the sh_link
 // field of the former should point to the latter.  I'm not sure who
 // started this, but the GNU linker does it, and some tools depend
@@ -5491,6 +6304,17 @@ Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
 	sha1_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
       else if (strcmp(style, "md5") == 0)
 	md5_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
+      else if (strcmp(style, "fast") == 0)
+	{
+	  // Hash the file as a single chunk, so that we get the same
+	  // ID however it is divided.
+	  unsigned char hash[8];
+	  elfcpp::Swap_unaligned<64, false>::writeval(hash,
+						      xxhash64(iv,
+							       output_file_size,
+							       0));
+	  fast_build_id(hash, sizeof hash, ov);
+	}
       else
 	gold_unreachable();
 
@@ -5499,9 +6323,13 @@ Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
   else
     {
       // Non-overlapping substrings of the output file have been hashed.
-      // Compute SHA-1 hash of the hashes.
-      sha1_buffer(reinterpret_cast<const char*>(array_of_hashes),
-		  size_of_hashes, ov);
+      // Compute SHA-1 hash of the hashes, or for --build-id=fast
+      // combine them with XXH64.
+      if (strcmp(parameters->options().build_id(), "fast") == 0)
+	fast_build_id(array_of_hashes, size_of_hashes, ov);
+      else
+	sha1_buffer(reinterpret_cast<const char*>(array_of_hashes),
+		    size_of_hashes, ov);
       delete[] array_of_hashes;
     }
 
@@ -5587,6 +6415,17 @@ Layout::print_stats() const
        p != this->section_list_.end();
        ++p)
     (*p)->print_merge_stats();
+
+  if (parameters->options().call_graph_ordering_file() != NULL)
+    {
+      fprintf(stderr,
+	      _("%s: call graph ordered sections: %u in %u clusters\n"),
+	      program_name, this->call_graph_sections_,
+	      this->call_graph_clusters_);
+      fprintf(stderr, _("%s: call graph hot text size: %llu bytes\n"),
+	      program_name,
+	      static_cast<unsigned long long>(this->call_graph_text_size_));
+    }
 }
 
 // Write_sections_task methods.
@@ -5614,9 +6453,13 @@ Write_sections_task::locks(Task_locker* tl)
 // Run the task--write out the data.
 
 void
-Write_sections_task::run(Workqueue*)
+Write_sections_task::run(Workqueue* workqueue)
 {
   this->layout_->write_output_sections(this->of_);
+
+  Output_chunks* output_chunks = this->layout_->output_chunks();
+  if (output_chunks != NULL)
+    output_chunks->sections_written(workqueue);
 }
 
 // Write_data_task methods.
@@ -5704,12 +6547,15 @@ Write_after_input_sections_task::run(Workqueue*)
 // Build IDs can be computed as a "flat" sha1 or md5 of a string of bytes,
 // or as a "tree" where each chunk of the string is hashed and then those
 // hashes are put into a (much smaller) string which is hashed with sha1.
-// We compute a checksum over the entire file because that is simplest.
+// --build-id=fast is always computed as a tree, using XXH64 for both
+// steps.  We compute a checksum over the entire file because that is
+// simplest.  Chunks which were completely written before the rest of
+// the file have already been hashed; see Output_chunks.
 
 void
 Build_id_task_runner::run(Workqueue* workqueue, const Task*)
 {
-  Task_token* post_hash_tasks_blocker = new Task_token(true);
+  Task_token* post_hash_tasks_blocker = NULL;
   const Layout* layout = this->layout_;
   Output_file* of = this->of_;
   const size_t filesize = (layout->output_file_size() <= 0 ? 0
@@ -5717,29 +6563,35 @@ Build_id_task_runner::run(Workqueue* workqueue, const Task*)
   unsigned char* array_of_hashes = NULL;
   size_t size_of_hashes = 0;
 
-  if (strcmp(this->options_->build_id(), "tree") == 0
-      && this->options_->build_id_chunk_size_for_treehash() > 0
-      && filesize > 0
-      && (filesize >= this->options_->build_id_min_file_size_for_treehash()))
-    {
-      static const size_t MD5_OUTPUT_SIZE_IN_BYTES = 16;
-      const size_t chunk_size =
-	  this->options_->build_id_chunk_size_for_treehash();
-      const size_t num_hashes = ((filesize - 1) / chunk_size) + 1;
-      post_hash_tasks_blocker->add_blockers(num_hashes);
-      size_of_hashes = num_hashes * MD5_OUTPUT_SIZE_IN_BYTES;
-      array_of_hashes = new unsigned char[size_of_hashes];
-      unsigned char *dst = array_of_hashes;
-      for (size_t i = 0, src_offset = 0; i < num_hashes;
-	   i++, dst += MD5_OUTPUT_SIZE_IN_BYTES, src_offset += chunk_size)
-	{
-	  size_t size = std::min(chunk_size, filesize - src_offset);
-	  workqueue->queue(new Hash_task(of,
-					 src_offset,
-					 size,
-					 dst,
-					 post_hash_tasks_blocker));
-	}
+  Output_chunks* tree = layout->output_chunks();
+  if (tree != NULL && !tree->is_hashing())
+    tree = NULL;
+  if (tree == NULL && build_id_uses_tree(filesize))
+    tree = new Output_chunks(of, filesize,
+			     this->options_->build_id_chunk_size_for_treehash(),
+			     true,
+			     strcmp(this->options_->build_id(), "fast") == 0,
+			     false);
+
+  if (tree == NULL)
+    post_hash_tasks_blocker = new Task_token(true);
+  else
+    {
+      tree->queue_remaining_chunks(workqueue);
+      post_hash_tasks_blocker = tree->blocker();
+      array_of_hashes = tree->release_hashes(&size_of_hashes);
+
+      if (this->options_->stats())
+	fprintf(stderr, _("%s: build ID chunks hashed while writing: "
+			  "%lu of %lu\n"),
+		program_name,
+		static_cast<unsigned long>(tree->early_chunk_count()),
+		static_cast<unsigned long>(tree->chunk_count()));
+
+      // The hash tasks write directly into ARRAY_OF_HASHES, so we are
+      // done with the tree.
+      if (tree != layout->output_chunks())
+	delete tree;
     }
 
   // Queue the final task to write the build id and close the output file.
@@ -6047,4 +6899,48 @@ Layout::add_to_gdb_index(bool is_type_unit,
 			 unsigned int reloc_type);
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+bool
+Layout::add_to_debug_names(Sized_relobj<32, false>* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type);
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+bool
+Layout::add_to_debug_names(Sized_relobj<32, true>* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type);
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+bool
+Layout::add_to_debug_names(Sized_relobj<64, false>* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type);
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+bool
+Layout::add_to_debug_names(Sized_relobj<64, true>* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type);
+#endif
+
 } // End namespace gold.
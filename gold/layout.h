@@ -42,6 +42,8 @@ namespace gold
 class General_options;
 class Incremental_inputs;
 class Incremental_binary;
+class Relink_cache;
+class Output_chunks;
 class Input_objects;
 class Mapfile;
 class Symbol_table;
@@ -59,6 +61,7 @@ class Output_reduced_debug_abbrev_section;
 class Output_reduced_debug_info_section;
 class Eh_frame;
 class Gdb_index;
+class Debug_names;
 class Target;
 struct Timespec;
 
@@ -508,6 +511,38 @@ class Layout
   incremental_base()
   { return this->incremental_base_; }
 
+  // For --relink-cache, record the cache of link outputs.
+  void
+  set_relink_cache(Relink_cache* relink_cache)
+  { this->relink_cache_ = relink_cache; }
+
+  Relink_cache*
+  relink_cache() const
+  { return this->relink_cache_; }
+
+  // Return true if the build ID may be computed by hashing chunks of
+  // the output file separately, as for --build-id=tree and
+  // --build-id=fast.
+  static bool
+  build_id_is_chunked();
+
+  // Return true if we track when chunks of the output file are
+  // complete, for a chunked build ID or for --output-writeback.
+  static bool
+  tracks_output_chunks();
+
+  // Set up tracking of the chunks of the output file OF, so that
+  // chunks may be hashed for the build ID or written back to disk
+  // while the file is being written.  This is called before any
+  // output is written.
+  void
+  create_output_chunks(Output_file* of);
+
+  // The chunks of the output file, or NULL.
+  Output_chunks*
+  output_chunks() const
+  { return this->output_chunks_; }
+
   // For incremental links, record the initial fixed layout of a section
   // from the base file, and return a pointer to the Output_section.
   template<int size, bool big_endian>
@@ -546,6 +581,10 @@ class Layout
     uint64_t flags;
     // Segment alignment.
     uint64_t align;
+    // Whether to align the output section itself to ALIGN, and pad
+    // its size to a multiple of ALIGN, rather than only setting the
+    // alignment of the segment.
+    bool align_contents;
   };
 
   // Mapping from input section to segment.
@@ -594,6 +633,29 @@ class Layout
   void
   read_layout_from_file();
 
+  // Read the call graph profile from the file specified with linker
+  // option --call-graph-ordering-file.
+  void
+  read_call_graph_profile();
+
+  // Order the input sections named by the call graph profile so that
+  // functions which call each other often are close together.  This
+  // must be called after all input sections have been laid out.
+  void
+  order_sections_by_call_graph(const Task*, const Symbol_table*);
+
+  // Read the list of hot functions from the file specified with
+  // linker option --hot-text-file.
+  void
+  read_hot_text_file();
+
+  // For --hot-text-segment, map the sections of the hot functions to
+  // a unique segment aligned for huge pages.  This must be called
+  // after all symbols have been read, and before the second layout
+  // pass.
+  void
+  map_hot_text_sections(const Task*, const Symbol_table*);
+
   // Layout an input reloc section when doing a relocatable link.  The
   // section is RELOC_SHNDX in OBJECT, with data in SHDR.
   // DATA_SECTION is the reloc section to which it refers.  RR is the
@@ -665,6 +727,18 @@ class Layout
 		   unsigned int reloc_shndx,
 		   unsigned int reloc_type);
 
+  // Merge a .debug_names section into the output name index.  Return
+  // false if it can not be merged, in which case it should be laid
+  // out as usual.
+  template<int size, bool big_endian>
+  bool
+  add_to_debug_names(Sized_relobj<size, big_endian>* object,
+		     const unsigned char* symbols,
+		     off_t symbols_size,
+		     unsigned int shndx,
+		     unsigned int reloc_shndx,
+		     unsigned int reloc_type);
+
   // Handle a GNU stack note.  This is called once per input object
   // file.  SEEN_GNU_STACK is true if the object file has a
   // .note.GNU-stack section.  GNU_STACK_FLAGS is the section flags
@@ -1381,6 +1455,8 @@ class Layout
   Output_section* eh_frame_hdr_section_;
   // The data for the .gdb_index section.
   Gdb_index* gdb_index_data_;
+  // The data for the merged .debug_names section.
+  Debug_names* debug_names_data_;
   // The space for the build ID checksum if there is one.
   Output_section_data* build_id_note_;
   // The output section containing dwarf abbreviations
@@ -1441,8 +1517,30 @@ class Layout
   Unordered_map<std::string, unsigned int> input_section_position_;
   // Vector of glob only patterns in the section_ordering file.
   std::vector<std::string> input_section_glob_;
+  // An edge in the --call-graph-ordering-file profile.
+  struct Call_graph_edge
+  {
+    std::string caller;
+    std::string callee;
+    uint64_t weight;
+  };
+  // The edges read from the --call-graph-ordering-file profile.
+  std::vector<Call_graph_edge> call_graph_edges_;
+  // The functions read from the --hot-text-file list.
+  std::vector<std::string> hot_text_functions_;
+  // For --hot-text-segment, the segment for the hot text.
+  Unique_segment_info hot_text_segment_;
+  // The number of input sections and clusters ordered by the call
+  // graph profile, and the total size of those sections, for --stats.
+  unsigned int call_graph_sections_;
+  unsigned int call_graph_clusters_;
+  uint64_t call_graph_text_size_;
   // For incremental links, the base file to be modified.
   Incremental_binary* incremental_base_;
+  // For --relink-cache, the cache of link outputs.
+  Relink_cache* relink_cache_;
+  // The chunks of the output file, tracked as they are written.
+  Output_chunks* output_chunks_;
   // For incremental links, a list of free space within the file.
   Free_list free_list_;
 };
@@ -1599,11 +1697,124 @@ class Write_after_input_sections_task : public Task
   Task_token* final_blocker_;
 };
 
+// The chunks of the output file, tracked as they are written.  A
+// chunk which holds only the contents of ordinary input sections is
+// complete as soon as the objects which own those sections have been
+// relocated and the output sections have been written.  For
+// --build-id=tree and --build-id=fast such a chunk is hashed right
+// away, and the remaining chunks are hashed by Build_id_task_runner
+// once the whole file has been written, so usually only a few chunks
+// and the final hash of hashes are left after the output file is
+// complete.  For --output-writeback a complete chunk is handed to
+// Output_file::write_back.
+
+class Output_chunks
+{
+ public:
+  // If IS_HASHING is true, compute the hashes of the chunks for the
+  // build ID, using XXH64 if IS_FAST is true.  If IS_WRITEBACK is
+  // true, write back chunks which are complete early.
+  Output_chunks(Output_file* of, size_t filesize, size_t chunk_size,
+		bool is_hashing, bool is_fast, bool is_writeback);
+
+  ~Output_chunks()
+  { delete[] this->hashes_; }
+
+  // Whether we are computing the chunk hashes.
+  bool
+  is_hashing() const
+  { return this->is_hashing_; }
+
+  // The size of the hash of a single chunk.
+  size_t
+  hash_size() const
+  { return this->is_fast_ ? 8 : 16; }
+
+  // Find the chunks which may be hashed before the whole output file
+  // has been written, and the tasks which must finish first.
+  void
+  find_early_chunks(const Layout*);
+
+  // Note that OBJECT has been relocated, so its input sections have
+  // been written.
+  void
+  object_written(Workqueue*, const Relobj* object);
+
+  // Note that the output sections have been written.
+  void
+  sections_written(Workqueue*);
+
+  // Queue tasks to hash the chunks which were not hashed early.
+  void
+  queue_remaining_chunks(Workqueue*);
+
+  // A blocker which is unblocked when all the chunks have been hashed.
+  Task_token*
+  blocker() const
+  { return this->blocker_; }
+
+  // The number of chunks, and the number complete early.
+  size_t
+  chunk_count() const
+  { return this->chunk_count_; }
+
+  size_t
+  early_chunk_count() const
+  { return this->early_chunk_count_; }
+
+  // Hand over the array of chunk hashes, which the caller must
+  // delete, and set *SIZE to its size.
+  unsigned char*
+  release_hashes(size_t* size);
+
+ private:
+  Output_chunks(const Output_chunks&);
+  Output_chunks& operator=(const Output_chunks&);
+
+  // A value in PENDING_ for a chunk which is not hashed early.
+  static const unsigned int not_early = -1U;
+
+  // Note that one of the writers of chunk INDEX has finished, and
+  // queue a task to hash it if it was the last one.
+  void
+  writer_done(Workqueue*, size_t index);
+
+  // Queue a task to hash chunk INDEX, and write it back if
+  // WRITE_BACK.
+  void
+  queue_chunk(Workqueue*, size_t index, bool write_back);
+
+  typedef Unordered_map<const Relobj*, std::vector<size_t> > Object_chunks;
+
+  Output_file* of_;
+  size_t filesize_;
+  size_t chunk_size_;
+  size_t chunk_count_;
+  bool is_hashing_;
+  bool is_fast_;
+  bool is_writeback_;
+  // The chunk hashes, if IS_HASHING_.
+  unsigned char* hashes_;
+  // For each chunk, the number of writers which have not finished, or
+  // NOT_EARLY.
+  std::vector<unsigned int> pending_;
+  // The early chunks which each object writes to.
+  Object_chunks object_chunks_;
+  // The early chunks, which all wait for the output sections.
+  std::vector<size_t> early_chunks_;
+  size_t early_chunk_count_;
+  // Controls access to PENDING_.
+  Lock lock_;
+  // Unblocked as each chunk is hashed.
+  Task_token* blocker_;
+};
+
 // This task function handles computation of the build id.
-// When using --build-id=tree, it schedules the tasks that
-// compute the hashes for each chunk of the file. This task
-// cannot run until we have finalized the size of the output
-// file, after the completion of Write_after_input_sections_task.
+// When using a chunked build ID, it schedules the tasks that
+// compute the hashes for the chunks of the file which were not hashed
+// while it was being written. This task cannot run until we have
+// finalized the size of the output file, after the completion of
+// Write_after_input_sections_task.
 
 class Build_id_task_runner : public Task_function_runner
 {
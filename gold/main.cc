@@ -22,8 +22,12 @@
 
 #include "gold.h"
 
+#include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <algorithm>
+#include <map>
+#include <vector>
 
 #ifdef HAVE_MALLINFO
 #include <malloc.h>
@@ -133,6 +137,191 @@ write_debug_script(std::string, const char*, const char*)
 
 #endif // !defined(DEBUG)
 
+// An input file listed by --stats-file.
+
+struct Stats_file_entry
+{
+  Stats_file_entry()
+    : tasks(), object(NULL), relobj(NULL)
+  { }
+
+  // The Tasks run for the file.
+  Task_stats tasks;
+  // The object, if the file was included in the link as an object.
+  const Object* object;
+  // The same object, if it is a regular object.
+  const Relobj* relobj;
+};
+
+typedef std::pair<std::string, const Stats_file_entry*> Stats_file_pair;
+
+// Sort the input files for --stats-file, with the ones that used the
+// most CPU time first.
+
+struct Stats_file_compare
+{
+  bool
+  operator()(const Stats_file_pair& a, const Stats_file_pair& b) const
+  {
+    const Task_stats& ta(a.second->tasks);
+    const Task_stats& tb(b.second->tasks);
+    if (ta.cpu_us != tb.cpu_us)
+      return ta.cpu_us > tb.cpu_us;
+    if (ta.wall_us != tb.wall_us)
+      return ta.wall_us > tb.wall_us;
+    return a.first < b.first;
+  }
+};
+
+typedef std::pair<std::string, const Task_stats*> Stats_class_pair;
+
+// Sort the Task classes for --stats-file, with the ones that used the
+// most CPU time first.
+
+struct Stats_class_compare
+{
+  bool
+  operator()(const Stats_class_pair& a, const Stats_class_pair& b) const
+  {
+    if (a.second->cpu_us != b.second->cpu_us)
+      return a.second->cpu_us > b.second->cpu_us;
+    return a.first < b.first;
+  }
+};
+
+// Write the fields of TS as JSON object members.
+
+static void
+write_task_stats(FILE* f, const Task_stats& ts)
+{
+  fprintf(f, "\"tasks\":%llu,\"wall_us\":%llu,\"cpu_us\":%llu,"
+	  "\"heap_growth\":%llu,\"max_heap_growth\":%llu",
+	  ts.count, ts.wall_us, ts.cpu_us, ts.heap_growth,
+	  ts.max_heap_growth);
+}
+
+// Write the statistics requested by --stats-file: the totals for the
+// link, the resources used by each Task class, and the input files
+// which used the most CPU time along with the work done for each.
+
+static void
+write_stats_file(const char* filename, const Workqueue& workqueue,
+		 const Input_objects& input_objects,
+		 const Symbol_table* symtab, Timer* timer)
+{
+  FILE* f = fopen(filename, "w");
+  if (f == NULL)
+    {
+      gold_error(_("cannot open statistics file %s: %s"), filename,
+		 strerror(errno));
+      return;
+    }
+
+  Timer::TimeStats elapsed = timer->get_elapsed_time();
+  fprintf(f, "{\"total\":{\"wall_us\":%llu,\"user_us\":%llu,"
+	  "\"sys_us\":%llu",
+	  static_cast<unsigned long long>(elapsed.wall) * 1000,
+	  static_cast<unsigned long long>(elapsed.user) * 1000,
+	  static_cast<unsigned long long>(elapsed.sys) * 1000);
+#ifdef HAVE_MALLINFO
+  struct mallinfo m = mallinfo();
+  fprintf(f, ",\"malloc_arena\":%u,\"malloc_mmap\":%u",
+	  static_cast<unsigned int>(m.arena),
+	  static_cast<unsigned int>(m.hblkhd));
+#endif
+  fprintf(f, ",\"input_objects\":%u}",
+	  input_objects.number_of_input_objects());
+
+  const Task_stats_map* by_class = workqueue.task_stats_by_class();
+  std::vector<Stats_class_pair> classes;
+  for (Task_stats_map::const_iterator p = by_class->begin();
+       p != by_class->end();
+       ++p)
+    classes.push_back(std::make_pair(p->first, &p->second));
+  std::sort(classes.begin(), classes.end(), Stats_class_compare());
+
+  fprintf(f, ",\n\"task_classes\":[");
+  for (size_t i = 0; i < classes.size(); ++i)
+    {
+      fprintf(f, "%s\n{\"name\":", i == 0 ? "" : ",");
+      write_json_string(f, classes[i].first);
+      putc(',', f);
+      write_task_stats(f, *classes[i].second);
+      putc('}', f);
+    }
+
+  // Combine the Task statistics for each file with the objects.
+  // Tasks run for other things, such as archives and search
+  // directories, are only counted by class.
+  std::map<std::string, Stats_file_entry> files;
+  for (Input_objects::Relobj_iterator p = input_objects.relobj_begin();
+       p != input_objects.relobj_end();
+       ++p)
+    {
+      // Objects claimed by a plugin are also on this list, but are
+      // not Relobjs.
+      Stats_file_entry* e = &files[(*p)->name()];
+      e->object = *p;
+      if ((*p)->pluginobj() == NULL)
+	e->relobj = *p;
+    }
+  for (Input_objects::Dynobj_iterator p = input_objects.dynobj_begin();
+       p != input_objects.dynobj_end();
+       ++p)
+    files[(*p)->name()].object = *p;
+  const Task_stats_map* by_file = workqueue.task_stats_by_file();
+  for (std::map<std::string, Stats_file_entry>::iterator p = files.begin();
+       p != files.end();
+       ++p)
+    {
+      Task_stats_map::const_iterator q = by_file->find(p->first);
+      if (q != by_file->end())
+	p->second.tasks = q->second;
+    }
+
+  std::vector<Stats_file_pair> sorted;
+  for (std::map<std::string, Stats_file_entry>::const_iterator p =
+	 files.begin();
+       p != files.end();
+       ++p)
+    sorted.push_back(std::make_pair(p->first, &p->second));
+  std::sort(sorted.begin(), sorted.end(), Stats_file_compare());
+
+  size_t count = sorted.size();
+  unsigned int top = parameters->options().stats_top_files();
+  if (top != 0 && top < count)
+    count = top;
+
+  fprintf(f, "\n],\n\"input_files\":[");
+  for (size_t i = 0; i < count; ++i)
+    {
+      const Stats_file_entry* e = sorted[i].second;
+      fprintf(f, "%s\n{\"name\":", i == 0 ? "" : ",");
+      write_json_string(f, sorted[i].first);
+      putc(',', f);
+      write_task_stats(f, e->tasks);
+      if (e->object != NULL)
+	{
+	  size_t defined;
+	  size_t used;
+	  e->object->get_global_symbol_counts(symtab, &defined, &used);
+	  fprintf(f, ",\"symbols_defined\":%llu,\"symbols_used\":%llu",
+		  static_cast<unsigned long long>(defined),
+		  static_cast<unsigned long long>(used));
+	}
+      if (e->relobj != NULL)
+	fprintf(f, ",\"relocs_scanned\":%llu,\"bytes_written\":%llu",
+		static_cast<unsigned long long>(e->relobj->relocs_scanned()),
+		static_cast<unsigned long long>(e->relobj->bytes_written()));
+      putc('}', f);
+    }
+  fprintf(f, "\n]}\n");
+
+  if (fclose(f) != 0)
+    gold_error(_("error writing statistics file %s: %s"), filename,
+	       strerror(errno));
+}
+
 
 int
 main(int argc, char** argv)
@@ -165,7 +354,8 @@ main(int argc, char** argv)
   command_line.process(argc - 1, const_cast<const char**>(argv + 1));
 
   Timer timer;
-  if (command_line.options().stats())
+  if (command_line.options().stats()
+      || command_line.options().stats_file() != NULL)
     {
       timer.start();
       set_parameters_timer(&timer);
@@ -232,9 +422,30 @@ main(int argc, char** argv)
   if (layout.incremental_inputs() != NULL)
     layout.incremental_inputs()->report_command_line(argc, argv);
 
+  // Set up the cache of link outputs.
+  Relink_cache* relink_cache = NULL;
+  if (parameters->options().relink_cache() != NULL)
+    {
+      relink_cache = new Relink_cache(parameters->options().relink_cache(),
+				      argc, argv);
+      layout.set_relink_cache(relink_cache);
+    }
+
   if (parameters->options().section_ordering_file())
     layout.read_layout_from_file();
 
+  if (parameters->options().call_graph_ordering_file())
+    layout.read_call_graph_profile();
+
+  // The hot functions are only known once the symbols have been read,
+  // so lay out the input sections in two passes.
+  if (parameters->options().hot_text_segment())
+    {
+      if (parameters->options().hot_text_file())
+	layout.read_hot_text_file();
+      layout.set_unique_segment_for_sections_specified();
+    }
+
   // Load plugin libraries.
   if (command_line.options().has_plugins())
     command_line.options().plugins()->load_plugins(&layout);
@@ -251,6 +462,13 @@ main(int argc, char** argv)
   // Run the main task processing loop.
   workqueue.process(0);
 
+  if (command_line.options().task_trace() != NULL)
+    workqueue.write_trace();
+
+  if (command_line.options().stats_file() != NULL)
+    write_stats_file(command_line.options().stats_file(), workqueue,
+		     input_objects, &symtab, &timer);
+
   if (command_line.options().print_output_format())
     print_output_format();
 
@@ -298,8 +516,13 @@ main(int argc, char** argv)
       File_read::print_stats();
       Archive::print_stats();
       Lib_group::print_stats();
-      fprintf(stderr, _("%s: output file size: %lld bytes\n"),
-	      program_name, static_cast<long long>(layout.output_file_size()));
+      if (relink_cache != NULL && relink_cache->output_fetched())
+	fprintf(stderr, _("%s: output file copied from relink cache\n"),
+		program_name);
+      else
+	fprintf(stderr, _("%s: output file size: %lld bytes\n"),
+		program_name,
+		static_cast<long long>(layout.output_file_size()));
       symtab.print_stats();
       layout.print_stats();
       Gdb_index::print_stats();
@@ -323,6 +546,15 @@ main(int argc, char** argv)
       && errors.error_count() == 0)
     gold_error("treating warnings as errors");
 
+  // Save the output in the relink cache.  Don't save a link which
+  // issued warnings, since a later copy from the cache would not
+  // repeat them.
+  if (relink_cache != NULL
+      && !relink_cache->output_fetched()
+      && errors.error_count() == 0
+      && errors.warning_count() == 0)
+    relink_cache->store_output();
+
   // If the user used --noinhibit-exec, we force the exit status to be
   // successful.  This is compatible with GNU ld.
   gold_exit((errors.error_count() == 0
@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <algorithm>
 
+#include "gold-threads.h"
 #include "merge.h"
 #include "compressed_output.h"
 
@@ -431,6 +432,51 @@ Output_merge_data::do_print_merge_stats(const char* section_name)
 
 // Class Output_merge_string.
 
+// Merged string sections, notably .debug_str, can be very large.  We
+// find the strings in a large input section, and compute their hash
+// codes, on several threads, in pieces of at least this many bytes.
+// Adding the strings to the Stringpool is still done in order, so the
+// Stringpool keys, and thus the output, do not depend on the number
+// of threads.
+
+static const section_size_type merge_string_piece_size = 1024 * 1024;
+
+template<typename Char_type>
+class Output_merge_string<Char_type>::Scan_strings_job : public Parallel_job
+{
+ public:
+  // BOUNDS holds the index, in characters, of the start of each piece,
+  // followed by the end of the last piece.  Each piece starts at the
+  // start of a string and ends just after a null character.
+  Scan_strings_job(const Char_type* p, const std::vector<size_t>* bounds,
+		   std::vector<std::vector<Input_string> >* strings)
+    : p_(p), bounds_(bounds), strings_(strings)
+  { }
+
+  void
+  run_piece(int index, int)
+  {
+    const Char_type* pt = this->p_ + (*this->bounds_)[index];
+    const Char_type* pend = this->p_ + (*this->bounds_)[index + 1];
+    std::vector<Input_string>* v = &(*this->strings_)[index];
+    while (pt < pend)
+      {
+	Input_string is;
+	is.start = pt - this->p_;
+	is.length = string_length(pt);
+	is.hash_code = Stringpool_template<Char_type>::hash_string(pt,
+								  is.length);
+	v->push_back(is);
+	pt += is.length + 1;
+      }
+  }
+
+ private:
+  const Char_type* p_;
+  const std::vector<size_t>* bounds_;
+  std::vector<std::vector<Input_string> >* strings_;
+};
+
 // Add an input section to a merged string section.
 
 template<typename Char_type>
@@ -473,22 +519,48 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   this->merged_strings_lists_.push_back(merged_strings_list);
   Merged_strings& merged_strings = merged_strings_list->merged_strings;
 
+  // Find the null terminated strings, splitting a large section into
+  // pieces which start at string boundaries.
+  const size_t nchars = pend0 - p;
+  int pieces = 1;
+  if (sec_len >= 2 * merge_string_piece_size)
+    pieces = std::min(parallel_job_threads(),
+		      static_cast<int>(sec_len / merge_string_piece_size));
+  std::vector<size_t> bounds(pieces + 1);
+  bounds[0] = 0;
+  for (int k = 1; k < pieces; ++k)
+    {
+      size_t b = std::max((static_cast<uint64_t>(nchars) * k) / pieces,
+			  static_cast<uint64_t>(bounds[k - 1]));
+      while (b > 0 && b < nchars && p[b - 1] != 0)
+	++b;
+      bounds[k] = b;
+    }
+  bounds[pieces] = nchars;
+
+  std::vector<std::vector<Input_string> > strings(pieces);
+  Scan_strings_job scan_job(p, &bounds, &strings);
+  run_parallel_job(&scan_job, pieces);
+
   // Count the number of non-null strings in the section and size the list.
   size_t count = 0;
-  const Char_type* pt = p;
-  while (pt < pend0)
+  size_t total = 0;
+  for (int k = 0; k < pieces; ++k)
     {
-      size_t len = string_length(pt);
-      if (len != 0)
-	++count;
-      pt += len + 1;
+      total += strings[k].size();
+      for (typename std::vector<Input_string>::const_iterator q =
+	     strings[k].begin();
+	   q != strings[k].end();
+	   ++q)
+	if (q->length != 0)
+	  ++count;
     }
   if (pend0 < pend)
-    ++count;
-  merged_strings.reserve(count + 1);
-
-  // The index I is in bytes, not characters.
-  section_size_type i = 0;
+    {
+      ++count;
+      ++total;
+    }
+  merged_strings.reserve(total + 1);
 
   // We assume here that the beginning of the section is correctly
   // aligned, so each string within the section must retain the same
@@ -497,21 +569,46 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 				 & (this->addralign() - 1));
   bool has_misaligned_strings = false;
 
-  while (p < pend)
+  for (int k = 0; k < pieces; ++k)
     {
-      size_t len = p < pend0 ? string_length(p) : pend - p;
+      for (typename std::vector<Input_string>::const_iterator q =
+	     strings[k].begin();
+	   q != strings[k].end();
+	   ++q)
+	{
+	  const Char_type* ps = p + q->start;
+
+	  // Within merge input section each string must be aligned.
+	  if (q->length != 0
+	      && ((reinterpret_cast<uintptr_t>(ps) & (this->addralign() - 1))
+		  != init_align_modulo))
+	    has_misaligned_strings = true;
 
-      // Within merge input section each string must be aligned.
-      if (len != 0
-	  && ((reinterpret_cast<uintptr_t>(p) & (this->addralign() - 1))
-	      != init_align_modulo))
-	  has_misaligned_strings = true;
+	  Stringpool::Key key;
+	  this->stringpool_.add_with_hash(ps, q->length, q->hash_code, true,
+					  &key);
+
+	  // The offset is in bytes, not characters.
+	  merged_strings.push_back(Merged_string(q->start * sizeof(Char_type),
+						 key));
+	}
+    }
+
+  // The index I is in bytes, not characters.
+  section_size_type i = nchars * sizeof(Char_type);
+
+  // Add any trailing string which is not null terminated.
+  if (pend0 < pend)
+    {
+      size_t len = pend - pend0;
+      if ((reinterpret_cast<uintptr_t>(pend0) & (this->addralign() - 1))
+	  != init_align_modulo)
+	has_misaligned_strings = true;
 
       Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+      this->stringpool_.add_with_length(pend0, len, true, &key);
 
       merged_strings.push_back(Merged_string(i, key));
-      p += len + 1;
       i += (len + 1) * sizeof(Char_type);
     }
 
@@ -538,6 +635,60 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   return true;
 }
 
+// Once the string offsets are known, this job adds the mappings for
+// the input sections in MERGED_STRINGS_LISTS to their merge maps,
+// which are in INPUT_MERGE_MAPS.  Each input section has its own
+// merge map, so the pieces are independent.
+
+template<typename Char_type>
+class Output_merge_string<Char_type>::Add_mappings_job : public Parallel_job
+{
+ public:
+  Add_mappings_job(
+      const Merged_strings_lists* merged_strings_lists,
+      const std::vector<Object_merge_map::Input_merge_map*>* input_merge_maps,
+      const Stringpool_template<Char_type>* stringpool)
+    : merged_strings_lists_(merged_strings_lists),
+      input_merge_maps_(input_merge_maps), stringpool_(stringpool)
+  { }
+
+  void
+  run_piece(int index, int count)
+  {
+    size_t n = this->merged_strings_lists_->size();
+    size_t start = (static_cast<uint64_t>(n) * index) / count;
+    size_t end = (static_cast<uint64_t>(n) * (index + 1)) / count;
+    for (size_t j = start; j < end; ++j)
+      {
+	const Merged_strings_list* l = (*this->merged_strings_lists_)[j];
+	Object_merge_map::Input_merge_map* input_merge_map =
+	  (*this->input_merge_maps_)[j];
+	section_offset_type last_input_offset = 0;
+	section_offset_type last_output_offset = 0;
+	for (typename Merged_strings::const_iterator p =
+	       l->merged_strings.begin();
+	     p != l->merged_strings.end();
+	     ++p)
+	  {
+	    section_size_type length = p->offset - last_input_offset;
+	    if (length > 0)
+	      input_merge_map->add_mapping(last_input_offset, length,
+					   last_output_offset);
+	    last_input_offset = p->offset;
+	    if (p->stringpool_key != 0)
+	      last_output_offset =
+		this->stringpool_->get_offset_from_key(p->stringpool_key);
+	  }
+	delete l;
+      }
+  }
+
+ private:
+  const Merged_strings_lists* merged_strings_lists_;
+  const std::vector<Object_merge_map::Input_merge_map*>* input_merge_maps_;
+  const Stringpool_template<Char_type>* stringpool_;
+};
+
 // Finalize the mappings from the input sections to the output
 // section, and return the final data size.
 
@@ -547,35 +698,32 @@ Output_merge_string<Char_type>::finalize_merged_data()
 {
   this->stringpool_.set_string_offsets();
 
-  for (typename Merged_strings_lists::const_iterator l =
-	 this->merged_strings_lists_.begin();
-       l != this->merged_strings_lists_.end();
-       ++l)
+  // Finding the merge maps may modify the objects, so do that first,
+  // on this thread.
+  const size_t n = this->merged_strings_lists_.size();
+  std::vector<Object_merge_map::Input_merge_map*> input_merge_maps(n);
+  size_t total = 0;
+  for (size_t j = 0; j < n; ++j)
     {
-      section_offset_type last_input_offset = 0;
-      section_offset_type last_output_offset = 0;
-      Relobj *object = (*l)->object;
-      Object_merge_map* merge_map = object->get_or_create_merge_map();
-      Object_merge_map::Input_merge_map* input_merge_map =
-        merge_map->get_or_make_input_merge_map(this, (*l)->shndx);
-
-      for (typename Merged_strings::const_iterator p =
-	     (*l)->merged_strings.begin();
-	   p != (*l)->merged_strings.end();
-	   ++p)
-	{
-	  section_size_type length = p->offset - last_input_offset;
-	  if (length > 0)
-	    input_merge_map->add_mapping(last_input_offset, length,
-                                         last_output_offset);
-	  last_input_offset = p->offset;
-	  if (p->stringpool_key != 0)
-	    last_output_offset =
-	        this->stringpool_.get_offset_from_key(p->stringpool_key);
-	}
-      delete *l;
+      const Merged_strings_list* l = this->merged_strings_lists_[j];
+      Object_merge_map* merge_map = l->object->get_or_create_merge_map();
+      input_merge_maps[j] =
+	merge_map->get_or_make_input_merge_map(this, l->shndx);
+      total += l->merged_strings.size();
     }
 
+  // Only use threads if there are enough strings to make it
+  // worthwhile.
+  int pieces = 1;
+  const size_t strings_per_piece = 100000;
+  if (n > 1 && total >= 2 * strings_per_piece)
+    pieces = std::min(static_cast<size_t>(parallel_job_threads()),
+		      std::min(n, total / strings_per_piece));
+
+  Add_mappings_job mappings_job(&this->merged_strings_lists_,
+				&input_merge_maps, &this->stringpool_);
+  run_parallel_job(&mappings_job, pieces);
+
   // Save some memory.  This also ensures that this function will work
   // if called twice, as may happen if Layout::set_segment_offsets
   // finds a better alignment.
@@ -498,6 +498,25 @@ class Output_merge_string : public Output_merge_base
 
   typedef std::vector<Merged_strings_list*> Merged_strings_lists;
 
+  // A string found while scanning an input section, with the hash
+  // code the Stringpool will use for it.
+  struct Input_string
+  {
+    // The index of the start of the string, in characters.
+    size_t start;
+    // The length of the string, in characters.
+    size_t length;
+    // The Stringpool hash code.
+    size_t hash_code;
+  };
+
+  // A job to find the strings in pieces of a large input section.
+  class Scan_strings_job;
+
+  // A job to add the mappings for the input sections to their merge
+  // maps.
+  class Add_mappings_job;
+
   // As we see the strings, we add them to a Stringpool.
   Stringpool_template<Char_type> stringpool_;
   // Map from a location in an input object to an entry in the
@@ -818,7 +818,11 @@ Sized_relobj_file<size, big_endian>::do_find_special_sections(
 	      && parameters->options().gdb_index()
 	      && (memmem(names, sd->section_names_size, "debug_info", 11) == 0
 		  || memmem(names, sd->section_names_size,
-			    "debug_types", 12) == 0)));
+			    "debug_types", 12) == 0))
+	  || (!parameters->options().relocatable()
+	      && parameters->options().merge_debug_names()
+	      && memmem(names, sd->section_names_size,
+			"debug_names", 12) != NULL));
 }
 
 // Read the sections and symbols from an object file.
@@ -863,7 +867,8 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
   gold_assert(symtabshdr.get_sh_type() == elfcpp::SHT_SYMTAB);
 
   // If this object has a .eh_frame section, or if building a .gdb_index
-  // section and there is debug info, we need all the symbols.
+  // section and there is debug info, or if merging .debug_names
+  // sections, we need all the symbols.
   // Otherwise we only need the external symbols.  While it would be
   // simpler to just always read all the symbols, I've seen object
   // files with well over 2000 local symbols, which for a 64-bit
@@ -918,6 +923,10 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+  // Hash the global symbol names now, while we are running in
+  // parallel with other objects.
+  Symbol_table::hash_symbol_names<size, big_endian>(sd, true);
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1524,6 +1533,9 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
   std::vector<unsigned int> debug_info_sections;
   std::vector<unsigned int> debug_types_sections;
 
+  // Keep track of .debug_names sections.
+  std::vector<unsigned int> debug_names_sections;
+
   // Skip the first, dummy, section.
   pshdrs = shdrs + This::shdr_size;
   for (unsigned int i = 1; i < shnum; ++i, pshdrs += This::shdr_size)
@@ -1765,6 +1777,20 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
 	}
       else
 	{
+	  // .debug_names sections are merged after the other sections,
+	  // when the strings and compilation units they refer to have
+	  // been laid out.
+	  if (!emit_relocs
+	      && !parameters->incremental()
+	      && parameters->options().merge_debug_names()
+	      && !(shdr.get_sh_flags() & elfcpp::SHF_ALLOC)
+	      && (strcmp(name, ".debug_names") == 0
+		  || strcmp(name, ".zdebug_names") == 0))
+	    {
+	      debug_names_sections.push_back(i);
+	      continue;
+	    }
+
 	  // When garbage collection is switched on the actual layout
 	  // only happens in the second call.
 	  this->layout_section(layout, i, name, shdr, reloc_shndx[i],
@@ -1812,6 +1838,30 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
 				    reloc_type[i]);
     }
 
+  // Merge the .debug_names sections into the output name index, or
+  // lay them out as usual if they can not be merged.
+  gold_assert(!is_pass_one || debug_names_sections.empty());
+  for (std::vector<unsigned int>::const_iterator p
+	   = debug_names_sections.begin();
+       p != debug_names_sections.end();
+       ++p)
+    {
+      unsigned int i = *p;
+      const unsigned char* pshdr;
+      pshdr = section_headers_data + i * This::shdr_size;
+      typename This::Shdr shdr(pshdr);
+
+      if (layout->add_to_debug_names(this, symbols_data, symbols_size, i,
+				     reloc_shndx[i], reloc_type[i]))
+	{
+	  out_sections[i] = NULL;
+	  out_section_offsets[i] = invalid_address;
+	}
+      else
+	this->layout_section(layout, i, pnames + shdr.get_sh_name(), shdr,
+			     reloc_shndx[i], reloc_type[i]);
+    }
+
   // When doing a relocatable link handle the reloc sections at the
   // end.  Garbage collection  and Identical Code Folding is not
   // turned on for relocatable code.
@@ -2024,6 +2074,9 @@ Sized_relobj_file<size, big_endian>::do_add_symbols(Symbol_table* symtab,
 			  sd->symbols->data() + sd->external_symbols_offset,
 			  symcount, this->local_symbol_count_,
 			  sym_names, sd->symbol_names_size,
+			  (sd->global_name_hashes.empty()
+			   ? NULL
+			   : &sd->global_name_hashes[0]),
 			  &this->symbols_,
 			  &this->defined_count_);
 
@@ -53,13 +53,24 @@ struct Symbols_data;
 template<typename Stringpool_char>
 class Stringpool_template;
 
+// The length and Stringpool hash code of a symbol name.
+
+struct Symbol_name_hash
+{
+  // Length of the name, not including any version.
+  size_t length;
+  // Stringpool hash code of the name.
+  size_t hash_code;
+};
+
 // Data to pass from read_symbols() to add_symbols().
 
 struct Read_symbols_data
 {
   Read_symbols_data()
     : section_headers(NULL), section_names(NULL), symbols(NULL),
-      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL)
+      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL),
+      global_name_hashes()
   { }
 
   ~Read_symbols_data();
@@ -95,6 +106,12 @@ struct Read_symbols_data
   File_view* verneed;
   section_size_type verneed_size;
   unsigned int verneed_info;
+
+  // The lengths and hash codes of the names of the external symbols.
+  // Symbols are read in parallel but must be added to the symbol
+  // table in order, so we hash the names in read_symbols, leaving
+  // less work for add_symbols.  Empty if not computed.
+  std::vector<Symbol_name_hash> global_name_hashes;
 };
 
 // Information used to print error messages.
@@ -1102,7 +1119,9 @@ class Relobj : public Object
       reloc_counts_(NULL),
       reloc_bases_(NULL),
       first_dyn_reloc_(0),
-      dyn_reloc_count_(0)
+      dyn_reloc_count_(0),
+      relocs_scanned_(0),
+      bytes_written_(0)
   { }
 
   // During garbage collection, the Read_symbols_data pass for 
@@ -1274,6 +1293,17 @@ class Relobj : public Object
   dyn_reloc_count() const
   { return this->dyn_reloc_count_; }
 
+  // Return the number of input relocations scanned, for --stats-file.
+  uint64_t
+  relocs_scanned() const
+  { return this->relocs_scanned_; }
+
+  // Return the number of section bytes written to the output file,
+  // for --stats-file.
+  uint64_t
+  bytes_written() const
+  { return this->bytes_written_; }
+
   // Relocate the input sections and write out the local symbols.
   void
   relocate(const Symbol_table* symtab, const Layout* layout, Output_file* of)
@@ -1539,6 +1569,16 @@ class Relobj : public Object
     return this->reloc_bases_[symndx] + counter;
   }
 
+  // Record that COUNT input relocations were scanned.
+  void
+  add_relocs_scanned(uint64_t count)
+  { this->relocs_scanned_ += count; }
+
+  // Record that BYTES section bytes were written to the output file.
+  void
+  add_bytes_written(uint64_t bytes)
+  { this->bytes_written_ += bytes; }
+
   // Return the word size of the object file--
   // implemented by child class.
   virtual int
@@ -1576,6 +1616,10 @@ class Relobj : public Object
   unsigned int first_dyn_reloc_;
   // Count of dynamic relocations for this object.
   unsigned int dyn_reloc_count_;
+  // The number of input relocations scanned.
+  uint64_t relocs_scanned_;
+  // The number of section bytes written to the output file.
+  uint64_t bytes_written_;
 };
 
 // This class is used to handle relocations against a section symbol
@@ -1306,6 +1306,23 @@ General_options::finalize()
 	gold_fatal(_("-f/--auxiliary may not be used without -shared"));
     }
 
+  if (this->hot_text_segment())
+    {
+      if (this->hot_text_file() == NULL
+	  && this->call_graph_ordering_file() == NULL)
+	gold_fatal(_("--hot-text-segment requires --hot-text-file "
+		     "or --call-graph-ordering-file"));
+      if (this->relocatable())
+	gold_fatal(_("--hot-text-segment is incompatible with -r"));
+      uint64_t page_size = this->hot_text_page_size();
+      if (page_size == 0 || (page_size & (page_size - 1)) != 0)
+	gold_fatal(_("--hot-text-page-size must be a power of 2"));
+    }
+
+  if (this->section_ordering_file() && this->call_graph_ordering_file())
+    gold_fatal(_("--section-ordering-file and --call-graph-ordering-file "
+		 "are incompatible"));
+
   // TODO: implement support for -retain-symbols-file with -r, if needed.
   if (this->relocatable() && this->retain_symbols_file())
     gold_fatal(_("-retain-symbols-file does not yet work with -r"));
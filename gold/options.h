@@ -751,6 +751,10 @@ class General_options
 
   // c
 
+  DEFINE_string(call_graph_ordering_file, options::TWO_DASHES, '\0', NULL,
+		N_("Order functions using a profile of calls between them"),
+		N_("FILENAME"));
+
   DEFINE_bool(check_sections, options::TWO_DASHES, '\0', true,
 	      N_("Check segment addresses for overlaps"),
 	      N_("Do not check segment addresses for overlaps"));
@@ -925,6 +929,20 @@ class General_options
 	      N_("Dynamic hash style"), N_("[sysv,gnu,both]"),
 	      {"sysv", "gnu", "both"});
 
+  DEFINE_string(hot_text_file, options::TWO_DASHES, '\0', NULL,
+		N_("List of hot functions for --hot-text-segment"),
+		N_("FILENAME"));
+
+  DEFINE_uint64(hot_text_page_size, options::TWO_DASHES, '\0', 0x200000,
+		N_("Page size to align the hot text segment to "
+		   "(default 0x200000)"),
+		N_("SIZE"));
+
+  DEFINE_bool(hot_text_segment, options::TWO_DASHES, '\0', false,
+	      N_("Put hot functions in their own segment, aligned and "
+		 "padded for huge pages"),
+	      N_("Do not put hot functions in their own segment"));
+
   // i
 
   DEFINE_bool_alias(i, relocatable, options::EXACTLY_ONE_DASH, '\0',
@@ -1024,6 +1042,11 @@ class General_options
 	      N_("Map whole files to memory"),
 	      N_("Map relevant file parts to memory"));
 
+  DEFINE_bool(merge_debug_names, options::TWO_DASHES, '\0', true,
+	      N_("Merge .debug_names sections into a single name index "
+		 "(default)"),
+	      N_("Concatenate .debug_names sections"));
+
   DEFINE_bool(merge_exidx_entries, options::TWO_DASHES, '\0', true,
 	      N_("(ARM only) Merge exidx entries in debuginfo"),
 	      N_("(ARM only) Do not merge exidx entries in debuginfo"));
@@ -1076,6 +1099,11 @@ class General_options
 	      N_("Orphan section handling"), N_("[place,discard,warn,error]"),
 	      {"place", "discard", "warn", "error"});
 
+  DEFINE_bool(output_writeback, options::TWO_DASHES, '\0', false,
+	      N_("Write completed parts of the output file to disk "
+		 "while linking"),
+	      N_("Write the output file when the link is complete"));
+
   // p
 
   DEFINE_bool(p, options::ONE_DASH, 'p', false,
@@ -1158,6 +1186,18 @@ class General_options
   DEFINE_bool(relax, options::TWO_DASHES, '\0', false,
 	      N_("Relax branches on certain targets"), NULL);
 
+  DEFINE_string(relink_cache, options::TWO_DASHES, '\0', NULL,
+		N_("Reuse outputs of identical links, and bases for "
+		   "incremental links, from this directory"),
+		N_("DIR"));
+
+  DEFINE_uint64(relink_cache_size, options::TWO_DASHES, '\0',
+		1024 * 1024 * 1024,
+		N_("Remove the least recently used files from the relink "
+		   "cache when it holds more than SIZE bytes (0 for no "
+		   "limit)"),
+		N_("SIZE"));
+
   DEFINE_string(retain_symbols_file, options::TWO_DASHES, '\0', NULL,
 		N_("keep only symbols listed in this file"), N_("FILE"));
 
@@ -1246,6 +1286,14 @@ class General_options
 
   DEFINE_bool(stats, options::TWO_DASHES, '\0', false,
 	      N_("Print resource usage statistics"), NULL);
+  DEFINE_string(stats_file, options::TWO_DASHES, '\0', NULL,
+		N_("Write resource usage statistics by task class and "
+		   "input file to FILENAME in JSON format"),
+		N_("FILENAME"));
+  DEFINE_uint(stats_top_files, options::TWO_DASHES, '\0', 20,
+	      N_("Number of input files listed by --stats-file "
+		 "(0 for all)"),
+	      N_("COUNT"));
 
   DEFINE_string(sysroot, options::TWO_DASHES, '\0', "",
 		N_("Set target system root directory"), N_("DIR"));
@@ -1266,6 +1314,10 @@ class General_options
 	      N_("[rel, abs, got-rel"),
 	      {"rel", "abs", "got-rel"});
 
+  DEFINE_string(task_trace, options::TWO_DASHES, '\0', NULL,
+		N_("Write a trace of workqueue tasks in Chrome trace format"),
+		N_("FILENAME"));
+
   DEFINE_bool(text_reorder, options::TWO_DASHES, '\0', true,
 	      N_("Enable text section reordering for GCC section names"),
 	      N_("Disable text section reordering for GCC section names"));
@@ -1325,6 +1377,11 @@ class General_options
   DEFINE_special(version_script, options::TWO_DASHES, '\0',
 		 N_("Read version script"), N_("FILE"));
 
+  DEFINE_uint64(view_cache_size, options::TWO_DASHES, '\0', 0,
+		N_("Limit the input file data kept in memory between "
+		   "uses to SIZE bytes (0 for no limit)"),
+		N_("SIZE"));
+
   // w
 
   DEFINE_bool(warn_common, options::TWO_DASHES, '\0', false,
@@ -2376,6 +2376,7 @@ Output_section::Output_section(const char* name, elfcpp::Elf_Word type,
     has_fixed_layout_(false),
     is_patch_space_allowed_(false),
     is_unique_segment_(false),
+    is_padded_to_alignment_(false),
     tls_offset_(0),
     extra_segment_flags_(0),
     segment_alignment_(0),
@@ -2519,7 +2520,8 @@ Output_section::add_input_section(Layout* layout,
       && (sh_flags & elfcpp::SHF_EXECINSTR) != 0
       && parameters->target().has_code_fill()
       && (parameters->target().may_relax()
-	  || layout->is_section_ordering_specified()))
+	  || layout->is_section_ordering_specified()
+	  || Layout::tracks_output_chunks()))
     {
       gold_assert(this->fills_.empty());
       this->generate_code_fills_at_write_ = true;
@@ -2558,7 +2560,8 @@ Output_section::add_input_section(Layout* layout,
       || this->must_sort_attached_input_sections()
       || parameters->options().user_set_Map()
       || parameters->target().may_relax()
-      || layout->is_section_ordering_specified())
+      || layout->is_section_ordering_specified()
+      || Layout::tracks_output_chunks())
     {
       Input_section isecn(object, shndx, input_section_size, addralign);
       /* If section ordering is requested by specifying a ordering file,
@@ -3178,6 +3181,9 @@ Output_section::set_final_data_size()
       data_size = off;
     }
 
+  if (this->is_padded_to_alignment_)
+    data_size = align_address(data_size, this->addralign());
+
   // For full incremental links, we want to allocate some patch space
   // in most sections for subsequent incremental updates.
   if (this->is_patch_space_allowed_ && parameters->incremental_full())
@@ -3200,6 +3206,48 @@ Output_section::set_final_data_size()
   this->set_data_size(data_size);
 }
 
+// Find the ranges of the output file which are written when the
+// objects owning the input sections of this section are relocated.
+
+bool
+Output_section::get_input_section_ranges(
+    std::vector<Input_section_range>* ranges) const
+{
+  if (this->input_sections_.empty()
+      || this->first_input_offset_ != 0
+      || !this->fills_.empty()
+      || this->after_input_sections_
+      || this->requires_postprocessing_
+      || this->has_fixed_layout_)
+    return false;
+
+  // Anything other than an ordinary input section may be written by
+  // some other task.
+  for (Input_section_list::const_iterator p = this->input_sections_.begin();
+       p != this->input_sections_.end();
+       ++p)
+    if (!p->is_input_section())
+      return false;
+
+  off_t off = 0;
+  for (Input_section_list::const_iterator p = this->input_sections_.begin();
+       p != this->input_sections_.end();
+       ++p)
+    {
+      off = align_address(off, p->addralign());
+      if (p->data_size() > 0)
+	{
+	  Input_section_range range;
+	  range.offset = this->offset() + off;
+	  range.size = p->data_size();
+	  range.relobj = p->relobj();
+	  ranges->push_back(range);
+	}
+      off += p->data_size();
+    }
+  return true;
+}
+
 // Reset the address and file offset.
 
 void
@@ -4972,7 +5020,11 @@ Output_file::Output_file(const char* name)
     base_(NULL),
     map_is_anonymous_(false),
     map_is_allocated_(false),
-    is_temporary_(false)
+    is_temporary_(false),
+    is_writeback_(false),
+    writeback_releases_memory_(false),
+    writeback_lock_(NULL),
+    written_ranges_()
 {
 }
 
@@ -5275,13 +5327,129 @@ Output_file::unmap()
   this->base_ = NULL;
 }
 
+// Start writing back parts of the output file early.  We need to be
+// able to write at any offset, so this only works for a regular
+// file.
+
+void
+Output_file::start_writeback(bool release_memory)
+{
+  struct stat s;
+  if (this->is_temporary_
+      || this->o_ < 0
+      || this->o_ == STDOUT_FILENO
+      || ::fstat(this->o_, &s) != 0
+      || !S_ISREG(s.st_mode))
+    return;
+
+  this->is_writeback_ = true;
+  this->writeback_releases_memory_ = (release_memory
+				      && !this->map_is_allocated_);
+  this->writeback_lock_ = new Lock();
+}
+
+// Write out SIZE bytes at START, which will not change again.  When
+// the file is mapped, the kernel would write the pages out eventually
+// anyhow; we just ask it to start now, so that the writes overlap
+// with the rest of the link rather than all happening at the end,
+// and we drop the pages from our address space so that they do not
+// keep adding to our memory use.  When the map is anonymous we write
+// the data ourselves, and close will skip it.
+
+void
+Output_file::write_back(off_t start, size_t size)
+{
+  if (!this->is_writeback_ || size == 0)
+    return;
+  gold_assert(start >= 0
+	      && start + static_cast<off_t>(size) <= this->file_size_);
+
+  bool release = true;
+  if (this->map_is_anonymous_)
+    {
+      if (!this->pwrite_range(start, size))
+	return;
+      release = this->writeback_releases_memory_;
+    }
+#ifdef SYNC_FILE_RANGE_WRITE
+  else
+    ::sync_file_range(this->o_, start, size, SYNC_FILE_RANGE_WRITE);
+#endif
+
+  {
+    Hold_lock hl(*this->writeback_lock_);
+    this->written_ranges_.push_back(std::make_pair(start, size));
+  }
+
+#ifdef MADV_DONTNEED
+  // Only whole pages can be released.  The map starts on a page
+  // boundary, and the last page of the map belongs to the file.
+  if (release)
+    {
+      const off_t page_size = ::getpagesize();
+      const off_t end = start + size;
+      off_t pstart = align_address(start, page_size);
+      off_t pend = (end == this->file_size_
+		    ? static_cast<off_t>(align_address(end, page_size))
+		    : end & ~(page_size - 1));
+      if (pend > pstart)
+	::madvise(this->base_ + pstart, pend - pstart, MADV_DONTNEED);
+    }
+#endif
+}
+
+// Write part of an anonymous map to the file.
+
+bool
+Output_file::pwrite_range(off_t start, size_t size)
+{
+  while (size > 0)
+    {
+      ssize_t bytes_written = ::pwrite(this->o_, this->base_ + start, size,
+				       start);
+      if (bytes_written == 0)
+	{
+	  gold_error(_("%s: pwrite: unexpected 0 return-value"), this->name_);
+	  return false;
+	}
+      else if (bytes_written < 0)
+	{
+	  gold_error(_("%s: pwrite: %s"), this->name_, strerror(errno));
+	  return false;
+	}
+      start += bytes_written;
+      size -= bytes_written;
+    }
+  return true;
+}
+
 // Close the output file.
 
 void
 Output_file::close()
 {
+  // If the map isn't file-backed, write out whatever was not written
+  // back early.
+  if (this->map_is_anonymous_
+      && !this->is_temporary_
+      && !this->written_ranges_.empty())
+    {
+      std::sort(this->written_ranges_.begin(), this->written_ranges_.end());
+      off_t off = 0;
+      for (Range_list::const_iterator p = this->written_ranges_.begin();
+	   p != this->written_ranges_.end();
+	   ++p)
+	{
+	  if (p->first > off)
+	    this->pwrite_range(off, p->first - off);
+	  off = std::max(off, static_cast<off_t>(p->first + p->second));
+	}
+      if (off < this->file_size_)
+	this->pwrite_range(off, this->file_size_ - off);
+    }
+
   // If the map isn't file-backed, we need to write it now.
-  if (this->map_is_anonymous_ && !this->is_temporary_)
+  else if (this->map_is_anonymous_ && !this->is_temporary_)
     {
       size_t bytes_to_write = this->file_size_;
       size_t offset = 0;
@@ -5302,6 +5470,16 @@ Output_file::close()
     }
   this->unmap();
 
+#ifdef POSIX_FADV_DONTNEED
+  // The parts written back early have most likely reached the disk by
+  // now, so drop them from the page cache rather than leaving them to
+  // push out other data.
+  for (Range_list::const_iterator p = this->written_ranges_.begin();
+       p != this->written_ranges_.end();
+       ++p)
+    ::posix_fadvise(this->o_, p->first, p->second, POSIX_FADV_DONTNEED);
+#endif
+
   // We don't close stdout or stderr
   if (this->o_ != STDOUT_FILENO
       && this->o_ != STDERR_FILENO
@@ -84,6 +84,21 @@ class Output_file
   void
   close();
 
+  // For --output-writeback, start writing completed parts of the
+  // file to disk before it is closed.  If RELEASE_MEMORY is true,
+  // nothing reads those parts again, so if the file is not mapped
+  // the memory holding them may be released once they are written.
+  // This method is thread-unsafe.
+  void
+  start_writeback(bool release_memory);
+
+  // The SIZE bytes at START are complete.  If writeback was started,
+  // write them to disk now, or start asynchronous writeback of the
+  // mapped file, and drop them from memory.  This method may be
+  // called from any thread.
+  void
+  write_back(off_t start, size_t size);
+
   // Return the size of this file.
   off_t
   filesize()
@@ -158,6 +173,14 @@ class Output_file
   void
   unmap();
 
+  // Write SIZE bytes at START from memory to the file, for an
+  // anonymous map.  Return whether the write succeeded.
+  bool
+  pwrite_range(off_t start, size_t size);
+
+  // A range of the file written back early, as offset and size.
+  typedef std::vector<std::pair<off_t, size_t> > Range_list;
+
   // File name.
   const char* name_;
   // File descriptor.
@@ -172,6 +195,15 @@ class Output_file
   bool map_is_allocated_;
   // True if this is a temporary file which should not be output.
   bool is_temporary_;
+  // True if completed parts of the file are written back early.
+  bool is_writeback_;
+  // True if the memory holding parts written back early may be
+  // released when the map is anonymous.
+  bool writeback_releases_memory_;
+  // Controls access to WRITTEN_RANGES_.
+  Lock* writeback_lock_;
+  // The parts of the file written back early.
+  Range_list written_ranges_;
 };
 
 // An abtract class for data which has to go into the output file.
@@ -3629,6 +3661,12 @@ class Output_section : public Output_data
   set_segment_alignment(uint64_t align)
   { this->segment_alignment_ = align; }
 
+  // Pad the size of the section to a multiple of its alignment, so
+  // that nothing else shares its last page.
+  void
+  set_is_padded_to_alignment()
+  { this->is_padded_to_alignment_ = true; }
+
   // If a section requires postprocessing, return the buffer to use.
   unsigned char*
   postprocessing_buffer() const
@@ -4136,6 +4174,23 @@ class Output_section : public Output_data
   input_sections()
   { return this->input_sections_; }
 
+  // A range of the output file holding the contents of an input
+  // section, which is written when its object is relocated.
+  struct Input_section_range
+  {
+    off_t offset;
+    off_t size;
+    const Relobj* relobj;
+  };
+
+  // If the contents of this section are written only by relocating
+  // the objects which own its input sections and by writing the
+  // section itself, append the ranges of its input sections to
+  // *RANGES and return true.  Otherwise return false.  This is used
+  // to hash parts of the output file before it is complete.
+  bool
+  get_input_section_ranges(std::vector<Input_section_range>* ranges) const;
+
  protected:
   // Return the output section--i.e., the object itself.
   Output_section*
@@ -4603,6 +4658,8 @@ class Output_section : public Output_data
   bool is_patch_space_allowed_ : 1;
   // True if this output section goes into a unique segment.
   bool is_unique_segment_ : 1;
+  // True if the size of this section is padded to its alignment.
+  bool is_padded_to_alignment_ : 1;
   // For SHT_TLS sections, the offset of this section relative to the base
   // of the TLS segment.
   uint64_t tls_offset_;
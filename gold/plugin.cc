@@ -557,11 +557,15 @@ Plugin_manager::all_symbols_read(Workqueue* workqueue, Task* task,
   this->mapfile_ = mapfile;
   this->this_blocker_ = NULL;
 
+  this->compute_symbol_resolutions();
+
   for (this->current_ = this->plugins_.begin();
        this->current_ != this->plugins_.end();
        ++this->current_)
     (*this->current_)->all_symbols_read();
 
+  this->clear_symbol_resolutions();
+
   if (this->any_added_)
     {
       Task_token* next_blocker = new Task_token(true);
@@ -573,6 +577,81 @@ Plugin_manager::all_symbols_read(Workqueue* workqueue, Task* task,
   *last_blocker = this->this_blocker_;
 }
 
+// A job which computes the symbol resolutions of the claimed objects,
+// spread over several threads.
+
+class Plugin_resolution_job : public Parallel_job
+{
+ public:
+  Plugin_resolution_job(const std::vector<Pluginobj*>* objects,
+			Symbol_table* symtab)
+    : objects_(objects), symtab_(symtab)
+  { }
+
+  void
+  run_piece(int index, int count)
+  {
+    for (size_t i = index; i < this->objects_->size(); i += count)
+      (*this->objects_)[i]->compute_symbol_resolutions(this->symtab_);
+  }
+
+ private:
+  const std::vector<Pluginobj*>* objects_;
+  Symbol_table* symtab_;
+};
+
+// Compute the symbol resolutions of all the claimed objects.  The
+// all-symbols-read handlers normally ask for the resolutions of every
+// claimed object in turn, which with many claimed objects is a long
+// serial step before code generation can start.  Nothing changes the
+// symbol table between here and those calls, so we can do the work
+// up front on several threads.  This is only worth doing when we can
+// use threads.
+
+void
+Plugin_manager::compute_symbol_resolutions()
+{
+  int threads = parallel_job_threads();
+  if (threads <= 1)
+    return;
+
+  // Only look at the objects in the link.  The objects_ list may
+  // refer to archive members which were not included and have since
+  // been deleted.
+  gold_assert(this->resolved_objects_.empty());
+  for (Input_objects::Relobj_iterator p = this->input_objects_->relobj_begin();
+       p != this->input_objects_->relobj_end();
+       ++p)
+    {
+      Pluginobj* obj = (*p)->pluginobj();
+      if (obj != NULL)
+	this->resolved_objects_.push_back(obj);
+    }
+  if (this->resolved_objects_.size() < 2)
+    {
+      this->resolved_objects_.clear();
+      return;
+    }
+
+  Plugin_resolution_job job(&this->resolved_objects_, this->symtab_);
+  run_parallel_job(&job, std::min(static_cast<size_t>(threads),
+				   this->resolved_objects_.size()));
+}
+
+// Discard the symbol resolutions computed ahead of time.  After this
+// get_symbols computes them when called.
+
+void
+Plugin_manager::clear_symbol_resolutions()
+{
+  for (std::vector<Pluginobj*>::const_iterator p =
+	 this->resolved_objects_.begin();
+       p != this->resolved_objects_.end();
+       ++p)
+    (*p)->clear_symbol_resolutions();
+  this->resolved_objects_.clear();
+}
+
 // This is called when we see a new undefined symbol.  If we are in
 // the replacement phase, this means that we may need to rescan some
 // archives we have previously seen.
@@ -880,6 +959,9 @@ Plugin_manager::add_input_file(const char* pathname, bool is_lib)
   if (parameters->incremental())
     gold_error(_("input files added by plug-ins in --incremental mode not "
 		 "supported yet"));
+  // The symbols of the new file may change the resolutions, so stop
+  // using the ones computed ahead of time.
+  this->clear_symbol_resolutions();
   this->workqueue_->queue_soon(new Read_symbols(this->input_objects_,
                                                 this->symtab_,
                                                 this->layout_,
@@ -901,7 +983,8 @@ Plugin_manager::add_input_file(const char* pathname, bool is_lib)
 Pluginobj::Pluginobj(const std::string& name, Input_file* input_file,
                      off_t offset, off_t filesize)
   : Object(name, input_file, false, offset),
-    nsyms_(0), syms_(NULL), symbols_(), filesize_(filesize), comdat_map_()
+    nsyms_(0), syms_(NULL), symbols_(), name_hashes_(), filesize_(filesize),
+    comdat_map_(), resolutions_()
 {
 }
 
@@ -967,61 +1050,136 @@ Pluginobj::get_symbol_resolution_info(Symbol_table* symtab,
   for (int i = 0; i < nsyms; i++)
     {
       ld_plugin_symbol* isym = &syms[i];
-      Symbol* lsym = this->symbols_[i];
-      if (lsym->is_forwarder())
-        lsym = symtab->resolve_forwards(lsym);
-      ld_plugin_symbol_resolution res = LDPR_UNKNOWN;
-
-      if (lsym->is_undefined())
-        // The symbol remains undefined.
-        res = LDPR_UNDEF;
-      else if (isym->def == LDPK_UNDEF
-               || isym->def == LDPK_WEAKUNDEF
-               || isym->def == LDPK_COMMON)
-        {
-          // The original symbol was undefined or common.
-          if (lsym->source() != Symbol::FROM_OBJECT)
-            res = LDPR_RESOLVED_EXEC;
-          else if (lsym->object()->pluginobj() == this)
-	    {
-	      if (is_referenced_from_outside(lsym))
-		res = LDPR_PREVAILING_DEF;
-	      else if (is_visible_from_outside(lsym))
-		res = ldpr_prevailing_def_ironly_exp;
-	      else
-		res = LDPR_PREVAILING_DEF_IRONLY;
-	    }
-          else if (lsym->object()->pluginobj() != NULL)
-            res = LDPR_RESOLVED_IR;
-          else if (lsym->object()->is_dynamic())
-            res = LDPR_RESOLVED_DYN;
-          else
-            res = LDPR_RESOLVED_EXEC;
-        }
+      ld_plugin_symbol_resolution res;
+      if (!this->resolutions_.empty() && isym->def == this->syms_[i].def)
+	{
+	  res = this->resolutions_[i];
+	  if (res == LDPR_PREVAILING_DEF_IRONLY_EXP)
+	    res = ldpr_prevailing_def_ironly_exp;
+	}
       else
-        {
-          // The original symbol was a definition.
-          if (lsym->source() != Symbol::FROM_OBJECT)
-            res = LDPR_PREEMPTED_REG;
-          else if (lsym->object() == static_cast<const Object*>(this))
-	    {
-	      if (is_referenced_from_outside(lsym))
-		res = LDPR_PREVAILING_DEF;
-	      else if (is_visible_from_outside(lsym))
-		res = ldpr_prevailing_def_ironly_exp;
-	      else
-		res = LDPR_PREVAILING_DEF_IRONLY;
-	    }
-          else
-            res = (lsym->object()->pluginobj() != NULL
-                   ? LDPR_PREEMPTED_IR
-                   : LDPR_PREEMPTED_REG);
-        }
+	res = this->symbol_resolution(symtab, isym, this->symbols_[i],
+				      ldpr_prevailing_def_ironly_exp);
       isym->resolution = res;
     }
   return LDPS_OK;
 }
 
+// Return the resolution of the plugin symbol ISYM, which was added to
+// the symbol table as LSYM.
+
+ld_plugin_symbol_resolution
+Pluginobj::symbol_resolution(
+    Symbol_table* symtab,
+    const ld_plugin_symbol* isym,
+    Symbol* lsym,
+    ld_plugin_symbol_resolution prevailing_def_ironly_exp) const
+{
+  if (lsym->is_forwarder())
+    lsym = symtab->resolve_forwards(lsym);
+  ld_plugin_symbol_resolution res = LDPR_UNKNOWN;
+
+  if (lsym->is_undefined())
+    // The symbol remains undefined.
+    res = LDPR_UNDEF;
+  else if (isym->def == LDPK_UNDEF
+	   || isym->def == LDPK_WEAKUNDEF
+	   || isym->def == LDPK_COMMON)
+    {
+      // The original symbol was undefined or common.
+      if (lsym->source() != Symbol::FROM_OBJECT)
+	res = LDPR_RESOLVED_EXEC;
+      else if (lsym->object()->pluginobj() == this)
+	{
+	  if (is_referenced_from_outside(lsym))
+	    res = LDPR_PREVAILING_DEF;
+	  else if (is_visible_from_outside(lsym))
+	    res = prevailing_def_ironly_exp;
+	  else
+	    res = LDPR_PREVAILING_DEF_IRONLY;
+	}
+      else if (lsym->object()->pluginobj() != NULL)
+	res = LDPR_RESOLVED_IR;
+      else if (lsym->object()->is_dynamic())
+	res = LDPR_RESOLVED_DYN;
+      else
+	res = LDPR_RESOLVED_EXEC;
+    }
+  else
+    {
+      // The original symbol was a definition.
+      if (lsym->source() != Symbol::FROM_OBJECT)
+	res = LDPR_PREEMPTED_REG;
+      else if (lsym->object() == static_cast<const Object*>(this))
+	{
+	  if (is_referenced_from_outside(lsym))
+	    res = LDPR_PREVAILING_DEF;
+	  else if (is_visible_from_outside(lsym))
+	    res = prevailing_def_ironly_exp;
+	  else
+	    res = LDPR_PREVAILING_DEF_IRONLY;
+	}
+      else
+	res = (lsym->object()->pluginobj() != NULL
+	       ? LDPR_PREEMPTED_IR
+	       : LDPR_PREEMPTED_REG);
+    }
+  return res;
+}
+
+// Compute the resolution of each symbol ahead of time, as reported by
+// version 2 of get_symbols.
+
+void
+Pluginobj::compute_symbol_resolutions(Symbol_table* symtab)
+{
+  gold_assert(this->resolutions_.empty());
+
+  // If we never decided to include this object, there is nothing to
+  // compute.
+  if (static_cast<size_t>(this->nsyms_) > this->symbols_.size())
+    return;
+
+  this->resolutions_.resize(this->nsyms_);
+  for (int i = 0; i < this->nsyms_; i++)
+    {
+      // The target may have declined to make a symbol; leave those
+      // objects to get_symbols.
+      if (this->symbols_[i] == NULL)
+	{
+	  this->clear_symbol_resolutions();
+	  return;
+	}
+      this->resolutions_[i] =
+	this->symbol_resolution(symtab, &this->syms_[i], this->symbols_[i],
+				LDPR_PREVAILING_DEF_IRONLY_EXP);
+    }
+}
+
+// Compute the lengths and hash codes of the names of the symbols, so
+// that adding them to the symbol table, which must be done in order,
+// has less work to do.
+
+void
+Pluginobj::hash_symbol_names()
+{
+  gold_assert(this->name_hashes_.empty());
+  this->name_hashes_.resize(this->nsyms_);
+  for (int i = 0; i < this->nsyms_; i++)
+    {
+      const char* name = this->syms_[i].name;
+      Symbol_name_hash* h = &this->name_hashes_[i];
+      if (name == NULL)
+	{
+	  h->length = 0;
+	  h->hash_code = 0;
+	  continue;
+	}
+      h->length = strlen(name);
+      h->hash_code = Stringpool::hash_string(name, h->length);
+    }
+}
+
 // Return TRUE if the comdat group with key COMDAT_KEY from this object
 // should be kept.
 
@@ -1160,9 +1318,16 @@ Sized_pluginobj<size, big_endian>::do_add_symbols(Symbol_table* symtab,
       osym.put_st_other(vis, 0);
       osym.put_st_shndx(shndx);
 
+      const Symbol_name_hash* name_hash = NULL;
+      if (name != NULL && !this->name_hashes_.empty())
+	name_hash = &this->name_hashes_[i];
+
       this->symbols_[i] =
-        symtab->add_from_pluginobj<size, big_endian>(this, name, ver, &sym);
+        symtab->add_from_pluginobj<size, big_endian>(this, name, ver,
+						     name_hash, &sym);
     }
+
+  std::vector<Symbol_name_hash>().swap(this->name_hashes_);
 }
 
 template<int size, bool big_endian>
@@ -1354,13 +1519,14 @@ Sized_pluginobj<size, big_endian>::do_get_global_symbol_counts(
   *used = 0;
 }
 
-// Get symbols.  Not used for plugin objects.
+// Get symbols.  This is used when an archive member claimed by a
+// plugin is included, to find the archive map entries to check again.
 
 template<int size, bool big_endian>
 const Object::Symbols*
 Sized_pluginobj<size, big_endian>::do_get_global_symbols() const
 {
-  gold_unreachable();
+  return &this->symbols_;
 }
 
 // Class Plugin_finish.  This task runs after all replacement files have
@@ -1888,6 +2054,7 @@ unique_segment_for_sections(const char* segment_name,
   s->name = segment_name;
   s->flags = flags;
   s->align = align;
+  s->align_contents = false;
 
   for (unsigned int i = 0; i < num_sections; ++i)
     {
@@ -25,6 +25,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include "object.h"
 #include "plugin-api.h"
@@ -135,7 +136,7 @@ class Plugin_manager
       options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
       symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
       this_blocker_(NULL), extra_search_path_(), lock_(NULL),
-      initialize_lock_(&lock_)
+      initialize_lock_(&lock_), resolved_objects_()
   { this->current_ = plugins_.end(); }
 
   ~Plugin_manager();
@@ -327,6 +328,16 @@ class Plugin_manager
   void
   rescan(Task*);
 
+  // Compute the symbol resolutions of all the claimed objects at
+  // once, on several threads, ahead of the calls to get_symbols from
+  // the all-symbols-read handlers.
+  void
+  compute_symbol_resolutions();
+
+  // Discard the resolutions computed by compute_symbol_resolutions.
+  void
+  clear_symbol_resolutions();
+
   // See whether the rescannable at index I defines SYM.
   bool
   rescannable_defines(size_t i, Symbol* sym);
@@ -383,6 +394,9 @@ class Plugin_manager
   std::string extra_search_path_;
   Lock* lock_;
   Initialize_lock initialize_lock_;
+  // The objects whose symbol resolutions were computed by
+  // compute_symbol_resolutions.
+  std::vector<Pluginobj*> resolved_objects_;
 };
 
 
@@ -413,6 +427,23 @@ class Pluginobj : public Object
     this->syms_ = syms;
   }
 
+  // Compute the lengths and hash codes of the names of the symbols
+  // provided by the plugin.  This does not touch the symbol table,
+  // so it may be called while reading symbols in parallel.
+  void
+  hash_symbol_names();
+
+  // Compute the resolution of each symbol ahead of a call to
+  // get_symbol_resolution_info.  This only reads the symbol table,
+  // so it may be called for different objects at the same time.
+  void
+  compute_symbol_resolutions(Symbol_table* symtab);
+
+  // Discard the resolutions computed by compute_symbol_resolutions.
+  void
+  clear_symbol_resolutions()
+  { std::vector<ld_plugin_symbol_resolution>().swap(this->resolutions_); }
+
   // Return TRUE if the comdat group with key COMDAT_KEY from this object
   // should be kept.
   bool
@@ -458,13 +489,30 @@ class Pluginobj : public Object
   // The entries in the symbol table for the external symbols.
   Symbols symbols_;
 
+  // The lengths and hash codes of the names of the symbols, or empty
+  // if not computed.
+  std::vector<Symbol_name_hash> name_hashes_;
+
  private:
+  // Return the resolution of the plugin symbol ISYM, which was added
+  // to the symbol table as LSYM.  PREVAILING_DEF_IRONLY_EXP is the
+  // resolution to use for a definition which is only visible from
+  // outside, which depends on the get_symbols version.
+  ld_plugin_symbol_resolution
+  symbol_resolution(Symbol_table* symtab, const ld_plugin_symbol* isym,
+		    Symbol* lsym,
+		    ld_plugin_symbol_resolution prevailing_def_ironly_exp)
+    const;
+
   // Size of the file (or archive member).
   off_t filesize_;
   // Map a comdat key symbol to a boolean indicating whether the comdat
   // group in this object with that key should be kept.
   typedef Unordered_map<std::string, bool> Comdat_map;
   Comdat_map comdat_map_;
+  // The resolutions computed by compute_symbol_resolutions, as
+  // reported by version 2 of get_symbols, or empty.
+  std::vector<ld_plugin_symbol_resolution> resolutions_;
 };
 
 // A plugin object, size-specific version.
@@ -355,6 +355,10 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
           // We are done with the file at this point, so unlock it.
           obj->unlock(this);
 
+	  // Prepare the symbols here, in parallel with other
+	  // Read_symbols tasks, since adding them is serialized.
+	  obj->hash_symbol_names();
+
           if (this->member_ != NULL)
 	    {
 	      this->member_->sd_ = NULL;
@@ -632,7 +636,12 @@ Add_symbols::run(Workqueue*)
 					    this->library_, script_info);
 	}
       this->object_->layout(this->symtab_, this->layout_, this->sd_);
+      // The symbols of a relocatable object may be queued, and added
+      // to the symbol table together with those of the objects which
+      // follow it.
+      this->symtab_->set_may_defer_symbols(true);
       this->object_->add_symbols(this->symtab_, this->sd_, this->layout_);
+      this->symtab_->set_may_defer_symbols(false);
       this->object_->discard_decompressed_sections();
       delete this->sd_;
       this->sd_ = NULL;
@@ -807,6 +816,7 @@ Start_group::locks(Task_locker* tl)
 void
 Start_group::run(Workqueue*)
 {
+  this->symtab_->add_pending_symbols();
   this->finish_group_->set_saw_undefined(this->symtab_->saw_undefined());
 }
 
@@ -841,6 +851,8 @@ Finish_group::locks(Task_locker* tl)
 void
 Finish_group::run(Workqueue*)
 {
+  this->symtab_->add_pending_symbols();
+
   size_t saw_undefined = this->saw_undefined_;
   while (saw_undefined != this->symtab_->saw_undefined())
     {
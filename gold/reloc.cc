@@ -234,10 +234,16 @@ Relocate_task::locks(Task_locker* tl)
 // Run the task.
 
 void
-Relocate_task::run(Workqueue*)
+Relocate_task::run(Workqueue* workqueue)
 {
   this->object_->relocate(this->symtab_, this->layout_, this->of_);
 
+  // Parts of the output file holding only this object's input
+  // sections may now be hashed for the build ID.
+  Output_chunks* output_chunks = this->layout_->output_chunks();
+  if (output_chunks != NULL)
+    output_chunks->object_written(workqueue, this->object_);
+
   // This is normally the last thing we will do with an object, so
   // uncache all views.
   this->object_->clear_view_cache_marks();
@@ -459,12 +465,15 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
 	  // only scan allocated sections.  We may see a non-allocated
 	  // section here if we are emitting relocs.
 	  if (p->is_data_section_allocated)
-	    target->scan_relocs(symtab, layout, this, p->data_shndx,
-				p->sh_type, p->contents->data(),
-				p->reloc_count, p->output_section,
-				p->needs_special_offset_handling,
-				this->local_symbol_count_,
-				local_symbols);
+	    {
+	      this->add_relocs_scanned(p->reloc_count);
+	      target->scan_relocs(symtab, layout, this, p->data_shndx,
+				  p->sh_type, p->contents->data(),
+				  p->reloc_count, p->output_section,
+				  p->needs_special_offset_handling,
+				  this->local_symbol_count_,
+				  local_symbols);
+	    }
 	  if (parameters->options().emit_relocs())
 	    this->emit_relocs_scan(symtab, layout, local_symbols, p);
 	  if (layout->incremental_inputs() != NULL)
@@ -475,6 +484,7 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
 	  Relocatable_relocs* rr = this->relocatable_relocs(p->reloc_shndx);
 	  gold_assert(rr != NULL);
 	  rr->set_reloc_count(p->reloc_count);
+	  this->add_relocs_scanned(p->reloc_count);
 	  target->scan_relocatable_relocs(symtab, layout, this,
 					  p->data_shndx, p->sh_type,
 					  p->contents->data(),
@@ -643,6 +653,7 @@ Sized_relobj_file<size, big_endian>::do_relocate(const Symbol_table* symtab,
 	    this->reverse_words(views[i].view, views[i].view_size);
 	  if (!views[i].is_postprocessing_view)
 	    {
+	      this->add_bytes_written(views[i].view_size);
 	      if (views[i].is_input_output_view)
 		of->write_input_output_view(views[i].offset,
 					    views[i].view_size,
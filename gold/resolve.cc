@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include "elfcpp.h"
+#include "errors.h"
 #include "target.h"
 #include "object.h"
 #include "symtab.h"
@@ -169,11 +170,13 @@ static const unsigned int undef_flag = 1 << def_undef_or_common_shift;
 static const unsigned int common_flag = 2 << def_undef_or_common_shift;
 
 // This convenience function combines all the flags based on facts
-// about the symbol.
+// about the symbol.  If DEFERRED is not NULL, errors are recorded
+// there rather than issued.
 
 static unsigned int
 symbol_to_bits(elfcpp::STB binding, bool is_dynamic,
-	       unsigned int shndx, bool is_ordinary)
+	       unsigned int shndx, bool is_ordinary,
+	       Deferred_diagnostics* deferred)
 {
   unsigned int bits;
 
@@ -191,14 +194,22 @@ symbol_to_bits(elfcpp::STB binding, bool is_dynamic,
     case elfcpp::STB_LOCAL:
       // We should only see externally visible symbols in the symbol
       // table.
-      gold_error(_("invalid STB_LOCAL symbol in external symbols"));
+      if (deferred != NULL)
+	deferred->error(_("invalid STB_LOCAL symbol in external symbols"));
+      else
+	gold_error(_("invalid STB_LOCAL symbol in external symbols"));
       bits = global_flag;
       break;
 
     default:
       // Any target which wants to handle STB_LOOS, etc., needs to
       // define a resolve method.
-      gold_error(_("unsupported symbol binding %d"), static_cast<int>(binding));
+      if (deferred != NULL)
+	deferred->error(_("unsupported symbol binding %d"),
+			static_cast<int>(binding));
+      else
+	gold_error(_("unsupported symbol binding %d"),
+		   static_cast<int>(binding));
       bits = global_flag;
     }
 
@@ -236,7 +247,8 @@ symbol_to_bits(elfcpp::STB binding, bool is_dynamic,
 // than a special code.  ORIG_ST_SHNDX is the original section index,
 // before any munging because of discarded sections, except that all
 // non-ordinary section indexes are mapped to SHN_UNDEF.  VERSION is
-// the version of SYM.
+// the version of SYM.  If DEFERRED is not NULL, diagnostics are
+// recorded there rather than issued.
 
 template<int size, bool big_endian>
 void
@@ -245,7 +257,8 @@ Symbol_table::resolve(Sized_symbol<size>* to,
 		      unsigned int st_shndx, bool is_ordinary,
 		      unsigned int orig_st_shndx,
 		      Object* object, const char* version,
-		      bool is_default_version)
+		      bool is_default_version,
+		      Deferred_diagnostics* deferred)
 {
   // It's possible for a symbol to be defined in an object file
   // using .symver to give it a version, and for there to also be
@@ -275,10 +288,16 @@ Symbol_table::resolve(Sized_symbol<size>* to,
       if (sym.get_st_type() == elfcpp::STT_COMMON
 	  && (is_ordinary || !Symbol::is_common_shndx(st_shndx)))
 	{
-	  gold_warning(_("STT_COMMON symbol '%s' in %s "
-			 "is not in a common section"),
-		       to->demangled_name().c_str(),
-		       to->object()->name().c_str());
+	  if (deferred != NULL)
+	    deferred->warning(_("STT_COMMON symbol '%s' in %s "
+				"is not in a common section"),
+			      to->demangled_name().c_str(),
+			      to->object()->name().c_str());
+	  else
+	    gold_warning(_("STT_COMMON symbol '%s' in %s "
+			   "is not in a common section"),
+			 to->demangled_name().c_str(),
+			 to->object()->name().c_str());
 	  return;
 	}
       // Record that we've seen this symbol in a regular object.
@@ -375,14 +394,15 @@ Symbol_table::resolve(Sized_symbol<size>* to,
 			  : sym.get_st_type());
   unsigned int frombits = symbol_to_bits(sym.get_st_bind(),
                                          object->is_dynamic(),
-					 st_shndx, is_ordinary);
+					 st_shndx, is_ordinary, deferred);
 
   bool adjust_common_sizes;
   bool adjust_dyndef;
   typename Sized_symbol<size>::Size_type tosize = to->symsize();
   if (Symbol_table::should_override(to, frombits, fromtype, OBJECT,
 				    object, &adjust_common_sizes,
-				    &adjust_dyndef, is_default_version))
+				    &adjust_dyndef, is_default_version,
+				    deferred))
     {
       elfcpp::STB tobinding = to->binding();
       typename Sized_symbol<size>::Value_type tovalue = to->value();
@@ -427,16 +447,16 @@ Symbol_table::resolve(Sized_symbol<size>* to,
 	Symbol_table::report_resolve_problem(false,
 					     _("common of '%s' overriding "
 					       "smaller common"),
-					     to, OBJECT, object);
+					     to, OBJECT, object, deferred);
       else if (tosize < sym.get_st_size())
 	Symbol_table::report_resolve_problem(false,
 					     _("common of '%s' overidden by "
 					       "larger common"),
-					     to, OBJECT, object);
+					     to, OBJECT, object, deferred);
       else
 	Symbol_table::report_resolve_problem(false,
 					     _("multiple common of '%s'"),
-					     to, OBJECT, object);
+					     to, OBJECT, object, deferred);
     }
 }
 
@@ -445,22 +465,26 @@ Symbol_table::resolve(Sized_symbol<size>* to,
 // returns true if we should override the existing symbol with the new
 // one, and returns false otherwise.  It sets *ADJUST_COMMON_SIZES to
 // true if we should set the symbol size to the maximum of the TO and
-// FROM sizes.  It handles error conditions.
+// FROM sizes.  It handles error conditions.  If DEFERRED is not NULL,
+// diagnostics are recorded there rather than issued.
 
 bool
 Symbol_table::should_override(const Symbol* to, unsigned int frombits,
 			      elfcpp::STT fromtype, Defined defined,
 			      Object* object, bool* adjust_common_sizes,
-			      bool* adjust_dyndef, bool is_default_version)
+			      bool* adjust_dyndef, bool is_default_version,
+			      Deferred_diagnostics* deferred)
 {
   *adjust_common_sizes = false;
   *adjust_dyndef = false;
 
   unsigned int tobits;
   if (to->source() == Symbol::IS_UNDEFINED)
-    tobits = symbol_to_bits(to->binding(), false, elfcpp::SHN_UNDEF, true);
+    tobits = symbol_to_bits(to->binding(), false, elfcpp::SHN_UNDEF, true,
+			    deferred);
   else if (to->source() != Symbol::FROM_OBJECT)
-    tobits = symbol_to_bits(to->binding(), false, elfcpp::SHN_ABS, false);
+    tobits = symbol_to_bits(to->binding(), false, elfcpp::SHN_ABS, false,
+			    deferred);
   else
     {
       bool is_ordinary;
@@ -468,7 +492,8 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
       tobits = symbol_to_bits(to->binding(),
 			      to->object()->is_dynamic(),
 			      shndx,
-			      is_ordinary);
+			      is_ordinary,
+			      deferred);
     }
 
   if ((to->type() == elfcpp::STT_TLS) ^ (fromtype == elfcpp::STT_TLS)
@@ -476,7 +501,7 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
     Symbol_table::report_resolve_problem(true,
 					 _("symbol '%s' used as both __thread "
 					   "and non-__thread"),
-					 to, defined, object);
+					 to, defined, object, deferred);
 
   // We use a giant switch table for symbol resolution.  This code is
   // unwieldy, but: 1) it is efficient; 2) we definitely handle all
@@ -518,7 +543,7 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
       if (!parameters->options().muldefs())
 	Symbol_table::report_resolve_problem(true,
 					     _("multiple definition of '%s'"),
-					     to, defined, object);
+					     to, defined, object, deferred);
       return false;
 
     case WEAK_DEF * 16 + DEF:
@@ -558,7 +583,7 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
 	Symbol_table::report_resolve_problem(false,
 					     _("definition of '%s' overriding "
 					       "common"),
-					     to, defined, object);
+					     to, defined, object, deferred);
       return true;
 
     case DEF * 16 + WEAK_DEF:
@@ -593,7 +618,7 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
 	Symbol_table::report_resolve_problem(false,
 					     _("definition of '%s' overriding "
 					       "dynamic common definition"),
-					     to, defined, object);
+					     to, defined, object, deferred);
       return true;
 
     case DEF * 16 + DYN_DEF:
@@ -753,7 +778,7 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
 	Symbol_table::report_resolve_problem(false,
 					     _("common '%s' overridden by "
 					       "previous definition"),
-					     to, defined, object);
+					     to, defined, object, deferred);
       return false;
 
     case WEAK_DEF * 16 + COMMON:
@@ -869,10 +894,14 @@ Symbol_table::should_override(const Symbol* to, unsigned int frombits,
 // symbol is defined, we should be able to pull the location from the
 // debug info if there is any.
 
+// If DEFERRED is not NULL, the diagnostics are recorded there rather
+// than issued.
+
 void
 Symbol_table::report_resolve_problem(bool is_error, const char* msg,
 				     const Symbol* to, Defined defined,
-				     Object* object)
+				     Object* object,
+				     Deferred_diagnostics* deferred)
 {
   std::string demangled(to->demangled_name());
   size_t len = strlen(msg) + demangled.length() + 10;
@@ -903,7 +932,14 @@ Symbol_table::report_resolve_problem(bool is_error, const char* msg,
       gold_unreachable();
     }
 
-  if (is_error)
+  if (deferred != NULL)
+    {
+      if (is_error)
+	deferred->error("%s: %s", objname, buf);
+      else
+	deferred->warning("%s: %s", objname, buf);
+    }
+  else if (is_error)
     gold_error("%s: %s", objname, buf);
   else
     gold_warning("%s: %s", objname, buf);
@@ -914,7 +950,11 @@ Symbol_table::report_resolve_problem(bool is_error, const char* msg,
     objname = to->object()->name().c_str();
   else
     objname = _("command line");
-  gold_info("%s: %s: previous definition here", program_name, objname);
+  if (deferred != NULL)
+    deferred->info("%s: %s: previous definition here", program_name,
+		   objname);
+  else
+    gold_info("%s: %s: previous definition here", program_name, objname);
 }
 
 // A special case of should_override which is only called for a strong
@@ -931,7 +971,7 @@ Symbol_table::should_override_with_special(const Symbol* to,
   unsigned int frombits = global_flag | regular_flag | def_flag;
   bool ret = Symbol_table::should_override(to, frombits, fromtype, defined,
 					   NULL, &adjust_common_sizes,
-					   &adjust_dyn_def, false);
+					   &adjust_dyn_def, false, NULL);
   gold_assert(!adjust_common_sizes && !adjust_dyn_def);
   return ret;
 }
@@ -1064,7 +1104,8 @@ Symbol_table::resolve<32, false>(
     unsigned int orig_st_shndx,
     Object* object,
     const char* version,
-    bool is_default_version);
+    bool is_default_version,
+    Deferred_diagnostics* deferred);
 
 template
 void
@@ -1076,7 +1117,8 @@ Symbol_table::resolve<32, true>(
     unsigned int orig_st_shndx,
     Object* object,
     const char* version,
-    bool is_default_version);
+    bool is_default_version,
+    Deferred_diagnostics* deferred);
 #endif
 
 #if defined(HAVE_TARGET_64_LITTLE) || defined(HAVE_TARGET_64_BIG)
@@ -1090,7 +1132,8 @@ Symbol_table::resolve<64, false>(
     unsigned int orig_st_shndx,
     Object* object,
     const char* version,
-    bool is_default_version);
+    bool is_default_version,
+    Deferred_diagnostics* deferred);
 
 template
 void
@@ -1102,7 +1145,8 @@ Symbol_table::resolve<64, true>(
     unsigned int orig_st_shndx,
     Object* object,
     const char* version,
-    bool is_default_version);
+    bool is_default_version,
+    Deferred_diagnostics* deferred);
 #endif
 
 #if defined(HAVE_TARGET_32_LITTLE) || defined(HAVE_TARGET_32_BIG)
@@ -28,6 +28,7 @@
 
 #include "output.h"
 #include "parameters.h"
+#include "gold-threads.h"
 #include "stringpool.h"
 
 namespace gold
@@ -237,10 +238,11 @@ Stringpool_template<Stringpool_char>::new_key_offset(size_t length)
 
 template<typename Stringpool_char>
 const Stringpool_char*
-Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
-						      size_t length,
-						      bool copy,
-						      Key* pkey)
+Stringpool_template<Stringpool_char>::add_with_hash(const Stringpool_char* s,
+						    size_t length,
+						    size_t hash_code,
+						    bool copy,
+						    Key* pkey)
 {
   typedef std::pair<typename String_set_type::iterator, bool> Insert_type;
 
@@ -252,7 +254,7 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
       // When we don't need to copy the string, we can call insert
       // directly.
 
-      std::pair<Hashkey, Hashval> element(Hashkey(s, length), k);
+      std::pair<Hashkey, Hashval> element(Hashkey(s, length, hash_code), k);
 
       Insert_type ins = this->string_set_.insert(element);
 
@@ -279,7 +281,7 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
   // canonicalize it by copying it into the canonical list. The hash
   // code will only be computed once.
 
-  Hashkey hk(s, length);
+  Hashkey hk(s, length, hash_code);
   typename String_set_type::const_iterator p = this->string_set_.find(hk);
   if (p != this->string_set_.end())
     {
@@ -354,6 +356,103 @@ Stringpool_template<Stringpool_char>::Stringpool_sort_comparison::operator()(
   return len1 > len2;
 }
 
+// The number of strings in a table for which it is worth sorting on
+// more than one thread.
+
+static const size_t parallel_sort_threshold = 50000;
+
+// Sorting a large string table is done in pieces on several threads.
+// This job sorts each piece.  BOUNDS has COUNT + 1 entries, giving
+// the start of each piece and the end of the last one.
+
+template<typename Iterator, typename Compare>
+class Parallel_sort_job : public Parallel_job
+{
+ public:
+  Parallel_sort_job(Iterator begin, const std::vector<size_t>* bounds,
+		    Compare comp)
+    : begin_(begin), bounds_(bounds), comp_(comp)
+  { }
+
+  void
+  run_piece(int index, int)
+  {
+    std::sort(this->begin_ + (*this->bounds_)[index],
+	      this->begin_ + (*this->bounds_)[index + 1],
+	      this->comp_);
+  }
+
+ private:
+  Iterator begin_;
+  const std::vector<size_t>* bounds_;
+  Compare comp_;
+};
+
+// This job merges adjacent runs of sorted pieces, WIDTH pieces at a
+// time, so that runs of 2 * WIDTH pieces are sorted.
+
+template<typename Iterator, typename Compare>
+class Parallel_merge_job : public Parallel_job
+{
+ public:
+  Parallel_merge_job(Iterator begin, const std::vector<size_t>* bounds,
+		     size_t width, Compare comp)
+    : begin_(begin), bounds_(bounds), width_(width), comp_(comp)
+  { }
+
+  void
+  run_piece(int index, int)
+  {
+    size_t pieces = this->bounds_->size() - 1;
+    size_t lo = 2 * this->width_ * index;
+    size_t mid = lo + this->width_;
+    if (mid >= pieces)
+      return;
+    size_t hi = std::min(mid + this->width_, pieces);
+    std::inplace_merge(this->begin_ + (*this->bounds_)[lo],
+		       this->begin_ + (*this->bounds_)[mid],
+		       this->begin_ + (*this->bounds_)[hi],
+		       this->comp_);
+  }
+
+ private:
+  Iterator begin_;
+  const std::vector<size_t>* bounds_;
+  size_t width_;
+  Compare comp_;
+};
+
+// Sort [BEGIN, END) using THREADS threads.  COMP must be a strict
+// total order on the elements, so that the result is the same as
+// calling std::sort.
+
+template<typename Iterator, typename Compare>
+void
+parallel_sort(Iterator begin, Iterator end, Compare comp, int threads)
+{
+  size_t count = end - begin;
+  if (threads <= 1)
+    {
+      std::sort(begin, end, comp);
+      return;
+    }
+
+  std::vector<size_t> bounds(threads + 1);
+  for (int i = 0; i <= threads; ++i)
+    bounds[i] = (static_cast<uint64_t>(count) * i) / threads;
+
+  Parallel_sort_job<Iterator, Compare> sort_job(begin, &bounds, comp);
+  run_parallel_job(&sort_job, threads);
+
+  for (size_t width = 1; width < static_cast<size_t>(threads); width *= 2)
+    {
+      Parallel_merge_job<Iterator, Compare> merge_job(begin, &bounds, width,
+						      comp);
+      size_t merges = (threads + 2 * width - 1) / (2 * width);
+      run_parallel_job(&merge_job, merges);
+    }
+}
+
 // Return whether s1 is a suffix of s2.
 
 template<typename Stringpool_char>
@@ -368,6 +467,50 @@ Stringpool_template<Stringpool_char>::is_suffix(const Stringpool_char* s1,
   return memcmp(s1, s2 + len2 - len1, len1 * sizeof(Stringpool_char)) == 0;
 }
 
+// When optimizing, finding the strings which are suffixes of the
+// string before them in sorted order is done in pieces on several
+// threads.  This job sets SUFFIX[I] for each string in its piece.
+
+template<typename Stringpool_char>
+class Stringpool_template<Stringpool_char>::Find_suffixes_job
+  : public Parallel_job
+{
+ public:
+  Find_suffixes_job(const std::vector<Stringpool_sort_info>* v,
+		    uint64_t addralign, std::vector<unsigned char>* suffix)
+    : v_(v), addralign_(addralign), suffix_(suffix)
+  { }
+
+  void
+  run_piece(int index, int count)
+  {
+    const std::vector<Stringpool_sort_info>& v(*this->v_);
+    size_t start = (static_cast<uint64_t>(v.size()) * index) / count;
+    size_t end = (static_cast<uint64_t>(v.size()) * (index + 1)) / count;
+    if (start == 0)
+      {
+	if (end == 0)
+	  return;
+	(*this->suffix_)[0] = false;
+	start = 1;
+      }
+    for (size_t i = start; i < end; ++i)
+      {
+	const Hashkey& curr(v[i]->first);
+	const Hashkey& last(v[i - 1]->first);
+	(*this->suffix_)[i] = (((curr.length - last.length)
+				% this->addralign_) == 0
+			       && is_suffix(curr.string, curr.length,
+					    last.string, last.length));
+      }
+  }
+
+ private:
+  const std::vector<Stringpool_sort_info>* v_;
+  uint64_t addralign_;
+  std::vector<unsigned char>* suffix_;
+};
+
 // Turn the stringpool into an ELF strtab: determine the offsets of
 // each string in the table.
 
@@ -408,7 +551,24 @@ Stringpool_template<Stringpool_char>::set_string_offsets()
            ++p)
         v.push_back(Stringpool_sort_info(p));
 
-      std::sort(v.begin(), v.end(), Stringpool_sort_comparison());
+      // The comparison is a total order on distinct strings, so the
+      // sorted order, and hence the string table, does not depend on
+      // how many threads we use.  The pieces are split evenly, so
+      // only use threads for large tables.
+      int threads = 1;
+      if (count >= parallel_sort_threshold)
+	threads = std::min(parallel_job_threads(),
+			   static_cast<int>(count / (parallel_sort_threshold
+						     / 2)));
+
+      parallel_sort(v.begin(), v.end(), Stringpool_sort_comparison(),
+		    threads);
+
+      // Comparing each string with the one before it is independent
+      // of the offsets, so do that on the same threads.
+      std::vector<unsigned char> suffix(count);
+      Find_suffixes_job suffix_job(&v, this->addralign_, &suffix);
+      run_parallel_job(&suffix_job, threads);
 
       section_offset_type last_offset = -1;
       for (typename std::vector<Stringpool_sort_info>::iterator last = v.end(),
@@ -419,13 +579,7 @@ Stringpool_template<Stringpool_char>::set_string_offsets()
 	  section_offset_type this_offset;
           if (this->zero_null_ && (*curr)->first.string[0] == 0)
             this_offset = 0;
-          else if (last != v.end()
-                   && ((((*curr)->first.length - (*last)->first.length)
-			% this->addralign_) == 0)
-                   && is_suffix((*curr)->first.string,
-				(*curr)->first.length,
-                                (*last)->first.string,
-				(*last)->first.length))
+          else if (suffix[curr - v.begin()])
             this_offset = (last_offset
 			   + (((*last)->first.length - (*curr)->first.length)
 			      * charsize));
@@ -227,7 +227,23 @@ class Stringpool_template
   // Add string S of length LEN characters to the pool.  If COPY is
   // true, S need not be null terminated.
   const Stringpool_char*
-  add_with_length(const Stringpool_char* s, size_t len, bool copy, Key* pkey);
+  add_with_length(const Stringpool_char* s, size_t len, bool copy, Key* pkey)
+  { return this->add_with_hash(s, len, string_hash(s, len), copy, pkey); }
+
+  // Add string S of length LEN characters to the pool, where
+  // HASH_CODE is the value returned by hash_string for S and LEN.
+  // This lets the caller compute the hash code ahead of time,
+  // possibly on a different thread.
+  const Stringpool_char*
+  add_with_hash(const Stringpool_char* s, size_t len, size_t hash_code,
+		bool copy, Key* pkey);
+
+  // Return the hash code that the pool will use for string S of
+  // length LEN characters.  This does not look at the pool, and may
+  // be called from any thread.
+  static size_t
+  hash_string(const Stringpool_char* s, size_t len)
+  { return string_hash(s, len); }
 
   // If the string S is present in the pool, return the canonical
   // string pointer.  Otherwise, return NULL.  If PKEY is not NULL,
@@ -237,7 +253,9 @@ class Stringpool_template
 
   // Turn the stringpool into a string table: determine the offsets of
   // all the strings.  After this is called, no more strings may be
-  // added to the stringpool.
+  // added to the stringpool.  When optimizing a large pool with
+  // --threads, the sorting is split across threads; the string table
+  // is the same either way.
   void
   set_string_offsets();
 
@@ -326,6 +344,9 @@ class Stringpool_template
   is_suffix(const Stringpool_char* s1, size_t len1,
             const Stringpool_char* s2, size_t len2);
 
+  // A job to find suffixes in the sorted strings when optimizing.
+  class Find_suffixes_job;
+
   // The hash table key includes the string, the length of the string,
   // and the hash code for the string.  We put the hash code
   // explicitly into the key so that we can do a find()/insert()
@@ -353,6 +374,11 @@ class Stringpool_template
     Hashkey(const Stringpool_char* s, size_t len)
       : string(s), length(len), hash_code(string_hash(s, len))
     { }
+
+    // This constructor is for a hash code which was already computed.
+    Hashkey(const Stringpool_char* s, size_t len, size_t hash)
+      : string(s), length(len), hash_code(hash)
+    { }
   };
 
   // Hash function.  This is trivial, since we have already computed
@@ -30,6 +30,7 @@
 #include <utility>
 #include "demangle.h"
 
+#include "errors.h"
 #include "gc.h"
 #include "object.h"
 #include "dwarf_reader.h"
@@ -37,6 +38,7 @@
 #include "output.h"
 #include "target.h"
 #include "workqueue.h"
+#include "gold-threads.h"
 #include "symtab.h"
 #include "script.h"
 #include "plugin.h"
@@ -564,12 +566,18 @@ Symbol::set_undefined()
 
 Symbol_table::Symbol_table(unsigned int count,
                            const Version_script_info& version_script)
-  : saw_undefined_(0), offset_(0), table_(count), namepool_(),
+  : saw_undefined_(0), offset_(0), tables_(), may_defer_symbols_(false),
+    pending_symbols_(), pending_lock_(NULL), namepool_(),
     forwarders_(), commons_(), tls_commons_(), small_commons_(),
     large_commons_(), forced_locals_(), warnings_(),
     version_script_(version_script), gc_(NULL), icf_(NULL),
     target_symbols_()
 {
+  for (unsigned int i = 0; i < table_shard_count; ++i)
+    {
+      Symbol_table_type table(count / table_shard_count);
+      this->tables_[i].swap(table);
+    }
   namepool_.reserve(count);
 }
 
@@ -650,6 +658,8 @@ Symbol_table::gc_mark_undef_symbols(Layout* layout)
 void
 Symbol_table::gc_mark_symbol(Symbol* sym)
 {
+  Hold_optional_lock hl(this->pending_lock_);
+
   // Add the object and section to the work list.
   bool is_ordinary;
   unsigned int shndx = sym->shndx(&is_ordinary);
@@ -679,6 +689,7 @@ Symbol_table::make_forwarder(Symbol* from, Symbol* to)
 {
   gold_assert(from != to);
   gold_assert(!from->is_forwarder() && !to->is_forwarder());
+  Hold_optional_lock hl(this->pending_lock_);
   this->forwarders_[from] = to;
   from->set_forwarder();
 }
@@ -700,6 +711,8 @@ Symbol_table::resolve_forwards(const Symbol* from) const
 Symbol*
 Symbol_table::lookup(const char* name, const char* version) const
 {
+  gold_assert(this->pending_symbols_.empty());
+
   Stringpool::Key name_key;
   name = this->namepool_.find(name, &name_key);
   if (name == NULL)
@@ -714,8 +727,9 @@ Symbol_table::lookup(const char* name, const char* version) const
     }
 
   Symbol_table_key key(name_key, version_key);
-  Symbol_table::Symbol_table_type::const_iterator p = this->table_.find(key);
-  if (p == this->table_.end())
+  const Symbol_table_type& table(this->table_shard(name_key));
+  Symbol_table::Symbol_table_type::const_iterator p = table.find(key);
+  if (p == table.end())
     return NULL;
   return p->second;
 }
@@ -740,7 +754,7 @@ Symbol_table::resolve(Sized_symbol<size>* to, const Sized_symbol<size>* from)
   bool is_ordinary;
   unsigned int shndx = from->shndx(&is_ordinary);
   this->resolve(to, esym.sym(), shndx, is_ordinary, shndx, from->object(),
-		from->version(), true);
+		from->version(), true, NULL);
   if (from->in_reg())
     to->set_in_reg();
   if (from->in_dyn())
@@ -753,7 +767,7 @@ Symbol_table::resolve(Sized_symbol<size>* to, const Sized_symbol<size>* from)
 // by visibility.
 
 void
-Symbol_table::force_local(Symbol* sym)
+Symbol_table::force_local(Symbol* sym, Pending_symbol* pending)
 {
   if (!sym->is_defined() && !sym->is_common())
     return;
@@ -763,7 +777,10 @@ Symbol_table::force_local(Symbol* sym)
       return;
     }
   sym->set_is_forced_local();
-  this->forced_locals_.push_back(sym);
+  if (pending != NULL)
+    pending->forced_local = true;
+  else
+    this->forced_locals_.push_back(sym);
 }
 
 // Adjust NAME for wrapping, and update *NAME_KEY if necessary.  This
@@ -940,6 +957,26 @@ Symbol_table::add_from_object(Object* object,
 			      bool is_ordinary,
 			      unsigned int orig_st_shndx)
 {
+  this->prepare_symbol_name(object, &name, &name_key, &version, &version_key,
+			    orig_st_shndx);
+  return this->add_to_table(object, name, name_key, version, version_key,
+			    is_default_version, sym, st_shndx, is_ordinary,
+			    orig_st_shndx, NULL);
+}
+
+// Print a message if the symbol *PNAME is being traced, and adjust
+// *PNAME and the other arguments for --wrap.  This is the part of
+// add_from_object which may add to the name pool.
+
+void
+Symbol_table::prepare_symbol_name(Object* object, const char** pname,
+				  Stringpool::Key* pname_key,
+				  const char** pversion,
+				  Stringpool::Key* pversion_key,
+				  unsigned int orig_st_shndx)
+{
+  const char* name = *pname;
+
   // Print a message if this symbol is being traced.
   if (parameters->options().is_trace_symbol(name))
     {
@@ -954,7 +991,7 @@ Symbol_table::add_from_object(Object* object,
   if (orig_st_shndx == elfcpp::SHN_UNDEF
       && parameters->options().any_wrap())
     {
-      const char* wrap_name = this->wrap_symbol(name, &name_key);
+      const char* wrap_name = this->wrap_symbol(name, pname_key);
       if (wrap_name != name)
 	{
 	  // If we see a reference to malloc with version GLIBC_2.0,
@@ -962,25 +999,52 @@ Symbol_table::add_from_object(Object* object,
 	  // discard the version number.  Otherwise the user would be
 	  // required to specify the correct version for
 	  // __wrap_malloc.
-	  version = NULL;
-	  version_key = 0;
-	  name = wrap_name;
+	  *pversion = NULL;
+	  *pversion_key = 0;
+	  *pname = wrap_name;
 	}
     }
+}
+
+// Add a symbol to the symbol table, once its name has been prepared
+// by prepare_symbol_name.  This only looks at the shard of the
+// symbol table for NAME_KEY, so different shards may be done in
+// parallel.  In that case PENDING is not NULL, and the changes to
+// the lists of symbols, and any diagnostics, are recorded there
+// rather than made.
+
+template<int size, bool big_endian>
+Sized_symbol<size>*
+Symbol_table::add_to_table(Object* object,
+			   const char* name,
+			   Stringpool::Key name_key,
+			   const char* version,
+			   Stringpool::Key version_key,
+			   bool is_default_version,
+			   const elfcpp::Sym<size, big_endian>& sym,
+			   unsigned int st_shndx,
+			   bool is_ordinary,
+			   unsigned int orig_st_shndx,
+			   Pending_symbol* pending)
+{
+  Symbol_table_type& table(this->table_shard(name_key));
+
+  Deferred_diagnostics deferred;
+  Deferred_diagnostics* pdeferred = pending != NULL ? &deferred : NULL;
 
   Symbol* const snull = NULL;
   std::pair<typename Symbol_table_type::iterator, bool> ins =
-    this->table_.insert(std::make_pair(std::make_pair(name_key, version_key),
-				       snull));
+    table.insert(std::make_pair(std::make_pair(name_key, version_key),
+				snull));
 
   std::pair<typename Symbol_table_type::iterator, bool> insdefault =
-    std::make_pair(this->table_.end(), false);
+    std::make_pair(table.end(), false);
   if (is_default_version)
     {
       const Stringpool::Key vnull_key = 0;
-      insdefault = this->table_.insert(std::make_pair(std::make_pair(name_key,
-								     vnull_key),
-						      snull));
+      insdefault = table.insert(std::make_pair(std::make_pair(name_key,
+							      vnull_key),
+					       snull));
     }
 
   // ins.first: an iterator, which is a pointer to a pair.
@@ -1002,7 +1066,7 @@ Symbol_table::add_from_object(Object* object,
       was_common = ret->is_common() && ret->object()->pluginobj() == NULL;
 
       this->resolve(ret, sym, st_shndx, is_ordinary, orig_st_shndx, object,
-		    version, is_default_version);
+		    version, is_default_version, pdeferred);
       if (parameters->options().gc_sections())
         this->gc_mark_dyn_syms(ret);
 
@@ -1033,7 +1097,7 @@ Symbol_table::add_from_object(Object* object,
 	      // (See PR gold/18703.)
 	      ret->set_is_not_default();
 	      const Stringpool::Key vnull_key = 0;
-	      this->table_.erase(std::make_pair(name_key, vnull_key));
+	      table.erase(std::make_pair(name_key, vnull_key));
 	    }
 	}
     }
@@ -1053,7 +1117,7 @@ Symbol_table::add_from_object(Object* object,
 	  was_common = ret->is_common() && ret->object()->pluginobj() == NULL;
 
 	  this->resolve(ret, sym, st_shndx, is_ordinary, orig_st_shndx, object,
-			version, is_default_version);
+			version, is_default_version, pdeferred);
           if (parameters->options().gc_sections())
             this->gc_mark_dyn_syms(ret);
 	  ins.first->second = ret;
@@ -1076,13 +1140,12 @@ Symbol_table::add_from_object(Object* object,
 		  // This means that we don't want a symbol table
 		  // entry after all.
 		  if (!is_default_version)
-		    this->table_.erase(ins.first);
+		    table.erase(ins.first);
 		  else
 		    {
-		      this->table_.erase(insdefault.first);
+		      table.erase(insdefault.first);
 		      // Inserting INSDEFAULT invalidated INS.
-		      this->table_.erase(std::make_pair(name_key,
-							version_key));
+		      table.erase(std::make_pair(name_key, version_key));
 		    }
 		  return NULL;
 		}
@@ -1108,9 +1171,14 @@ Symbol_table::add_from_object(Object* object,
   // archive groups.
   if (!was_undefined && ret->is_undefined())
     {
-      ++this->saw_undefined_;
-      if (parameters->options().has_plugins())
-	parameters->options().plugins()->new_undefined_symbol(ret);
+      if (pending != NULL)
+	pending->saw_undefined = true;
+      else
+	{
+	  ++this->saw_undefined_;
+	  if (parameters->options().has_plugins())
+	    parameters->options().plugins()->new_undefined_symbol(ret);
+	}
     }
 
   // Keep track of common symbols, to speed up common symbol
@@ -1119,16 +1187,21 @@ Symbol_table::add_from_object(Object* object,
   // replacement file.
   if (!was_common && ret->is_common() && ret->object()->pluginobj() == NULL)
     {
+      Commons_type* commons;
       if (ret->type() == elfcpp::STT_TLS)
-	this->tls_commons_.push_back(ret);
+	commons = &this->tls_commons_;
       else if (!is_ordinary
 	       && st_shndx == parameters->target().small_common_shndx())
-	this->small_commons_.push_back(ret);
+	commons = &this->small_commons_;
       else if (!is_ordinary
 	       && st_shndx == parameters->target().large_common_shndx())
-	this->large_commons_.push_back(ret);
+	commons = &this->large_commons_;
+      else
+	commons = &this->commons_;
+      if (pending != NULL)
+	pending->commons = commons;
       else
-	this->commons_.push_back(ret);
+	commons->push_back(ret);
     }
 
   // If we're not doing a relocatable link, then any symbol with
@@ -1139,11 +1212,66 @@ Symbol_table::add_from_object(Object* object,
 	  || ret->binding() == elfcpp::STB_GNU_UNIQUE
 	  || ret->binding() == elfcpp::STB_WEAK)
       && !parameters->options().relocatable())
-    this->force_local(ret);
+    this->force_local(ret, pending);
+
+  if (!deferred.empty())
+    {
+      pending->diagnostics = new Deferred_diagnostics();
+      pending->diagnostics->swap(deferred);
+    }
 
   return ret;
 }
 
+// Compute the lengths and hash codes of the names of the external
+// symbols in SD.  This is called from read_symbols, which runs in
+// parallel for different objects, so that add_symbols, which must run
+// serially in command line order, only has to look up the names.
+
+template<int size, bool big_endian>
+void
+Symbol_table::hash_symbol_names(Read_symbols_data* sd, bool split_versions)
+{
+  gold_assert(sd->global_name_hashes.empty());
+  if (sd->symbols == NULL || sd->symbol_names == NULL)
+    return;
+
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+  size_t count = ((sd->symbols_size - sd->external_symbols_offset)
+		  / sym_size);
+  const unsigned char* p = (sd->symbols->data()
+			    + sd->external_symbols_offset);
+  const char* sym_names =
+    reinterpret_cast<const char*>(sd->symbol_names->data());
+  section_size_type sym_name_size = sd->symbol_names_size;
+
+  sd->global_name_hashes.resize(count);
+  for (size_t i = 0; i < count; ++i, p += sym_size)
+    {
+      Symbol_name_hash* h = &sd->global_name_hashes[i];
+      elfcpp::Sym<size, big_endian> sym(p);
+      unsigned int st_name = sym.get_st_name();
+      if (st_name >= sym_name_size)
+	{
+	  // The error is reported by add_from_relobj/add_from_dynobj.
+	  h->length = 0;
+	  h->hash_code = 0;
+	  continue;
+	}
+
+      const char* name = sym_names + st_name;
+      const char* ver = split_versions ? strchr(name, '@') : NULL;
+      h->length = ver != NULL ? ver - name : strlen(name);
+      h->hash_code = Stringpool::hash_string(name, h->length);
+    }
+}
+
+// The number of symbols add_from_relobj may queue before they are
+// added to the symbol table.  This bounds the memory used by the
+// queue.
+
+static const size_t max_pending_symbols = 1 << 20;
+
 // Add all the symbols in a relocatable object to the hash table.
 
 template<int size, bool big_endian>
@@ -1155,6 +1283,7 @@ Symbol_table::add_from_relobj(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     typename Sized_relobj_file<size, big_endian>::Symbols* sympointers,
     size_t* defined)
 {
@@ -1166,6 +1295,13 @@ Symbol_table::add_from_relobj(
 
   const bool just_symbols = relobj->just_symbols();
 
+  // The symbols may be queued, and added to the symbol table in
+  // parallel with those of the objects which follow.  Otherwise any
+  // symbols queued for earlier objects must be added first.
+  const bool defer = this->may_defer_symbols_ && this->can_defer_symbols();
+  if (!defer)
+    this->add_pending_symbols();
+
   const unsigned char* p = syms;
   for (size_t i = 0; i < count; ++i, p += sym_size)
     {
@@ -1213,8 +1349,17 @@ Symbol_table::add_from_relobj(
 
       // In an object file, an '@' in the name separates the symbol
       // name from the version name.  If there are two '@' characters,
-      // this is the default version.
-      const char* ver = strchr(name, '@');
+      // this is the default version.  If the names were hashed
+      // while reading the symbols, we already know where the '@'
+      // is, if any.
+      const char* ver;
+      if (name_hashes == NULL)
+	ver = strchr(name, '@');
+      else
+	{
+	  const char* end = name + name_hashes[i].length;
+	  ver = *end == '@' ? end : NULL;
+	}
       Stringpool::Key ver_key = 0;
       int namelen = 0;
       // IS_DEFAULT_VERSION: is the version default?
@@ -1247,7 +1392,9 @@ Symbol_table::add_from_relobj(
       // about a common symbol?
       else
 	{
-	  namelen = strlen(name);
+	  namelen = (name_hashes == NULL
+		     ? strlen(name)
+		     : name_hashes[i].length);
 	  if (!this->version_script_.empty()
 	      && st_shndx != elfcpp::SHN_UNDEF)
 	    {
@@ -1272,7 +1419,7 @@ Symbol_table::add_from_relobj(
 	    }
 	}
 
-      elfcpp::Sym<size, big_endian>* psym = &sym;
+      const unsigned char* psym = p;
       unsigned char symbuf[sym_size];
       elfcpp::Sym<size, big_endian> sym2(symbuf);
       if (just_symbols)
@@ -1294,7 +1441,7 @@ Symbol_table::add_from_relobj(
 	    }
 	  st_shndx = elfcpp::SHN_ABS;
 	  is_ordinary = false;
-	  psym = &sym2;
+	  psym = symbuf;
 	}
 
       // Fix up visibility if object has no-export set.
@@ -1302,10 +1449,10 @@ Symbol_table::add_from_relobj(
 	  && (orig_st_shndx != elfcpp::SHN_UNDEF || !is_ordinary))
         {
 	  // We may have copied symbol already above.
-	  if (psym != &sym2)
+	  if (psym != symbuf)
 	    {
 	      memcpy(symbuf, p, sym_size);
-	      psym = &sym2;
+	      psym = symbuf;
 	    }
 
 	  elfcpp::STV visibility = sym2.get_st_visibility();
@@ -1319,37 +1466,218 @@ Symbol_table::add_from_relobj(
         }
 
       Stringpool::Key name_key;
-      name = this->namepool_.add_with_length(name, namelen, true,
-					     &name_key);
+      if (name_hashes == NULL)
+	name = this->namepool_.add_with_length(name, namelen, true,
+					       &name_key);
+      else
+	name = this->namepool_.add_with_hash(name, namelen,
+					     name_hashes[i].hash_code,
+					     true, &name_key);
+
+      this->prepare_symbol_name(relobj, &name, &name_key, &ver, &ver_key,
+				orig_st_shndx);
+
+      Pending_symbol ps;
+      ps.object = relobj;
+      ps.name = name;
+      ps.name_key = name_key;
+      ps.version = ver;
+      ps.version_key = ver_key;
+      ps.psymbol = &(*sympointers)[i];
+      ps.st_shndx = st_shndx;
+      ps.orig_st_shndx = orig_st_shndx;
+      memcpy(ps.sym, psym, sym_size);
+      ps.is_ordinary = is_ordinary;
+      ps.is_default_version = is_default_version;
+      ps.is_forced_local = is_forced_local;
+      ps.is_defined_in_discarded_section = is_defined_in_discarded_section;
+      ps.saw_undefined = false;
+      ps.forced_local = false;
+      ps.commons = NULL;
+      ps.diagnostics = NULL;
+
+      if (defer)
+	this->pending_symbols_.push_back(ps);
+      else
+	this->add_pending_symbol<size, big_endian>(&ps, false);
+    }
 
-      Sized_symbol<size>* res;
-      res = this->add_from_object(relobj, name, name_key, ver, ver_key,
-				  is_default_version, *psym, st_shndx,
-				  is_ordinary, orig_st_shndx);
+  // Don't let the queue grow without bound.
+  if (this->pending_symbols_.size() >= max_pending_symbols)
+    this->add_pending_symbols();
+}
 
-      if (res == NULL)
-	continue;
-      
-      if (is_forced_local)
-	this->force_local(res);
+// Add the symbol PS from a relocatable object to the symbol table.
+// If IN_PARALLEL is true, other shards of the symbol table are being
+// done at the same time, and the changes to the lists of symbols are
+// recorded in PS for add_pending_symbols to make.
+
+template<int size, bool big_endian>
+void
+Symbol_table::add_pending_symbol(Pending_symbol* ps, bool in_parallel)
+{
+  Pending_symbol* pending = in_parallel ? ps : NULL;
+  elfcpp::Sym<size, big_endian> sym(ps->sym);
+  Sized_symbol<size>* res;
+  res = this->add_to_table(ps->object, ps->name, ps->name_key, ps->version,
+			   ps->version_key, ps->is_default_version, sym,
+			   ps->st_shndx, ps->is_ordinary, ps->orig_st_shndx,
+			   pending);
 
-      // Do not treat this symbol as garbage if this symbol will be
-      // exported to the dynamic symbol table.  This is true when
-      // building a shared library or using --export-dynamic and
-      // the symbol is externally visible.
-      if (parameters->options().gc_sections()
-	  && res->is_externally_visible()
-	  && !res->is_from_dynobj()
-          && (parameters->options().shared()
-	      || parameters->options().export_dynamic()
-	      || parameters->options().in_dynamic_list(res->name())))
-        this->gc_mark_symbol(res);
+  if (res == NULL)
+    return;
+
+  if (ps->is_forced_local)
+    this->force_local(res, pending);
+
+  // Do not treat this symbol as garbage if this symbol will be
+  // exported to the dynamic symbol table.  This is true when
+  // building a shared library or using --export-dynamic and
+  // the symbol is externally visible.
+  if (parameters->options().gc_sections()
+      && res->is_externally_visible()
+      && !res->is_from_dynobj()
+      && (parameters->options().shared()
+	  || parameters->options().export_dynamic()
+	  || parameters->options().in_dynamic_list(res->name())))
+    this->gc_mark_symbol(res);
+
+  if (ps->is_defined_in_discarded_section)
+    res->set_is_defined_in_discarded_section();
+
+  *ps->psymbol = res;
+}
 
-      if (is_defined_in_discarded_section)
-	res->set_is_defined_in_discarded_section();
+// Return whether add_from_relobj may queue symbols to be added
+// later.  Adding the symbols of one relocatable object after another
+// gives the same result as adding them one shard at a time, as long
+// as nothing looks at the symbol table in between and resolving a
+// symbol only touches symbols with the same name.  That is not so
+// for weak aliases from dynamic objects, and for the target and
+// plugin hooks.
+
+bool
+Symbol_table::can_defer_symbols() const
+{
+  return (parallel_job_threads() > 1
+	  && !parameters->options().relocatable()
+	  && !parameters->incremental()
+	  && !parameters->options().has_plugins()
+	  && !parameters->options().detect_odr_violations()
+	  && !parameters->target().has_make_symbol()
+	  && !parameters->target().has_resolve()
+	  && this->weak_aliases_.empty());
+}
 
-      (*sympointers)[i] = res;
+// Add the symbols of shards INDEX, INDEX + COUNT, ... which are
+// listed in SHARDS.
+
+template<int size, bool big_endian>
+class Symbol_table::Add_pending_job : public Parallel_job
+{
+ public:
+  Add_pending_job(Symbol_table* symtab,
+		  const std::vector<std::vector<size_t> >* shards)
+    : symtab_(symtab), shards_(shards)
+  { }
+
+  void
+  run_piece(int index, int count)
+  {
+    Pending_symbols& pending(this->symtab_->pending_symbols_);
+    for (size_t shard = index; shard < this->shards_->size(); shard += count)
+      {
+	const std::vector<size_t>& v((*this->shards_)[shard]);
+	for (std::vector<size_t>::const_iterator p = v.begin();
+	     p != v.end();
+	     ++p)
+	  this->symtab_->add_pending_symbol<size, big_endian>(&pending[*p],
+							      true);
+      }
+  }
+
+ private:
+  Symbol_table* symtab_;
+  const std::vector<std::vector<size_t> >* shards_;
+};
+
+// Add the symbols queued by add_from_relobj.  Each shard of the
+// symbol table gets its symbols in the order in which they were
+// queued, which is the order in which they would have been added
+// without the queue, so the result does not depend on how the
+// shards are spread over the threads.
+
+void
+Symbol_table::add_pending_symbols()
+{
+  if (this->pending_symbols_.empty())
+    return;
+
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+    case Parameters::TARGET_32_LITTLE:
+      this->sized_add_pending_symbols<32, false>();
+      break;
+#endif
+#ifdef HAVE_TARGET_32_BIG
+    case Parameters::TARGET_32_BIG:
+      this->sized_add_pending_symbols<32, true>();
+      break;
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+    case Parameters::TARGET_64_LITTLE:
+      this->sized_add_pending_symbols<64, false>();
+      break;
+#endif
+#ifdef HAVE_TARGET_64_BIG
+    case Parameters::TARGET_64_BIG:
+      this->sized_add_pending_symbols<64, true>();
+      break;
+#endif
+    default:
+      gold_unreachable();
+    }
+}
+
+template<int size, bool big_endian>
+void
+Symbol_table::sized_add_pending_symbols()
+{
+  std::vector<std::vector<size_t> > shards(table_shard_count);
+  for (size_t i = 0; i < this->pending_symbols_.size(); ++i)
+    {
+      const Pending_symbol& ps(this->pending_symbols_[i]);
+      shards[ps.name_key % table_shard_count].push_back(i);
+    }
+
+  Lock lock;
+  this->pending_lock_ = &lock;
+  Add_pending_job<size, big_endian> job(this, &shards);
+  run_parallel_job(&job, std::min(parallel_job_threads(),
+				  static_cast<int>(table_shard_count)));
+  this->pending_lock_ = NULL;
+
+  // Now update the lists of symbols, and issue the diagnostics, in
+  // the order in which the symbols were queued.
+  for (Pending_symbols::const_iterator p = this->pending_symbols_.begin();
+       p != this->pending_symbols_.end();
+       ++p)
+    {
+      if (p->saw_undefined)
+	++this->saw_undefined_;
+      if (p->commons != NULL)
+	p->commons->push_back(*p->psymbol);
+      if (p->forced_local)
+	this->forced_locals_.push_back(*p->psymbol);
+      if (p->diagnostics != NULL)
+	{
+	  p->diagnostics->issue();
+	  delete p->diagnostics;
+	}
     }
+
+  this->pending_symbols_.clear();
 }
 
 // Add a symbol from a plugin-claimed file.
@@ -1360,8 +1688,12 @@ Symbol_table::add_from_pluginobj(
     Sized_pluginobj<size, big_endian>* obj,
     const char* name,
     const char* ver,
+    const Symbol_name_hash* name_hash,
     elfcpp::Sym<size, big_endian>* sym)
 {
+  // Symbols queued for earlier objects must be added first.
+  this->add_pending_symbols();
+
   unsigned int st_shndx = sym->get_st_shndx();
   bool is_ordinary = st_shndx < elfcpp::SHN_LORESERVE;
 
@@ -1403,7 +1735,12 @@ Symbol_table::add_from_pluginobj(
     }
 
   Stringpool::Key name_key;
-  name = this->namepool_.add(name, true, &name_key);
+  if (name_hash == NULL)
+    name = this->namepool_.add(name, true, &name_key);
+  else
+    name = this->namepool_.add_with_hash(name, name_hash->length,
+					 name_hash->hash_code, true,
+					 &name_key);
 
   Sized_symbol<size>* res;
   res = this->add_from_object(obj, name, name_key, ver, ver_key,
@@ -1429,6 +1766,7 @@ Symbol_table::add_from_dynobj(
     size_t count,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     const unsigned char* versym,
     size_t versym_size,
     const std::vector<const char*>* version_map,
@@ -1439,6 +1777,10 @@ Symbol_table::add_from_dynobj(
 
   gold_assert(size == parameters->target().get_size());
 
+  // Symbols queued for earlier objects must be added first, so that
+  // they are resolved before the symbols of the dynamic object.
+  this->add_pending_symbols();
+
   if (dynobj->just_symbols())
     {
       gold_error(_("--just-symbols does not make sense with a shared object"));
@@ -1526,7 +1868,12 @@ Symbol_table::add_from_dynobj(
       if (versym == NULL)
 	{
 	  Stringpool::Key name_key;
-	  name = this->namepool_.add(name, true, &name_key);
+	  if (name_hashes == NULL)
+	    name = this->namepool_.add(name, true, &name_key);
+	  else
+	    name = this->namepool_.add_with_hash(name, name_hashes[i].length,
+						 name_hashes[i].hash_code,
+						 true, &name_key);
 	  res = this->add_from_object(dynobj, name, name_key, NULL, 0,
 				      false, *psym, st_shndx, is_ordinary,
 				      st_shndx);
@@ -1556,7 +1903,12 @@ Symbol_table::add_from_dynobj(
 
 	  // At this point we are definitely going to add this symbol.
 	  Stringpool::Key name_key;
-	  name = this->namepool_.add(name, true, &name_key);
+	  if (name_hashes == NULL)
+	    name = this->namepool_.add(name, true, &name_key);
+	  else
+	    name = this->namepool_.add_with_hash(name, name_hashes[i].length,
+						 name_hashes[i].hash_code,
+						 true, &name_key);
 
 	  if (v == static_cast<unsigned int>(elfcpp::VER_NDX_LOCAL)
 	      || v == static_cast<unsigned int>(elfcpp::VER_NDX_GLOBAL))
@@ -1645,6 +1997,9 @@ Symbol_table::add_from_incrobj(
     const char* ver,
     elfcpp::Sym<size, big_endian>* sym)
 {
+  // Symbols queued for earlier objects must be added first.
+  this->add_pending_symbols();
+
   unsigned int st_shndx = sym->get_st_shndx();
   bool is_ordinary = st_shndx < elfcpp::SHN_LORESERVE;
 
@@ -1764,6 +2119,8 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
   *resolve_oldsym = false;
   *poldsym = NULL;
 
+  gold_assert(this->pending_symbols_.empty());
+
   // If the caller didn't give us a version, see if we get one from
   // the version script.
   std::string v;
@@ -1787,9 +2144,9 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
   Sized_symbol<size>* sym;
 
   bool add_to_table = false;
-  typename Symbol_table_type::iterator add_loc = this->table_.end();
+  typename Symbol_table_type::iterator add_loc;
   bool add_def_to_table = false;
-  typename Symbol_table_type::iterator add_def_loc = this->table_.end();
+  typename Symbol_table_type::iterator add_def_loc;
 
   if (only_if_ref)
     {
@@ -1815,21 +2172,20 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
       if (*pversion != NULL)
 	*pversion = this->namepool_.add(*pversion, true, &version_key);
 
+      Symbol_table_type& table(this->table_shard(name_key));
       Symbol* const snull = NULL;
       std::pair<typename Symbol_table_type::iterator, bool> ins =
-	this->table_.insert(std::make_pair(std::make_pair(name_key,
-							  version_key),
-					   snull));
+	table.insert(std::make_pair(std::make_pair(name_key, version_key),
+				    snull));
 
       std::pair<typename Symbol_table_type::iterator, bool> insdefault =
-	std::make_pair(this->table_.end(), false);
+	std::make_pair(table.end(), false);
       if (is_default_version)
 	{
 	  const Stringpool::Key vnull = 0;
-	  insdefault =
-	    this->table_.insert(std::make_pair(std::make_pair(name_key,
-							      vnull),
-					       snull));
+	  insdefault = table.insert(std::make_pair(std::make_pair(name_key,
+								  vnull),
+						   snull));
 	}
 
       if (!ins.second)
@@ -2513,65 +2869,73 @@ Symbol_table::set_dynsym_indexes(unsigned int index,
   if (parameters->target().has_custom_set_dynsym_indexes())
     {
       std::vector<Symbol*> dyn_symbols;
-      for (Symbol_table_type::iterator p = this->table_.begin();
-           p != this->table_.end();
-           ++p)
-        {
-          Symbol* sym = p->second;
-          if (sym->is_forced_local())
-	    continue;
-          if (!sym->should_add_dynsym_entry(this))
-            sym->set_dynsym_index(-1U);
-          else
-            dyn_symbols.push_back(sym);
-        }
+      for (unsigned int i = 0; i < table_shard_count; ++i)
+	{
+	  Symbol_table_type& table(this->tables_[i]);
+	  for (Symbol_table_type::iterator p = table.begin();
+	       p != table.end();
+	       ++p)
+	    {
+	      Symbol* sym = p->second;
+	      if (sym->is_forced_local())
+		continue;
+	      if (!sym->should_add_dynsym_entry(this))
+		sym->set_dynsym_index(-1U);
+	      else
+		dyn_symbols.push_back(sym);
+	    }
+	}
 
       return parameters->target().set_dynsym_indexes(&dyn_symbols, index, syms,
                                                      dynpool, versions, this);
     }
 
-  for (Symbol_table_type::iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (unsigned int i = 0; i < table_shard_count; ++i)
     {
-      Symbol* sym = p->second;
-
-      if (sym->is_forced_local())
-        continue;
+      Symbol_table_type& table(this->tables_[i]);
+      for (Symbol_table_type::iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Symbol* sym = p->second;
 
-      // Note that SYM may already have a dynamic symbol index, since
-      // some symbols appear more than once in the symbol table, with
-      // and without a version.
+	  if (sym->is_forced_local())
+	    continue;
 
-      if (!sym->should_add_dynsym_entry(this))
-	sym->set_dynsym_index(-1U);
-      else if (!sym->has_dynsym_index())
-	{
-	  sym->set_dynsym_index(index);
-	  ++index;
-	  syms->push_back(sym);
-	  dynpool->add(sym->name(), false, NULL);
+	  // Note that SYM may already have a dynamic symbol index, since
+	  // some symbols appear more than once in the symbol table, with
+	  // and without a version.
 
-	  // If the symbol is defined in a dynamic object and is
-	  // referenced strongly in a regular object, then mark the
-	  // dynamic object as needed.  This is used to implement
-	  // --as-needed.
-	  if (sym->is_from_dynobj()
-	      && sym->in_reg()
-	      && !sym->is_undef_binding_weak())
-	    sym->object()->set_is_needed();
-
-	  // Record any version information, except those from
-	  // as-needed libraries not seen to be needed.  Note that the
-	  // is_needed state for such libraries can change in this loop.
-	  if (sym->version() != NULL)
+	  if (!sym->should_add_dynsym_entry(this))
+	    sym->set_dynsym_index(-1U);
+	  else if (!sym->has_dynsym_index())
 	    {
-	      if (!sym->is_from_dynobj()
-		  || !sym->object()->as_needed()
-		  || sym->object()->is_needed())
-		versions->record_version(this, dynpool, sym);
-	      else
-		as_needed_sym.push_back(sym);
+	      sym->set_dynsym_index(index);
+	      ++index;
+	      syms->push_back(sym);
+	      dynpool->add(sym->name(), false, NULL);
+
+	      // If the symbol is defined in a dynamic object and is
+	      // referenced strongly in a regular object, then mark the
+	      // dynamic object as needed.  This is used to implement
+	      // --as-needed.
+	      if (sym->is_from_dynobj()
+		  && sym->in_reg()
+		  && !sym->is_undef_binding_weak())
+		sym->object()->set_is_needed();
+
+	      // Record any version information, except those from
+	      // as-needed libraries not seen to be needed.  Note that the
+	      // is_needed state for such libraries can change in this loop.
+	      if (sym->version() != NULL)
+		{
+		  if (!sym->is_from_dynobj()
+		      || !sym->object()->as_needed()
+		      || sym->object()->is_needed())
+		    versions->record_version(this, dynpool, sym);
+		  else
+		    as_needed_sym.push_back(sym);
+		}
 	    }
 	}
     }
@@ -2705,13 +3069,17 @@ Symbol_table::sized_finalize(off_t off, Stringpool* pool,
     }
 
   // Now do all the remaining symbols.
-  for (Symbol_table_type::iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (unsigned int i = 0; i < table_shard_count; ++i)
     {
-      Symbol* sym = p->second;
-      if (this->sized_finalize_symbol<size>(sym))
-	this->add_to_final_symtab<size>(sym, pool, &index, &off);
+      Symbol_table_type& table(this->tables_[i]);
+      for (Symbol_table_type::iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Symbol* sym = p->second;
+	  if (this->sized_finalize_symbol<size>(sym))
+	    this->add_to_final_symtab<size>(sym, pool, &index, &off);
+	}
     }
 
   // Now do target-specific symbols.
@@ -3021,184 +3389,188 @@ Symbol_table::sized_write_globals(const Stringpool* sympool,
   else
     dynamic_view = of->get_output_view(this->dynamic_offset_, dynamic_size);
 
-  for (Symbol_table_type::const_iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (unsigned int i = 0; i < table_shard_count; ++i)
     {
-      Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
+      const Symbol_table_type& table(this->tables_[i]);
+      for (Symbol_table_type::const_iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
 
-      // Possibly warn about unresolved symbols in shared libraries.
-      this->warn_about_undefined_dynobj_symbol(sym);
+	  // Possibly warn about unresolved symbols in shared libraries.
+	  this->warn_about_undefined_dynobj_symbol(sym);
 
-      unsigned int sym_index = sym->symtab_index();
-      unsigned int dynsym_index;
-      if (dynamic_view == NULL)
-	dynsym_index = -1U;
-      else
-	dynsym_index = sym->dynsym_index();
+	  unsigned int sym_index = sym->symtab_index();
+	  unsigned int dynsym_index;
+	  if (dynamic_view == NULL)
+	    dynsym_index = -1U;
+	  else
+	    dynsym_index = sym->dynsym_index();
 
-      if (sym_index == -1U && dynsym_index == -1U)
-	{
-	  // This symbol is not included in the output file.
-	  continue;
-	}
+	  if (sym_index == -1U && dynsym_index == -1U)
+	    {
+	      // This symbol is not included in the output file.
+	      continue;
+	    }
 
-      unsigned int shndx;
-      typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
-      typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
-      elfcpp::STB binding = sym->binding();
-
-      // If --weak-unresolved-symbols is set, change binding of unresolved
-      // global symbols to STB_WEAK.
-      if (parameters->options().weak_unresolved_symbols()
-	  && binding == elfcpp::STB_GLOBAL
-	  && sym->is_undefined())
-	binding = elfcpp::STB_WEAK;
-
-      // If --no-gnu-unique is set, change STB_GNU_UNIQUE to STB_GLOBAL.
-      if (binding == elfcpp::STB_GNU_UNIQUE
-	  && !parameters->options().gnu_unique())
-	binding = elfcpp::STB_GLOBAL;
+	  unsigned int shndx;
+	  typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
+	  typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
+	  elfcpp::STB binding = sym->binding();
 
-      switch (sym->source())
-	{
-	case Symbol::FROM_OBJECT:
-	  {
-	    bool is_ordinary;
-	    unsigned int in_shndx = sym->shndx(&is_ordinary);
+	  // If --weak-unresolved-symbols is set, change binding of unresolved
+	  // global symbols to STB_WEAK.
+	  if (parameters->options().weak_unresolved_symbols()
+	      && binding == elfcpp::STB_GLOBAL
+	      && sym->is_undefined())
+	    binding = elfcpp::STB_WEAK;
 
-	    if (!is_ordinary
-		&& in_shndx != elfcpp::SHN_ABS
-		&& !Symbol::is_common_shndx(in_shndx))
-	      {
-		gold_error(_("%s: unsupported symbol section 0x%x"),
-			   sym->demangled_name().c_str(), in_shndx);
-		shndx = in_shndx;
-	      }
-	    else
+	  // If --no-gnu-unique is set, change STB_GNU_UNIQUE to STB_GLOBAL.
+	  if (binding == elfcpp::STB_GNU_UNIQUE
+	      && !parameters->options().gnu_unique())
+	    binding = elfcpp::STB_GLOBAL;
+
+	  switch (sym->source())
+	    {
+	    case Symbol::FROM_OBJECT:
 	      {
-		Object* symobj = sym->object();
-		if (symobj->is_dynamic())
+		bool is_ordinary;
+		unsigned int in_shndx = sym->shndx(&is_ordinary);
+
+		if (!is_ordinary
+		    && in_shndx != elfcpp::SHN_ABS
+		    && !Symbol::is_common_shndx(in_shndx))
 		  {
-		    if (sym->needs_dynsym_value())
-		      dynsym_value = target.dynsym_value(sym);
-		    shndx = elfcpp::SHN_UNDEF;
-		    if (sym->is_undef_binding_weak())
-		      binding = elfcpp::STB_WEAK;
-		    else
-		      binding = elfcpp::STB_GLOBAL;
+		    gold_error(_("%s: unsupported symbol section 0x%x"),
+			       sym->demangled_name().c_str(), in_shndx);
+		    shndx = in_shndx;
 		  }
-		else if (symobj->pluginobj() != NULL)
-		  shndx = elfcpp::SHN_UNDEF;
-		else if (in_shndx == elfcpp::SHN_UNDEF
-			 || (!is_ordinary
-			     && (in_shndx == elfcpp::SHN_ABS
-				 || Symbol::is_common_shndx(in_shndx))))
-		  shndx = in_shndx;
 		else
 		  {
-		    Relobj* relobj = static_cast<Relobj*>(symobj);
-		    Output_section* os = relobj->output_section(in_shndx);
-                    if (this->is_section_folded(relobj, in_shndx))
-                      {
-                        // This global symbol must be written out even though
-                        // it is folded.
-                        // Get the os of the section it is folded onto.
-                        Section_id folded =
-                             this->icf_->get_folded_section(relobj, in_shndx);
-                        gold_assert(folded.first !=NULL);
-                        Relobj* folded_obj = 
-                          reinterpret_cast<Relobj*>(folded.first);
-                        os = folded_obj->output_section(folded.second);  
-                        gold_assert(os != NULL);
-                      }
-		    gold_assert(os != NULL);
-		    shndx = os->out_shndx();
-
-		    if (shndx >= elfcpp::SHN_LORESERVE)
+		    Object* symobj = sym->object();
+		    if (symobj->is_dynamic())
 		      {
-			if (sym_index != -1U)
-			  symtab_xindex->add(sym_index, shndx);
-			if (dynsym_index != -1U)
-			  dynsym_xindex->add(dynsym_index, shndx);
-			shndx = elfcpp::SHN_XINDEX;
+			if (sym->needs_dynsym_value())
+			  dynsym_value = target.dynsym_value(sym);
+			shndx = elfcpp::SHN_UNDEF;
+			if (sym->is_undef_binding_weak())
+			  binding = elfcpp::STB_WEAK;
+			else
+			  binding = elfcpp::STB_GLOBAL;
+		      }
+		    else if (symobj->pluginobj() != NULL)
+		      shndx = elfcpp::SHN_UNDEF;
+		    else if (in_shndx == elfcpp::SHN_UNDEF
+			     || (!is_ordinary
+				 && (in_shndx == elfcpp::SHN_ABS
+				     || Symbol::is_common_shndx(in_shndx))))
+		      shndx = in_shndx;
+		    else
+		      {
+			Relobj* relobj = static_cast<Relobj*>(symobj);
+			Output_section* os = relobj->output_section(in_shndx);
+			if (this->is_section_folded(relobj, in_shndx))
+			  {
+			    // This global symbol must be written out even though
+			    // it is folded.
+			    // Get the os of the section it is folded onto.
+			    Section_id folded =
+				 this->icf_->get_folded_section(relobj, in_shndx);
+			    gold_assert(folded.first !=NULL);
+			    Relobj* folded_obj = 
+			      reinterpret_cast<Relobj*>(folded.first);
+			    os = folded_obj->output_section(folded.second);  
+			    gold_assert(os != NULL);
+			  }
+			gold_assert(os != NULL);
+			shndx = os->out_shndx();
+
+			if (shndx >= elfcpp::SHN_LORESERVE)
+			  {
+			    if (sym_index != -1U)
+			      symtab_xindex->add(sym_index, shndx);
+			    if (dynsym_index != -1U)
+			      dynsym_xindex->add(dynsym_index, shndx);
+			    shndx = elfcpp::SHN_XINDEX;
+			  }
+
+			// In object files symbol values are section
+			// relative.
+			if (parameters->options().relocatable())
+			  sym_value -= os->address();
 		      }
-
-		    // In object files symbol values are section
-		    // relative.
-		    if (parameters->options().relocatable())
-		      sym_value -= os->address();
 		  }
 	      }
-	  }
-	  break;
-
-	case Symbol::IN_OUTPUT_DATA:
-	  {
-	    Output_data* od = sym->output_data();
+	      break;
 
-	    shndx = od->out_shndx();
-	    if (shndx >= elfcpp::SHN_LORESERVE)
+	    case Symbol::IN_OUTPUT_DATA:
 	      {
-		if (sym_index != -1U)
-		  symtab_xindex->add(sym_index, shndx);
-		if (dynsym_index != -1U)
-		  dynsym_xindex->add(dynsym_index, shndx);
-		shndx = elfcpp::SHN_XINDEX;
+		Output_data* od = sym->output_data();
+
+		shndx = od->out_shndx();
+		if (shndx >= elfcpp::SHN_LORESERVE)
+		  {
+		    if (sym_index != -1U)
+		      symtab_xindex->add(sym_index, shndx);
+		    if (dynsym_index != -1U)
+		      dynsym_xindex->add(dynsym_index, shndx);
+		    shndx = elfcpp::SHN_XINDEX;
+		  }
+
+		// In object files symbol values are section
+		// relative.
+		if (parameters->options().relocatable())
+		  {
+		    Output_section* os = od->output_section();
+		    gold_assert(os != NULL);
+		    sym_value -= os->address();
+		  }
 	      }
+	      break;
 
-	    // In object files symbol values are section
-	    // relative.
-	    if (parameters->options().relocatable())
+	    case Symbol::IN_OUTPUT_SEGMENT:
 	      {
-		Output_section* os = od->output_section();
-		gold_assert(os != NULL);
-		sym_value -= os->address();
+		Output_segment* oseg = sym->output_segment();
+		Output_section* osect = oseg->first_section();
+		if (osect == NULL)
+		  shndx = elfcpp::SHN_ABS;
+		else
+		  shndx = osect->out_shndx();
 	      }
-	  }
-	  break;
+	      break;
 
-	case Symbol::IN_OUTPUT_SEGMENT:
-	  {
-	    Output_segment* oseg = sym->output_segment();
-	    Output_section* osect = oseg->first_section();
-	    if (osect == NULL)
+	    case Symbol::IS_CONSTANT:
 	      shndx = elfcpp::SHN_ABS;
-	    else
-	      shndx = osect->out_shndx();
-	  }
-	  break;
+	      break;
 
-	case Symbol::IS_CONSTANT:
-	  shndx = elfcpp::SHN_ABS;
-	  break;
+	    case Symbol::IS_UNDEFINED:
+	      shndx = elfcpp::SHN_UNDEF;
+	      break;
 
-	case Symbol::IS_UNDEFINED:
-	  shndx = elfcpp::SHN_UNDEF;
-	  break;
-
-	default:
-	  gold_unreachable();
-	}
+	    default:
+	      gold_unreachable();
+	    }
 
-      if (sym_index != -1U)
-	{
-	  sym_index -= first_global_index;
-	  gold_assert(sym_index < output_count);
-	  unsigned char* ps = psyms + (sym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
-						     binding, sympool, ps);
-	}
+	  if (sym_index != -1U)
+	    {
+	      sym_index -= first_global_index;
+	      gold_assert(sym_index < output_count);
+	      unsigned char* ps = psyms + (sym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
+							 binding, sympool, ps);
+	    }
 
-      if (dynsym_index != -1U)
-	{
-	  dynsym_index -= first_dynamic_global_index;
-	  gold_assert(dynsym_index < dynamic_count);
-	  unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
-						     binding, dynpool, pd);
-          // Allow a target to adjust dynamic symbol value.
-          parameters->target().adjust_dyn_symbol(sym, pd);
+	  if (dynsym_index != -1U)
+	    {
+	      dynsym_index -= first_dynamic_global_index;
+	      gold_assert(dynsym_index < dynamic_count);
+	      unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
+							 binding, dynpool, pd);
+	      // Allow a target to adjust dynamic symbol value.
+	      parameters->target().adjust_dyn_symbol(sym, pd);
+	    }
 	}
     }
 
@@ -3402,12 +3774,23 @@ Symbol_table::sized_write_section_symbol(const Output_section* os,
 void
 Symbol_table::print_stats() const
 {
+  size_t entries = 0;
+#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
+  size_t buckets = 0;
+#endif
+  for (unsigned int i = 0; i < table_shard_count; ++i)
+    {
+      entries += this->tables_[i].size();
+#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
+      buckets += this->tables_[i].bucket_count();
+#endif
+    }
 #if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
   fprintf(stderr, _("%s: symbol table entries: %zu; buckets: %zu\n"),
-	  program_name, this->table_.size(), this->table_.bucket_count());
+	  program_name, entries, buckets);
 #else
   fprintf(stderr, _("%s: symbol table entries: %zu\n"),
-	  program_name, this->table_.size());
+	  program_name, entries);
 #endif
   this->namepool_.print_stats("symbol table stringpool");
 }
@@ -3659,6 +4042,13 @@ void
 Sized_symbol<64>::allocate_common(Output_data*, Value_type);
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+void
+Symbol_table::hash_symbol_names<32, false>(Read_symbols_data* sd,
+					  bool split_versions);
+#endif
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 void
@@ -3669,10 +4059,18 @@ Symbol_table::add_from_relobj<32, false>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<32, false>::Symbols* sympointers,
     size_t* defined);
 #endif
 
+#ifdef HAVE_TARGET_32_BIG
+template
+void
+Symbol_table::hash_symbol_names<32, true>(Read_symbols_data* sd,
+					  bool split_versions);
+#endif
+
 #ifdef HAVE_TARGET_32_BIG
 template
 void
@@ -3683,10 +4081,18 @@ Symbol_table::add_from_relobj<32, true>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<32, true>::Symbols* sympointers,
     size_t* defined);
 #endif
 
+#ifdef HAVE_TARGET_64_LITTLE
+template
+void
+Symbol_table::hash_symbol_names<64, false>(Read_symbols_data* sd,
+					  bool split_versions);
+#endif
+
 #ifdef HAVE_TARGET_64_LITTLE
 template
 void
@@ -3697,10 +4103,18 @@ Symbol_table::add_from_relobj<64, false>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<64, false>::Symbols* sympointers,
     size_t* defined);
 #endif
 
+#ifdef HAVE_TARGET_64_BIG
+template
+void
+Symbol_table::hash_symbol_names<64, true>(Read_symbols_data* sd,
+					  bool split_versions);
+#endif
+
 #ifdef HAVE_TARGET_64_BIG
 template
 void
@@ -3711,6 +4125,7 @@ Symbol_table::add_from_relobj<64, true>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<64, true>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3722,6 +4137,7 @@ Symbol_table::add_from_pluginobj<32, false>(
     Sized_pluginobj<32, false>* obj,
     const char* name,
     const char* ver,
+    const Symbol_name_hash* name_hash,
     elfcpp::Sym<32, false>* sym);
 #endif
 
@@ -3732,6 +4148,7 @@ Symbol_table::add_from_pluginobj<32, true>(
     Sized_pluginobj<32, true>* obj,
     const char* name,
     const char* ver,
+    const Symbol_name_hash* name_hash,
     elfcpp::Sym<32, true>* sym);
 #endif
 
@@ -3742,6 +4159,7 @@ Symbol_table::add_from_pluginobj<64, false>(
     Sized_pluginobj<64, false>* obj,
     const char* name,
     const char* ver,
+    const Symbol_name_hash* name_hash,
     elfcpp::Sym<64, false>* sym);
 #endif
 
@@ -3752,6 +4170,7 @@ Symbol_table::add_from_pluginobj<64, true>(
     Sized_pluginobj<64, true>* obj,
     const char* name,
     const char* ver,
+    const Symbol_name_hash* name_hash,
     elfcpp::Sym<64, true>* sym);
 #endif
 
@@ -3764,6 +4183,7 @@ Symbol_table::add_from_dynobj<32, false>(
     size_t count,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     const unsigned char* versym,
     size_t versym_size,
     const std::vector<const char*>* version_map,
@@ -3780,6 +4200,7 @@ Symbol_table::add_from_dynobj<32, true>(
     size_t count,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     const unsigned char* versym,
     size_t versym_size,
     const std::vector<const char*>* version_map,
@@ -3796,6 +4217,7 @@ Symbol_table::add_from_dynobj<64, false>(
     size_t count,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     const unsigned char* versym,
     size_t versym_size,
     const std::vector<const char*>* version_map,
@@ -3812,6 +4234,7 @@ Symbol_table::add_from_dynobj<64, true>(
     size_t count,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     const unsigned char* versym,
     size_t versym_size,
     const std::vector<const char*>* version_map,
@@ -60,6 +60,8 @@ class Output_file;
 class Output_symtab_xindex;
 class Garbage_collection;
 class Icf;
+class Lock;
+class Deferred_diagnostics;
 
 // The base class of an entry in the symbol table.  The symbol table
 // can have a lot of entries, so we don't want this class too big.
@@ -1415,10 +1417,20 @@ class Symbol_table
   inline void
   gc_mark_dyn_syms(Symbol* sym);
 
+  // Fill in SD->global_name_hashes with the length and hash code of
+  // the name of each external symbol in SD.  If SPLIT_VERSIONS is
+  // true, the length stops at an '@' character, as in a relocatable
+  // object.  This does not touch the symbol table, so it may be
+  // called while reading symbols in parallel.
+  template<int size, bool big_endian>
+  static void
+  hash_symbol_names(Read_symbols_data* sd, bool split_versions);
+
   // Add COUNT external symbols from the relocatable object RELOBJ to
   // the symbol table.  SYMS is the symbols, SYMNDX_OFFSET is the
   // offset in the symbol table of the first symbol, SYM_NAMES is
-  // their names, SYM_NAME_SIZE is the size of SYM_NAMES.  This sets
+  // their names, SYM_NAME_SIZE is the size of SYM_NAMES.  NAME_HASHES
+  // is NULL or the result of hash_symbol_names.  This sets
   // SYMPOINTERS to point to the symbols in the symbol table.  It sets
   // *DEFINED to the number of defined symbols.
   template<int size, bool big_endian>
@@ -1426,27 +1438,46 @@ class Symbol_table
   add_from_relobj(Sized_relobj_file<size, big_endian>* relobj,
 		  const unsigned char* syms, size_t count,
 		  size_t symndx_offset, const char* sym_names,
-		  size_t sym_name_size,
+		  size_t sym_name_size, const Symbol_name_hash* name_hashes,
 		  typename Sized_relobj_file<size, big_endian>::Symbols*,
 		  size_t* defined);
 
+  // Set whether add_from_relobj may queue the symbols it is given,
+  // rather than adding them to the symbol table at once.  Queued
+  // symbols are added by add_pending_symbols, which resolves the
+  // symbols of several objects in parallel.  This is only done when
+  // using more than one thread.
+  void
+  set_may_defer_symbols(bool may_defer)
+  { this->may_defer_symbols_ = may_defer; }
+
+  // Add the symbols queued by add_from_relobj to the symbol table.
+  // This must be called before anything looks at the symbol table.
+  void
+  add_pending_symbols();
+
   // Add one external symbol from the plugin object OBJ to the symbol table.
+  // NAME_HASH is NULL or the length and hash code of NAME, computed
+  // by Pluginobj::hash_symbol_names.
   // Returns a pointer to the resolved symbol in the symbol table.
   template<int size, bool big_endian>
   Symbol*
   add_from_pluginobj(Sized_pluginobj<size, big_endian>* obj,
                      const char* name, const char* ver,
+                     const Symbol_name_hash* name_hash,
                      elfcpp::Sym<size, big_endian>* sym);
 
   // Add COUNT dynamic symbols from the dynamic object DYNOBJ to the
   // symbol table.  SYMS is the symbols.  SYM_NAMES is their names.
-  // SYM_NAME_SIZE is the size of SYM_NAMES.  The other parameters are
+  // SYM_NAME_SIZE is the size of SYM_NAMES.  NAME_HASHES is NULL or
+  // the result of hash_symbol_names.  The other parameters are
   // symbol version data.
   template<int size, bool big_endian>
   void
   add_from_dynobj(Sized_dynobj<size, big_endian>* dynobj,
 		  const unsigned char* syms, size_t count,
 		  const char* sym_names, size_t sym_name_size,
+		  const Symbol_name_hash* name_hashes,
 		  const unsigned char* versym, size_t versym_size,
 		  const std::vector<const char*>*,
 		  typename Sized_relobj_file<size, big_endian>::Symbols*,
@@ -1532,7 +1563,10 @@ class Symbol_table
   // Return the count of undefined symbols seen.
   size_t
   saw_undefined() const
-  { return this->saw_undefined_; }
+  {
+    gold_assert(this->pending_symbols_.empty());
+    return this->saw_undefined_;
+  }
 
   // Allocate the common symbols
   void
@@ -1647,12 +1681,17 @@ class Symbol_table
   void
   for_all_symbols(F f) const
   {
-    for (Symbol_table_type::const_iterator p = this->table_.begin();
-         p != this->table_.end();
-         ++p)
+    for (unsigned int i = 0; i < table_shard_count; ++i)
       {
-	Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
-	f(sym);
+	const Symbol_table_type& table(this->tables_[i]);
+	for (Symbol_table_type::const_iterator p = table.begin();
+	     p != table.end();
+	     ++p)
+	  {
+	    Sized_symbol<size>* sym =
+	      static_cast<Sized_symbol<size>*>(p->second);
+	    f(sym);
+	  }
       }
   }
 
@@ -1695,6 +1734,75 @@ class Symbol_table
   typedef Unordered_map<Symbol_table_key, Symbol*, Symbol_table_hash,
 			Symbol_table_eq> Symbol_table_type;
 
+  // The symbol hash table is split into this many shards, chosen by
+  // the Stringpool key of the symbol name, so that all versions of a
+  // name are in the same shard.  Symbols in different shards can be
+  // added in parallel.  This does not depend on the number of
+  // threads, so that the output does not either.
+  static const unsigned int table_shard_count = 16;
+
+  // A global symbol from a relocatable object, ready to be added to
+  // the symbol table.  add_from_relobj may queue these to be added
+  // later by add_pending_symbols.
+  struct Pending_symbol
+  {
+    // The object which defines or refers to the symbol.
+    Object* object;
+    // The canonicalized name and version, and their Stringpool keys.
+    const char* name;
+    Stringpool::Key name_key;
+    const char* version;
+    Stringpool::Key version_key;
+    // Where to store the symbol table entry.
+    Symbol** psymbol;
+    // The section indexes to pass to add_from_object.
+    unsigned int st_shndx;
+    unsigned int orig_st_shndx;
+    // The ELF symbol.
+    unsigned char sym[elfcpp::Elf_sizes<64>::sym_size];
+    bool is_ordinary : 1;
+    bool is_default_version : 1;
+    // Whether the version script makes the symbol local.
+    bool is_forced_local : 1;
+    bool is_defined_in_discarded_section : 1;
+    // The following are set when the symbol is added in parallel
+    // with other symbols, and the lists are updated afterward in
+    // order: whether this is a new undefined symbol, whether the
+    // symbol was forced local, and the list of common symbols to
+    // add it to, if any.
+    bool saw_undefined : 1;
+    bool forced_local : 1;
+    Commons_type* commons;
+    // Likewise, the diagnostics from resolving the symbol, if any,
+    // which are issued afterward in order.
+    Deferred_diagnostics* diagnostics;
+  };
+
+  typedef std::vector<Pending_symbol> Pending_symbols;
+
+  // Add the pending symbols in some of the shards.
+  template<int size, bool big_endian>
+  class Add_pending_job;
+
+  // Return the shard of the symbol table which holds the symbols
+  // whose name has the Stringpool key NAME_KEY.
+  Symbol_table_type&
+  table_shard(Stringpool::Key name_key)
+  { return this->tables_[name_key % table_shard_count]; }
+
+  const Symbol_table_type&
+  table_shard(Stringpool::Key name_key) const
+  { return this->tables_[name_key % table_shard_count]; }
+
+  // Return whether add_from_relobj may queue symbols now.
+  bool
+  can_defer_symbols() const;
+
+  // Add the queued symbols, specialized for size and endianness.
+  template<int size, bool big_endian>
+  void
+  sized_add_pending_symbols();
+
   // A map from symbol name (as a pointer into the namepool) to all
   // the locations the symbols is (weakly) defined (and certain other
   // conditions are met).  This map will be used later to detect
@@ -1722,13 +1830,38 @@ class Symbol_table
 		  unsigned int st_shndx, bool is_ordinary,
 		  unsigned int orig_st_shndx);
 
+  // Trace a symbol being added, and adjust its name for --wrap.
+  void
+  prepare_symbol_name(Object*, const char** pname,
+		      Stringpool::Key* pname_key, const char** pversion,
+		      Stringpool::Key* pversion_key,
+		      unsigned int orig_st_shndx);
+
+  // Add a symbol whose name has been prepared.  If PENDING is not
+  // NULL, this is running in parallel with other shards, and the
+  // lists of symbols are not updated but recorded in PENDING.
+  template<int size, bool big_endian>
+  Sized_symbol<size>*
+  add_to_table(Object*, const char* name, Stringpool::Key name_key,
+	       const char* version, Stringpool::Key version_key,
+	       bool def, const elfcpp::Sym<size, big_endian>& sym,
+	       unsigned int st_shndx, bool is_ordinary,
+	       unsigned int orig_st_shndx, Pending_symbol* pending);
+
+  // Add a symbol from a relocatable object.  IN_PARALLEL is true if
+  // this is running in parallel with other shards.
+  template<int size, bool big_endian>
+  void
+  add_pending_symbol(Pending_symbol*, bool in_parallel);
+
   // Define a default symbol.
   template<int size, bool big_endian>
   void
   define_default_version(Sized_symbol<size>*, bool,
 			 Symbol_table_type::iterator);
 
-  // Resolve symbols.
+  // Resolve symbols.  If DEFERRED is not NULL, diagnostics are
+  // recorded there rather than issued.
   template<int size, bool big_endian>
   void
   resolve(Sized_symbol<size>* to,
@@ -1736,7 +1869,7 @@ class Symbol_table
 	  unsigned int st_shndx, bool is_ordinary,
 	  unsigned int orig_st_shndx,
 	  Object*, const char* version,
-	  bool is_default_version);
+	  bool is_default_version, Deferred_diagnostics* deferred);
 
   template<int size, bool big_endian>
   void
@@ -1745,7 +1878,13 @@ class Symbol_table
   // Record that a symbol is forced to be local by a version script or
   // by visibility.
   void
-  force_local(Symbol*);
+  force_local(Symbol* sym)
+  { this->force_local(sym, NULL); }
+
+  // Likewise, but if PENDING is not NULL, only record in PENDING that
+  // the symbol must be added to the list of forced local symbols.
+  void
+  force_local(Symbol*, Pending_symbol* pending);
 
   // Adjust NAME and *NAME_KEY for wrapping.
   const char*
@@ -1755,12 +1894,14 @@ class Symbol_table
   // resolve.cc.
   static bool
   should_override(const Symbol*, unsigned int, elfcpp::STT, Defined,
-		  Object*, bool*, bool*, bool);
+		  Object*, bool*, bool*, bool, Deferred_diagnostics*);
 
-  // Report a problem in symbol resolution.
+  // Report a problem in symbol resolution, or record it in DEFERRED
+  // if that is not NULL.
   static void
   report_resolve_problem(bool is_error, const char* msg, const Symbol* to,
-			 Defined, Object* object);
+			 Defined, Object* object,
+			 Deferred_diagnostics* deferred);
 
   // Override a symbol.
   template<int size, bool big_endian>
@@ -1935,8 +2076,15 @@ class Symbol_table
   // The number of global dynamic symbols (including forced-local symbols),
   // or 0 if none.
   unsigned int dynamic_count_;
-  // The symbol hash table.
-  Symbol_table_type table_;
+  // The shards of the symbol hash table.
+  Symbol_table_type tables_[table_shard_count];
+  // Whether add_from_relobj may queue symbols.
+  bool may_defer_symbols_;
+  // Symbols queued by add_from_relobj, in the order they were seen.
+  Pending_symbols pending_symbols_;
+  // While pending symbols are added in parallel, a lock for the
+  // data shared between shards; otherwise NULL.
+  Lock* pending_lock_;
   // A pool of symbol names.  This is used for all global symbols.
   // Entries in the hash table point into this pool.
   Stringpool namepool_;
@@ -0,0 +1,26 @@
+/* build_id_test.c -- test --build-id
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This file is compiled with different values of BUILD_ID_TEST_VALUE,
+   giving objects which differ in a single byte of data.  The build
+   IDs of programs linked with them must differ.  */
+
+int build_id_test_value = BUILD_ID_TEST_VALUE;
@@ -0,0 +1,170 @@
+#!/bin/sh
+
+# build_id_test.sh -- test --build-id=fast and --build-id=tree.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# build_id_test_fast_1 and build_id_test_fast_2 are linked from the
+# same objects with --build-id=fast, and build_id_test_fast_3 with one
+# object changed.  build_id_test_tree_1 and build_id_test_tree_2 are
+# linked with small tree hash chunks, without and with threads, so
+# that chunks are hashed while the output is written.
+# build_id_test_tree_3 and build_id_test_tree_4 are linked the same way
+# with threads from objects which differ in a single byte, as are
+# build_id_test_fast_4, build_id_test_fast_6 and, with
+# --output-writeback, build_id_test_fast_5.
+
+# Every tree ID is compared with one computed here from the finished
+# file, which is what gold would get if it hashed no chunk early: the
+# SHA-1 of the MD5 digests of the 4096 byte chunks of the file, with
+# the build ID note descriptor zeroed.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# Print the build ID of file $1.
+build_id()
+{
+    awk -v file="$1" '
+/^File: / { cur = $2; }
+/Build ID: / { if (cur == file) print $NF; }' build_id_test.stdout
+}
+
+# Print the --build-id=tree ID of file $1, computed from its contents.
+tree_id()
+{
+    off=`awk -v file="$1" '
+/^File: / { cur = $2; }
+/\.note\.gnu\.build-id/ {
+  if (cur == file)
+    for (i = 1; i < NF; i++)
+      if ($i == ".note.gnu.build-id")
+	print $(i + 3);
+}' build_id_test.stdout`
+    if test -z "$off"
+    then
+	return
+    fi
+    rm -rf $1.chunks
+    mkdir $1.chunks
+    cp $1 $1.chunks/file
+    # The descriptor follows the 12 byte note header and "GNU\0".
+    dd if=/dev/zero of=$1.chunks/file bs=1 seek=`expr \`printf '%d' 0x$off\` + 16` \
+	count=20 conv=notrunc 2> /dev/null
+    (cd $1.chunks && split -b 4096 file chunk.)
+    for c in $1.chunks/chunk.*
+    do
+	md5sum < $c
+    done | LC_ALL=C awk '
+{
+  for (i = 1; i < 32; i += 2)
+    printf "%c", (index("0123456789abcdef", substr($1, i, 1)) - 1) * 16 \
+		  + index("0123456789abcdef", substr($1, i + 1, 1)) - 1;
+}' | sha1sum | awk '{ print $1; }'
+    rm -rf $1.chunks
+}
+
+fast_1=`build_id build_id_test_fast_1`
+fast_2=`build_id build_id_test_fast_2`
+fast_3=`build_id build_id_test_fast_3`
+tree_1=`build_id build_id_test_tree_1`
+tree_2=`build_id build_id_test_tree_2`
+fast_4=`build_id build_id_test_fast_4`
+fast_5=`build_id build_id_test_fast_5`
+fast_6=`build_id build_id_test_fast_6`
+tree_3=`build_id build_id_test_tree_3`
+tree_4=`build_id build_id_test_tree_4`
+
+if ! expr "$fast_1" : '[0-9a-f]\{32\}$' > /dev/null
+then
+    echo "Bad --build-id=fast ID: $fast_1"
+    exit 1
+fi
+
+if test "$fast_1" != "$fast_2"
+then
+    echo "--build-id=fast IDs of identical links differ:"
+    echo "   $fast_1"
+    echo "   $fast_2"
+    exit 1
+fi
+
+if test "$fast_1" = "$fast_3"
+then
+    echo "--build-id=fast IDs of different links are the same: $fast_1"
+    exit 1
+fi
+
+if test -z "$tree_1" || test "$tree_1" != "$tree_2"
+then
+    echo "--build-id=tree IDs differ with threads:"
+    echo "   $tree_1"
+    echo "   $tree_2"
+    exit 1
+fi
+
+if test "$fast_4" != "$fast_5"
+then
+    echo "--build-id=fast IDs differ with --output-writeback:"
+    echo "   $fast_4"
+    echo "   $fast_5"
+    exit 1
+fi
+
+if test "$fast_4" = "$fast_6"
+then
+    echo "--build-id=fast IDs of links differing in one byte are the same: $fast_4"
+    exit 1
+fi
+
+if test -z "$tree_3" || test "$tree_3" = "$tree_4"
+then
+    echo "--build-id=tree IDs of links differing in one byte are the same: $tree_3"
+    exit 1
+fi
+
+for f in build_id_test_tree_1 build_id_test_tree_2 \
+    build_id_test_tree_3 build_id_test_tree_4
+do
+    id=`build_id $f`
+    ref=`tree_id $f`
+    if test -z "$ref" || test "$id" != "$ref"
+    then
+	echo "--build-id=tree ID of $f is not the hash of the file:"
+	echo "   $id"
+	echo "   $ref"
+	exit 1
+    fi
+done
+
+check build_id_test_fast_5.err "build ID chunks hashed while writing: [1-9]"
+check build_id_test_tree_2.err "build ID chunks hashed while writing: [1-9]"
+
+exit 0
@@ -0,0 +1,71 @@
+/* call_graph_order_test.c -- test --call-graph-ordering-file
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   The functions are defined so that the hot ones are separated by
+   cold ones in the source.  The profile in call_graph_order_test.txt
+   makes main, hot_caller and hot_callee one cluster, and cold_1 and
+   cold_2 a second, less dense one.  */
+
+int cold_1 (int) __attribute__ ((noinline));
+int hot_callee (int) __attribute__ ((noinline));
+int cold_2 (int) __attribute__ ((noinline));
+int hot_caller (int) __attribute__ ((noinline));
+int cold_3 (int) __attribute__ ((noinline));
+
+int
+cold_1 (int i)
+{
+  return cold_2 (i) + 1;
+}
+
+int
+hot_callee (int i)
+{
+  return i * 2;
+}
+
+int
+cold_2 (int i)
+{
+  return i - 1;
+}
+
+int
+hot_caller (int i)
+{
+  return hot_callee (i) + 3;
+}
+
+int
+cold_3 (int i)
+{
+  return i + 5;
+}
+
+int
+main (void)
+{
+  int i, sum = 0;
+
+  for (i = 0; i < 10; ++i)
+    sum += hot_caller (i);
+  return sum == 120 && cold_1 (1) == 1 && cold_3 (0) == 5 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#!/bin/sh
+
+# call_graph_order_test.sh -- test --call-graph-ordering-file.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with call_graph_order_test.c and
+# call_graph_order_test.txt.  The functions in the hot cluster must be
+# placed together, in call order, and be followed by the cold cluster.
+# cold_3 is not in the profile, so it must not come between them.
+# --stats must report both clusters.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# Print the functions of the test in address order.
+order=`grep -E ' T (main|hot_caller|hot_callee|cold_[123])$' \
+	call_graph_order_test.stdout | awk '{ print $3 }' | tr '\n' ' '`
+
+expected="main hot_caller hot_callee cold_1 cold_2 "
+case "$order" in
+*"$expected"*) ;;
+*)
+    echo "Wrong function order in call_graph_order_test:"
+    echo "   expected: $expected"
+    echo "   actual:   $order"
+    exit 1
+    ;;
+esac
+
+check call_graph_order_test.err "call graph ordered sections: 5 in 2 clusters"
+check call_graph_order_test.err "call graph hot text size: [1-9][0-9]* bytes"
+
+exit 0
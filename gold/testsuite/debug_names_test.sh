@@ -0,0 +1,78 @@
+#!/bin/sh
+
+# debug_names_test.sh -- test merging .debug_names sections
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# debug_names_test_1.s and debug_names_test_2.s each have a name
+# index for their compilation unit, with four names of which two are
+# in both.  By default gold merges them into a single name index for
+# two compilation units with six names; with --no-merge-debug-names
+# the two name indexes are concatenated.
+
+# Print the little-endian 32-bit word HEX as a number.
+word()
+{
+  echo $((0x`echo "$1" | sed -e 's/\(..\)\(..\)\(..\)\(..\)/\4\3\2\1/'`))
+}
+
+# Check the first name index in the .debug_names dump of FILE.  It
+# must have CUS compilation units and NAMES names, and the section
+# must hold only that name index if SINGLE is yes.
+check()
+{
+  file=$1
+  cus=$2
+  names=$3
+  single=$4
+
+  size=`sed -n -e 's/.*\.debug_names *PROGBITS *[0-9a-f]* [0-9a-f]* \([0-9a-f]*\) .*/\1/p' $file`
+  if test -z "$size"; then
+    echo "no .debug_names section in $file"
+    exit 1
+  fi
+  size=$((0x$size))
+
+  length=`word \`awk '$1 == "0x00000000" { print $2 }' $file\``
+  cu_count=`word \`awk '$1 == "0x00000000" { print $4 }' $file\``
+  name_count=`word \`awk '$1 == "0x00000010" { print $4 }' $file\``
+
+  if test "$cu_count" != "$cus"; then
+    echo "$file: expected $cus compilation units, found $cu_count"
+    exit 1
+  fi
+  if test "$name_count" != "$names"; then
+    echo "$file: expected $names names, found $name_count"
+    exit 1
+  fi
+  if test "$single" = "yes" -a $((length + 4)) -ne $size; then
+    echo "$file: expected a single name index of $size bytes"
+    exit 1
+  fi
+  if test "$single" = "no" -a $((length + 4)) -ge $size; then
+    echo "$file: expected more than one name index"
+    exit 1
+  fi
+}
+
+check debug_names_test.stdout 2 6 yes
+check debug_names_test_nomerge.stdout 1 4 no
+
+exit 0
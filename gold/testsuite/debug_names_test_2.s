@@ -0,0 +1,203 @@
+# A compilation unit with a DWARF 5 name index, as a compiler would
+# emit it for:
+#   int var_2 = 1;
+#   static int helper (void) { return var_2; }
+#   int func_2 (void) { return helper (); }
+# The names "helper" and "int" are in debug_names_test_1.s as well.
+
+	.text
+	.type	helper, @function
+helper:
+.Lhelper_begin:
+	movl	var_2(%rip), %eax
+	ret
+.Lhelper_end:
+	.size	helper, .-helper
+
+	.globl	func_2
+	.type	func_2, @function
+func_2:
+.Lfunc_2_begin:
+	call	helper
+	ret
+.Lfunc_2_end:
+	.size	func_2, .-func_2
+
+	.data
+	.globl	var_2
+	.type	var_2, @object
+	.size	var_2, 4
+var_2:
+	.long	2
+
+	.section	.debug_info,"",@progbits
+.Lcu_begin:
+	.long	.Lcu_end - .Lcu_version		# unit_length
+.Lcu_version:
+	.value	4				# version
+	.long	.Labbrev_begin			# debug_abbrev_offset
+	.byte	8				# address_size
+	.uleb128 1				# DW_TAG_compile_unit
+	.string	"debug_names_test_2.c"		# DW_AT_name
+	.byte	0xc				# DW_AT_language: DW_LANG_C99
+	.quad	.Lhelper_begin			# DW_AT_low_pc
+	.quad	.Lfunc_2_end - .Lhelper_begin	# DW_AT_high_pc
+.Ldie_int:
+	.uleb128 2				# DW_TAG_base_type
+	.long	.Lstr_int			# DW_AT_name
+	.byte	4				# DW_AT_byte_size
+	.byte	5				# DW_AT_encoding: DW_ATE_signed
+.Ldie_var_2:
+	.uleb128 3				# DW_TAG_variable
+	.long	.Lstr_var_2			# DW_AT_name
+	.long	.Ldie_int - .Lcu_begin		# DW_AT_type
+	.uleb128 9				# DW_AT_location
+	.byte	3				# DW_OP_addr
+	.quad	var_2
+.Ldie_helper:
+	.uleb128 4				# DW_TAG_subprogram
+	.long	.Lstr_helper			# DW_AT_name
+	.long	.Ldie_int - .Lcu_begin		# DW_AT_type
+	.quad	.Lhelper_begin			# DW_AT_low_pc
+	.quad	.Lhelper_end - .Lhelper_begin	# DW_AT_high_pc
+.Ldie_func_2:
+	.uleb128 5				# DW_TAG_subprogram
+	.long	.Lstr_func_2			# DW_AT_name
+	.long	.Ldie_int - .Lcu_begin		# DW_AT_type
+	.quad	.Lfunc_2_begin			# DW_AT_low_pc
+	.quad	.Lfunc_2_end - .Lfunc_2_begin	# DW_AT_high_pc
+	.byte	0				# end of children
+.Lcu_end:
+
+	.section	.debug_abbrev,"",@progbits
+.Labbrev_begin:
+	.uleb128 1				# abbrev code
+	.uleb128 0x11				# DW_TAG_compile_unit
+	.byte	1				# has children
+	.uleb128 0x3, 0x8			# DW_AT_name, DW_FORM_string
+	.uleb128 0x13, 0xb			# DW_AT_language, DW_FORM_data1
+	.uleb128 0x11, 0x1			# DW_AT_low_pc, DW_FORM_addr
+	.uleb128 0x12, 0x7			# DW_AT_high_pc, DW_FORM_data8
+	.byte	0, 0
+	.uleb128 2				# abbrev code
+	.uleb128 0x24				# DW_TAG_base_type
+	.byte	0				# no children
+	.uleb128 0x3, 0xe			# DW_AT_name, DW_FORM_strp
+	.uleb128 0xb, 0xb			# DW_AT_byte_size, DW_FORM_data1
+	.uleb128 0x3e, 0xb			# DW_AT_encoding, DW_FORM_data1
+	.byte	0, 0
+	.uleb128 3				# abbrev code
+	.uleb128 0x34				# DW_TAG_variable
+	.byte	0				# no children
+	.uleb128 0x3, 0xe			# DW_AT_name, DW_FORM_strp
+	.uleb128 0x49, 0x13			# DW_AT_type, DW_FORM_ref4
+	.uleb128 0x3f, 0x19			# DW_AT_external, DW_FORM_flag_present
+	.uleb128 0x2, 0x18			# DW_AT_location, DW_FORM_exprloc
+	.byte	0, 0
+	.uleb128 4				# abbrev code
+	.uleb128 0x2e				# DW_TAG_subprogram
+	.byte	0				# no children
+	.uleb128 0x3, 0xe			# DW_AT_name, DW_FORM_strp
+	.uleb128 0x49, 0x13			# DW_AT_type, DW_FORM_ref4
+	.uleb128 0x27, 0x19			# DW_AT_prototyped, DW_FORM_flag_present
+	.uleb128 0x11, 0x1			# DW_AT_low_pc, DW_FORM_addr
+	.uleb128 0x12, 0x7			# DW_AT_high_pc, DW_FORM_data8
+	.byte	0, 0
+	.uleb128 5				# abbrev code
+	.uleb128 0x2e				# DW_TAG_subprogram
+	.byte	0				# no children
+	.uleb128 0x3, 0xe			# DW_AT_name, DW_FORM_strp
+	.uleb128 0x49, 0x13			# DW_AT_type, DW_FORM_ref4
+	.uleb128 0x27, 0x19			# DW_AT_prototyped, DW_FORM_flag_present
+	.uleb128 0x3f, 0x19			# DW_AT_external, DW_FORM_flag_present
+	.uleb128 0x11, 0x1			# DW_AT_low_pc, DW_FORM_addr
+	.uleb128 0x12, 0x7			# DW_AT_high_pc, DW_FORM_data8
+	.byte	0, 0
+	.byte	0
+
+	.section	.debug_aranges,"",@progbits
+	.long	.Laranges_end - .Laranges_version	# unit_length
+.Laranges_version:
+	.value	2				# version
+	.long	.Lcu_begin			# debug_info_offset
+	.byte	8				# address_size
+	.byte	0				# segment_size
+	.long	0				# padding
+	.quad	.Lhelper_begin
+	.quad	.Lfunc_2_end - .Lhelper_begin
+	.quad	0
+	.quad	0
+.Laranges_end:
+
+	.section	.debug_str,"MS",@progbits,1
+.Lstr_int:
+	.string	"int"
+.Lstr_var_2:
+	.string	"var_2"
+.Lstr_helper:
+	.string	"helper"
+.Lstr_func_2:
+	.string	"func_2"
+
+	.section	.debug_names,"",@progbits
+	.long	.Lnames_end - .Lnames_version	# unit_length
+.Lnames_version:
+	.value	5				# version
+	.value	0				# padding
+	.long	1				# comp_unit_count
+	.long	0				# local_type_unit_count
+	.long	0				# foreign_type_unit_count
+	.long	0				# bucket_count
+	.long	4				# name_count
+	.long	.Lnames_abbrev_end - .Lnames_abbrev	# abbrev_table_size
+	.long	0				# augmentation_string_size
+	.long	.Lcu_begin			# compilation unit list
+	.long	.Lstr_int			# string offsets
+	.long	.Lstr_var_2
+	.long	.Lstr_helper
+	.long	.Lstr_func_2
+	.long	.Lentry_int - .Lentry_pool	# entry offsets
+	.long	.Lentry_var_2 - .Lentry_pool
+	.long	.Lentry_helper - .Lentry_pool
+	.long	.Lentry_func_2 - .Lentry_pool
+.Lnames_abbrev:
+	.uleb128 1				# abbrev code
+	.uleb128 0x24				# DW_TAG_base_type
+	.uleb128 3, 0x13			# DW_IDX_die_offset, DW_FORM_ref4
+	.uleb128 0x2000, 0x19			# DW_IDX_GNU_internal, DW_FORM_flag_present
+	.byte	0, 0
+	.uleb128 2				# abbrev code
+	.uleb128 0x34				# DW_TAG_variable
+	.uleb128 3, 0x13			# DW_IDX_die_offset, DW_FORM_ref4
+	.uleb128 0x2001, 0x19			# DW_IDX_GNU_external, DW_FORM_flag_present
+	.byte	0, 0
+	.uleb128 3				# abbrev code
+	.uleb128 0x2e				# DW_TAG_subprogram
+	.uleb128 3, 0x13			# DW_IDX_die_offset, DW_FORM_ref4
+	.uleb128 0x2000, 0x19			# DW_IDX_GNU_internal, DW_FORM_flag_present
+	.byte	0, 0
+	.uleb128 4				# abbrev code
+	.uleb128 0x2e				# DW_TAG_subprogram
+	.uleb128 3, 0x13			# DW_IDX_die_offset, DW_FORM_ref4
+	.uleb128 0x2001, 0x19			# DW_IDX_GNU_external, DW_FORM_flag_present
+	.byte	0, 0
+	.byte	0
+.Lnames_abbrev_end:
+.Lentry_pool:
+.Lentry_int:
+	.uleb128 1
+	.long	.Ldie_int - .Lcu_begin
+	.byte	0
+.Lentry_var_2:
+	.uleb128 2
+	.long	.Ldie_var_2 - .Lcu_begin
+	.byte	0
+.Lentry_helper:
+	.uleb128 3
+	.long	.Ldie_helper - .Lcu_begin
+	.byte	0
+.Lentry_func_2:
+	.uleb128 4
+	.long	.Ldie_func_2 - .Lcu_begin
+	.byte	0
+.Lnames_end:
@@ -0,0 +1,39 @@
+#!/bin/sh
+
+# dwp_test_3.sh -- Test the dwp --threads and --memory-budget options.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# dwp_test_3.dwp is built from the same .dwo files as dwp_test_1.dwp,
+# on several threads and with a memory budget small enough that the
+# section contents and strings are moved to temporary files.
+# dwp_test_3z.dwp is built the same way, but with one of the .dwo
+# files compressed.  Both should be identical to dwp_test_1.dwp.
+
+for f in dwp_test_3.dwp dwp_test_3z.dwp
+do
+    if ! cmp -s dwp_test_1.dwp $f
+    then
+	echo "$f differs from dwp_test_1.dwp"
+	exit 1
+    fi
+done
+
+exit 0
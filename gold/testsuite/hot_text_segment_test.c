@@ -0,0 +1,65 @@
+/* hot_text_segment_test.c -- test --hot-text-segment
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   hot_text_segment_test.txt names hot_1 and hot_2 as hot functions.
+   They must be placed between __hot_text_start and __hot_text_end,
+   and cold_fn must not be.  */
+
+extern char __hot_text_start[] __attribute__ ((visibility ("hidden")));
+extern char __hot_text_end[] __attribute__ ((visibility ("hidden")));
+
+int hot_1 (int) __attribute__ ((noinline));
+int cold_fn (int) __attribute__ ((noinline));
+int hot_2 (int) __attribute__ ((noinline));
+
+int
+hot_1 (int i)
+{
+  return i + 1;
+}
+
+int
+cold_fn (int i)
+{
+  return i + 2;
+}
+
+int
+hot_2 (int i)
+{
+  return i + 3;
+}
+
+static int
+is_hot (int (*fn) (int))
+{
+  const char *p = (const char *) fn;
+
+  return p >= __hot_text_start && p < __hot_text_end;
+}
+
+int
+main (void)
+{
+  if (!is_hot (hot_1) || !is_hot (hot_2) || is_hot (cold_fn))
+    return 1;
+  return hot_1 (0) + hot_2 (0) + cold_fn (0) == 6 ? 0 : 1;
+}
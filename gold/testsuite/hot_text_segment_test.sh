@@ -0,0 +1,72 @@
+#!/bin/sh
+
+# hot_text_segment_test.sh -- test --hot-text-segment.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with hot_text_segment_test.c, which is linked with a
+# hot text page size of 0x10000.  The .text.hot section must start and
+# end on that boundary, and must be alone in a PT_LOAD segment with
+# that alignment.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# Strip the section index, so that the name is the first field.
+set -- `sed -n -e 's/^.*\] \(\.text\.hot .*\)$/\1/p' hot_text_segment_test.stdout`
+if test "$#" -lt 5
+then
+    echo "Did not find .text.hot in hot_text_segment_test.stdout"
+    cat hot_text_segment_test.stdout
+    exit 1
+fi
+addr=$3
+size=$5
+
+case "$addr" in
+*0000) ;;
+*)
+    echo ".text.hot address $addr is not aligned to 0x10000"
+    exit 1
+    ;;
+esac
+
+case "$size" in
+*0000) ;;
+*)
+    echo ".text.hot size $size is not a multiple of 0x10000"
+    exit 1
+    ;;
+esac
+
+check hot_text_segment_test.stdout "LOAD .* 0x10000$"
+check hot_text_segment_test.stdout "^  *[0-9][0-9]*  *\.text\.hot *$"
+
+exit 0
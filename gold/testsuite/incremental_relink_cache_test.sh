@@ -0,0 +1,62 @@
+#!/bin/sh
+
+# incremental_relink_cache_test.sh -- test an incremental update
+# whose base file comes from the relink cache.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The output of the first link of incremental_relink_cache_test is
+# removed before the second link, which should then update the base
+# file kept in the relink cache, reading only the changed object.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_not()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check incremental_relink_cache_test.err "incremental_relink_cache_test.dir/base-.*\.out"
+check incremental_relink_cache_test.err "\"two_file_test_tmp_rc.o\""
+check_not incremental_relink_cache_test.err "\"two_file_test_1.o\""
+check_not incremental_relink_cache_test.err "linking with --incremental-full"
+
+./incremental_relink_cache_test || exit 1
+
+exit 0
@@ -0,0 +1,56 @@
+#!/bin/sh
+
+# output_writeback_test.sh -- test --output-writeback.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# output_writeback_test_1 is linked normally.  output_writeback_test_2
+# to output_writeback_test_5 are linked from the same objects with
+# --output-writeback, with the output file mapped and with
+# --no-mmap-output-file, and without and with threads.  All are linked
+# with --build-id=tree and small chunks, so that chunks are hashed and
+# written back while the rest of the output is still being written.
+# The outputs, build ID included, must be the same.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for n in 2 3 4 5
+do
+    f=output_writeback_test_$n
+    if ! cmp -s output_writeback_test_1 $f
+    then
+	echo "$f differs from output_writeback_test_1"
+	exit 1
+    fi
+    check $f.err "build ID chunks hashed while writing: [1-9]"
+done
+
+exit 0
@@ -0,0 +1,93 @@
+#!/bin/sh
+
+# parallel_symtab_test.sh -- test resolving symbols in parallel.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with parallel_symtab_test_1.c and
+# parallel_symtab_test_2.c.  parallel_symtab_test_1 is linked without
+# threads, and parallel_symtab_test_2 and parallel_symtab_test_3 are
+# linked with 3 and 16 threads, which resolve the symbols of the
+# input objects in parallel.  The outputs must be the same.
+
+# parallel_symtab_test_dyn_1 and parallel_symtab_test_dyn_2 are
+# linked from several objects followed by a shared library, without
+# threads and with 4 threads, with --build-id and --warn-common.  The
+# outputs and the warnings must be the same.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_not()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for f in parallel_symtab_test_2 parallel_symtab_test_3
+do
+    if ! cmp -s parallel_symtab_test_1 $f
+    then
+	echo "$f differs from parallel_symtab_test_1"
+	exit 1
+    fi
+done
+
+if ! cmp -s parallel_symtab_test_dyn_1 parallel_symtab_test_dyn_2
+then
+    echo "parallel_symtab_test_dyn_2 differs from parallel_symtab_test_dyn_1"
+    exit 1
+fi
+if ! cmp -s parallel_symtab_test_dyn_1.err parallel_symtab_test_dyn_2.err
+then
+    echo "parallel_symtab_test_dyn_2.err differs from parallel_symtab_test_dyn_1.err"
+    diff parallel_symtab_test_dyn_1.err parallel_symtab_test_dyn_2.err
+    exit 1
+fi
+check parallel_symtab_test_dyn_1.err "multiple common of 'common_var'"
+check parallel_symtab_test_dyn_1.err "common of 'common_a' overidden by larger common"
+
+# The strong definition overrides the weak one, the hidden symbol and
+# the one not in the version script are local, the unused one is
+# garbage collected, and the common symbol gets the larger size.
+check parallel_symtab_test.stdout " T weak_fn"
+check parallel_symtab_test.stdout " t hidden_fn"
+check parallel_symtab_test.stdout " t local_fn"
+check_not parallel_symtab_test.stdout "unused_fn"
+check parallel_symtab_test.stdout "80 B common_array"
+
+exit 0
@@ -0,0 +1,59 @@
+/* parallel_symtab_test_1.c -- test resolving symbols in parallel
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This file and parallel_symtab_test_2.c define common, weak and
+   hidden symbols, and symbols made local by a version script.  The
+   test links them with and without --threads, which resolves the
+   symbols of the two files in parallel, and checks that the output
+   is the same.  */
+
+int common_var __attribute__ ((common));
+int common_array[16] __attribute__ ((common));
+
+__attribute__ ((weak)) int
+weak_fn (void)
+{
+  return 1;
+}
+
+__attribute__ ((visibility ("hidden"))) int
+hidden_fn (void)
+{
+  return 2;
+}
+
+int
+local_fn (void)
+{
+  return 4;
+}
+
+int
+unused_fn (void)
+{
+  return 8;
+}
+
+int
+t1 (void)
+{
+  return weak_fn () + hidden_fn () + local_fn () + common_var;
+}
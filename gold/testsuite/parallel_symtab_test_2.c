@@ -0,0 +1,41 @@
+/* parallel_symtab_test_2.c -- test resolving symbols in parallel
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   See parallel_symtab_test_1.c.  */
+
+extern int t1 (void);
+
+int common_var __attribute__ ((common));
+int common_array[32] __attribute__ ((common));
+
+int
+weak_fn (void)
+{
+  return 3;
+}
+
+int
+main (void)
+{
+  common_var = 1;
+  common_array[31] = 1;
+  return t1 () == 3 + 2 + 4 + 1 ? 0 : 1;
+}
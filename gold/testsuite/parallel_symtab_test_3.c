@@ -0,0 +1,45 @@
+/* parallel_symtab_test_3.c -- test resolving symbols in parallel
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This file and parallel_symtab_test_4.c define common symbols with
+   different sizes, so that --warn-common reports them, and refer to
+   symbols in parallel_symtab_test_lib.so.  The test links them and
+   the shared library after parallel_symtab_test_1.c and
+   parallel_symtab_test_2.c, with and without --threads, and checks
+   that the outputs and the warnings are the same.  */
+
+extern int lib_fn (int);
+extern int lib_var;
+
+int common_var __attribute__ ((common));
+int common_array[8] __attribute__ ((common));
+int common_a[1] __attribute__ ((common));
+int common_b[2] __attribute__ ((common));
+int common_c[3] __attribute__ ((common));
+int common_d[4] __attribute__ ((common));
+int common_e[5] __attribute__ ((common));
+int common_f[6] __attribute__ ((common));
+
+int
+t3 (void)
+{
+  return lib_fn (lib_var) + common_a[0] + common_f[5];
+}
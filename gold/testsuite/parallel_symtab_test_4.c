@@ -0,0 +1,37 @@
+/* parallel_symtab_test_4.c -- test resolving symbols in parallel
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   See parallel_symtab_test_3.c.  */
+
+extern int lib_fn (int);
+
+int common_a[6] __attribute__ ((common));
+int common_b[5] __attribute__ ((common));
+int common_c[4] __attribute__ ((common));
+int common_d[3] __attribute__ ((common));
+int common_e[2] __attribute__ ((common));
+int common_f[1] __attribute__ ((common));
+
+int
+t4 (void)
+{
+  return lib_fn (common_b[4]) + common_e[1];
+}
@@ -0,0 +1,38 @@
+/* parallel_symtab_test_lib.c -- test resolving symbols in parallel
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   A shared library which is linked after the objects of
+   parallel_symtab_test_3.c.  It defines weak_fn, which the objects
+   also define.  */
+
+int lib_var = 1;
+
+int
+lib_fn (int i)
+{
+  return i + 1;
+}
+
+int
+weak_fn (void)
+{
+  return 5;
+}
@@ -0,0 +1,87 @@
+#!/bin/sh
+
+# relink_cache_test.sh -- test --relink-cache.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with the relink_cache_test links in Makefile.am.
+# The first link starts with an empty cache, the second is identical
+# apart from writing a --stats-file, and should be copied from the
+# cache, and the third replaces one of the objects and should be
+# linked again.  The fourth has another
+# command line and a cache size limit too small for any file, so it
+# should leave no outputs in the cache.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_not()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check relink_cache_test_1.err "output file size"
+check_not relink_cache_test_1.err "copied from relink cache"
+
+# The statistics are still printed when the output comes from the cache.
+check relink_cache_test_2.err "output file copied from relink cache"
+check relink_cache_test_2.err "total run time"
+check relink_cache_test_2.stats '"total":'
+if ! cmp -s relink_cache_test_1 relink_cache_test_2
+then
+    echo "relink_cache_test_2 differs from relink_cache_test_1"
+    exit 1
+fi
+
+check relink_cache_test_3.err "output file size"
+check_not relink_cache_test_3.err "copied from relink cache"
+if cmp -s relink_cache_test_1 relink_cache_test_3
+then
+    echo "relink_cache_test_3 was not relinked"
+    exit 1
+fi
+
+check relink_cache_test_4.err "output file size"
+if ls relink_cache_test.dir/*.out > /dev/null 2>&1
+then
+    echo "relink_cache_test.dir was not trimmed:"
+    ls -l relink_cache_test.dir
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,56 @@
+#!/bin/sh
+
+# view_cache_test.sh -- test --view-cache-size.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# view_cache_test_1 is linked without a view cache budget.
+# view_cache_test_2 and view_cache_test_3 are linked from the same
+# objects with a budget of one byte, without and with threads, so that
+# the views of every input file are dropped when the file is released
+# and read again when it is next used.  The outputs must be the same.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for f in view_cache_test_2 view_cache_test_3
+do
+    if ! cmp -s view_cache_test_1 $f
+    then
+	echo "$f differs from view_cache_test_1"
+	exit 1
+    fi
+done
+
+check view_cache_test_2.err "bytes of input file views dropped to stay within --view-cache-size: [1-9]"
+check view_cache_test_2.err "input file views read again after being dropped: [1-9]"
+check view_cache_test_3.err "bytes of input file views dropped to stay within --view-cache-size: [1-9]"
+
+exit 0
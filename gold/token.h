@@ -92,7 +92,8 @@ class Task_token
 {
  public:
   Task_token(bool is_blocker)
-    : is_blocker_(is_blocker), blockers_(0), writer_(NULL), waiting_()
+    : is_blocker_(is_blocker), blockers_(0), writer_(NULL), waiting_(),
+      trace_id_(0)
   { }
 
   ~Task_token()
@@ -191,6 +192,17 @@ class Task_token
   remove_first_waiting()
   { return this->waiting_.pop_front(); }
 
+  // Return the number which identifies this token in --task-trace
+  // output, or 0 if it has not been given one.
+  unsigned int
+  trace_id() const
+  { return this->trace_id_; }
+
+  // Set the number which identifies this token in --task-trace output.
+  void
+  set_trace_id(unsigned int id)
+  { this->trace_id_ = id; }
+
  private:
   // It makes no sense to copy these.
   Task_token(const Task_token&);
@@ -204,6 +216,8 @@ class Task_token
   const Task* writer_;
   // The list of Tasks waiting for this token to be released.
   Task_list waiting_;
+  // The number of this token in --task-trace output, or 0.
+  unsigned int trace_id_;
 };
 
 // In order to support tokens more reliably, we provide objects which
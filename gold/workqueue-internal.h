@@ -24,7 +24,9 @@
 #define GOLD_WORKQUEUE_INTERNAL_H
 
 #include <queue>
+#include <vector>
 #include <csignal>
+#include <cstdio>
 
 #include "gold-threads.h"
 #include "workqueue.h"
@@ -104,6 +106,170 @@ class Workqueue_threader_threadpool : public Workqueue_threader
   int threads_;
 };
 
+// A run queue of Tasks which have already been checked with
+// is_runnable and which already hold their locks, so that starting
+// one does not require the Workqueue lock.  When a Task releases a
+// blocker, the Tasks which were waiting for it are locked and put on
+// the run queue of the thread that released them.  Each thread takes
+// Tasks from its own run queue first, and steals from the other run
+// queues when it has nothing else to do.  A run queue has its own
+// lock; when both are needed, the Workqueue lock must be taken
+// first.
+
+class Workqueue_run_queue
+{
+ public:
+  Workqueue_run_queue()
+    : lock_(), tasks_()
+  { }
+
+  // Add T to the end of the queue.
+  void
+  push(Task* t);
+
+  // Remove and return the first Task on the queue, or return NULL if
+  // the queue is empty.
+  Task*
+  pop();
+
+ private:
+  // This class can not be copied.
+  Workqueue_run_queue(const Workqueue_run_queue&);
+  Workqueue_run_queue& operator=(const Workqueue_run_queue&);
+
+  // Lock controlling access to tasks_.
+  Lock lock_;
+  // The queued Tasks.
+  Task_list tasks_;
+};
+
+// A record of every Task run by the Workqueue, used to implement
+// --task-trace.  The trace is written in the JSON trace event format
+// understood by chrome://tracing and Perfetto, so that the critical
+// path through the link and any idle threads can be seen.  All
+// methods other than write must be called with the Workqueue lock
+// held.
+
+class Workqueue_trace
+{
+ public:
+  Workqueue_trace(const char* filename);
+
+  // Return the current time in microseconds.
+  static uint64_t
+  now();
+
+  // Record that task T ran on thread THREAD_NUMBER from START until
+  // now.  Return the index of the new event.
+  long
+  record(Task* t, int thread_number, uint64_t start);
+
+  // Return the number which identifies TOKEN in the trace, giving it
+  // one if necessary.  We number the tokens rather than printing
+  // their addresses, which are reused once a token is freed.
+  unsigned int
+  token_id(Task_token* token);
+
+  // Return the index of the most recently recorded event.
+  long
+  last_event() const
+  { return static_cast<long>(this->events_.size()) - 1; }
+
+  // Write out the trace.
+  void
+  write() const;
+
+ private:
+  // This class can not be copied.
+  Workqueue_trace(const Workqueue_trace&);
+  Workqueue_trace& operator=(const Workqueue_trace&);
+
+  // A single completed Task.
+  struct Event
+  {
+    // The Task name.
+    std::string name;
+    // The thread which ran the Task.
+    int thread_number;
+    // When the Task was queued, started, and finished.
+    uint64_t queued;
+    uint64_t start;
+    uint64_t end;
+    // The trace number of the last Task_token the Task waited for, or
+    // 0.
+    unsigned int blocker;
+    // The index of the event which made this Task runnable, or -1.
+    long released_by;
+  };
+
+  // The file to write.
+  const char* filename_;
+  // The time at which the trace was started.
+  uint64_t origin_;
+  // The events, in order of completion.
+  std::vector<Event> events_;
+  // The number of Task_tokens given a trace number so far.
+  unsigned int token_count_;
+};
+
+// Gather the Task_stats for --stats-file.
+
+class Workqueue_stats
+{
+ public:
+  Workqueue_stats()
+    : by_class_(), by_file_()
+  { }
+
+  // The resources used so far, sampled before and after running a
+  // Task.
+  struct Sample
+  {
+    Sample()
+      : wall(0), cpu(0), heap(0)
+    { }
+
+    // The wall clock time in microseconds.
+    uint64_t wall;
+    // The CPU time used by the current thread in microseconds.
+    uint64_t cpu;
+    // The number of bytes allocated by malloc.
+    uint64_t heap;
+  };
+
+  // Sample the resources used by the current thread.
+  static void
+  sample(Sample*);
+
+  // Record that the Task named NAME ran from START to END.
+  void
+  record(const std::string& name, const Sample& start, const Sample& end);
+
+  // Return the statistics by Task class.
+  const Task_stats_map&
+  by_class() const
+  { return this->by_class_; }
+
+  // Return the statistics by input file.
+  const Task_stats_map&
+  by_file() const
+  { return this->by_file_; }
+
+ private:
+  // This class can not be copied.
+  Workqueue_stats(const Workqueue_stats&);
+  Workqueue_stats& operator=(const Workqueue_stats&);
+
+  // Add one Task to TS.
+  static void
+  add(Task_stats* ts, const Sample& start, const Sample& end);
+
+  // The statistics by Task class.
+  Task_stats_map by_class_;
+  // The statistics by input file.
+  Task_stats_map by_file_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_WORKQUEUE_INTERNAL_H)
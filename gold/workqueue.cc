@@ -22,6 +22,15 @@
 
 #include "gold.h"
 
+#include <cerrno>
+#include <algorithm>
+#include <ctime>
+#include <sys/time.h>
+
+#ifdef HAVE_MALLINFO
+#include <malloc.h>
+#endif
+
 #include "debug.h"
 #include "options.h"
 #include "timer.h"
@@ -94,6 +103,26 @@ Task_list::pop_front()
   return ret;
 }
 
+// Class Workqueue_run_queue.
+
+// Add T to the end of the run queue.
+
+void
+Workqueue_run_queue::push(Task* t)
+{
+  Hold_lock hl(this->lock_);
+  this->tasks_.push_back(t);
+}
+
+// Remove and return the first Task on the run queue.
+
+Task*
+Workqueue_run_queue::pop()
+{
+  Hold_lock hl(this->lock_);
+  return this->tasks_.pop_front();
+}
+
 // The simple single-threaded implementation of Workqueue_threader.
 
 class Workqueue_threader_single : public Workqueue_threader
@@ -122,9 +151,18 @@ Workqueue::Workqueue(const General_options& options)
     tasks_(),
     running_(0),
     waiting_(0),
+    idle_(0),
     condvar_(this->lock_),
-    threader_(NULL)
+    threader_(NULL),
+    trace_(NULL),
+    stats_(NULL),
+    run_queues_(new Workqueue_run_queue[run_queue_count])
 {
+  if (options.task_trace() != NULL)
+    this->trace_ = new Workqueue_trace(options.task_trace());
+  if (options.stats_file() != NULL)
+    this->stats_ = new Workqueue_stats();
+
   bool threads = options.threads();
 #ifndef ENABLE_THREADS
   threads = false;
@@ -143,6 +181,24 @@ Workqueue::Workqueue(const General_options& options)
 
 Workqueue::~Workqueue()
 {
+  delete this->trace_;
+  delete this->stats_;
+  delete[] this->run_queues_;
+}
+
+// Note that T must wait for TOKEN.  This must be called with the
+// workqueue lock held.
+
+inline void
+Workqueue::add_waiting(Task_token* token, Task* t, bool front)
+{
+  if (front)
+    token->add_waiting_front(t);
+  else
+    token->add_waiting(t);
+  ++this->waiting_;
+  if (this->trace_ != NULL)
+    t->set_trace_blocker(this->trace_->token_id(token));
 }
 
 // Add a task to the end of a specific queue, or put it on the list
@@ -153,15 +209,12 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
 {
   Hold_lock hl(this->lock_);
 
+  if (this->trace_ != NULL)
+    t->set_trace_queued(Workqueue_trace::now());
+
   Task_token* token = t->is_runnable();
   if (token != NULL)
-    {
-      if (front)
-	token->add_waiting_front(t);
-      else
-	token->add_waiting(t);
-      ++this->waiting_;
-    }
+    this->add_waiting(token, t, front);
   else
     {
       if (front)
@@ -222,23 +275,67 @@ Workqueue::find_runnable_in_list(Task_list* tasks)
       if (token == NULL)
 	return t;
 
-      token->add_waiting(t);
-      ++this->waiting_;
+      this->add_waiting(token, t, false);
     }
 
   // We couldn't find any runnable task.
   return NULL;
 }
 
-// Find a runnable task.  Return NULL if none could be found.  The
-// workqueue lock must be held when this is called.
+// Take the locks for T, which must be runnable, and count it as
+// running.  The workqueue lock must be held when this is called.
+
+inline void
+Workqueue::start_task(Task* t)
+{
+  Task_locker* tl = t->locker();
+  tl->clear();
+  t->locks(tl);
+  ++this->running_;
+}
+
+// Return the run queue used by THREAD_NUMBER.
+
+inline Workqueue_run_queue*
+Workqueue::run_queue(int thread_number)
+{
+  return &this->run_queues_[thread_number % run_queue_count];
+}
+
+// Take a Task from one of the run queues not used by THREAD_NUMBER.
+// Return NULL if they are all empty.
+
+Task*
+Workqueue::steal_task(int thread_number)
+{
+  for (int i = 1; i < run_queue_count; ++i)
+    {
+      Task* t = this->run_queue(thread_number + i)->pop();
+      if (t != NULL)
+	return t;
+    }
+  return NULL;
+}
+
+// Find a runnable task, and take its locks.  Return NULL if none
+// could be found.  The workqueue lock must be held when this is
+// called.
 
 Task*
-Workqueue::find_runnable()
+Workqueue::find_runnable(int thread_number)
 {
   Task* t = this->find_runnable_in_list(&this->first_tasks_);
   if (t == NULL)
-    t = this->find_runnable_in_list(&this->tasks_);
+    {
+      // Tasks on the run queues already hold their locks.
+      t = this->run_queue(thread_number)->pop();
+      if (t != NULL)
+	return t;
+      t = this->find_runnable_in_list(&this->tasks_);
+      if (t == NULL)
+	return this->steal_task(thread_number);
+    }
+  this->start_task(t);
   return t;
 }
 
@@ -249,10 +346,11 @@ Workqueue::find_runnable()
 Task*
 Workqueue::find_runnable_or_wait(int thread_number)
 {
-  Task* t = this->find_runnable();
+  Task* t = this->find_runnable(thread_number);
 
   while (t == NULL)
     {
+      // Tasks on the run queues are counted in running_.
       if (this->running_ == 0
 	  && this->first_tasks_.empty()
 	  && this->tasks_.empty())
@@ -269,11 +367,13 @@ Workqueue::find_runnable_or_wait(int thread_number)
 
       gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
 
+      ++this->idle_;
       this->condvar_.wait();
+      --this->idle_;
 
       gold_debug(DEBUG_TASK, "%3d awake", thread_number);
 
-      t = this->find_runnable();
+      t = this->find_runnable(thread_number);
     }
 
   return t;
@@ -288,24 +388,20 @@ Workqueue::find_runnable_or_wait(int thread_number)
 bool
 Workqueue::find_and_run_task(int thread_number)
 {
-  Task* t;
-  Task_locker tl;
-
-  {
-    Hold_lock hl(this->lock_);
-
-    // Find a runnable task.
-    t = this->find_runnable_or_wait(thread_number);
+  // A Task on our own run queue already holds its locks, so we can
+  // start it without taking the workqueue lock.
+  Task* t = this->run_queue(thread_number)->pop();
 
-    if (t == NULL)
-      return false;
+  if (t == NULL)
+    {
+      Hold_lock hl(this->lock_);
 
-    // Get the locks for the task.  This must be called while we are
-    // still holding the Workqueue lock.
-    t->locks(&tl);
+      // Find a runnable task.  This also gets the locks for the task.
+      t = this->find_runnable_or_wait(thread_number);
 
-    ++this->running_;
-  }
+      if (t == NULL)
+	return false;
+    }
 
   while (t != NULL)
     {
@@ -316,8 +412,27 @@ Workqueue::find_and_run_task(int thread_number)
       if (is_debugging_enabled(DEBUG_TASK))
         timer.start();
 
+      // Get the name for the trace before running the Task, since
+      // running it may free what the name is built from.
+      uint64_t trace_start = 0;
+      if (this->trace_ != NULL)
+	{
+	  t->name();
+	  trace_start = Workqueue_trace::now();
+	}
+      Workqueue_stats::Sample stats_start;
+      if (this->stats_ != NULL)
+	{
+	  t->name();
+	  Workqueue_stats::sample(&stats_start);
+	}
+
       t->run(this);
 
+      Workqueue_stats::Sample stats_end;
+      if (this->stats_ != NULL)
+	Workqueue_stats::sample(&stats_end);
+
       if (is_debugging_enabled(DEBUG_TASK))
         {
           Timer::TimeStats elapsed = timer.get_elapsed_time();
@@ -337,27 +452,33 @@ Workqueue::find_and_run_task(int thread_number)
 
 	--this->running_;
 
-	// Release the locks for the task.  This must be done with the
-	// workqueue lock held.  Get the next Task to run if any.
-	next = this->release_locks(t, &tl);
+	// Record the task in the trace before releasing its locks, so
+	// that the Tasks it releases can refer to it.
+	if (this->trace_ != NULL)
+	  this->trace_->record(t, thread_number, trace_start);
+	if (this->stats_ != NULL)
+	  this->stats_->record(t->name(), stats_start, stats_end);
 
-	if (next == NULL)
-	  next = this->find_runnable();
-
-	// If we have another Task to run, get the Locks.  This must
-	// be called while we are still holding the Workqueue lock.
-	if (next != NULL)
-	  {
-	    tl.clear();
-	    next->locks(&tl);
-
-	    ++this->running_;
-	  }
+	// Release the locks for the task.  This must be done with the
+	// workqueue lock held.  Get the next Task to run if any; it
+	// will already hold its locks.
+	next = this->release_locks(t, thread_number);
       }
 
       // We are done with this task.
       delete t;
 
+      // Prefer the Tasks we released ourselves, which don't need the
+      // workqueue lock to start.
+      if (next == NULL)
+	next = this->run_queue(thread_number)->pop();
+
+      if (next == NULL)
+	{
+	  Hold_lock hl(this->lock_);
+	  next = this->find_runnable(thread_number);
+	}
+
       t = next;
     }
 
@@ -371,7 +492,12 @@ Workqueue::find_and_run_task(int thread_number)
 
 // 2) Otherwise, T is runnable.  If *PRET is not NULL, then we have
 // already decided which Task to run next.  Add T to the list of
-// runnable tasks, and signal another thread.
+// runnable tasks, and increment *PQUEUED so that the caller wakes
+// another thread.  If T was released by a blocker and need not run
+// soon, take its locks and put it on the run queue of THREAD_NUMBER;
+// a blocker typically releases a large batch of Tasks at once, such
+// as the Relocate_tasks, and this lets them be started without
+// contending for the workqueue lock.
 
 // 3) Otherwise, *PRET is NULL.  If IS_BLOCKER is false, then T was
 // waiting on a write lock.  We can grab that lock now, so we run T
@@ -391,17 +517,18 @@ Workqueue::find_and_run_task(int thread_number)
 
 // This function must be called with the Workqueue lock held.
 
-// Return true if we set *PRET to T, false otherwise.
+// Return true if we set *PRET to T, false otherwise.  If we set *PRET
+// to T, we also take the locks for T.
 
 bool
-Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
+Workqueue::return_or_queue(Task* t, bool is_blocker, int thread_number,
+			   Task** pret, int* pqueued)
 {
   Task_token* token = t->is_runnable();
 
   if (token != NULL)
     {
-      token->add_waiting(t);
-      ++this->waiting_;
+      this->add_waiting(token, t, false);
       return false;
     }
 
@@ -422,6 +549,9 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
   if (should_return)
     {
       gold_assert(*pret == NULL);
+      // Take the locks now, before any other Task we release can
+      // take them.
+      this->start_task(t);
       *pret = t;
       return true;
     }
@@ -429,9 +559,19 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     {
       if (t->should_run_soon())
 	this->first_tasks_.push_back(t);
+      else if (is_blocker)
+	{
+	  this->start_task(t);
+	  this->run_queue(thread_number)->push(t);
+	}
       else
-	this->tasks_.push_back(t);
-      this->condvar_.signal();
+	{
+	  // We must not take the locks of a Task waiting on a write
+	  // lock, since the Tasks after it on the same token would
+	  // then go straight back onto the token's list.
+	  this->tasks_.push_back(t);
+	}
+      ++*pqueued;
       return false;
     }
 
@@ -439,14 +579,16 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
 }
 
 // Release the locks associated with a Task.  Return the first
-// runnable Task that we find.  If we find more runnable tasks, add
-// them to the run queue and signal any other threads.  This must be
-// called with the Workqueue lock held.
+// runnable Task that we find, with its locks taken.  If we find more
+// runnable tasks, add them to the run queues and wake up any idle
+// threads.  This must be called with the Workqueue lock held.
 
 Task*
-Workqueue::release_locks(Task* t, Task_locker* tl)
+Workqueue::release_locks(Task* t, int thread_number)
 {
   Task* ret = NULL;
+  int queued = 0;
+  Task_locker* tl = t->locker();
   for (Task_locker::iterator p = tl->begin(); p != tl->end(); ++p)
     {
       Task_token* token = *p;
@@ -460,7 +602,9 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	      while ((t = token->remove_first_waiting()) != NULL)
 		{
 		  --this->waiting_;
-		  this->return_or_queue(t, true, &ret);
+		  if (this->trace_ != NULL)
+		    t->set_trace_released_by(this->trace_->last_event());
+		  this->return_or_queue(t, true, thread_number, &ret, &queued);
 		}
 	    }
 	}
@@ -477,14 +621,40 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	  while ((t = token->remove_first_waiting()) != NULL)
 	    {
 	      --this->waiting_;
-	      if (this->return_or_queue(t, false, &ret))
+	      if (this->trace_ != NULL)
+		t->set_trace_released_by(this->trace_->last_event());
+	      if (this->return_or_queue(t, false, thread_number, &ret,
+					&queued))
 		break;
 	    }
 	}
     }
+  tl->clear();
+
+  this->wake_threads(queued);
+
   return ret;
 }
 
+// Wake up idle threads to run COUNT newly queued Tasks.  We do this
+// once after releasing all of a Task's locks, rather than once per
+// queued Task, and we don't wake more threads than are idle.  The
+// workqueue lock must be held when this is called.
+
+void
+Workqueue::wake_threads(int count)
+{
+  if (count <= 0 || this->idle_ == 0)
+    return;
+  if (count >= this->idle_)
+    this->condvar_.broadcast();
+  else
+    {
+      for (int i = 0; i < count; ++i)
+	this->condvar_.signal();
+    }
+}
+
 // Process all the tasks on the workqueue.  Keep going until the
 // workqueue is empty, or until we have been told to exit.  This
 // function is called by all threads.
@@ -518,4 +688,247 @@ Workqueue::add_blocker(Task_token* token)
   token->add_blocker();
 }
 
+// Write the task trace, if there is one.
+
+void
+Workqueue::write_trace()
+{
+  if (this->trace_ != NULL)
+    this->trace_->write();
+}
+
+// Return the Task statistics by class, if they are being gathered.
+
+const Task_stats_map*
+Workqueue::task_stats_by_class() const
+{
+  if (this->stats_ == NULL)
+    return NULL;
+  return &this->stats_->by_class();
+}
+
+// Return the Task statistics by input file, if they are being
+// gathered.
+
+const Task_stats_map*
+Workqueue::task_stats_by_file() const
+{
+  if (this->stats_ == NULL)
+    return NULL;
+  return &this->stats_->by_file();
+}
+
+// Write S as a JSON string.
+
+void
+write_json_string(FILE* f, const std::string& s)
+{
+  putc('"', f);
+  for (std::string::const_iterator p = s.begin(); p != s.end(); ++p)
+    {
+      unsigned char c = *p;
+      if (c == '"' || c == '\\')
+	fprintf(f, "\\%c", c);
+      else if (c < 0x20)
+	fprintf(f, "\\u%04x", c);
+      else
+	putc(c, f);
+    }
+  putc('"', f);
+}
+
+// Class Workqueue_trace.
+
+Workqueue_trace::Workqueue_trace(const char* filename)
+  : filename_(filename), origin_(Workqueue_trace::now()), events_(),
+    token_count_(0)
+{
+}
+
+// Return the current time in microseconds.
+
+uint64_t
+Workqueue_trace::now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+// Return the trace number of TOKEN.
+
+unsigned int
+Workqueue_trace::token_id(Task_token* token)
+{
+  if (token->trace_id() == 0)
+    token->set_trace_id(++this->token_count_);
+  return token->trace_id();
+}
+
+// Record a completed Task.
+
+long
+Workqueue_trace::record(Task* t, int thread_number, uint64_t start)
+{
+  Event e;
+  e.name = t->name();
+  e.thread_number = thread_number;
+  e.queued = t->trace_queued();
+  e.start = start;
+  e.end = Workqueue_trace::now();
+  e.blocker = t->trace_blocker();
+  e.released_by = t->trace_released_by();
+  this->events_.push_back(e);
+  return this->last_event();
+}
+
+// Write out the trace.  Each Task becomes a complete ("X") event on
+// the thread which ran it.  When a Task was made runnable by the
+// completion of another Task, we also emit a flow event pair
+// connecting the two, which is what shows up as the critical path.
+
+void
+Workqueue_trace::write() const
+{
+  FILE* f = fopen(this->filename_, "w");
+  if (f == NULL)
+    {
+      gold_error(_("cannot open task trace file %s: %s"), this->filename_,
+		 strerror(errno));
+      return;
+    }
+
+  fprintf(f, "{\"traceEvents\":[\n");
+
+  // Name the threads.
+  int max_thread = 0;
+  for (std::vector<Event>::const_iterator p = this->events_.begin();
+       p != this->events_.end();
+       ++p)
+    max_thread = std::max(max_thread, p->thread_number);
+  for (int i = 0; i <= max_thread; ++i)
+    fprintf(f,
+	    "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\","
+	    "\"args\":{\"name\":\"gold thread %d\"}},\n",
+	    i, i);
+
+  for (size_t i = 0; i < this->events_.size(); ++i)
+    {
+      const Event& e(this->events_[i]);
+      unsigned long long ts = e.start - this->origin_;
+      unsigned long long dur = e.end - e.start;
+      unsigned long long wait = e.queued != 0 ? e.start - e.queued : 0;
+
+      fprintf(f, "{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%llu,"
+	      "\"dur\":%llu,\"name\":",
+	      e.thread_number, ts, dur);
+      write_json_string(f, e.name);
+      fprintf(f, ",\"args\":{\"wait_us\":%llu", wait);
+      if (e.blocker != 0)
+	fprintf(f, ",\"blocker\":\"token %u\"", e.blocker);
+      if (e.released_by >= 0)
+	{
+	  fprintf(f, ",\"released_by\":");
+	  write_json_string(f, this->events_[e.released_by].name);
+	}
+      fprintf(f, "}},\n");
+
+      if (e.released_by >= 0)
+	{
+	  const Event& r(this->events_[e.released_by]);
+	  unsigned long long rts = r.end - this->origin_;
+	  fprintf(f, "{\"ph\":\"s\",\"pid\":1,\"tid\":%d,\"ts\":%llu,"
+		  "\"id\":%lu,\"cat\":\"release\",\"name\":\"release\"},\n",
+		  r.thread_number, rts, static_cast<unsigned long>(i));
+	  fprintf(f, "{\"ph\":\"f\",\"bp\":\"e\",\"pid\":1,\"tid\":%d,"
+		  "\"ts\":%llu,\"id\":%lu,\"cat\":\"release\","
+		  "\"name\":\"release\"},\n",
+		  e.thread_number, ts, static_cast<unsigned long>(i));
+	}
+    }
+
+  // The trace event format permits a trailing comma in the array,
+  // but not every consumer does, so finish with a metadata event.
+  fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+	  "\"args\":{\"name\":\"gold\"}}\n]}\n");
+
+  if (fclose(f) != 0)
+    gold_error(_("error writing task trace file %s: %s"), this->filename_,
+	       strerror(errno));
+}
+
+// Class Workqueue_stats.
+
+// Sample the resources used by the current thread.
+
+void
+Workqueue_stats::sample(Sample* s)
+{
+  s->wall = Workqueue_trace::now();
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    s->cpu = (static_cast<uint64_t>(ts.tv_sec) * 1000000
+	      + ts.tv_nsec / 1000);
+  else
+    s->cpu = 0;
+#else
+  s->cpu = 0;
+#endif
+
+#ifdef HAVE_MALLINFO
+  // The mallinfo fields are int; treat them as unsigned so that they
+  // remain useful up to 4G.
+  struct mallinfo m = mallinfo();
+  s->heap = (static_cast<unsigned int>(m.uordblks)
+	     + static_cast<unsigned int>(m.hblkhd));
+#else
+  s->heap = 0;
+#endif
+}
+
+// Add a Task which ran from START to END to TS.
+
+void
+Workqueue_stats::add(Task_stats* ts, const Sample& start, const Sample& end)
+{
+  ++ts->count;
+  if (end.wall > start.wall)
+    ts->wall_us += end.wall - start.wall;
+  if (end.cpu > start.cpu)
+    ts->cpu_us += end.cpu - start.cpu;
+  if (end.heap > start.heap)
+    {
+      uint64_t growth = end.heap - start.heap;
+      ts->heap_growth += growth;
+      if (growth > ts->max_heap_growth)
+	ts->max_heap_growth = growth;
+    }
+}
+
+// Record a completed Task.  This is called with the workqueue lock
+// held.
+
+void
+Workqueue_stats::record(const std::string& name, const Sample& start,
+			const Sample& end)
+{
+  std::string::size_type pos = name.find(' ');
+
+  // A Task_function is named for its runner, which is the more
+  // useful class.
+  if (name.compare(0, pos, "Task_function") == 0
+      && pos != std::string::npos)
+    {
+      Workqueue_stats::add(&this->by_class_[name.substr(pos + 1)], start,
+			   end);
+      return;
+    }
+
+  Workqueue_stats::add(&this->by_class_[name.substr(0, pos)], start, end);
+  if (pos != std::string::npos)
+    Workqueue_stats::add(&this->by_file_[name.substr(pos + 1)], start, end);
+}
+
 } // End namespace gold.
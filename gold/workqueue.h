@@ -27,6 +27,8 @@
 #ifndef GOLD_WORKQUEUE_H
 #define GOLD_WORKQUEUE_H
 
+#include <cstdio>
+#include <map>
 #include <string>
 
 #include "gold-threads.h"
@@ -45,7 +47,8 @@ class Task
 {
  public:
   Task()
-    : list_next_(NULL), name_(), should_run_soon_(false)
+    : list_next_(NULL), name_(), should_run_soon_(false), locker_(),
+      trace_queued_(0), trace_blocker_(0), trace_released_by_(-1)
   { }
   virtual ~Task()
   { }
@@ -96,6 +99,50 @@ class Task
   clear_list_next()
   { this->list_next_ = NULL; }
 
+  // Return the Task_locker which holds the locks for this Task while
+  // it is waiting on a run queue and while it runs.  Called by
+  // Workqueue.
+  Task_locker*
+  locker()
+  { return &this->locker_; }
+
+  // The following are only used when writing a task trace with
+  // --task-trace.  They are only called with the workqueue lock held.
+
+  // Return the time at which the Task was queued.
+  uint64_t
+  trace_queued() const
+  { return this->trace_queued_; }
+
+  // Set the time at which the Task was queued.
+  void
+  set_trace_queued(uint64_t t)
+  { this->trace_queued_ = t; }
+
+  // Return the trace number of the last Task_token which this Task
+  // waited for, or 0.
+  unsigned int
+  trace_blocker() const
+  { return this->trace_blocker_; }
+
+  // Note that this Task had to wait for the Task_token with trace
+  // number ID.
+  void
+  set_trace_blocker(unsigned int id)
+  { this->trace_blocker_ = id; }
+
+  // Return the index in the trace of the Task whose completion made
+  // this Task runnable, or -1.
+  long
+  trace_released_by() const
+  { return this->trace_released_by_; }
+
+  // Set the index in the trace of the Task which made this Task
+  // runnable.
+  void
+  set_trace_released_by(long index)
+  { this->trace_released_by_ = index; }
+
   // Return the name of the Task.  This is only used for debugging
   // purposes.
   const std::string&
@@ -127,6 +174,16 @@ class Task
   // Whether this Task should be executed soon.  This is used for
   // Tasks which can be run after some data is read.
   bool should_run_soon_;
+  // The locks held by this Task.
+  Task_locker locker_;
+  // Time in microseconds at which this Task was queued, for tracing.
+  uint64_t trace_queued_;
+  // The trace number of the last Task_token this Task waited on, for
+  // tracing.
+  unsigned int trace_blocker_;
+  // Index in the trace of the Task which released this Task, for
+  // tracing.
+  long trace_released_by_;
 };
 
 // An interface for Task_function.  This is a convenience class to run
@@ -191,9 +248,44 @@ class Task_function : public Task
   const char* name_;
 };
 
+// Resources used by a group of Tasks, gathered for --stats-file.
+// Tasks are grouped by class, which is the first word of the Task
+// name, and by input file, which is the rest of the name.
+
+struct Task_stats
+{
+  Task_stats()
+    : count(0), wall_us(0), cpu_us(0), heap_growth(0), max_heap_growth(0)
+  { }
+
+  // The number of Tasks.
+  unsigned long long count;
+  // The wall clock time, and the CPU time of the threads running the
+  // Tasks, in microseconds.
+  unsigned long long wall_us;
+  unsigned long long cpu_us;
+  // The growth of the malloc heap while the Tasks ran, and the
+  // largest growth for a single Task.  Other threads may allocate
+  // memory at the same time, so when using threads these are only
+  // approximate.
+  unsigned long long heap_growth;
+  unsigned long long max_heap_growth;
+};
+
+typedef std::map<std::string, Task_stats> Task_stats_map;
+
+// Write S to F as a JSON string, with the quotes.  This is used when
+// writing the files requested by --task-trace and --stats-file.
+
+extern void
+write_json_string(FILE* f, const std::string& s);
+
 // The workqueue itself.
 
 class Workqueue_threader;
+class Workqueue_trace;
+class Workqueue_stats;
+class Workqueue_run_queue;
 
 class Workqueue
 {
@@ -233,6 +325,21 @@ class Workqueue
   void
   add_blocker(Task_token*);
 
+  // Write the task trace requested by --task-trace, if any.  This
+  // must be called after process has returned.
+  void
+  write_trace();
+
+  // Return the statistics for each Task class gathered for
+  // --stats-file, or NULL if they are not being gathered.  This must
+  // be called after process has returned.
+  const Task_stats_map*
+  task_stats_by_class() const;
+
+  // Likewise, for each input file.
+  const Task_stats_map*
+  task_stats_by_file() const;
+
  private:
   // This class can not be copied.
   Workqueue(const Workqueue&);
@@ -248,7 +355,7 @@ class Workqueue
 
   // Find a runnable task.
   Task*
-  find_runnable();
+  find_runnable(int thread_number);
 
   // Find a runnable task in a list.
   Task*
@@ -258,13 +365,34 @@ class Workqueue
   bool
   find_and_run_task(int);
 
+  // Take the locks for a runnable Task and count it as running.
+  void
+  start_task(Task*);
+
+  // Return the run queue used by a thread.
+  Workqueue_run_queue*
+  run_queue(int thread_number);
+
+  // Take a Task from another thread's run queue.
+  Task*
+  steal_task(int thread_number);
+
   // Release the locks for a Task.  Return the next Task to run.
   Task*
-  release_locks(Task*, Task_locker*);
+  release_locks(Task*, int thread_number);
 
   // Store T into *PRET, or queue it as appropriate.
   bool
-  return_or_queue(Task* t, bool is_blocker, Task** pret);
+  return_or_queue(Task* t, bool is_blocker, int thread_number, Task** pret,
+		  int* pqueued);
+
+  // Wake up idle threads to run newly queued Tasks.
+  void
+  wake_threads(int count);
+
+  // Note that T must wait for TOKEN.
+  void
+  add_waiting(Task_token* token, Task* t, bool front);
 
   // Return whether to cancel this thread.
   bool
@@ -281,6 +409,8 @@ class Workqueue
   int running_;
   // Number of tasks waiting for a lock to release.
   int waiting_;
+  // Number of threads waiting on condvar_ for a task to run.
+  int idle_;
   // Condition variable associated with lock_.  This is signalled when
   // there may be a new Task to execute.
   Condvar condvar_;
@@ -288,6 +418,18 @@ class Workqueue
   // The threading implementation.  This is set at construction time
   // and not changed thereafter.
   Workqueue_threader* threader_;
+  // The task trace, if --task-trace was used; otherwise NULL.  This
+  // is protected by lock_.
+  Workqueue_trace* trace_;
+  // The Task statistics, if --stats-file was used; otherwise NULL.
+  // This is protected by lock_.
+  Workqueue_stats* stats_;
+
+  // The number of run queues.  A thread uses the run queue selected
+  // by its thread number modulo this count.
+  static const int run_queue_count = 16;
+  // The run queues, which have their own locks.
+  Workqueue_run_queue* run_queues_;
 };
 
 } // End namespace gold.